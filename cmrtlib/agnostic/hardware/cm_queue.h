@@ -40,8 +40,10 @@ typedef enum _CM_FASTCOPY_DIRECTION
 
 typedef enum _CM_FASTCOPY_OPTION
 {
-    CM_FASTCOPY_OPTION_NONBLOCKING = 0x00,
-    CM_FASTCOPY_OPTION_BLOCKING    = 0x01
+    CM_FASTCOPY_OPTION_NONBLOCKING         = 0x00,
+    CM_FASTCOPY_OPTION_BLOCKING            = 0x01,
+    CM_FASTCOPY_OPTION_DISABLE_TURBO_BOOST = 0x02,
+    CM_FASTCOPY_OPTION_STAGED              = 0x04
 } CM_FASTCOPY_OPTION;
 
 //CM_ENQUEUE_GPUCOPY_PARAM version 2: two new fields are added
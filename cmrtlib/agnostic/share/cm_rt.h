@@ -378,8 +378,10 @@ typedef enum _CM_DEVICE_CAP_NAME
 
 typedef enum _CM_FASTCOPY_OPTION
 {
-    CM_FASTCOPY_OPTION_NONBLOCKING  = 0x00,
-    CM_FASTCOPY_OPTION_BLOCKING     = 0x01
+    CM_FASTCOPY_OPTION_NONBLOCKING          = 0x00,
+    CM_FASTCOPY_OPTION_BLOCKING             = 0x01,
+    CM_FASTCOPY_OPTION_DISABLE_TURBO_BOOST  = 0x02,
+    CM_FASTCOPY_OPTION_STAGED               = 0x04  // CPU to GPU only, source is staged so it can be reused at once
 } CM_FASTCOPY_OPTION;
 
 typedef enum _CM_DEPENDENCY_PATTERN
@@ -857,6 +857,15 @@ CM_RT_API int32_t CmDeviceRT::DestroySurface(CmSurface2D* &surface)
     {
         return CM_NULL_POINTER;
     }
+
+    // CPU read/write of the surface holds its own lock, not the device lock.
+    // Wait here for one still in flight before the resource may be freed.
+    // The lock can't be held across the destroy since it lives in the surface.
+    // Surface lock is always taken after the device lock, never the other way.
+    {
+        CLock readWriteLocker(*surfaceRT->GetReadWriteLock());
+    }
+
     int32_t status = m_surfaceMgr->DestroySurface(surfaceRT, APP_DESTROY);
 
     if (status != CM_FAILURE)  // CM_SURFACE_IN_USE may be returned, which should be treated as SUCCESS.
@@ -526,8 +526,6 @@ MOS_STATUS HalCm_VeboxInitSTMMHistory(
     PRENDERHAL_SURFACE      renderHalSTMMSurface)
 {
     MOS_STATUS          hr;
-    uint32_t            size;
-    int32_t             x, y;
     uint8_t             *bytes;
     MOS_LOCK_PARAMS     lockFlags;
 
@@ -546,20 +544,12 @@ MOS_STATUS HalCm_VeboxInitSTMMHistory(
 
     CM_CHK_NULL_RETURN_MOSSTATUS(bytes);
 
-    size = stmmSurface->dwWidth >> 2;
-
-    // Fill STMM surface with DN history init values.
-    for (y = 0; y < (int32_t)stmmSurface->dwHeight; y++)
-    {
-        for (x = 0; x < (int32_t)size; x++)
-        {
-            MOS_FillMemory(bytes, 2, DNDI_HISTORY_INITVALUE);
-            // skip denoise history init.
-            bytes += 4;
-        }
-
-        bytes += stmmSurface->dwPitch - stmmSurface->dwWidth;
-    }
+    // Fill STMM surface with DN history init values, skip denoise history init.
+    Mhw_FillSTMMHistory(
+        bytes,
+        stmmSurface->dwWidth,
+        stmmSurface->dwHeight,
+        stmmSurface->dwPitch);
 
     // Unlock the surface
     CM_HRESULT2MOSSTATUS_AND_CHECK(osInterface->pfnUnlockResource(
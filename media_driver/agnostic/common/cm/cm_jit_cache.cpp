@@ -0,0 +1,699 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      cm_jit_cache.cpp
+//! \brief     Contains Class CmJitCache definitions
+//!
+
+#include "cm_jit_cache.h"
+
+#include <stdio.h>
+#include "cm_mem.h"
+
+namespace CMRT_UMD
+{
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the process wide JIT binary cache
+//| Returns:    Pointer to the cache.
+//*-----------------------------------------------------------------------------
+CmJitCache *CmJitCache::GetInstance()
+{
+    static CmJitCache instance;
+    return &instance;
+}
+}  // namespace
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT void CmJitCache_SetUltConfig(uint64_t limit, const char *path)
+    {
+        CMRT_UMD::CmJitCache::GetInstance()->SetUltConfig(limit, path);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+namespace CMRT_UMD
+{
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Constructor of CmJitCache, reads the size limit and cache path
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+CmJitCache::CmJitCache()
+{
+    uint64_t    limit = 0;
+    std::string path;
+
+    m_mutex = MOS_CreateMutex();
+
+    // Like the cached binaries, the mutex outlives the devices and is not counted
+    MosMemAllocCounter--;
+    MOS_MEMNINJA_FREE_MESSAGE(m_mutex, __FUNCTION__, __FILE__, __LINE__);
+
+    ReadConfig(limit, path);
+    SetConfig(limit, path);
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Read the size limit and cache path from the user features
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::ReadConfig(uint64_t &limit, std::string &path)
+{
+    MOS_USER_FEATURE_VALUE_DATA userFeatureData;
+    char                        stringData[MOS_MAX_PATH_LENGTH + 1];
+
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_SIZE_ID,
+        &userFeatureData);
+    limit = (uint64_t)userFeatureData.u32Data << 20;
+    path.clear();
+
+    if (limit == 0)
+    {
+        return;
+    }
+
+#ifdef LINUX
+    char *customizedPath = getenv(CM_JIT_CACHE_PATH_ENV);
+    if (customizedPath != nullptr && strlen(customizedPath) != 0)
+    {
+        path = customizedPath;
+        return;
+    }
+#endif
+
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    stringData[0] = '\0';
+    userFeatureData.StringData.pStringData = stringData;
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_PATH_ID,
+        &userFeatureData);
+
+    if (userFeatureData.StringData.uSize > 0 && userFeatureData.StringData.uSize <= MOS_MAX_PATH_LENGTH)
+    {
+        path = userFeatureData.StringData.pStringData;
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Apply the size limit and cache path, unreferenced binaries in
+//|             memory are dropped. Called locked once constructed.
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::SetConfig(uint64_t limit, const std::string &path)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        Entry *entry = it->second;
+        ++it;
+        if (entry->refCount == 0)
+        {
+            DestroyEntry(entry);
+        }
+    }
+
+    m_limit = limit;
+    m_path  = (limit == 0) ? "" : path;
+
+    if (!m_path.empty())
+    {
+        if (m_path[m_path.length() - 1] != MOS_DIRECTORY_DELIMITER)
+        {
+            m_path += MOS_DIRECTORY_DELIMITER;
+        }
+        if (MOS_CreateDirectory((char *)m_path.c_str()) != MOS_STATUS_SUCCESS)
+        {
+            CM_NORMALMESSAGE("Warning: JIT cache directory is not accessible, binaries are cached in memory only.");
+            m_path.clear();
+        }
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Override the user feature settings, used by ULT
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::SetUltConfig(uint64_t limit, const char *path)
+{
+    std::string cachePath;
+
+    if (m_mutex == nullptr)
+    {
+        return;
+    }
+
+    MOS_LockMutex(m_mutex);
+    if (path == nullptr)
+    {
+        ReadConfig(limit, cachePath);
+    }
+    else
+    {
+        cachePath = path;
+    }
+    SetConfig(limit, cachePath);
+    MOS_UnlockMutex(m_mutex);
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Destructor of CmJitCache
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+CmJitCache::~CmJitCache()
+{
+    for (auto &it : m_entries)
+    {
+        // Binaries still referenced by programs are not freed at process exit
+        if (it.second->refCount == 0)
+        {
+            free(it.second->binary);
+            delete it.second;
+        }
+    }
+    m_entries.clear();
+    m_binaries.clear();
+
+    if (m_mutex != nullptr)
+    {
+        MOS_DestroyMutex(m_mutex);
+        m_mutex = nullptr;
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    FNV-1a hash of data, continuing from hash
+//| Returns:    Updated hash.
+//*-----------------------------------------------------------------------------
+uint64_t CmJitCache::Hash(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= CM_JIT_CACHE_FNV_PRIME;
+    }
+    return hash;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Hash the parts of the key shared by all kernels of a program
+//| Returns:    Program hash.
+//*-----------------------------------------------------------------------------
+uint64_t CmJitCache::GetProgramHash(
+    pJITCompile     jitCompile,
+    uint64_t        cisaCodeHash,
+    uint32_t        cisaCodeSize,
+    const char      *platform,
+    int             majorVersion,
+    int             minorVersion,
+    int             numArgs,
+    const char      *args[])
+{
+    uint64_t hash       = CM_JIT_CACHE_FNV_OFFSET;
+    uint64_t jitterHash = GetJitterHash(jitCompile);
+
+    hash = Hash(hash, &jitterHash, sizeof(jitterHash));
+    hash = Hash(hash, &cisaCodeSize, sizeof(cisaCodeSize));
+    hash = Hash(hash, &cisaCodeHash, sizeof(cisaCodeHash));
+    if (platform)
+    {
+        hash = Hash(hash, platform, strlen(platform) + 1);
+    }
+    hash = Hash(hash, &majorVersion, sizeof(majorVersion));
+    hash = Hash(hash, &minorVersion, sizeof(minorVersion));
+    hash = Hash(hash, &numArgs, sizeof(numArgs));
+    for (int i = 0; i < numArgs; i++)
+    {
+        if (args[i])
+        {
+            hash = Hash(hash, args[i], strlen(args[i]) + 1);
+        }
+    }
+
+    return hash;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Serialize the key of a kernel. Strings are stored with their
+//|             terminator, so adjacent strings cannot run into each other.
+//| Returns:    Key data.
+//*-----------------------------------------------------------------------------
+std::string CmJitCache::GetKeyData(
+    uint64_t        programHash,
+    const char      *kernelName,
+    const char      *platform,
+    int             majorVersion,
+    int             minorVersion,
+    int             numArgs,
+    const char      *args[])
+{
+    std::string keyData;
+
+    keyData.append((const char *)&programHash, sizeof(programHash));
+    keyData.append(kernelName, strnlen(kernelName, CM_MAX_KERNEL_NAME_SIZE_IN_BYTE));
+    keyData.push_back('\0');
+    keyData.append(platform ? platform : "");
+    keyData.push_back('\0');
+    keyData.append((const char *)&majorVersion, sizeof(majorVersion));
+    keyData.append((const char *)&minorVersion, sizeof(minorVersion));
+    keyData.append((const char *)&numArgs, sizeof(numArgs));
+    for (int i = 0; i < numArgs; i++)
+    {
+        keyData.append(args[i] ? args[i] : "");
+        keyData.push_back('\0');
+    }
+
+    return keyData;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the finalized binary of a kernel from the cache, or jit and
+//|             add it to the cache. Files are read and written unlocked.
+//| Returns:    Result of the operation.
+//*-----------------------------------------------------------------------------
+int32_t CmJitCache::Compile(
+    pJITCompile     jitCompile,
+    pFreeBlock      freeBlock,
+    uint64_t        programHash,
+    const char      *kernelName,
+    const void      *kernelIsa,
+    uint32_t        kernelIsaSize,
+    void            *&genBinary,
+    uint32_t        &genBinarySize,
+    const char      *platform,
+    int             majorVersion,
+    int             minorVersion,
+    int             numArgs,
+    const char      *args[],
+    char            *errorMsg,
+    FINALIZER_INFO  *jitInfo)
+{
+    std::string keyData;
+    uint64_t    key     = 0;
+    Entry       *entry  = nullptr;
+    std::string path;
+    uint64_t    limit   = 0;
+
+    if (!IsEnabled())
+    {
+        return jitCompile(kernelName, kernelIsa, kernelIsaSize, genBinary, genBinarySize,
+            platform, majorVersion, minorVersion, numArgs, args, errorMsg, jitInfo);
+    }
+
+    keyData = GetKeyData(programHash, kernelName, platform, majorVersion, minorVersion, numArgs, args);
+    key     = Hash(CM_JIT_CACHE_FNV_OFFSET, keyData.data(), keyData.size());
+
+    MOS_LockMutex(m_mutex);
+    entry = AcquireEntry(key, keyData);
+    path  = m_path;
+    limit = m_limit;
+    MOS_UnlockMutex(m_mutex);
+
+    if (entry == nullptr && !path.empty())
+    {
+        FINALIZER_INFO  fileJitInfo;
+        uint32_t        fileBinarySize  = 0;
+        uint8_t         *fileBinary     = LoadFromDisk(path, limit, key, keyData, fileBinarySize, fileJitInfo);
+
+        if (fileBinary)
+        {
+            MOS_LockMutex(m_mutex);
+            entry = AcquireEntry(key, keyData);
+            if (entry == nullptr)
+            {
+                entry = CreateEntry(key, keyData, fileBinary, fileBinarySize, &fileJitInfo);
+                if (entry)
+                {
+                    entry->refCount++;
+                    TrimMemory();
+                }
+            }
+            MOS_UnlockMutex(m_mutex);
+            MOS_FreeMemory(fileBinary);
+        }
+    }
+
+    if (entry)
+    {
+        // jitInfo of an entry is not changed once created
+        MOS_SecureMemcpy(jitInfo, sizeof(FINALIZER_INFO), &entry->jitInfo, sizeof(FINALIZER_INFO));
+    }
+    else
+    {
+        // Jit outside of the lock, other kernels may be looked up meanwhile
+        void     *jitBinary     = nullptr;
+        uint32_t jitBinarySize  = 0;
+        bool     created        = false;
+        int32_t  result         = jitCompile(kernelName, kernelIsa, kernelIsaSize, jitBinary, jitBinarySize,
+            platform, majorVersion, minorVersion, numArgs, args, errorMsg, jitInfo);
+        if (result != CM_SUCCESS)
+        {
+            return result;
+        }
+
+        MOS_LockMutex(m_mutex);
+        // Jitted by another thread as well if found
+        entry = AcquireEntry(key, keyData);
+        if (entry == nullptr)
+        {
+            entry   = CreateEntry(key, keyData, jitBinary, jitBinarySize, jitInfo);
+            created = (entry != nullptr);
+            if (entry)
+            {
+                entry->refCount++;
+                TrimMemory();
+            }
+        }
+        path  = m_path;
+        limit = m_limit;
+        MOS_UnlockMutex(m_mutex);
+
+        if (entry == nullptr)
+        {
+            // Out of memory or a different kernel holds the key, hand out the
+            // jitter's binary uncached
+            genBinary     = jitBinary;
+            genBinarySize = jitBinarySize;
+            return CM_SUCCESS;
+        }
+        freeBlock(jitBinary);
+
+        // The reference taken keeps the entry alive while it is written
+        if (created && !path.empty())
+        {
+            StoreToDisk(path, limit, entry);
+        }
+    }
+
+    genBinary     = entry->binary;
+    genBinarySize = entry->binarySize;
+
+    return CM_SUCCESS;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Return a binary got from Compile()
+//| Returns:    false if the binary is not owned by the cache.
+//*-----------------------------------------------------------------------------
+bool CmJitCache::ReleaseBinary(void *genBinary)
+{
+    // the cache may have been disabled since the binary was handed out
+    if (m_mutex == nullptr || genBinary == nullptr)
+    {
+        return false;
+    }
+
+    MOS_LockMutex(m_mutex);
+    auto it = m_binaries.find(genBinary);
+    if (it == m_binaries.end())
+    {
+        MOS_UnlockMutex(m_mutex);
+        return false;
+    }
+
+    CM_ASSERT(it->second->refCount > 0);
+    it->second->refCount--;
+    TrimMemory();
+    MOS_UnlockMutex(m_mutex);
+
+    return true;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Reference the entry of a key, called locked
+//| Returns:    The entry, nullptr if not cached or cached for another key with
+//|             the same hash.
+//*-----------------------------------------------------------------------------
+CmJitCache::Entry *CmJitCache::AcquireEntry(uint64_t key, const std::string &keyData)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || it->second->keyData != keyData)
+    {
+        return nullptr;
+    }
+
+    it->second->refCount++;
+    it->second->lastUse = ++m_useCount;
+    return it->second;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Add a copy of a binary to the in-memory cache, called locked.
+//|             The caller references the entry before trimming the cache.
+//| Returns:    The new entry, nullptr if out of memory or the hash is taken by
+//|             another key.
+//*-----------------------------------------------------------------------------
+CmJitCache::Entry *CmJitCache::CreateEntry(
+    uint64_t                key,
+    const std::string       &keyData,
+    const void              *binary,
+    uint32_t                binarySize,
+    const FINALIZER_INFO    *jitInfo)
+{
+    if (m_entries.find(key) != m_entries.end())
+    {
+        return nullptr;
+    }
+
+    // Entries outlive the devices, they are not tracked by MemNinja
+    Entry *entry = new (std::nothrow) Entry;
+    if (entry == nullptr)
+    {
+        return nullptr;
+    }
+
+    entry->binary = (uint8_t *)malloc(binarySize);
+    if (entry->binary == nullptr)
+    {
+        delete entry;
+        return nullptr;
+    }
+
+    MOS_SecureMemcpy(entry->binary, binarySize, binary, binarySize);
+    MOS_SecureMemcpy(&entry->jitInfo, sizeof(FINALIZER_INFO), jitInfo, sizeof(FINALIZER_INFO));
+    entry->jitInfo.genDebugInfo     = nullptr;
+    entry->jitInfo.genDebugInfoSize = 0;
+    entry->jitInfo.bbNum            = 0;
+    entry->jitInfo.bbInfo           = nullptr;
+    entry->key                      = key;
+    entry->keyData                  = keyData;
+    entry->binarySize               = binarySize;
+    entry->refCount                 = 0;
+    entry->lastUse                  = ++m_useCount;
+
+    m_entries[key]              = entry;
+    m_binaries[entry->binary]   = entry;
+    m_size                     += binarySize;
+
+    return entry;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Remove an entry from the in-memory cache, called locked
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::DestroyEntry(Entry *entry)
+{
+    m_entries.erase(entry->key);
+    m_binaries.erase(entry->binary);
+    m_size -= entry->binarySize;
+
+    free(entry->binary);
+    delete entry;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Evict unreferenced binaries, least recently used first, until
+//|             the in-memory cache fits in the limit. Called locked.
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::TrimMemory()
+{
+    while (m_size > m_limit)
+    {
+        Entry *oldest = nullptr;
+        for (auto &it : m_entries)
+        {
+            if (it.second->refCount == 0 && (oldest == nullptr || it.second->lastUse < oldest->lastUse))
+            {
+                oldest = it.second;
+            }
+        }
+
+        if (oldest == nullptr)
+        {
+            // Everything left is in use
+            break;
+        }
+        DestroyEntry(oldest);
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the cache file name of a key
+//| Returns:    File name.
+//*-----------------------------------------------------------------------------
+std::string CmJitCache::GetFileName(const std::string &path, uint64_t key)
+{
+    char name[32];
+    MOS_SecureStringPrint(name, sizeof(name), sizeof(name) - 1, "%016llx" CM_JIT_CACHE_FILE_EXT, (unsigned long long)key);
+    return path + name;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Read a binary from the cache directory, files failing the
+//|             integrity check are removed. Called unlocked.
+//| Returns:    The binary, freed with MOS_FreeMemory, nullptr if not cached on
+//|             disk or cached for another key with the same hash.
+//*-----------------------------------------------------------------------------
+uint8_t *CmJitCache::LoadFromDisk(
+    const std::string   &path,
+    uint64_t            limit,
+    uint64_t            key,
+    const std::string   &keyData,
+    uint32_t            &binarySize,
+    FINALIZER_INFO      &jitInfo)
+{
+    std::string                 fileName = GetFileName(path, key);
+    FILE                        *file    = nullptr;
+    CM_JIT_CACHE_FILE_HEADER    header;
+    std::string                 fileKeyData;
+    uint8_t                     *binary  = nullptr;
+    bool                        valid    = false;
+    bool                        otherKey = false;
+    long                        fileSize = 0;
+
+    if (MOS_SecureFileOpen(&file, fileName.c_str(), "rb") != MOS_STATUS_SUCCESS || file == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        fileSize = ftell(file);
+        rewind(file);
+    }
+
+    // Check the sizes against the file before allocating, the header may be corrupted
+    if (fread(&header, sizeof(header), 1, file) == 1 &&
+        header.magic == CM_JIT_CACHE_MAGIC &&
+        header.version == CM_JIT_CACHE_VERSION &&
+        header.key == key &&
+        header.infoSize == sizeof(FINALIZER_INFO) &&
+        header.keySize > 0 &&
+        header.binarySize > 0 &&
+        header.binarySize <= limit &&
+        fileSize == (long)(sizeof(header) + (uint64_t)header.keySize + header.binarySize))
+    {
+        fileKeyData.resize(header.keySize);
+        if (fread(&fileKeyData[0], header.keySize, 1, file) == 1)
+        {
+            // A file of another key is left alone, it is not corrupted
+            otherKey = (fileKeyData != keyData);
+            binary   = otherKey ? nullptr : (uint8_t *)MOS_AllocMemory(header.binarySize);
+        }
+        if (binary &&
+            fread(binary, header.binarySize, 1, file) == 1 &&
+            fgetc(file) == EOF)
+        {
+            uint64_t checksum = Hash(CM_JIT_CACHE_FNV_OFFSET, &header.jitInfo, sizeof(FINALIZER_INFO));
+            checksum = Hash(checksum, binary, header.binarySize);
+            valid    = (checksum == header.checksum);
+        }
+    }
+    fclose(file);
+
+    if (!valid)
+    {
+        if (!otherKey)
+        {
+            CM_NORMALMESSAGE("Warning: Corrupted JIT cache file %s is removed.", fileName.c_str());
+            remove(fileName.c_str());
+        }
+        MOS_FreeMemory(binary);
+        return nullptr;
+    }
+
+    binarySize = header.binarySize;
+    jitInfo    = header.jitInfo;
+    return binary;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Write a binary to the cache directory. The file is written under
+//|             a temporary name and renamed, so concurrent writers never expose
+//|             a partial file. Called unlocked with the entry referenced.
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::StoreToDisk(const std::string &path, uint64_t limit, const Entry *entry)
+{
+    char                        tempExt[48];
+    std::string                 fileName = GetFileName(path, entry->key);
+    std::string                 tempName;
+    FILE                        *file    = nullptr;
+    CM_JIT_CACHE_FILE_HEADER    header;
+    bool                        written  = false;
+
+    // Unique per process and entry, threads may write files of the same key
+    MOS_SecureStringPrint(tempExt, sizeof(tempExt), sizeof(tempExt) - 1, ".%u.%p", (uint32_t)MOS_GetPid(), (const void *)entry);
+    tempName = fileName + tempExt;
+
+    MOS_ZeroMemory(&header, sizeof(header));
+    header.magic        = CM_JIT_CACHE_MAGIC;
+    header.version      = CM_JIT_CACHE_VERSION;
+    header.key          = entry->key;
+    header.infoSize     = sizeof(FINALIZER_INFO);
+    header.keySize      = (uint32_t)entry->keyData.size();
+    header.binarySize   = entry->binarySize;
+    header.jitInfo      = entry->jitInfo;
+    header.checksum     = Hash(CM_JIT_CACHE_FNV_OFFSET, &header.jitInfo, sizeof(FINALIZER_INFO));
+    header.checksum     = Hash(header.checksum, entry->binary, entry->binarySize);
+
+    if (MOS_SecureFileOpen(&file, tempName.c_str(), "wb") != MOS_STATUS_SUCCESS || file == nullptr)
+    {
+        return;
+    }
+
+    written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(entry->keyData.data(), entry->keyData.size(), 1, file) == 1 &&
+              fwrite(entry->binary, entry->binarySize, 1, file) == 1;
+    written = (fclose(file) == 0) && written;
+
+    if (!written || rename(tempName.c_str(), fileName.c_str()) != 0)
+    {
+        remove(tempName.c_str());
+        return;
+    }
+
+    TrimDisk(path, limit);
+}
+}  // namespace
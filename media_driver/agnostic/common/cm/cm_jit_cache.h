@@ -0,0 +1,237 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      cm_jit_cache.h
+//! \brief     Contains Class CmJitCache definitions
+//!
+
+#ifndef MEDIADRIVER_AGNOSTIC_COMMON_CM_CMJITCACHE_H_
+#define MEDIADRIVER_AGNOSTIC_COMMON_CM_CMJITCACHE_H_
+
+#include <map>
+#include <string>
+#include "cm_program.h"
+
+#define CM_JIT_CACHE_MAGIC          0x434a4954  // "CJIT"
+#define CM_JIT_CACHE_VERSION        2
+#define CM_JIT_CACHE_FILE_EXT       ".cmjit"
+#define CM_JIT_CACHE_PATH_ENV       "MDF_JIT_CACHE_PATH"
+#define CM_JIT_CACHE_FNV_OFFSET     0xcbf29ce484222325ull
+#define CM_JIT_CACHE_FNV_PRIME      0x100000001b3ull
+
+namespace CMRT_UMD
+{
+//! Header of a cached binary file, followed by keySize bytes of key data and
+//! binarySize bytes of binary
+struct CM_JIT_CACHE_FILE_HEADER
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t infoSize;      // sizeof(FINALIZER_INFO) of the writer
+    uint32_t keySize;
+    uint32_t binarySize;
+    uint64_t checksum;      // Hash of jitInfo and binary
+    FINALIZER_INFO jitInfo; // Pointer fields are not cached
+};
+
+//*-----------------------------------------------------------------------------
+//! Process wide cache of jitter finalized kernel binaries.
+//! Binaries are keyed by the CISA code, kernel name, platform, CISA version,
+//! jitter flags and jitter library. They are kept in memory, and in files under
+//! the "MDF JIT Cache Path" directory when it is set, so devices and processes
+//! loading the same program skip the jitter. Both are bounded by "MDF JIT Cache
+//! Size" and evict the least recently used binaries first. Entries and files
+//! are looked up by the hash of the key and hit only if the whole key matches.
+//*-----------------------------------------------------------------------------
+class CmJitCache
+{
+public:
+    static CmJitCache *GetInstance();
+
+    //!
+    //! \brief    Check if the cache is enabled
+    //!
+    bool IsEnabled() { return m_limit > 0 && m_mutex != nullptr; }
+
+    //!
+    //! \brief    Override the size limit and cache path of the user features,
+    //!           used by ULT. Unreferenced binaries in memory are dropped.
+    //! \param    [in] limit
+    //!           Size limit in bytes, 0 to disable
+    //! \param    [in] path
+    //!           Cache directory, empty for in-memory only, nullptr to restore
+    //!           the user feature settings along with the limit
+    //!
+    void SetUltConfig(uint64_t limit, const char *path);
+
+    //!
+    //! \brief    Hash the parts of the key shared by all kernels of a program
+    //! \param    [in] jitCompile
+    //!           Jitter compile function, identifies the jitter library
+    //! \param    [in] cisaCodeHash
+    //!           Hash of the CISA code of the program, see Hash()
+    //! \param    [in] cisaCodeSize
+    //!           Size of the CISA code
+    //! \param    [in] platform
+    //!           Platform string passed to the jitter
+    //! \param    [in] majorVersion
+    //!           CISA major version
+    //! \param    [in] minorVersion
+    //!           CISA minor version
+    //! \param    [in] numArgs
+    //!           Number of jitter flags
+    //! \param    [in] args
+    //!           Jitter flags
+    //! \return   uint64_t
+    //!           Program hash to pass to Compile()
+    //!
+    uint64_t GetProgramHash(
+        pJITCompile     jitCompile,
+        uint64_t        cisaCodeHash,
+        uint32_t        cisaCodeSize,
+        const char      *platform,
+        int             majorVersion,
+        int             minorVersion,
+        int             numArgs,
+        const char      *args[]);
+
+    //!
+    //! \brief    Get the finalized binary of a kernel from the cache, or jit
+    //!           and add it to the cache
+    //! \details  Same arguments as pJITCompile plus the program hash. On success
+    //!           genBinary is owned by the cache, it must be returned with
+    //!           ReleaseBinary(). The pointer fields of jitInfo are not cached
+    //!           and are null on a cache hit.
+    //! \return   int32_t
+    //!           Return value of the jitter, CM_SUCCESS on a cache hit
+    //!
+    int32_t Compile(
+        pJITCompile     jitCompile,
+        pFreeBlock      freeBlock,
+        uint64_t        programHash,
+        const char      *kernelName,
+        const void      *kernelIsa,
+        uint32_t        kernelIsaSize,
+        void            *&genBinary,
+        uint32_t        &genBinarySize,
+        const char      *platform,
+        int             majorVersion,
+        int             minorVersion,
+        int             numArgs,
+        const char      *args[],
+        char            *errorMsg,
+        FINALIZER_INFO  *jitInfo);
+
+    //!
+    //! \brief    Return a binary got from Compile()
+    //! \param    [in] genBinary
+    //!           Binary to release
+    //! \return   bool
+    //!           false if genBinary is not owned by the cache, the caller
+    //!           frees it with the jitter's free function then
+    //!
+    bool ReleaseBinary(void *genBinary);
+
+    //!
+    //! \brief    FNV-1a hash of data, start with CM_JIT_CACHE_FNV_OFFSET
+    //!
+    static uint64_t Hash(uint64_t hash, const void *data, size_t size);
+
+protected:
+    struct Entry
+    {
+        uint64_t        key;
+        std::string     keyData;
+        uint8_t         *binary;
+        uint32_t        binarySize;
+        FINALIZER_INFO  jitInfo;
+        uint32_t        refCount;
+        uint64_t        lastUse;
+    };
+
+    CmJitCache();
+    ~CmJitCache();
+
+    //!
+    //! \brief    Hash identifying the jitter library build, OS specific
+    //!
+    static uint64_t GetJitterHash(pJITCompile jitCompile);
+
+    static void ReadConfig(uint64_t &limit, std::string &path);
+
+    //!
+    //! \brief    Serialize the key of a kernel: program hash, kernel name,
+    //!           platform, CISA version and jitter flags
+    //!
+    static std::string GetKeyData(
+        uint64_t        programHash,
+        const char      *kernelName,
+        const char      *platform,
+        int             majorVersion,
+        int             minorVersion,
+        int             numArgs,
+        const char      *args[]);
+
+    void SetConfig(uint64_t limit, const std::string &path);
+
+    Entry *AcquireEntry(uint64_t key, const std::string &keyData);
+
+    Entry *CreateEntry(uint64_t key, const std::string &keyData, const void *binary, uint32_t binarySize, const FINALIZER_INFO *jitInfo);
+
+    void DestroyEntry(Entry *entry);
+
+    static std::string GetFileName(const std::string &path, uint64_t key);
+
+    static uint8_t *LoadFromDisk(
+        const std::string   &path,
+        uint64_t            limit,
+        uint64_t            key,
+        const std::string   &keyData,
+        uint32_t            &binarySize,
+        FINALIZER_INFO      &jitInfo);
+
+    static void StoreToDisk(const std::string &path, uint64_t limit, const Entry *entry);
+
+    //!
+    //! \brief    Remove least recently written files until the directory fits
+    //!           in the limit, OS specific
+    //!
+    static void TrimDisk(const std::string &path, uint64_t limit);
+
+    void TrimMemory();
+
+    PMOS_MUTEX                  m_mutex    = nullptr;
+    std::map<uint64_t, Entry *> m_entries;             // By key
+    std::map<void *, Entry *>   m_binaries;            // By binary, for release
+    uint64_t                    m_size     = 0;        // Bytes of binaries in memory
+    uint64_t                    m_limit    = 0;
+    uint64_t                    m_useCount = 0;
+    std::string                 m_path;                // Empty if not cached on disk
+
+private:
+    CmJitCache(const CmJitCache &other);
+    CmJitCache &operator=(const CmJitCache &other);
+};
+}; //namespace
+
+#endif  // #ifndef MEDIADRIVER_AGNOSTIC_COMMON_CM_CMJITCACHE_H_
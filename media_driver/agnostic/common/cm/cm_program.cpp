@@ -29,6 +29,8 @@
 #include "cm_device_rt.h"
 #include "cm_mem.h"
 #include "cm_hal.h"
+#include "cm_jit_cache.h"
+#include "cm_program_store.h"
 
 #if USE_EXTENSION_CODE
 #include "cm_hw_debugger.h"
@@ -126,6 +128,7 @@ CmProgramRT::CmProgramRT( CmDeviceRT* device, uint32_t programId ):
     m_programCodeSize( 0 ),
     m_programCode(nullptr),
     m_isaFile(nullptr),
+    m_sharedProgram(nullptr),
     m_options( nullptr ),
     m_surfaceCount( 0 ),
     m_kernelCount( 0 ),
@@ -151,7 +154,6 @@ CmProgramRT::CmProgramRT( CmDeviceRT* device, uint32_t programId ):
 CmProgramRT::~CmProgramRT( void )
 {
     MosSafeDeleteArray( m_options );
-    MosSafeDeleteArray( m_programCode );
     for( uint32_t i = 0; i < m_kernelCount; i ++ )
     {
         uint32_t refCount = this->ReleaseKernelInfo(i);
@@ -159,7 +161,12 @@ CmProgramRT::~CmProgramRT( void )
 
     }
     m_kernelInfo.Delete();
-    CmSafeDelete(m_isaFile);
+
+    // Code and ISA file are shared with the programs of other devices
+    CmProgramStore::GetInstance()->Release(m_sharedProgram);
+    m_sharedProgram = nullptr;
+    m_programCode = nullptr;
+    m_isaFile = nullptr;
 }
 
 #if (_RELEASE_INTERNAL)
@@ -207,6 +214,10 @@ int32_t CmProgramRT::Initialize( void* cisaCode, const uint32_t cisaCodeSize, co
 
     char* flagStepInfo = nullptr;
 
+    CmJitCache *jitCache = CmJitCache::GetInstance();
+    bool useJitCache = false;
+    uint64_t programHash = 0;
+
     if( options )
     {
         size_t length = strnlen( options, CM_MAX_OPTION_SIZE_IN_BYTE );
@@ -258,6 +269,18 @@ int32_t CmProgramRT::Initialize( void* cisaCode, const uint32_t cisaCodeSize, co
         }
     }
 
+    // Byte identical code loaded on any device shares one copy, use it from here on
+    m_sharedProgram = CmProgramStore::GetInstance()->Acquire(cisaCode, cisaCodeSize);
+    if (m_sharedProgram == nullptr)
+    {
+        CM_ASSERTMESSAGE("Error: Out of system memory.");
+        MosSafeDeleteArray(m_options);
+        return CM_OUT_OF_HOST_MEMORY;
+    }
+    m_programCode = m_sharedProgram->code;
+    m_programCodeSize = cisaCodeSize;
+    cisaCode = m_programCode;
+
     uint8_t *buf = (uint8_t*)cisaCode;
     uint32_t bytePos = 0;
 
@@ -275,8 +298,8 @@ int32_t CmProgramRT::Initialize( void* cisaCode, const uint32_t cisaCodeSize, co
     }
     else
     {
-        m_isaFile = new vISA::ISAfile((uint8_t*)cisaCode, cisaCodeSize);
-        if (!m_isaFile->readFile())
+        m_isaFile = CmProgramStore::GetInstance()->GetIsaFile(m_sharedProgram);
+        if (!m_isaFile)
         {
             CM_ASSERTMESSAGE("Error: invalid VISA.");
             MosSafeDeleteArray(m_options);
@@ -376,6 +399,17 @@ int32_t CmProgramRT::Initialize( void* cisaCode, const uint32_t cisaCodeSize, co
                 return CM_OUT_OF_HOST_MEMORY;
             }
         }
+
+        // Debug info of the jitter is not cached, always jit for the debugger and GTPin
+        useJitCache = jitCache->IsEnabled() && !m_isHwDebugEnabled;
+#if USE_EXTENSION_CODE
+        useJitCache = useJitCache && !m_device->CheckGTPinEnabled();
+#endif
+        if (useJitCache)
+        {
+            programHash = jitCache->GetProgramHash(m_fJITCompile, m_sharedProgram->hash, cisaCodeSize, platform,
+                                                   m_cisaMajorVersion, m_cisaMinorVersion, numJitFlags, jitFlags);
+        }
     }
 
     if (useVisaApi)
@@ -597,8 +631,16 @@ int32_t CmProgramRT::Initialize( void* cisaCode, const uint32_t cisaCodeSize, co
             }
             CmSafeMemSet( jitProfInfo, 0, CM_JIT_PROF_INFO_SIZE );
 
-            result = m_fJITCompile( kernInfo->kernelName, (uint8_t*)cisaCode, cisaCodeSize,
-                                    jitBinary, jitBinarySize, platform, m_cisaMajorVersion, m_cisaMinorVersion, numJitFlags, jitFlags, errorMsg, jitProfInfo );
+            if (useJitCache)
+            {
+                result = jitCache->Compile( m_fJITCompile, m_fFreeBlock, programHash, kernInfo->kernelName, (uint8_t*)cisaCode, cisaCodeSize,
+                                            jitBinary, jitBinarySize, platform, m_cisaMajorVersion, m_cisaMinorVersion, numJitFlags, jitFlags, errorMsg, jitProfInfo );
+            }
+            else
+            {
+                result = m_fJITCompile( kernInfo->kernelName, (uint8_t*)cisaCode, cisaCodeSize,
+                                        jitBinary, jitBinarySize, platform, m_cisaMajorVersion, m_cisaMinorVersion, numJitFlags, jitFlags, errorMsg, jitProfInfo );
+            }
 
             //if error code returned or error message not nullptr
             if(result != CM_SUCCESS)// || errorMsg[0])
@@ -613,6 +655,11 @@ int32_t CmProgramRT::Initialize( void* cisaCode, const uint32_t cisaCodeSize, co
             // if spill code exists and scrach space disabled, return error to user
             if( jitProfInfo->isSpill &&  m_device->IsScratchSpaceDisabled())
             {
+                if (!jitCache->ReleaseBinary(jitBinary))
+                {
+                    m_fFreeBlock(jitBinary);
+                }
+                free(jitProfInfo);
                 CmSafeDelete(kernInfo);
                 free(errorMsg);
                 return CM_INVALID_KERNEL_SPILL_CODE;
@@ -649,20 +696,6 @@ int32_t CmProgramRT::Initialize( void* cisaCode, const uint32_t cisaCodeSize, co
         CM_NORMALMESSAGE("Jitter Done.");
 #endif
 
-    // now bytePos index to the start of common isa body;
-    // compute the code size for common isa
-    m_programCodeSize = cisaCodeSize;
-    m_programCode = MOS_NewArray(uint8_t, m_programCodeSize);
-    if( !m_programCode )
-    {
-        CM_ASSERTMESSAGE("Error: Out of system memory.");
-        hr = CM_OUT_OF_HOST_MEMORY;
-        goto finish;
-    }
-
-    //Copy CISA content
-    CmFastMemCopy((void *)m_programCode, cisaCode, cisaCodeSize);
-
     hr = CM_SUCCESS;
 
 finish:
@@ -670,7 +703,6 @@ finish:
     if(hr != CM_SUCCESS )
     {
         MosSafeDeleteArray(m_options);
-        MosSafeDeleteArray(m_programCode);
     }
     return hr;
 }
@@ -839,7 +871,8 @@ uint32_t CmProgramRT::ReleaseKernelInfo(uint32_t index)
             {
                 if(m_isJitterEnabled)
                 {
-                    if(kernelInfo && kernelInfo->jitBinaryCode)
+                    if(kernelInfo && kernelInfo->jitBinaryCode
+                        && !CmJitCache::GetInstance()->ReleaseBinary(kernelInfo->jitBinaryCode))
                         m_fFreeBlock(kernelInfo->jitBinaryCode);
                     if(kernelInfo && kernelInfo->jitInfo)
                         free(kernelInfo->jitInfo);
@@ -934,4 +967,19 @@ vISA::ISAfile *CmProgramRT::getISAfile()
 {
     return m_isaFile;
 }
-}
\ No newline at end of file
+}  // namespace
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT void *CmProgram_GetUltIsaFile(CMRT_UMD::CmProgram *program)
+    {
+        return static_cast<CMRT_UMD::CmProgramRT *>(program)->getISAfile();
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
\ No newline at end of file
@@ -31,6 +31,7 @@
 #include "cm_array.h"
 #include "cm_jitter_info.h"
 #include "cm_visa.h"
+#include "cm_program_store.h"
 
 struct attribute_info_t
 {
@@ -209,8 +210,9 @@ protected:
     CmDeviceRT* m_device;
 
     uint32_t m_programCodeSize;
-    uint8_t *m_programCode;
-    vISA::ISAfile* m_isaFile;
+    uint8_t *m_programCode;             // Read only, owned by m_sharedProgram
+    vISA::ISAfile* m_isaFile;           // Read only, owned by m_sharedProgram
+    CM_SHARED_PROGRAM *m_sharedProgram;
     char* m_options;
     char m_isaFileName[ CM_MAX_ISA_FILE_NAME_SIZE_IN_BYTE ];
     uint32_t m_surfaceCount;
@@ -0,0 +1,215 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      cm_program_store.cpp
+//! \brief     Contains Class CmProgramStore definitions
+//!
+
+#include "cm_program_store.h"
+
+#include "cm_jit_cache.h"
+#include "cm_mem.h"
+
+namespace CMRT_UMD
+{
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the process wide program store
+//| Returns:    Pointer to the store.
+//*-----------------------------------------------------------------------------
+CmProgramStore *CmProgramStore::GetInstance()
+{
+    static CmProgramStore instance;
+    return &instance;
+}
+}  // namespace
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT uint32_t CmProgramStore_GetUltProgramCount()
+    {
+        return CMRT_UMD::CmProgramStore::GetInstance()->GetProgramCount();
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+namespace CMRT_UMD
+{
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Constructor of CmProgramStore
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+CmProgramStore::CmProgramStore()
+{
+    m_mutex = MOS_CreateMutex();
+
+    // The store outlives the CM devices whose MemNinja count the mutex would skew
+    MosMemAllocCounter--;
+    MOS_MEMNINJA_FREE_MESSAGE(m_mutex, __FUNCTION__, __FILE__, __LINE__);
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Destructor of CmProgramStore
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+CmProgramStore::~CmProgramStore()
+{
+    if (m_mutex != nullptr)
+    {
+        MOS_DestroyMutex(m_mutex);
+        m_mutex = nullptr;
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the shared copy of CISA code, byte identical code shares
+//|             one entry
+//| Returns:    Shared program, nullptr if out of memory.
+//*-----------------------------------------------------------------------------
+CM_SHARED_PROGRAM *CmProgramStore::Acquire(const void *cisaCode, uint32_t cisaCodeSize)
+{
+    CM_SHARED_PROGRAM *program = nullptr;
+    uint64_t hash = CmJitCache::Hash(CM_JIT_CACHE_FNV_OFFSET, cisaCode, cisaCodeSize);
+
+    MOS_LockMutex(m_mutex);
+
+    auto range = m_programs.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second->size == cisaCodeSize && !memcmp(it->second->code, cisaCode, cisaCodeSize))
+        {
+            program = it->second;
+            break;
+        }
+    }
+
+    if (program == nullptr)
+    {
+        program = MOS_New(CM_SHARED_PROGRAM);
+        if (program == nullptr)
+        {
+            MOS_UnlockMutex(m_mutex);
+            return nullptr;
+        }
+        program->code = MOS_NewArray(uint8_t, cisaCodeSize);
+        if (program->code == nullptr)
+        {
+            MOS_Delete(program);
+            MOS_UnlockMutex(m_mutex);
+            return nullptr;
+        }
+
+        CmFastMemCopy(program->code, cisaCode, cisaCodeSize);
+        program->hash       = hash;
+        program->size       = cisaCodeSize;
+        program->isaFile    = nullptr;
+        program->isaParsed  = false;
+        program->refCount   = 0;
+        m_programs.insert(std::make_pair(hash, program));
+    }
+
+    program->refCount++;
+
+    MOS_UnlockMutex(m_mutex);
+
+    return program;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Release a shared program, the last release frees it
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmProgramStore::Release(CM_SHARED_PROGRAM *program)
+{
+    if (program == nullptr)
+    {
+        return;
+    }
+
+    MOS_LockMutex(m_mutex);
+
+    CM_ASSERT(program->refCount > 0);
+    if (--program->refCount > 0)
+    {
+        MOS_UnlockMutex(m_mutex);
+        return;
+    }
+
+    auto range = m_programs.equal_range(program->hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == program)
+        {
+            m_programs.erase(it);
+            break;
+        }
+    }
+
+    MOS_UnlockMutex(m_mutex);
+
+    CmSafeDelete(program->isaFile);
+    MosSafeDeleteArray(program->code);
+    MOS_Delete(program);
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the parsed ISA file of a shared program
+//| Returns:    Parsed ISA file, nullptr if the code is not valid VISA.
+//*-----------------------------------------------------------------------------
+vISA::ISAfile *CmProgramStore::GetIsaFile(CM_SHARED_PROGRAM *program)
+{
+    MOS_LockMutex(m_mutex);
+
+    if (!program->isaParsed)
+    {
+        program->isaParsed = true;
+        program->isaFile = new (std::nothrow) vISA::ISAfile(program->code, program->size);
+        if (program->isaFile && !program->isaFile->readFile())
+        {
+            CmSafeDelete(program->isaFile);
+        }
+    }
+
+    MOS_UnlockMutex(m_mutex);
+
+    return program->isaFile;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the number of shared programs in the store
+//| Returns:    Number of distinct programs in use.
+//*-----------------------------------------------------------------------------
+uint32_t CmProgramStore::GetProgramCount()
+{
+    MOS_LockMutex(m_mutex);
+    uint32_t count = static_cast<uint32_t>(m_programs.size());
+    MOS_UnlockMutex(m_mutex);
+
+    return count;
+}
+}  // namespace
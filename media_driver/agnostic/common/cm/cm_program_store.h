@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      cm_program_store.h
+//! \brief     Contains Class CmProgramStore definitions
+//!
+
+#ifndef MEDIADRIVER_AGNOSTIC_COMMON_CM_CMPROGRAMSTORE_H_
+#define MEDIADRIVER_AGNOSTIC_COMMON_CM_CMPROGRAMSTORE_H_
+
+#include <map>
+#include "cm_def.h"
+#include "cm_visa.h"
+
+namespace CMRT_UMD
+{
+//! CISA code shared by all programs loaded from byte identical code
+struct CM_SHARED_PROGRAM
+{
+    uint64_t        hash;       // Hash of the code
+    uint32_t        size;
+    uint8_t         *code;      // Read only copy of the code
+    vISA::ISAfile   *isaFile;   // Parsed on first use, nullptr if invalid
+    bool            isaParsed;
+    uint32_t        refCount;
+};
+
+//*-----------------------------------------------------------------------------
+//! Process wide store of program code. Devices loading byte identical CISA
+//! code share one read only copy of it and of its parsed ISA file, instead
+//! of copying and parsing it per CmProgram. Entries are reference counted by
+//! the programs using them. Jitted kernels are shared through CmJitCache.
+//*-----------------------------------------------------------------------------
+class CmProgramStore
+{
+public:
+    static CmProgramStore *GetInstance();
+
+    //!
+    //! \brief    Get the shared copy of CISA code
+    //! \param    [in] cisaCode
+    //!           Pointer to the CISA code
+    //! \param    [in] cisaCodeSize
+    //!           Size of the CISA code
+    //! \return   CM_SHARED_PROGRAM*
+    //!           Shared program, nullptr if out of memory
+    //!
+    CM_SHARED_PROGRAM *Acquire(const void *cisaCode, uint32_t cisaCodeSize);
+
+    //!
+    //! \brief    Release a shared program got from Acquire()
+    //! \param    [in] program
+    //!           Shared program to release
+    //!
+    void Release(CM_SHARED_PROGRAM *program);
+
+    //!
+    //! \brief    Get the parsed ISA file of a shared program, the code is
+    //!           parsed by the first caller only
+    //! \param    [in] program
+    //!           Shared program
+    //! \return   vISA::ISAfile*
+    //!           Parsed ISA file, nullptr if the code is not valid VISA
+    //!
+    vISA::ISAfile *GetIsaFile(CM_SHARED_PROGRAM *program);
+
+    //!
+    //! \brief    Get the number of shared programs in the store
+    //! \return   uint32_t
+    //!           Number of distinct programs in use
+    //!
+    uint32_t GetProgramCount();
+
+protected:
+    CmProgramStore();
+    ~CmProgramStore();
+
+    PMOS_MUTEX                                       m_mutex = nullptr;
+    std::multimap<uint64_t, CM_SHARED_PROGRAM *>     m_programs;  // By hash
+
+private:
+    CmProgramStore(const CmProgramStore &other);
+    CmProgramStore &operator=(const CmProgramStore &other);
+};
+}; //namespace
+
+#endif  // #ifndef MEDIADRIVER_AGNOSTIC_COMMON_CM_CMPROGRAMSTORE_H_
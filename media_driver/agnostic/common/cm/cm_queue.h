@@ -33,7 +33,8 @@ enum CM_FASTCOPY_OPTION
 {
     CM_FASTCOPY_OPTION_NONBLOCKING = 0x00,
     CM_FASTCOPY_OPTION_BLOCKING = 0x01,
-    CM_FASTCOPY_OPTION_DISABLE_TURBO_BOOST = 0x02
+    CM_FASTCOPY_OPTION_DISABLE_TURBO_BOOST = 0x02,
+    CM_FASTCOPY_OPTION_STAGED = 0x04
 };
 
 namespace CMRT_UMD
@@ -279,7 +280,10 @@ public:
     //! \param    [in] option
     //!           If it is "CM_FASTCOPY_OPTION_NONBLOCKING", it returns immediately without waiting for GPU to start or finish.\n
     //!           If it is "CM_FASTCOPY_OPTION_BLOCKING", this function will return until copy is finished indeed.\n
-    //!           If it is "CM_FASTCOPY_OPTION_DISABLE_TURBO_BOOST", mdf turbo boost is disabled.
+    //!           If it is "CM_FASTCOPY_OPTION_DISABLE_TURBO_BOOST", mdf turbo boost is disabled.\n
+    //!           If "CM_FASTCOPY_OPTION_STAGED" is set, sysMem is first copied into a staging buffer
+    //!           pooled by the queue, it can be reused as soon as the function returns and has no
+    //!           alignment restriction.
     //! \param    [in,out] event
     //!           reference to pointer of event generated. If it is set as CM_NO_EVENT,
     //!           its value returned by runtime is NULL.
@@ -128,6 +128,8 @@ CmQueueRT::~CmQueueRT()
 {
     uint32_t eventReleaseTimes = 0;
 
+    ReleaseStagingBuffers();
+
     uint32_t eventArrayUsedSize = m_eventArray.GetMaxSize();
     for( uint32_t i = 0; i < eventArrayUsedSize; i ++ )
     {
@@ -1120,6 +1122,11 @@ int32_t CmQueueRT::EnqueueCopyInternal(CmSurface2DRT* surface,
         return CM_GPUCOPY_INVALID_SURFACES;
     }
 
+    if ((option & CM_FASTCOPY_OPTION_STAGED) && direction == CM_FASTCOPY_CPU2GPU)
+    {
+        return EnqueueCopyInternal_Staged(surface, sysMem, widthStride, heightStride, option, event);
+    }
+
     if (format == CM_SURFACE_FORMAT_NV12 || format == CM_SURFACE_FORMAT_P010 || format == CM_SURFACE_FORMAT_P016)
     {
         hr = EnqueueCopyInternal_2Planes(surface, (unsigned char*)sysMem, format, width, widthStride, height, heightStride, sizePerPixel, direction, option, event);
@@ -1663,6 +1670,221 @@ finish:
     return hr;
 }
 
+//*-----------------------------------------------------------------------------
+//| Purpose:    Copy system memory into a pooled staging buffer and enqueue the
+//|             GPU copy from the staging buffer to the surface
+//| Arguments:
+//|             surface       [in]  Pointer to a CmSurface2D object as copy destination
+//|             sysMem        [in]  Pointer to a system memory as copy source
+//|             widthStride   [in]  Width stride in bytes for system memory
+//|             heightStride  [in]  Height stride in rows for system memory
+//|             option        [in]  Option passed from user
+//|             event         [in,out]  Reference to the pointer to Event
+//| Returns:    Result of the operation.
+//|
+//| Restrictions & Notes:
+//|             1) sysMem can be reused as soon as this function returns.
+//|             2) sysMem and widthStride need not be 16-byte aligned.
+//*-----------------------------------------------------------------------------
+int32_t CmQueueRT::EnqueueCopyInternal_Staged(CmSurface2DRT* surface,
+                                       unsigned char* sysMem,
+                                       const uint32_t widthStride,
+                                       const uint32_t heightStride,
+                                       const uint32_t option,
+                                       CmEvent* & event)
+{
+    int32_t             hr                  = CM_SUCCESS;
+    uint32_t            width               = 0;
+    uint32_t            height              = 0;
+    uint32_t            sizePerPixel        = 0;
+    CM_SURFACE_FORMAT   format              = CM_SURFACE_FORMAT_INVALID;
+    uint32_t            strideInBytes       = widthStride;
+    uint32_t            heightStrideInRows  = heightStride;
+    uint32_t            stagedStride        = 0;
+    uint32_t            rowCount            = 0;
+    CM_STAGING_BUFFER   *stagingBuffer      = nullptr;
+    CmEvent             *internalEvent      = nullptr;
+
+    if (sysMem == nullptr)
+    {
+        CM_ASSERTMESSAGE("Error: Pointer to system memory is null.");
+        return CM_GPUCOPY_INVALID_SYSMEM;
+    }
+
+    CMCHK_HR(surface->GetSurfaceDesc(width, height, format, sizePerPixel));
+
+    if (strideInBytes == 0)
+    {
+        strideInBytes = width * sizePerPixel;
+    }
+    if (heightStrideInRows == 0)
+    {
+        heightStrideInRows = height;
+    }
+
+    // UV plane of 2 plane formats follows the Y plane with half the copied rows,
+    // as read by EnqueueCopyInternal_2Planes
+    rowCount = heightStrideInRows;
+    if (format == CM_SURFACE_FORMAT_NV12 || format == CM_SURFACE_FORMAT_P010 || format == CM_SURFACE_FORMAT_P016)
+    {
+        rowCount += MOS_MIN(heightStrideInRows, height) / 2;
+    }
+
+    // GPU copy requires 16-byte aligned stride, staging buffers are page aligned
+    stagedStride = MOS_ALIGN_CEIL(strideInBytes, 16);
+
+    CMCHK_HR(AcquireStagingBuffer(stagedStride * rowCount, stagingBuffer));
+
+    if (stagedStride == strideInBytes)
+    {
+        CmFastMemCopy(stagingBuffer->sysMem, sysMem, strideInBytes * rowCount);
+    }
+    else
+    {
+        for (uint32_t row = 0; row < rowCount; row++)
+        {
+            CmFastMemCopy(stagingBuffer->sysMem + row * stagedStride, sysMem + row * strideInBytes, strideInBytes);
+        }
+    }
+
+    CMCHK_HR(EnqueueCopyInternal(surface, stagingBuffer->sysMem, stagedStride, heightStrideInRows,
+                                 CM_FASTCOPY_CPU2GPU, option & ~CM_FASTCOPY_OPTION_STAGED, internalEvent));
+    CMCHK_NULL(internalEvent);
+
+    // Keep the event until the GPU finished reading the staging buffer
+    static_cast<CmEventRT *>(internalEvent)->Acquire();
+    m_criticalSectionStagingBuffer.Acquire();
+    stagingBuffer->event = internalEvent;
+    m_criticalSectionStagingBuffer.Release();
+
+    if (event == CM_NO_EVENT)  //User doesn't need CmEvent for this copy
+    {
+        event = nullptr;
+        CMCHK_HR(DestroyEvent(internalEvent));
+    }
+    else
+    {
+        event = internalEvent;
+    }
+
+finish:
+    if (hr != CM_SUCCESS && stagingBuffer && stagingBuffer->event == nullptr)
+    {
+        m_criticalSectionStagingBuffer.Acquire();
+        stagingBuffer->inUse = false;
+        m_criticalSectionStagingBuffer.Release();
+    }
+    return hr;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get a free staging buffer of at least size bytes from the pool.
+//|             Buffers are free again once the copy reading them finished.
+//| Returns:    Result of the operation.
+//*-----------------------------------------------------------------------------
+int32_t CmQueueRT::AcquireStagingBuffer(uint32_t size, CM_STAGING_BUFFER* &stagingBuffer)
+{
+    CM_STAGING_BUFFER *smallBuffer = nullptr;
+    CM_STATUS          status      = CM_STATUS_QUEUED;
+
+    CLock locker(m_criticalSectionStagingBuffer);
+
+    stagingBuffer = nullptr;
+    for (CM_STAGING_BUFFER *buffer : m_stagingBuffers)
+    {
+        if (buffer->inUse && buffer->event)
+        {
+            buffer->event->GetStatus(status);
+            if (status == CM_STATUS_FINISHED || status == CM_STATUS_RESET)
+            {
+                DestroyEvent(buffer->event);
+                buffer->inUse = false;
+            }
+        }
+
+        if (buffer->inUse)
+        {
+            continue;
+        }
+        if (buffer->size >= size)
+        {
+            if (stagingBuffer == nullptr || buffer->size < stagingBuffer->size)
+            {
+                stagingBuffer = buffer;
+            }
+        }
+        else
+        {
+            smallBuffer = buffer;
+        }
+    }
+
+    if (stagingBuffer == nullptr)
+    {
+        // Grow a free buffer rather than adding one, the pool holds as many
+        // buffers as copies in flight
+        if (smallBuffer)
+        {
+            stagingBuffer = smallBuffer;
+            if (stagingBuffer->sysMem)
+            {
+                MOS_AlignedFreeMemory(stagingBuffer->sysMem);
+            }
+        }
+        else
+        {
+            stagingBuffer = MOS_New(CM_STAGING_BUFFER);
+            if (stagingBuffer == nullptr)
+            {
+                CM_ASSERTMESSAGE("Error: Out of system memory.");
+                return CM_OUT_OF_HOST_MEMORY;
+            }
+            m_stagingBuffers.push_back(stagingBuffer);
+        }
+
+        stagingBuffer->size   = MOS_ALIGN_CEIL(size, PAGE_ALIGNED);
+        stagingBuffer->sysMem = (unsigned char *)MOS_AlignedAllocMemory(stagingBuffer->size, PAGE_ALIGNED);
+        stagingBuffer->event  = nullptr;
+        stagingBuffer->inUse  = false;
+        if (stagingBuffer->sysMem == nullptr)
+        {
+            // Keep the empty entry, it is grown by the next request
+            stagingBuffer->size = 0;
+            stagingBuffer = nullptr;
+            CM_ASSERTMESSAGE("Error: Out of system memory.");
+            return CM_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    stagingBuffer->inUse = true;
+    stagingBuffer->event = nullptr;
+
+    return CM_SUCCESS;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Free the staging buffer pool, tasks of the queue are finished
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmQueueRT::ReleaseStagingBuffers()
+{
+    CLock locker(m_criticalSectionStagingBuffer);
+
+    for (CM_STAGING_BUFFER *buffer : m_stagingBuffers)
+    {
+        if (buffer->event)
+        {
+            DestroyEvent(buffer->event);
+        }
+        if (buffer->sysMem)
+        {
+            MOS_AlignedFreeMemory(buffer->sysMem);
+        }
+        MOS_Delete(buffer);
+    }
+    m_stagingBuffers.clear();
+}
+
 //*-----------------------------------------------------------------------------
 //! Enqueue an task, which contains one pre-defined kernel to copy from video memory to video memory
 //! This is a non-blocking call. i.e. it returns immediately without waiting for
@@ -30,6 +30,7 @@
 #include "cm_queue.h"
 
 #include <queue>
+#include <vector>
 
 #include "cm_array.h"
 #include "cm_csync.h"
@@ -63,6 +64,14 @@ struct CM_GPUCOPY_KERNEL
     bool locked;
 };
 
+struct CM_STAGING_BUFFER
+{
+    unsigned char *sysMem;  // Page aligned
+    uint32_t size;
+    CmEvent *event;         // Last copy reading the buffer
+    bool inUse;
+};
+
 class ThreadSafeQueue
 {
 public:
@@ -212,6 +221,13 @@ public:
                                 const uint32_t option,
                                 CmEvent *&event);
 
+    int32_t EnqueueCopyInternal_Staged(CmSurface2DRT *surface,
+                                       unsigned char *sysMem,
+                                       const uint32_t widthStride,
+                                       const uint32_t heightStride,
+                                       const uint32_t option,
+                                       CmEvent *&event);
+
     int32_t EnqueueUnalignedCopyInternal(CmSurface2DRT *surface,
                                          unsigned char *sysMem,
                                          const uint32_t widthStride,
@@ -287,6 +303,10 @@ protected:
 
     int32_t AddGPUCopyKernel(CM_GPUCOPY_KERNEL* &kernelParam);
 
+    int32_t AcquireStagingBuffer(uint32_t size, CM_STAGING_BUFFER* &stagingBuffer);
+
+    void ReleaseStagingBuffers();
+
     int32_t GetGPUCopyKrnID(uint32_t widthInByte,
                             uint32_t height,
                             CM_SURFACE_FORMAT format,
@@ -328,6 +348,9 @@ protected:
 
     CSync m_criticalSectionGPUCopyKrn;
 
+    std::vector<CM_STAGING_BUFFER *> m_stagingBuffers;  // Pool for staged CPU to GPU copies
+    CSync m_criticalSectionStagingBuffer;
+
     CM_HAL_MAX_VALUES *m_halMaxValues;
     CM_QUEUE_CREATE_OPTION m_queueOption;
 
@@ -236,10 +236,8 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurface( const unsigned char* sysMem, CmEv
     m_surfaceMgr->GetCmDevice(cmDevice);
     CMCHK_NULL_AND_RETURN(cmDevice);
 
-    //Lock for surface read/write
-    CSync* surfaceLock = cmDevice->GetSurfaceLock();
-    CM_ASSERT(surfaceLock);
-    CLock locker(*surfaceLock);
+    //Lock for surface read/write, per surface so other surfaces are not blocked
+    CLock locker(m_criticalSectionReadWrite);
 
     PCM_CONTEXT_DATA cmData = (PCM_CONTEXT_DATA)cmDevice->GetAccelData();
     CMCHK_NULL_AND_RETURN(cmData);
@@ -425,10 +423,8 @@ CM_RT_API int32_t CmSurface2DRT::ReadSurface( unsigned char* sysMem, CmEvent* ev
     m_surfaceMgr->GetCmDevice(cmDevice);
     CMCHK_NULL_AND_RETURN(cmDevice);
 
-    //Lock for surface read/write
-    CSync* surfaceLock = cmDevice->GetSurfaceLock();
-    CM_ASSERT(surfaceLock);
-    CLock locker(*surfaceLock);
+    //Lock for surface read/write, per surface so other surfaces are not blocked
+    CLock locker(m_criticalSectionReadWrite);
 
     PCM_CONTEXT_DATA cmData = (PCM_CONTEXT_DATA)cmDevice->GetAccelData();
     CMCHK_NULL_AND_RETURN(cmData);
@@ -529,10 +525,8 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurfaceStride( const unsigned char* sysMem
     m_surfaceMgr->GetCmDevice(cmDevice);
     CMCHK_NULL_AND_RETURN(cmDevice);
 
-    //Lock for surface read/write
-    CSync* surfaceLock = cmDevice->GetSurfaceLock();
-    CM_ASSERT(surfaceLock);
-    CLock locker(*surfaceLock);
+    //Lock for surface read/write, per surface so other surfaces are not blocked
+    CLock locker(m_criticalSectionReadWrite);
 
     PCM_CONTEXT_DATA cmData = (PCM_CONTEXT_DATA)cmDevice->GetAccelData();
     CMCHK_NULL_AND_RETURN(cmData);
@@ -660,10 +654,8 @@ CM_RT_API int32_t CmSurface2DRT::ReadSurfaceFullStride( unsigned char* sysMem, C
     m_surfaceMgr->GetCmDevice(cmDevice);
     CMCHK_NULL_AND_RETURN(cmDevice);
 
-    //Lock for surface read/write
-    CSync* surfaceLock = cmDevice->GetSurfaceLock();
-    CM_ASSERT(surfaceLock);
-    CLock locker(*surfaceLock);
+    //Lock for surface read/write, per surface so other surfaces are not blocked
+    CLock locker(m_criticalSectionReadWrite);
 
     PCM_CONTEXT_DATA cmData = (PCM_CONTEXT_DATA)cmDevice->GetAccelData();
     CMCHK_NULL_AND_RETURN(cmData);
@@ -776,10 +768,8 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurfaceFullStride( const unsigned char* sy
     m_surfaceMgr->GetCmDevice(cmDevice);
     CMCHK_NULL_AND_RETURN(cmDevice);
 
-    //Lock for surface read/write
-    CSync* surfaceLock = cmDevice->GetSurfaceLock();
-    CM_ASSERT(surfaceLock);
-    CLock locker(*surfaceLock);
+    //Lock for surface read/write, per surface so other surfaces are not blocked
+    CLock locker(m_criticalSectionReadWrite);
 
     PCM_CONTEXT_DATA cmData = (PCM_CONTEXT_DATA)cmDevice->GetAccelData();
     CMCHK_NULL_AND_RETURN(cmData);
@@ -968,6 +958,9 @@ CM_RT_API int32_t CmSurface2DRT::InitSurface(const unsigned int initValue, CmEve
 
     WaitForReferenceFree();   // wait all owner task finished
 
+    //Lock for surface read/write, per surface so other surfaces are not blocked
+    CLock locker(m_criticalSectionReadWrite);
+
     uint32_t sizePerPixel  = 0;
     uint32_t updatedHeight = 0;
     CMCHK_HR(m_surfaceMgr->GetPixelBytesAndHeight(m_width, m_height, m_format, sizePerPixel, updatedHeight));
@@ -1186,9 +1179,7 @@ void CmSurface2DRT::DumpContent(uint32_t kernelNumber, char *kernelName, int32_t
     m_surfaceMgr->GetCmDevice(cmDevice);
     CM_ASSERT(cmDevice);
     
-    CSync* surfaceLock = cmDevice->GetSurfaceLock();
-    CM_ASSERT(surfaceLock);
-    CLock locker(*surfaceLock);
+    CLock locker(m_criticalSectionReadWrite);
     uint32_t        sizePerPixel = 0;
     uint32_t        updatedHeight = 0;
     uint32_t        surfaceSize = 0;
@@ -30,12 +30,14 @@ set(TMP_SOURCES_
     ${CMAKE_CURRENT_LIST_DIR}/cm_hal_hashtable.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_hal_dump.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_hal_vebox.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/cm_jit_cache.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_kernel_rt.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_kernel_data.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_log.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_perf.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_printf_host.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_program.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/cm_program_store.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_queue_rt.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_sampler_rt.cpp
     ${CMAKE_CURRENT_LIST_DIR}/cm_sampler8x8_state_rt.cpp
@@ -70,6 +72,7 @@ set(TMP_HEADERS_
     ${CMAKE_CURRENT_LIST_DIR}/cm_hal_generic.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_hal_hashtable.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_hal_vebox.h
+    ${CMAKE_CURRENT_LIST_DIR}/cm_jit_cache.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_kernel.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_kernel_rt.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_kernel_data.h
@@ -79,6 +82,7 @@ set(TMP_HEADERS_
     ${CMAKE_CURRENT_LIST_DIR}/cm_perf.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_printf_host.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_program.h
+    ${CMAKE_CURRENT_LIST_DIR}/cm_program_store.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_queue.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_queue_rt.h
     ${CMAKE_CURRENT_LIST_DIR}/cm_sampler.h
@@ -26,6 +26,213 @@
 
 #include "codechal_allocator.h"
 
+CodechalResourcePool::CodechalResourcePool()
+{
+    MOS_USER_FEATURE_VALUE_DATA     userFeatureData;
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_ENCODE_TRACKED_BUFFER_POOL_SIZE_ID,
+        &userFeatureData);
+    m_limit = (uint64_t)userFeatureData.u32Data << 20;
+
+    m_mutex = MOS_CreateMutex();
+
+    // Freed with the pool at process exit, after the last device's MemNinja report
+    MosMemAllocCounter--;
+    MOS_MEMNINJA_FREE_MESSAGE(m_mutex, __FUNCTION__, __FILE__, __LINE__);
+}
+
+CodechalResourcePool::~CodechalResourcePool()
+{
+    if (m_mutex != nullptr)
+    {
+        MOS_DestroyMutex(m_mutex);
+        m_mutex = nullptr;
+    }
+}
+
+CodechalResourcePool *CodechalResourcePool::Instance()
+{
+    static CodechalResourcePool instance;
+
+    return &instance;
+}
+
+void CodechalResourcePool::CreateDevice(PMOS_CONTEXT osDriverContext)
+{
+    CodechalResourcePool *pool = Instance();
+    if (pool->m_mutex == nullptr || osDriverContext == nullptr)
+    {
+        return;
+    }
+
+    MOS_LockMutex(pool->m_mutex);
+
+    Device &device = pool->m_devices[osDriverContext->bufmgr];
+    if (device.osDriverContext == nullptr)
+    {
+        device.osDriverContext = MOS_New(MOS_CONTEXT, *osDriverContext);
+    }
+
+    MOS_UnlockMutex(pool->m_mutex);
+}
+
+void CodechalResourcePool::DestroyDevice(void *device)
+{
+    // the pool may have been disabled since resources were pooled
+    CodechalResourcePool *pool = Instance();
+    if (pool->m_mutex == nullptr)
+    {
+        return;
+    }
+
+    MOS_LockMutex(pool->m_mutex);
+
+    auto it = pool->m_devices.find(device);
+    if (it != pool->m_devices.end())
+    {
+        MOS_INTERFACE *osInterface = it->second.osInterface;
+        for (auto& entry : it->second.entries)
+        {
+            if (entry.second.surface)
+            {
+                MOS_SURFACE* ptr = (MOS_SURFACE*)entry.second.pointer;
+                osInterface->pfnFreeResource(osInterface, &ptr->OsResource);
+                MOS_Delete(ptr);
+            }
+            else
+            {
+                MOS_RESOURCE* ptr = (MOS_RESOURCE*)entry.second.pointer;
+                osInterface->pfnFreeResource(osInterface, ptr);
+                MOS_Delete(ptr);
+            }
+        }
+
+        MOS_OS_VERBOSEMESSAGE("Resource pool: %d allocations saved, %d misses.", it->second.hits, it->second.misses);
+
+        if (osInterface != nullptr)
+        {
+            osInterface->pfnDestroy(osInterface, false);
+            MOS_FreeMemory(osInterface);
+        }
+        MOS_Delete(it->second.osDriverContext);
+        pool->m_devices.erase(it);
+    }
+
+    MOS_UnlockMutex(pool->m_mutex);
+}
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT void CodecHal_SetUltResourcePoolSize(uint32_t sizeInMB)
+    {
+        CodechalResourcePool::Instance()->SetLimit((uint64_t)sizeInMB << 20);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+MOS_INTERFACE *CodechalResourcePool::CreateOsInterface(PMOS_CONTEXT osDriverContext)
+{
+    MOS_INTERFACE *poolOsInterface = (MOS_INTERFACE *)MOS_AllocAndZeroMemory(sizeof(MOS_INTERFACE));
+    if (poolOsInterface == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (MOS_STATUS_SUCCESS != Mos_InitInterface(poolOsInterface, osDriverContext, COMPONENT_Encode))
+    {
+        MOS_OS_ASSERTMESSAGE("Initialize resource pool OS interface failed.");
+        MOS_FreeMemory(poolOsInterface);
+        return nullptr;
+    }
+
+    return poolOsInterface;
+}
+
+void* CodechalResourcePool::Acquire(MOS_INTERFACE *osInterface, uint64_t desc)
+{
+    if (!IsEnabled())
+    {
+        return nullptr;
+    }
+
+    Entry entry = {};
+
+    MOS_LockMutex(m_mutex);
+
+    auto device = m_devices.find(osInterface->pfnGetDeviceHandle(osInterface));
+    if (device == m_devices.end())
+    {
+        // No resource was pooled on the device yet
+        m_devices[osInterface->pfnGetDeviceHandle(osInterface)].misses++;
+    }
+    else
+    {
+        auto it = device->second.entries.find(desc);
+        if (it != device->second.entries.end())
+        {
+            entry = it->second;
+            device->second.size -= entry.size;
+            device->second.entries.erase(it);
+            device->second.hits++;
+        }
+        else
+        {
+            device->second.misses++;
+        }
+    }
+
+    MOS_UnlockMutex(m_mutex);
+
+    if (entry.pointer != nullptr)
+    {
+        // The resource may still be in use by the GPU work of the instance that released it
+        MOS_RESOURCE* resource = entry.surface ? &((MOS_SURFACE*)entry.pointer)->OsResource : (MOS_RESOURCE*)entry.pointer;
+        osInterface->pfnWaitOnResource(osInterface, resource);
+    }
+
+    return entry.pointer;
+}
+
+bool CodechalResourcePool::Release(MOS_INTERFACE *osInterface, uint64_t desc, void* pointer, bool surface, uint64_t size)
+{
+    if (!IsEnabled())
+    {
+        return false;
+    }
+
+    bool pooled = false;
+
+    MOS_LockMutex(m_mutex);
+
+    // The OS context of the releasing codec instance goes away with it, the
+    // pool frees the resources with its own OS interface of the device
+    Device &device = m_devices[osInterface->pfnGetDeviceHandle(osInterface)];
+    if (device.osInterface == nullptr && device.osDriverContext != nullptr)
+    {
+        device.osInterface = CreateOsInterface(device.osDriverContext);
+    }
+
+    if (device.osInterface != nullptr && device.size + size <= m_limit)
+    {
+        Entry entry = { pointer, surface, size };
+        device.entries.insert(std::make_pair(desc, entry));
+        device.size += size;
+        pooled = true;
+    }
+
+    MOS_UnlockMutex(m_mutex);
+
+    return pooled;
+}
+
 uint64_t CodechalAllocator::GetResourceTag(uint16_t resourceID, Match level)
 {
     if (!m_resourceList.empty())
@@ -54,10 +261,72 @@ void* CodechalAllocator::GetResourcePointer(uint16_t resourceID, Match level)
     return nullptr;
 }
 
+void* CodechalAllocator::AcquireFromPool(uint64_t resourceTag, MOS_FORMAT format)
+{
+    uint64_t desc = GetPoolDesc(resourceTag, format);
+    if (m_pool == nullptr || !m_pool->IsEnabled() || desc == 0)
+    {
+        return nullptr;
+    }
+
+    void* pointer = m_pool->Acquire(m_osInterface, desc);
+    if (pointer != nullptr)
+    {
+        // place the pooled resource onto the list
+        m_resourceList[resourceTag] = pointer;
+        MOS_OS_NORMALMESSAGE("reuse pooled buffer = 0x%x, tag = 0x%llx", pointer, (long long)resourceTag);
+    }
+
+    return pointer;
+}
+
+bool CodechalAllocator::ReleaseToPool(uint64_t resourceTag, void* pointer)
+{
+    if (m_pool == nullptr || !m_pool->IsEnabled())
+    {
+        return false;
+    }
+
+    bool pooled = false;
+    if (Is1DBuffer(resourceTag))
+    {
+        uint64_t desc = GetPoolDesc(resourceTag, Format_Buffer);
+        pooled = desc && m_pool->Release(m_osInterface, desc, pointer, false, (uint32_t)(resourceTag >> 32));
+    }
+    else if (Is2DBuffer(resourceTag))
+    {
+        MOS_SURFACE* surface = (MOS_SURFACE*)pointer;
+        uint64_t desc = GetPoolDesc(resourceTag, surface->Format);
+        uint64_t size = (uint64_t)surface->dwWidth * surface->dwHeight;
+
+        // planar 4:2:0 or packed/planar 4:2:2
+        size = (surface->Format == Format_NV12) ? size * 3 / 2 : size * 2;
+        pooled = desc && m_pool->Release(m_osInterface, desc, pointer, true, size);
+    }
+
+    if (pooled)
+    {
+        MOS_OS_NORMALMESSAGE("pool buffer = 0x%x, tag = 0x%llx", pointer, (long long)resourceTag);
+    }
+
+    return pooled;
+}
+
 void* CodechalAllocator::Allocate1DBuffer(uint64_t resourceTag, uint32_t size,
     bool zeroOnAllocation, const char *bufName)
 {
-    MOS_RESOURCE* resource = MOS_New(MOS_RESOURCE);
+    MOS_RESOURCE* resource = (MOS_RESOURCE*)AcquireFromPool(resourceTag, Format_Buffer);
+    if (resource != nullptr)
+    {
+        if (zeroOnAllocation)
+        {
+            ClearResource(resource, size);
+        }
+
+        return resource;
+    }
+
+    resource = MOS_New(MOS_RESOURCE);
     MOS_ZeroMemory(resource, sizeof(MOS_RESOURCE));
 
     MOS_ALLOC_GFXRES_PARAMS allocParams;
@@ -92,7 +361,18 @@ void* CodechalAllocator::Allocate2DBuffer(
     uint64_t resourceTag, uint32_t width, uint32_t height, MOS_FORMAT format,
     MOS_TILE_TYPE tile, bool zeroOnAllocation, const char *bufName)
 {
-    MOS_SURFACE* surface = MOS_New(MOS_SURFACE);
+    MOS_SURFACE* surface = (MOS_SURFACE*)AcquireFromPool(resourceTag, format);
+    if (surface != nullptr)
+    {
+        if (zeroOnAllocation)
+        {
+            ClearResource(&surface->OsResource, width * height);
+        }
+
+        return surface;
+    }
+
+    surface = MOS_New(MOS_SURFACE);
     MOS_ZeroMemory(surface, sizeof(MOS_SURFACE));
 
     MOS_ALLOC_GFXRES_PARAMS allocParams;
@@ -112,6 +392,11 @@ void* CodechalAllocator::Allocate2DBuffer(
         return nullptr;
     }
 
+    // the pool matches released surfaces by these, caller may not query the resource info
+    surface->Format   = format;
+    surface->dwWidth  = width;
+    surface->dwHeight = height;
+
     // place the newly allocated resource onto the list
     m_resourceList[resourceTag] = surface;
     MOS_OS_NORMALMESSAGE("allocate 2D buffer = 0x%x, tag = 0x%llx", surface, (long long)resourceTag);
@@ -214,6 +499,11 @@ void CodechalAllocator::ClearResource(MOS_RESOURCE* resource, size_t size)
 
 void CodechalAllocator::Deallocate(uint64_t tag, void* pointer)
 {
+    if (ReleaseToPool(tag, pointer))
+    {
+        return;
+    }
+
     if (Is1DBuffer(tag))
     {
         MOS_RESOURCE* ptr = (MOS_RESOURCE*)pointer;
@@ -247,13 +537,7 @@ void CodechalAllocator::Deallocate(uint64_t tag, void* pointer)
     }
 }
 
-CodechalAllocator::CodechalAllocator(MOS_INTERFACE* osInterface)
-    : m_osInterface(osInterface),
-    m_resourceList{}
-{
-}
-
-CodechalAllocator::~CodechalAllocator()
+void CodechalAllocator::ReleaseAllResources()
 {
     if (!m_resourceList.empty())
     {
@@ -265,3 +549,17 @@ CodechalAllocator::~CodechalAllocator()
         m_resourceList.clear();
     }
 }
+
+CodechalAllocator::CodechalAllocator(MOS_INTERFACE* osInterface)
+    : m_osInterface(osInterface),
+    m_resourceList{}
+{
+    m_pool = CodechalResourcePool::Instance();
+}
+
+CodechalAllocator::~CodechalAllocator()
+{
+    ReleaseAllResources();
+
+    m_pool = nullptr;
+}
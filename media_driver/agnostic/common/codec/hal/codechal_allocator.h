@@ -28,6 +28,132 @@
 #define __CODECHAL_ALLOCATOR_H__
 
 #include "codechal.h"
+#include <map>
+
+//!
+//! Process wide pool of released 1D buffers and 2D surfaces.
+//! Allocators of different codec instances on the same device hand identical
+//! resources to each other through the pool instead of freeing and re-allocating them.
+//! Pooled resources are kept until the device is torn down, so a codec instance
+//! re-created after the previous one was destroyed still finds them.
+//!
+class CodechalResourcePool
+{
+public:
+    //!
+    //! \brief    Get the instance of the pool
+    //!
+    //! \return   pointer of pool
+    //!
+    static CodechalResourcePool *Instance();
+
+    //!
+    //! \brief    Register a device, called when the device is set up.
+    //!           Resources are only pooled on registered devices.
+    //!
+    //! \param    [in] osDriverContext
+    //!           OS context of the device, without per codec instance data.
+    //!           The pool keeps a copy to free the resources of the device with.
+    //!
+    //! \return   void
+    //!
+    static void CreateDevice(PMOS_CONTEXT osDriverContext);
+
+    //!
+    //! \brief    Free the pooled resources of a device, called when the device is torn down
+    //!
+    //! \param    [in] device
+    //!           Device handle, as returned by pfnGetDeviceHandle
+    //!
+    //! \return   void
+    //!
+    static void DestroyDevice(void *device);
+
+    //!
+    //! \brief    Check whether the pool is enabled
+    //!
+    //! \return   true if enabled
+    //!
+    bool IsEnabled() { return m_limit != 0 && m_mutex != nullptr; }
+
+    //!
+    //! \brief    Override the pool size of the user feature, used by ULT
+    //!
+    //! \param    [in] limit
+    //!           Bytes pooled per device, 0 to disable
+    //!
+    //! \return   void
+    //!
+    void SetLimit(uint64_t limit) { m_limit = limit; }
+
+    //!
+    //! \brief    Take a resource matching the description out of the pool.
+    //!           The call waits until the GPU is done with the resource.
+    //!
+    //! \param    [in] osInterface
+    //!           OS interface of the allocator
+    //! \param    [in] desc
+    //!           Resource description, type/format/tile/size of the allocator tag
+    //!
+    //! \return   pointer to MOS_RESOURCE or MOS_SURFACE, nullptr if none pooled
+    //!
+    void* Acquire(MOS_INTERFACE *osInterface, uint64_t desc);
+
+    //!
+    //! \brief    Put a released resource into the pool
+    //!
+    //! \param    [in] osInterface
+    //!           OS interface of the allocator
+    //! \param    [in] desc
+    //!           Resource description, type/format/tile/size of the allocator tag
+    //! \param    [in] pointer
+    //!           Pointer to MOS_RESOURCE or MOS_SURFACE
+    //! \param    [in] surface
+    //!           true if pointer is a MOS_SURFACE
+    //! \param    [in] size
+    //!           Size of the resource in bytes
+    //!
+    //! \return   true if pooled, false if the pool is full and the caller frees the resource
+    //!
+    bool Release(MOS_INTERFACE *osInterface, uint64_t desc, void* pointer, bool surface, uint64_t size);
+
+private:
+    CodechalResourcePool();
+    ~CodechalResourcePool();
+    CodechalResourcePool(const CodechalResourcePool&) = delete;
+    CodechalResourcePool& operator=(const CodechalResourcePool&) = delete;
+
+    struct Entry
+    {
+        void*                           pointer;                        //!< MOS_RESOURCE or MOS_SURFACE
+        bool                            surface;                        //!< pointer is a MOS_SURFACE
+        uint64_t                        size;                           //!< Size in bytes
+    };
+
+    struct Device
+    {
+        MOS_CONTEXT                     *osDriverContext;               //!< OS context of the device, nullptr if not registered
+        MOS_INTERFACE                   *osInterface;                   //!< OS interface of the pool, frees the resources after the allocators are gone
+        uint64_t                        size;                           //!< Bytes pooled
+        uint32_t                        hits;                           //!< Allocations saved
+        uint32_t                        misses;                         //!< Allocations not found in pool
+        std::multimap<uint64_t, Entry>  entries;                        //!< list of <desc, entry>
+    };
+
+    //!
+    //! \brief    Create the OS interface the pool frees the resources of a device with
+    //!
+    //! \param    [in] osDriverContext
+    //!           OS context of the device
+    //!
+    //! \return   pointer to MOS_INTERFACE, nullptr if failed
+    //!
+    static MOS_INTERFACE *CreateOsInterface(PMOS_CONTEXT osDriverContext);
+
+    PMOS_MUTEX                          m_mutex = nullptr;              //!< Protects the device list
+    uint64_t                            m_limit = 0;                    //!< Bytes pooled per device, 0 if disabled
+    std::map<void*, Device>             m_devices;                      //!< list of <device handle, device>
+};
 
 //!
 //! This class provides a generic resource allocation service.
@@ -103,6 +229,14 @@ protected:
     //!
     void ReleaseResource(uint16_t resourceID, Match level);
 
+    //!
+    //! \brief    Release all resources on the list
+    //!           Derived class calls this in its destructor, so that released resources can be pooled
+    //!
+    void ReleaseAllResources();
+
+    CodechalResourcePool*               m_pool = nullptr;                   //!< Pool shared with other allocators, nullptr if not used
+
 private:
     CodechalAllocator(const CodechalAllocator&) = delete;
     CodechalAllocator& operator=(const CodechalAllocator&) = delete;
@@ -121,6 +255,28 @@ private:
     //!
     virtual uint16_t GetResourceID(uint64_t resourceTag, Match level) = 0;
 
+    //!
+    //! \brief    Get resource's description used to match pooled resources
+    //!           Derived class to implement this if its resources can be pooled
+    //!
+    //! \return   resource's description, 0 if the resource is not handed to the pool
+    //!
+    virtual uint64_t GetPoolDesc(uint64_t resourceTag, MOS_FORMAT format) { return 0; }
+
+    //!
+    //! \brief    Take a matching resource from the pool and place it onto the list
+    //!
+    //! \return   pointer to resource, NULL if none pooled
+    //!
+    void* AcquireFromPool(uint64_t resourceTag, MOS_FORMAT format);
+
+    //!
+    //! \brief    Hand a released resource to the pool
+    //!
+    //! \return   true if pooled, false if the caller frees the resource
+    //!
+    bool ReleaseToPool(uint64_t resourceTag, void* pointer);
+
     MOS_INTERFACE*                      m_osInterface = nullptr;            //!< OS interface
     std::map<uint64_t, void*>           m_resourceList{};                   //!< list of <tag, pointer>
 };
@@ -186,6 +186,8 @@ MOS_STATUS CodechalDebugConfigMgr::ParseConfig()
         }
     }
 
+    CompileConfigs();
+
     return MOS_STATUS_SUCCESS;
 }
 
@@ -437,6 +439,9 @@ MOS_STATUS CodechalDebugConfigMgr::DeleteCfgNode(uint32_t frameIdx)
         if (it->frameIndex == frameIdx)
         {
             m_debugFrameConfigs.erase(it);
+            // erase moves the following configs
+            m_curFrameConfig = nullptr;
+            m_curFrameValid  = false;
             break;
         }
     }
@@ -452,99 +457,352 @@ std::string CodechalDebugConfigMgr::GetMediaStateStr(CODECHAL_MEDIA_STATE_TYPE m
         return it->second;
     }
 
-    return nullptr;
+    return std::string();
 }
 
-bool CodechalDebugConfigMgr::AttrIsEnabled(std::string attrName)
+void CodechalDebugConfigMgr::CompileConfigs()
 {
+    // Intern every attribute name any config mentions
+    m_attrIds.clear();
+    m_attrKeys.clear();
+    m_curFrameConfig = nullptr;
+    m_curFrameValid  = false;
+
     if (nullptr != m_debugAllConfigs)
     {
-        int attrValue = m_debugAllConfigs->cmdAttribs[attrName];
-        if (attrValue > 0)
+        for (auto &it : m_debugAllConfigs->cmdAttribs)
         {
-            return true;
+            m_attrIds.insert(std::make_pair(it.first, (uint32_t)m_attrIds.size()));
         }
     }
-
-    for (auto it : m_debugFrameConfigs)
+    for (auto &frameConfig : m_debugFrameConfigs)
     {
-        if (it.frameIndex == m_debugInterface->m_bufferDumpFrameNum)
+        for (auto &it : frameConfig.cmdAttribs)
         {
-            int attrValue = it.cmdAttribs[attrName];
-            return attrValue > 0;
+            m_attrIds.insert(std::make_pair(it.first, (uint32_t)m_attrIds.size()));
         }
     }
 
-    return false;
+    if (nullptr != m_debugAllConfigs)
+    {
+        CompileConfig(m_debugAllConfigs);
+    }
+    for (auto &frameConfig : m_debugFrameConfigs)
+    {
+        CompileConfig(&frameConfig);
+    }
 }
 
-bool CodechalDebugConfigMgr::AttrIsEnabled(
-    CODECHAL_MEDIA_STATE_TYPE mediaState,
-    std::string               attrName)
+void CodechalDebugConfigMgr::CompileConfig(CodechalDbgCfg *config)
 {
-    std::string kernelName = GetMediaStateStr(mediaState);
-    if (kernelName.empty())
+    config->cmdAttribMask.assign((m_attrIds.size() + 63) / 64, 0);
+    for (auto &it : config->cmdAttribs)
     {
-        return false;
+        if (it.second > 0)
+        {
+            uint32_t attrId = m_attrIds[it.first];
+            config->cmdAttribMask[attrId >> 6] |= 1ull << (attrId & 63);
+        }
     }
 
-    if (nullptr != m_debugAllConfigs)
+    config->kernelAttribMask.assign(CODECHAL_NUM_MEDIA_STATES, 0);
+    CodechalDbgKernel::KernelStateMap::kernelMapType &kernelMap = CodechalDbgKernel::KernelStateMap::GetKernelStateMap();
+    for (auto &it : kernelMap)
     {
-        KernelDumpConfig attrs   = m_debugAllConfigs->kernelAttribs[kernelName];
-        bool             enabled = KernelAttrEnabled(attrs, attrName);
-        if (enabled)
+        auto kernelIt = config->kernelAttribs.find(it.second);
+        if (kernelIt != config->kernelAttribs.end() && it.first < CODECHAL_NUM_MEDIA_STATES)
         {
-            return enabled;
+            config->kernelAttribMask[it.first] = CompileKernelConfig(kernelIt->second);
         }
     }
+}
+
+uint8_t CodechalDebugConfigMgr::CompileKernelConfig(const KernelDumpConfig &kernelConfig)
+{
+    uint8_t kernelAttr = 0;
+    kernelAttr |= kernelConfig.dumpDsh ? CODECHAL_DBG_KERNEL_ATTR_DSH : 0;
+    kernelAttr |= kernelConfig.dumpSsh ? CODECHAL_DBG_KERNEL_ATTR_SSH : 0;
+    kernelAttr |= kernelConfig.dumpIsh ? CODECHAL_DBG_KERNEL_ATTR_ISH : 0;
+    kernelAttr |= kernelConfig.dumpCurbe ? CODECHAL_DBG_KERNEL_ATTR_CURBE : 0;
+    kernelAttr |= kernelConfig.dumpCmdBuffer ? CODECHAL_DBG_KERNEL_ATTR_CMD_BUFFER : 0;
+    kernelAttr |= kernelConfig.dump2ndLvlBatch ? CODECHAL_DBG_KERNEL_ATTR_2ND_LVL_BATCH : 0;
+    kernelAttr |= kernelConfig.dumpInput ? CODECHAL_DBG_KERNEL_ATTR_INPUT : 0;
+    kernelAttr |= kernelConfig.dumpOutput ? CODECHAL_DBG_KERNEL_ATTR_OUTPUT : 0;
+    return kernelAttr;
+}
+
+const CodechalDebugConfigMgr::AttrKey &CodechalDebugConfigMgr::GetAttrKey(const char *attrName)
+{
+    auto it = m_attrKeys.find(attrName);
+    if (it != m_attrKeys.end())
+    {
+        return it->second;
+    }
+
+    // First use of this name, resolve it by string once
+    AttrKey key;
+    key.cmdAttrId  = m_invalidAttrId;
+    key.kernelAttr = GetKernelAttr(attrName);
+
+    auto idIt = m_attrIds.find(attrName);
+    if (idIt != m_attrIds.end())
+    {
+        key.cmdAttrId = idIt->second;
+    }
+
+    return m_attrKeys.insert(std::make_pair(attrName, key)).first->second;
+}
+
+CodechalDbgCfg *CodechalDebugConfigMgr::GetCurFrameConfig()
+{
+    uint32_t frameIdx = m_debugInterface->m_bufferDumpFrameNum;
+    if (m_curFrameValid && m_curFrameIndex == frameIdx)
+    {
+        return m_curFrameConfig;
+    }
 
-    for (auto it : m_debugFrameConfigs)
+    m_curFrameConfig = nullptr;
+    for (auto &it : m_debugFrameConfigs)
     {
-        if (it.frameIndex == m_debugInterface->m_bufferDumpFrameNum)
+        if (it.frameIndex == frameIdx)
         {
-            KernelDumpConfig attrs = it.kernelAttribs[kernelName];
-            return KernelAttrEnabled(attrs, attrName);
+            m_curFrameConfig = &it;
+            break;
         }
     }
-    return false;
+    m_curFrameIndex = frameIdx;
+    m_curFrameValid = true;
+
+    return m_curFrameConfig;
 }
 
-bool CodechalDebugConfigMgr::KernelAttrEnabled(KernelDumpConfig kernelConfig, std::string attrName)
+bool CodechalDebugConfigMgr::AttrIsEnabled(const char *attrName)
 {
-    if (!strncmp(attrName.c_str(), CodechalDbgAttr::attrDsh, sizeof(CodechalDbgAttr::attrDsh) - 1))
+    if (nullptr == attrName || m_attrIds.empty())
+    {
+        return false;
+    }
+
+    uint32_t attrId = GetAttrKey(attrName).cmdAttrId;
+    if (attrId == m_invalidAttrId)
+    {
+        return false;
+    }
+
+    if (nullptr != m_debugAllConfigs && CmdAttrEnabled(m_debugAllConfigs, attrId))
     {
-        return kernelConfig.dumpDsh;
+        return true;
     }
-    else if (!strncmp(attrName.c_str(), CodechalDbgAttr::attrSsh, sizeof(CodechalDbgAttr::attrSsh) - 1))
+
+    CodechalDbgCfg *frameConfig = GetCurFrameConfig();
+    return frameConfig != nullptr && CmdAttrEnabled(frameConfig, attrId);
+}
+
+bool CodechalDebugConfigMgr::AttrIsEnabled(
+    CODECHAL_MEDIA_STATE_TYPE mediaState,
+    const char *              attrName)
+{
+    if (nullptr == attrName || mediaState >= CODECHAL_NUM_MEDIA_STATES)
     {
-        return kernelConfig.dumpSsh;
+        return false;
     }
-    else if (!strncmp(attrName.c_str(), CodechalDbgAttr::attrIsh, sizeof(CodechalDbgAttr::attrIsh) - 1))
+
+    uint8_t kernelAttr = GetAttrKey(attrName).kernelAttr;
+    if (kernelAttr == 0)
     {
-        return kernelConfig.dumpIsh;
+        return false;
     }
-    else if (!strncmp(attrName.c_str(), CodechalDbgAttr::attrCurbe, sizeof(CodechalDbgAttr::attrCurbe) - 1))
+
+    if (nullptr != m_debugAllConfigs &&
+        !m_debugAllConfigs->kernelAttribMask.empty() &&
+        (m_debugAllConfigs->kernelAttribMask[mediaState] & kernelAttr))
     {
-        return kernelConfig.dumpCurbe;
+        return true;
     }
-    else if (!strncmp(attrName.c_str(), CodechalDbgAttr::attrCmdBuffer, sizeof(CodechalDbgAttr::attrCmdBuffer) - 1))
+
+    CodechalDbgCfg *frameConfig = GetCurFrameConfig();
+    return frameConfig != nullptr &&
+        !frameConfig->kernelAttribMask.empty() &&
+        (frameConfig->kernelAttribMask[mediaState] & kernelAttr);
+}
+
+uint8_t CodechalDebugConfigMgr::GetKernelAttr(const char *attrName)
+{
+    if (!strncmp(attrName, CodechalDbgAttr::attrDsh, sizeof(CodechalDbgAttr::attrDsh) - 1))
     {
-        return kernelConfig.dumpCmdBuffer;
+        return CODECHAL_DBG_KERNEL_ATTR_DSH;
     }
-    else if (!strncmp(attrName.c_str(), CodechalDbgAttr::attr2ndLvlBatch, sizeof(CodechalDbgAttr::attr2ndLvlBatch) - 1))
+    else if (!strncmp(attrName, CodechalDbgAttr::attrSsh, sizeof(CodechalDbgAttr::attrSsh) - 1))
     {
-        return kernelConfig.dump2ndLvlBatch;
+        return CODECHAL_DBG_KERNEL_ATTR_SSH;
     }
-    else if (!strncmp(attrName.c_str(), CodechalDbgAttr::attrInput, sizeof(CodechalDbgAttr::attrInput) - 1))
+    else if (!strncmp(attrName, CodechalDbgAttr::attrIsh, sizeof(CodechalDbgAttr::attrIsh) - 1))
     {
-        return kernelConfig.dumpInput;
+        return CODECHAL_DBG_KERNEL_ATTR_ISH;
     }
-    else if (!strncmp(attrName.c_str(), CodechalDbgAttr::attrOutput, sizeof(CodechalDbgAttr::attrOutput) - 1))
+    else if (!strncmp(attrName, CodechalDbgAttr::attrCurbe, sizeof(CodechalDbgAttr::attrCurbe) - 1))
     {
-        return kernelConfig.dumpOutput;
+        return CODECHAL_DBG_KERNEL_ATTR_CURBE;
+    }
+    else if (!strncmp(attrName, CodechalDbgAttr::attrCmdBuffer, sizeof(CodechalDbgAttr::attrCmdBuffer) - 1))
+    {
+        return CODECHAL_DBG_KERNEL_ATTR_CMD_BUFFER;
+    }
+    else if (!strncmp(attrName, CodechalDbgAttr::attr2ndLvlBatch, sizeof(CodechalDbgAttr::attr2ndLvlBatch) - 1))
+    {
+        return CODECHAL_DBG_KERNEL_ATTR_2ND_LVL_BATCH;
+    }
+    else if (!strncmp(attrName, CodechalDbgAttr::attrInput, sizeof(CodechalDbgAttr::attrInput) - 1))
+    {
+        return CODECHAL_DBG_KERNEL_ATTR_INPUT;
+    }
+    else if (!strncmp(attrName, CodechalDbgAttr::attrOutput, sizeof(CodechalDbgAttr::attrOutput) - 1))
+    {
+        return CODECHAL_DBG_KERNEL_ATTR_OUTPUT;
     }
     else
+        return 0;
+}
+
+#if MOS_ULT_HOOKS_ENABLED
+//!
+//! \brief    Config manager with the string keyed lookup the bitmasks replaced,
+//!           so the ULT can compare both
+//!
+class CodechalDebugConfigMgrUlt : public CodechalDebugConfigMgr
+{
+public:
+    using CodechalDebugConfigMgr::CodechalDebugConfigMgr;
+
+    bool AttrIsEnabledByName(std::string attrName)
+    {
+        if (nullptr != m_debugAllConfigs)
+        {
+            int attrValue = m_debugAllConfigs->cmdAttribs[attrName];
+            if (attrValue > 0)
+            {
+                return true;
+            }
+        }
+
+        for (auto it : m_debugFrameConfigs)
+        {
+            if (it.frameIndex == m_debugInterface->m_bufferDumpFrameNum)
+            {
+                int attrValue = it.cmdAttribs[attrName];
+                return attrValue > 0;
+            }
+        }
         return false;
+    }
+
+    bool AttrIsEnabledByName(CODECHAL_MEDIA_STATE_TYPE mediaState, std::string attrName)
+    {
+        std::string kernelName = GetMediaStateStr(mediaState);
+        if (kernelName.empty())
+        {
+            return false;
+        }
+
+        if (nullptr != m_debugAllConfigs)
+        {
+            KernelDumpConfig attrs = m_debugAllConfigs->kernelAttribs[kernelName];
+            if (CompileKernelConfig(attrs) & GetKernelAttr(attrName.c_str()))
+            {
+                return true;
+            }
+        }
+
+        for (auto it : m_debugFrameConfigs)
+        {
+            if (it.frameIndex == m_debugInterface->m_bufferDumpFrameNum)
+            {
+                KernelDumpConfig attrs = it.kernelAttribs[kernelName];
+                return (CompileKernelConfig(attrs) & GetKernelAttr(attrName.c_str())) != 0;
+            }
+        }
+        return false;
+    }
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to check every dump attribute, then every
+    //!           kernel attribute of every media state, dwLoops times against
+    //!           the CodecDbgSetting.cfg in pOutputFolder. bByName selects the
+    //!           string keyed lookup instead of the compiled bitmasks.
+    //!           pResults receives 1 per enabled check of the last loop and
+    //!           pdwResultNum the number of checks, in as the capacity.
+    //!
+    MOS_FUNC_EXPORT MOS_STATUS CodechalDebug_UltCheckDumpAttribs(
+        const char      *pOutputFolder,
+        uint32_t        dwFrameIdx,
+        bool            bByName,
+        uint32_t        dwLoops,
+        uint8_t         *pResults,
+        uint32_t        *pdwResultNum)
+    {
+        static const char *cmdAttribs[] =
+        {
+            CodechalDbgAttr::attrPicParams, CodechalDbgAttr::attrSlcParams, CodechalDbgAttr::attrMbParams,
+            CodechalDbgAttr::attrIqParams, CodechalDbgAttr::attrSeqParams, CodechalDbgAttr::attrBitstream,
+            CodechalDbgAttr::attrStreamOut, CodechalDbgAttr::attrMvData, CodechalDbgAttr::attrHucRegions,
+            CodechalDbgAttr::attrHuCDmem, CodechalDbgAttr::attrCmdBufferMfx, CodechalDbgAttr::attr2ndLvlBatchMfx,
+            CodechalDbgAttr::attrDecodeOutputSurface, CodechalDbgAttr::attrReferenceSurfaces,
+            CodechalDbgAttr::attrEncodeRawInputSurface, CodechalDbgAttr::attrReconstructedSurface,
+            CodechalDbgAttr::attrDriverUltDump, CodechalDbgAttr::attrDumpBufferInBinary,
+            CodechalDbgAttr::attrDumpCmdBufInBinary, CodechalDbgAttr::attrStatusReport
+        };
+        static const char *kernelAttribs[] =
+        {
+            CodechalDbgAttr::attrDsh, CodechalDbgAttr::attrIsh, CodechalDbgAttr::attrSsh, CodechalDbgAttr::attrCurbe,
+            CodechalDbgAttr::attrCmdBuffer, CodechalDbgAttr::attr2ndLvlBatch, CodechalDbgAttr::attrInput,
+            CodechalDbgAttr::attrOutput
+        };
+        const uint32_t resultNum = MOS_ARRAY_SIZE(cmdAttribs) + CODECHAL_NUM_MEDIA_STATES * MOS_ARRAY_SIZE(kernelAttribs);
+
+        CODECHAL_DEBUG_CHK_NULL(pOutputFolder);
+        CODECHAL_DEBUG_CHK_NULL(pResults);
+        CODECHAL_DEBUG_CHK_NULL(pdwResultNum);
+        if (*pdwResultNum < resultNum)
+        {
+            *pdwResultNum = resultNum;
+            return MOS_STATUS_NOT_ENOUGH_BUFFER;
+        }
+
+        CodechalDebugInterface debugInterface;
+        debugInterface.m_bufferDumpFrameNum = dwFrameIdx;
+        CodechalDebugConfigMgrUlt configMgr(&debugInterface, CODECHAL_FUNCTION_DECODE, pOutputFolder);
+        CODECHAL_DEBUG_CHK_STATUS(configMgr.ParseConfig());
+
+        for (uint32_t loop = 0; loop < dwLoops; loop++)
+        {
+            uint32_t n = 0;
+            for (auto attrib : cmdAttribs)
+            {
+                pResults[n++] = bByName ? configMgr.AttrIsEnabledByName(attrib) : configMgr.AttrIsEnabled(attrib);
+            }
+            for (uint32_t mediaState = 0; mediaState < CODECHAL_NUM_MEDIA_STATES; mediaState++)
+            {
+                for (auto attrib : kernelAttribs)
+                {
+                    pResults[n++] = bByName ?
+                        configMgr.AttrIsEnabledByName((CODECHAL_MEDIA_STATE_TYPE)mediaState, attrib) :
+                        configMgr.AttrIsEnabled((CODECHAL_MEDIA_STATE_TYPE)mediaState, attrib);
+                }
+            }
+        }
+        *pdwResultNum = resultNum;
+
+        return MOS_STATUS_SUCCESS;
+    }
+
+#ifdef __cplusplus
 }
+#endif
+#endif  // MOS_ULT_HOOKS_ENABLED
 
 #endif  // USE_CODECHAL_DEBUG_TOOL
@@ -30,6 +30,7 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include "mos_defs.h"
 #include "codechal_hw.h"
@@ -249,12 +250,30 @@ struct KernelDumpConfig
     bool dumpInput       = false;
     bool dumpOutput      = false;
 };
+//!
+//! \brief  Kernel dump attribute bits compiled from KernelDumpConfig
+//!
+enum CODECHAL_DBG_KERNEL_ATTR
+{
+    CODECHAL_DBG_KERNEL_ATTR_DSH            = (1 << 0),
+    CODECHAL_DBG_KERNEL_ATTR_SSH            = (1 << 1),
+    CODECHAL_DBG_KERNEL_ATTR_ISH            = (1 << 2),
+    CODECHAL_DBG_KERNEL_ATTR_CURBE          = (1 << 3),
+    CODECHAL_DBG_KERNEL_ATTR_CMD_BUFFER     = (1 << 4),
+    CODECHAL_DBG_KERNEL_ATTR_2ND_LVL_BATCH  = (1 << 5),
+    CODECHAL_DBG_KERNEL_ATTR_INPUT          = (1 << 6),
+    CODECHAL_DBG_KERNEL_ATTR_OUTPUT         = (1 << 7)
+};
+
 struct CodechalDbgCfg
 {
     int32_t frameIndex;
     std::map<std::string, int32_t>          cmdAttribs;
     std::map<std::string, KernelDumpConfig> kernelAttribs;
     std::vector<std::string> forceCmds;
+    // Compiled from the maps above once parsing is done
+    std::vector<uint64_t>                   cmdAttribMask;      //!< One bit per interned attribute id, set if value > 0
+    std::vector<uint8_t>                    kernelAttribMask;   //!< CODECHAL_DBG_KERNEL_ATTR bits per media state
 };
 class CodechalDebugInterface;
 class CodechalDebugConfigMgr
@@ -270,15 +289,54 @@ public:
 
     std::string GetMediaStateStr(CODECHAL_MEDIA_STATE_TYPE mediaState);
 
-    bool AttrIsEnabled(std::string attrib);
-    bool AttrIsEnabled(CODECHAL_MEDIA_STATE_TYPE mediaState, std::string attrib);
+    //!
+    //! \brief    Check whether an attribute is enabled for the current frame
+    //! \details  Attribute names are interned on first use, so the name must be
+    //!           a static string such as the CodechalDbgAttr constants. Each
+    //!           later check is a bit test on the compiled configs.
+    //! \param    [in] attrib
+    //!           Attribute name
+    //! \return   bool
+    //!           true if enabled, else false
+    //!
+    bool AttrIsEnabled(const char *attrib);
+
+    //!
+    //! \brief    Check whether a kernel attribute is enabled for the current frame
+    //! \param    [in] mediaState
+    //!           Media state of the kernel
+    //! \param    [in] attrib
+    //!           Kernel attribute name, static string as above
+    //! \return   bool
+    //!           true if enabled, else false
+    //!
+    bool AttrIsEnabled(CODECHAL_MEDIA_STATE_TYPE mediaState, const char *attrib);
 
 protected:
+    static const uint32_t m_invalidAttrId = 0xffffffff;
+
+    struct AttrKey
+    {
+        uint32_t cmdAttrId;     //!< Interned id, m_invalidAttrId if no config names it
+        uint8_t  kernelAttr;    //!< CODECHAL_DBG_KERNEL_ATTR bit matching the name
+    };
+
     void GenerateDefaultConfig();
     uint32_t GetFrameConfig(uint32_t frameIdx);
     void StoreDebugAttribs(std::string line, CodechalDbgCfg *dbgCfg);
     void ParseKernelAttribs(std::string line, CodechalDbgCfg *dbgCfg);
-    bool KernelAttrEnabled(KernelDumpConfig kernelConfig, std::string attrName);
+    uint8_t GetKernelAttr(const char *attrName);
+    uint8_t CompileKernelConfig(const KernelDumpConfig &kernelConfig);
+    void CompileConfig(CodechalDbgCfg *config);
+    void CompileConfigs();
+    const AttrKey &GetAttrKey(const char *attrName);
+    CodechalDbgCfg *GetCurFrameConfig();
+
+    static bool CmdAttrEnabled(const CodechalDbgCfg *config, uint32_t attrId)
+    {
+        return attrId < config->cmdAttribMask.size() * 64 &&
+            (config->cmdAttribMask[attrId >> 6] & (1ull << (attrId & 63)));
+    }
 
 protected:
     CodechalDebugInterface *    m_debugInterface = nullptr;
@@ -286,6 +344,12 @@ protected:
     std::string                 m_outputFolderPath;
     std::vector<CodechalDbgCfg> m_debugFrameConfigs;
     CodechalDbgCfg *            m_debugAllConfigs = nullptr;
+
+    std::map<std::string, uint32_t>             m_attrIds;                  //!< Attribute names interned from all configs
+    std::unordered_map<const char *, AttrKey>   m_attrKeys;                 //!< Interned keys by name address
+    CodechalDbgCfg *                            m_curFrameConfig = nullptr; //!< Config of m_curFrameIndex, nullptr if none
+    uint32_t                                    m_curFrameIndex  = 0;
+    bool                                        m_curFrameValid  = false;
 };
 
 #endif  //USE_CODECHAL_DEBUG_TOOL
@@ -144,16 +144,167 @@ MOS_STATUS CodechalDecodeAvc::SendSlice(
     return eStatus;
 }
 
+CodechalDecodeAvcMonoChroma::CodechalDecodeAvcMonoChroma()
+{
+    m_mutex = MOS_CreateMutex();
+
+    // Shared by the AVC decoders until process exit, not a leak of any of them
+    MosMemAllocCounter--;
+    MOS_MEMNINJA_FREE_MESSAGE(m_mutex, __FUNCTION__, __FILE__, __LINE__);
+}
+
+CodechalDecodeAvcMonoChroma::~CodechalDecodeAvcMonoChroma()
+{
+    if (m_mutex != nullptr)
+    {
+        MOS_DestroyMutex(m_mutex);
+        m_mutex = nullptr;
+    }
+}
+
+CodechalDecodeAvcMonoChroma *CodechalDecodeAvcMonoChroma::Instance()
+{
+    static CodechalDecodeAvcMonoChroma instance;
+
+    return &instance;
+}
+
+MOS_STATUS CodechalDecodeAvcMonoChroma::Acquire(
+    PMOS_INTERFACE  osInterface,
+    uint32_t        size,
+    PMOS_RESOURCE   *resource)
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    CODECHAL_DECODE_FUNCTION_ENTER;
+
+    CODECHAL_DECODE_CHK_NULL_RETURN(m_mutex);
+    CODECHAL_DECODE_CHK_NULL_RETURN(osInterface);
+    CODECHAL_DECODE_CHK_NULL_RETURN(osInterface->pfnGetDeviceHandle);
+    CODECHAL_DECODE_CHK_NULL_RETURN(resource);
+
+    void *device = osInterface->pfnGetDeviceHandle(osInterface);
+
+    MOS_LockMutex(m_mutex);
+
+    for (auto buffer : m_buffers)
+    {
+        if (buffer->device == device && buffer->size >= size)
+        {
+            buffer->ref++;
+            *resource = &buffer->resource;
+            MOS_UnlockMutex(m_mutex);
+            return eStatus;
+        }
+    }
+
+    // Allocated under the lock, decoders of the device starting together share one buffer
+    Buffer *buffer = MOS_New(Buffer);
+    if (buffer == nullptr)
+    {
+        MOS_UnlockMutex(m_mutex);
+        return MOS_STATUS_NO_SPACE;
+    }
+
+    MOS_ZeroMemory(buffer, sizeof(*buffer));
+    buffer->device = device;
+    buffer->size   = size;
+    buffer->ref    = 1;
+
+    MOS_ALLOC_GFXRES_PARAMS allocParams;
+    MOS_ZeroMemory(&allocParams, sizeof(MOS_ALLOC_GFXRES_PARAMS));
+    allocParams.Type        = MOS_GFXRES_BUFFER;
+    allocParams.TileType    = MOS_TILE_LINEAR;
+    allocParams.Format      = Format_Buffer;
+    allocParams.dwBytes     = size;
+    allocParams.pBufName    = "MonoPictureChromaBuffer";
+
+    eStatus = osInterface->pfnAllocateResource(osInterface, &allocParams, &buffer->resource);
+    if (eStatus == MOS_STATUS_SUCCESS)
+    {
+        CodechalResLock ResourceLock(osInterface, &buffer->resource);
+        auto data = (uint8_t*)ResourceLock.Lock(CodechalResLock::writeOnly);
+        if (data != nullptr)
+        {
+            MOS_FillMemory(data, size, CODECHAL_DECODE_AVC_MONOPIC_CHROMA_DEFAULT);
+        }
+        else
+        {
+            eStatus = MOS_STATUS_NULL_POINTER;
+        }
+    }
+
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        CODECHAL_DECODE_ASSERTMESSAGE("Failed to allocate MonoPicture Chroma Buffer.");
+        osInterface->pfnFreeResource(osInterface, &buffer->resource);
+        MOS_Delete(buffer);
+        MOS_UnlockMutex(m_mutex);
+        return eStatus;
+    }
+
+    m_buffers.push_back(buffer);
+    *resource = &buffer->resource;
+
+    MOS_UnlockMutex(m_mutex);
+
+    return eStatus;
+}
+
+void CodechalDecodeAvcMonoChroma::Release(
+    PMOS_INTERFACE  osInterface,
+    PMOS_RESOURCE   resource)
+{
+    if (m_mutex == nullptr || osInterface == nullptr || resource == nullptr)
+    {
+        return;
+    }
+
+    MOS_LockMutex(m_mutex);
+
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); it++)
+    {
+        Buffer *buffer = *it;
+        if (&buffer->resource != resource)
+        {
+            continue;
+        }
+
+        if (--buffer->ref == 0)
+        {
+            // Buffers of a device are freed by any OS interface of the same device
+            osInterface->pfnFreeResource(osInterface, &buffer->resource);
+            MOS_Delete(buffer);
+            m_buffers.erase(it);
+        }
+        break;
+    }
+
+    MOS_UnlockMutex(m_mutex);
+}
+
 MOS_STATUS CodechalDecodeAvc::FormatAvcMonoPicture()
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
 
+    m_monoPictureCopyNum = 0;
+
     PCODEC_AVC_PIC_PARAMS picParams = (PCODEC_AVC_PIC_PARAMS)m_avcPicParams;
     if (picParams->seq_fields.chroma_format_idc != avcChromaFormatMono)
     {
         return MOS_STATUS_SUCCESS;
     }
 
+    // MFX only writes the luma of mono pictures, a surface formatted before keeps its chroma
+    if (m_destContentTag == CODECHAL_DECODE_AVC_MONOPIC_CONTENT_TAG)
+    {
+        m_osInterface->pfnSetResourceContentTag(
+            m_osInterface,
+            &m_decodeParams.m_destSurface->OsResource,
+            CODECHAL_DECODE_AVC_MONOPIC_CONTENT_TAG);
+        return MOS_STATUS_SUCCESS;
+    }
+
     MOS_SURFACE dstSurface;
     MOS_ZeroMemory(&dstSurface, sizeof(MOS_SURFACE));
     dstSurface.Format = Format_NV12;
@@ -169,33 +320,17 @@ MOS_STATUS CodechalDecodeAvc::FormatAvcMonoPicture()
     uint32_t frameSize = pitch * MOS_ALIGN_CEIL((frameHeight + chromaHeight), MOS_YTILE_H_ALIGNMENT);
     uint32_t chromaBufSize = MOS_ALIGN_CEIL(pitch * alignedChromaHeight, MHW_PAGE_SIZE);
 
-    if (Mos_ResourceIsNull(&m_resMonoPictureChromaBuffer))
+    if (m_resMonoPictureChromaBuffer == nullptr || m_monoPictureChromaBufferSize < chromaBufSize)
     {
-        CODECHAL_DECODE_CHK_STATUS_MESSAGE_RETURN(AllocateBuffer(
-                                                      &m_resMonoPictureChromaBuffer,
-                                                      chromaBufSize,
-                                                      "MonoPictureChromaBuffer",
-                                                      true,
-                                                      CODECHAL_DECODE_AVC_MONOPIC_CHROMA_DEFAULT),
-            "Failed to allocate MonoPicture Chroma Buffer.");
-    }
-
-    MOS_COMMAND_BUFFER cmdBuffer;
-    CodechalHucStreamoutParams hucStreamOutParams;
-    if (!m_hwInterface->m_noHuC)
-    {
-        m_osInterface->pfnSetGpuContext(m_osInterface, m_videoContextForWa);
-        m_osInterface->pfnResetOsStates(m_osInterface);
-
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnGetCommandBuffer(m_osInterface, &cmdBuffer, 0));
+        CodechalDecodeAvcMonoChroma::Instance()->Release(m_osInterface, m_resMonoPictureChromaBuffer);
+        m_resMonoPictureChromaBuffer  = nullptr;
+        m_monoPictureChromaBufferSize = 0;
 
-        CODECHAL_DECODE_CHK_STATUS_RETURN(SendPrologWithFrameTracking(&cmdBuffer, false));
-
-        // use huc stream out to do clear to clear copy
-
-        MOS_ZeroMemory(&hucStreamOutParams, sizeof(hucStreamOutParams));
-        hucStreamOutParams.dataBuffer            = &m_resMonoPictureChromaBuffer;
-        hucStreamOutParams.streamOutObjectBuffer = &m_decodeParams.m_destSurface->OsResource;
+        CODECHAL_DECODE_CHK_STATUS_RETURN(CodechalDecodeAvcMonoChroma::Instance()->Acquire(
+            m_osInterface,
+            chromaBufSize,
+            &m_resMonoPictureChromaBuffer));
+        m_monoPictureChromaBufferSize = chromaBufSize;
     }
 
     uint32_t uvblockHeight = CODECHAL_MACROBLOCK_HEIGHT;
@@ -210,7 +345,7 @@ MOS_STATUS CodechalDecodeAvc::FormatAvcMonoPicture()
         {
             CodechalDataCopyParams dataCopyParams;
             MOS_ZeroMemory(&dataCopyParams, sizeof(CodechalDataCopyParams));
-            dataCopyParams.srcResource = &m_resMonoPictureChromaBuffer;
+            dataCopyParams.srcResource = m_resMonoPictureChromaBuffer;
             dataCopyParams.srcSize     = uvrowSize;
             dataCopyParams.srcOffset   = 0;
             dataCopyParams.dstResource = &m_decodeParams.m_destSurface->OsResource;
@@ -221,13 +356,9 @@ MOS_STATUS CodechalDecodeAvc::FormatAvcMonoPicture()
         }
         else
         {
-            CODECHAL_DECODE_CHK_STATUS_RETURN(HucCopy(
-                &cmdBuffer,                                 // pCmdBuffer
-                &m_resMonoPictureChromaBuffer,              // presSrc
-                &m_decodeParams.m_destSurface->OsResource,  // presDst
-                uvrowSize,                                  // u32CopyLength
-                0,                                          // u32CopyInputOffset
-                dstOffset));                                // u32CopyOutputOffset
+            m_monoPictureCopies[m_monoPictureCopyNum].length    = uvrowSize;
+            m_monoPictureCopies[m_monoPictureCopyNum].dstOffset = dstOffset;
+            m_monoPictureCopyNum++;
         }
     }
 
@@ -238,7 +369,7 @@ MOS_STATUS CodechalDecodeAvc::FormatAvcMonoPicture()
     {
         CodechalDataCopyParams dataCopyParams;
         MOS_ZeroMemory(&dataCopyParams, sizeof(CodechalDataCopyParams));
-        dataCopyParams.srcResource     = &m_resMonoPictureChromaBuffer;
+        dataCopyParams.srcResource     = m_resMonoPictureChromaBuffer;
         dataCopyParams.srcSize         = uvsize;
         dataCopyParams.srcOffset       = 0;
         dataCopyParams.dstResource     = &m_decodeParams.m_destSurface->OsResource;
@@ -246,44 +377,55 @@ MOS_STATUS CodechalDecodeAvc::FormatAvcMonoPicture()
         dataCopyParams.dstOffset       = dstOffset;
 
         CODECHAL_DECODE_CHK_STATUS_RETURN(m_hwInterface->CopyDataSourceWithDrv(&dataCopyParams));
+
+        m_osInterface->pfnSetResourceContentTag(
+            m_osInterface,
+            &m_decodeParams.m_destSurface->OsResource,
+            CODECHAL_DECODE_AVC_MONOPIC_CONTENT_TAG);
     }
     else
     {
-        CODECHAL_DECODE_CHK_STATUS_RETURN(HucCopy(
-            &cmdBuffer,                                 // pCmdBuffer
-            &m_resMonoPictureChromaBuffer,              // presSrc
-            &m_decodeParams.m_destSurface->OsResource,  // presDst
-            uvsize,                                     // u32CopyLength
-            0,                                          // u32CopyInputOffset
-            dstOffset));                                // u32CopyOutputOffset
-
-        MHW_MI_FLUSH_DW_PARAMS flushDwParams;
-        MOS_ZeroMemory(&flushDwParams, sizeof(flushDwParams));
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_miInterface->AddMiFlushDwCmd(&cmdBuffer, &flushDwParams));
-
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_miInterface->AddMiBatchBufferEnd(&cmdBuffer, nullptr));
-
-        m_osInterface->pfnReturnCommandBuffer(m_osInterface, &cmdBuffer, 0);
+        // Copied by HuC in the picture command buffer, see AddMonoPictureCopies()
+        m_monoPictureCopies[m_monoPictureCopyNum].length    = uvsize;
+        m_monoPictureCopies[m_monoPictureCopyNum].dstOffset = dstOffset;
+        m_monoPictureCopyNum++;
+    }
 
-        MOS_SYNC_PARAMS syncParams;
+    return eStatus;
+}
 
-        syncParams = g_cInitSyncParams;
-        syncParams.GpuContext = m_videoContext;
-        syncParams.presSyncResource = &m_resSyncObjectVideoContextInUse;
+MOS_STATUS CodechalDecodeAvc::AddMonoPictureCopies(
+    PMOS_COMMAND_BUFFER             cmdBuffer)
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
 
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnEngineSignal(m_osInterface, &syncParams));
+    CODECHAL_DECODE_FUNCTION_ENTER;
 
-        syncParams = g_cInitSyncParams;
-        syncParams.GpuContext = m_videoContextForWa;
-        syncParams.presSyncResource = &m_resSyncObjectVideoContextInUse;
+    CODECHAL_DECODE_CHK_NULL_RETURN(cmdBuffer);
 
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnEngineWait(m_osInterface, &syncParams));
+    if (m_monoPictureCopyNum == 0)
+    {
+        return eStatus;
+    }
 
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnSubmitCommandBuffer(m_osInterface, &cmdBuffer, m_videoContextUsesNullHw));
+    CODECHAL_DECODE_CHK_NULL_RETURN(m_resMonoPictureChromaBuffer);
 
-        m_osInterface->pfnSetGpuContext(m_osInterface, m_videoContext);
+    // HuC runs ahead of MFX on the same VDBox, MFX leaves the chroma of mono pictures untouched
+    for (uint32_t i = 0; i < m_monoPictureCopyNum; i++)
+    {
+        CODECHAL_DECODE_CHK_STATUS_RETURN(HucCopy(
+            cmdBuffer,                                  // pCmdBuffer
+            m_resMonoPictureChromaBuffer,               // presSrc
+            &m_decodeParams.m_destSurface->OsResource,  // presDst
+            m_monoPictureCopies[i].length,              // u32CopyLength
+            0,                                          // u32CopyInputOffset
+            m_monoPictureCopies[i].dstOffset));         // u32CopyOutputOffset
     }
 
+    MHW_MI_FLUSH_DW_PARAMS flushDwParams;
+    MOS_ZeroMemory(&flushDwParams, sizeof(flushDwParams));
+    CODECHAL_DECODE_CHK_STATUS_RETURN(m_miInterface->AddMiFlushDwCmd(cmdBuffer, &flushDwParams));
+
     return eStatus;
 }
 
@@ -935,14 +1077,6 @@ MOS_STATUS CodechalDecodeAvc::AllocateResourcesFixedSizes()
 
     CODECHAL_DECODE_FUNCTION_ENTER;
 
-    CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnCreateSyncResource(
-        m_osInterface,
-        &m_resSyncObjectWaContextInUse));
-
-    CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnCreateSyncResource(
-        m_osInterface,
-        &m_resSyncObjectVideoContextInUse));
-
     MOS_LOCK_PARAMS lockFlagsWriteOnly;
     MOS_ZeroMemory(&lockFlagsWriteOnly, sizeof(MOS_LOCK_PARAMS));
     lockFlagsWriteOnly.WriteOnly = 1;
@@ -1053,6 +1187,24 @@ MOS_STATUS CodechalDecodeAvc::AllocateStandard(
         &m_commandPatchListSizeNeeded,
         m_shortFormatInUse);
 
+    // HuC copies of the mono picture chroma, see AddMonoPictureCopies()
+    if (!m_hwInterface->m_noHuC && m_hwInterface->GetHucInterface() != nullptr)
+    {
+        uint32_t hucCommandsSize  = 0;
+        uint32_t hucPatchListSize = 0;
+        MHW_VDBOX_STATE_CMDSIZE_PARAMS stateCmdSizeParams;
+        MOS_ZeroMemory(&stateCmdSizeParams, sizeof(stateCmdSizeParams));
+
+        CODECHAL_DECODE_CHK_STATUS_RETURN(m_hwInterface->GetHucInterface()->GetHucStateCommandSize(
+            CODECHAL_DECODE_MODE_AVCVLD,
+            &hucCommandsSize,
+            &hucPatchListSize,
+            &stateCmdSizeParams));
+
+        m_commandBufferSizeNeeded    += hucCommandsSize * 2;
+        m_commandPatchListSizeNeeded += hucPatchListSize * 2;
+    }
+
     // Slice Level Commands (cannot be placed in 2nd level batch)
     m_hwInterface->GetMfxPrimitiveCommandsDataSize(
         CODECHAL_DECODE_MODE_AVCVLD,
@@ -1071,14 +1223,6 @@ CodechalDecodeAvc::~CodechalDecodeAvc()
 
     CodecHalFreeDataList(m_avcRefList, CODEC_AVC_NUM_UNCOMPRESSED_SURFACE);
 
-    m_osInterface->pfnDestroySyncResource(
-        m_osInterface,
-        &m_resSyncObjectWaContextInUse);
-
-    m_osInterface->pfnDestroySyncResource(
-        m_osInterface,
-        &m_resSyncObjectVideoContextInUse);
-
     MOS_FreeMemory(m_vldSliceRecord);
 
     m_osInterface->pfnFreeResource(
@@ -1097,11 +1241,12 @@ CodechalDecodeAvc::~CodechalDecodeAvc()
         m_osInterface,
         &m_resMprRowStoreScratchBuffer);
 
-    if (!Mos_ResourceIsNull(&m_resMonoPictureChromaBuffer))
+    if (m_resMonoPictureChromaBuffer != nullptr)
     {
-        m_osInterface->pfnFreeResource(
+        CodechalDecodeAvcMonoChroma::Instance()->Release(
             m_osInterface,
-            &m_resMonoPictureChromaBuffer);
+            m_resMonoPictureChromaBuffer);
+        m_resMonoPictureChromaBuffer = nullptr;
     }
 
     for (uint32_t ctr = 0; ctr < CODEC_AVC_NUM_DMV_BUFFERS; ctr++)
@@ -1515,6 +1660,8 @@ MOS_STATUS CodechalDecodeAvc::DecodeStateLevel()
         CODECHAL_DECODE_CHK_STATUS_RETURN(StartStatusReport(&cmdBuffer));
     }
 
+    CODECHAL_DECODE_CHK_STATUS_RETURN(AddMonoPictureCopies(&cmdBuffer));
+
     CODECHAL_DECODE_CHK_STATUS_RETURN(AddPictureCmds(&cmdBuffer, &picMhwParams));
 
     m_osInterface->pfnReturnCommandBuffer(m_osInterface, &cmdBuffer, 0);
@@ -1796,22 +1943,6 @@ MOS_STATUS CodechalDecodeAvc::DecodePrimitiveLevel()
 
     m_osInterface->pfnReturnCommandBuffer(m_osInterface, &cmdBuffer, 0);
 
-    bool syncCompleteFrame = (m_avcPicParams->seq_fields.chroma_format_idc == avcChromaFormatMono && !m_hwInterface->m_noHuC);
-    if (syncCompleteFrame)
-    {
-        syncParams = g_cInitSyncParams;
-        syncParams.GpuContext = m_videoContextForWa;
-        syncParams.presSyncResource = &m_resSyncObjectWaContextInUse;
-
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnEngineSignal(m_osInterface, &syncParams));
-
-        syncParams = g_cInitSyncParams;
-        syncParams.GpuContext = m_videoContext;
-        syncParams.presSyncResource = &m_resSyncObjectWaContextInUse;
-
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnEngineWait(m_osInterface, &syncParams));
-    }
-
     CODECHAL_DEBUG_TOOL(
         CODECHAL_DECODE_CHK_STATUS_RETURN(m_debugInterface->DumpCmdBuffer(
             &cmdBuffer,
@@ -1825,6 +1956,15 @@ MOS_STATUS CodechalDecodeAvc::DecodePrimitiveLevel()
 
     CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnSubmitCommandBuffer(m_osInterface, &cmdBuffer, m_videoContextUsesNullHw));
 
+    if (m_monoPictureCopyNum)
+    {
+        m_osInterface->pfnSetResourceContentTag(
+            m_osInterface,
+            &m_decodeParams.m_destSurface->OsResource,
+            CODECHAL_DECODE_AVC_MONOPIC_CONTENT_TAG);
+        m_monoPictureCopyNum = 0;
+    }
+
     CODECHAL_DEBUG_TOOL(
         m_mmc->UpdateUserFeatureKey(&m_destSurface);)
 
@@ -1952,7 +2092,9 @@ CodechalDecodeAvc::CodechalDecodeAvc(
 
     MOS_ZeroMemory(m_presReferences, (sizeof(PMOS_RESOURCE) * CODEC_AVC_MAX_NUM_REF_FRAME));
     MOS_ZeroMemory(&m_resDataBuffer, sizeof(MOS_RESOURCE));
-    MOS_ZeroMemory(&m_resMonoPictureChromaBuffer, sizeof(MOS_RESOURCE));
+    m_resMonoPictureChromaBuffer  = nullptr;
+    m_monoPictureChromaBufferSize = 0;
+    m_monoPictureCopyNum          = 0;
     MOS_ZeroMemory(&m_resMfdIntraRowStoreScratchBuffer, sizeof(MOS_RESOURCE));
     MOS_ZeroMemory(&m_resMfdDeblockingFilterRowStoreScratchBuffer, sizeof(MOS_RESOURCE));
     MOS_ZeroMemory(&m_resBsdMpcRowStoreScratchBuffer, sizeof(MOS_RESOURCE));
@@ -32,6 +32,7 @@
 #include "codechal.h"
 #include "codechal_decoder.h"
 #include "codechal_decode_sfc_avc.h"
+#include <vector>
 
 //!
 //! \def CODECHAL_DECODE_AVC_MONOPIC_CHROMA_DEFAULT
@@ -39,6 +40,12 @@
 //!
 #define CODECHAL_DECODE_AVC_MONOPIC_CHROMA_DEFAULT        0x80
 
+//!
+//! \def CODECHAL_DECODE_AVC_MONOPIC_CONTENT_TAG
+//! content tag of a destination surface with the default chroma formatted
+//!
+#define CODECHAL_DECODE_AVC_MONOPIC_CONTENT_TAG           0x4D4F4E4F
+
 //!
 //! \def CODECHAL_DECODE_AVC_INVALID_FRAME_IDX
 //! invalid value for invalid frame index
@@ -77,6 +84,67 @@
 
 typedef class CodechalDecodeAvc *PCODECHAL_DECODE_AVC_STATE;
 
+//!
+//! \class CodechalDecodeAvcMonoChroma
+//! \brief Default chroma data of mono pictures, shared by the AVC decoders of a device.
+//!        A new buffer is allocated when a larger chroma plane is requested, smaller
+//!        buffers are freed once their last user releases them.
+//!
+class CodechalDecodeAvcMonoChroma
+{
+public:
+    //!
+    //! \brief    Get the instance
+    //!
+    //! \return   pointer of CodechalDecodeAvcMonoChroma
+    //!
+    static CodechalDecodeAvcMonoChroma *Instance();
+
+    //!
+    //! \brief    Get a buffer filled with the default chroma value
+    //!
+    //! \param    [in] osInterface
+    //!           OS interface of the decoder
+    //! \param    [in] size
+    //!           Size in bytes required
+    //! \param    [out] resource
+    //!           Buffer, valid until released
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS Acquire(PMOS_INTERFACE osInterface, uint32_t size, PMOS_RESOURCE *resource);
+
+    //!
+    //! \brief    Release a buffer got from Acquire
+    //!
+    //! \param    [in] osInterface
+    //!           OS interface of the decoder
+    //! \param    [in] resource
+    //!           Buffer to release
+    //!
+    //! \return   void
+    //!
+    void Release(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource);
+
+private:
+    CodechalDecodeAvcMonoChroma();
+    ~CodechalDecodeAvcMonoChroma();
+    CodechalDecodeAvcMonoChroma(const CodechalDecodeAvcMonoChroma&) = delete;
+    CodechalDecodeAvcMonoChroma& operator=(const CodechalDecodeAvcMonoChroma&) = delete;
+
+    struct Buffer
+    {
+        void                    *device;                //!< Device the buffer is allocated from
+        MOS_RESOURCE            resource;               //!< Default chroma data
+        uint32_t                size;                   //!< Size in bytes
+        uint32_t                ref;                    //!< Number of decoders using the buffer
+    };
+
+    PMOS_MUTEX                  m_mutex = nullptr;      //!< Protects the buffer list
+    std::vector<Buffer *>       m_buffers;              //!< Buffers of all devices
+};
+
 //!
 //! \class CodechalDecodeAvc
 //! \brief This class defines the member fields, functions etc used by AVC decoder.
@@ -324,6 +392,18 @@ public:
     //!
     MOS_STATUS          FormatAvcMonoPicture();
 
+    //!
+    //! \brief    Add the HuC copies of the mono picture chroma
+    //! \details  Copies prepared by FormatAvcMonoPicture are folded into the picture
+    //!           command buffer, ahead of the MFX commands of the picture
+    //! \param    [in] cmdBuffer
+    //!           Pointer to Command buffer
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS          AddMonoPictureCopies(
+        PMOS_COMMAND_BUFFER             cmdBuffer);
+
     //!
     //! \brief    Set frame store Id for avc codec.
     //! \details
@@ -409,7 +489,14 @@ public:
     PCODECHAL_VLD_SLICE_RECORD  m_vldSliceRecord;
 
     MOS_RESOURCE  m_resDataBuffer;                                //!< Handle of Data Buffer
-    MOS_RESOURCE  m_resMonoPictureChromaBuffer;                   //!< Handle of MonoPicture's default Chroma data surface
+    PMOS_RESOURCE m_resMonoPictureChromaBuffer;                   //!< Handle of MonoPicture's default Chroma data surface, shared by the decoders of the device
+    uint32_t      m_monoPictureChromaBufferSize;                  //!< Size of MonoPicture's default Chroma data surface
+    uint32_t      m_monoPictureCopyNum;                           //!< Number of MonoPicture chroma copies pending for the current picture
+    struct
+    {
+        uint32_t  length;                                         //!< Bytes to copy
+        uint32_t  dstOffset;                                      //!< Offset in the destination surface
+    } m_monoPictureCopies[2];                                     //!< MonoPicture chroma copies pending for the current picture
     MOS_RESOURCE  m_resMfdIntraRowStoreScratchBuffer;             //!< Handle of MFD Intra Row Store Scratch data surface
     MOS_RESOURCE  m_resMfdDeblockingFilterRowStoreScratchBuffer;  //!< Handle of MFD Deblocking Filter Row Store Scratch data surface
     MOS_RESOURCE  m_resBsdMpcRowStoreScratchBuffer;               //!< Handle of BSD/MPC Row Store Scratch data surface
@@ -420,7 +507,5 @@ public:
     MOS_SURFACE   m_destSurface;                                  //!< Handle of Dest data surface
     PMOS_SURFACE  m_refFrameSurface;                              //!< Handle of reference frame surface
     PMOS_RESOURCE m_presReferences[CODEC_AVC_MAX_NUM_REF_FRAME];  //!< Pointer to Handle of Reference Frames
-    MOS_RESOURCE  m_resSyncObjectWaContextInUse;                  //!< signals on the video WA context
-    MOS_RESOURCE  m_resSyncObjectVideoContextInUse;               //!< signals on the video context
 };
 #endif  // __CODECHAL_DECODER_AVC_H__
@@ -1200,104 +1200,67 @@ MOS_STATUS CodechalDecodeMpeg2::SliceLevel()
     return eStatus;
 }
 
+//!
+//! \brief  Intel motion type indexed by [field picture][MPEG2 motion type]
+//!
+static const uint8_t CODECHAL_DECODE_MPEG2_IntelMotionType[2][4] =
+{
+    // frame picture: none, field, frame, dual prime
+    { CODECHAL_MPEG2_IMT_NONE, CODECHAL_MPEG2_IMT_FRAME_FIELD, CODECHAL_MPEG2_IMT_FRAME_FRAME, CODECHAL_MPEG2_IMT_FRAME_DUAL_PRIME },
+    // field picture: none, field, 16x8, dual prime
+    { CODECHAL_MPEG2_IMT_NONE, CODECHAL_MPEG2_IMT_FIELD_FIELD, CODECHAL_MPEG2_IMT_16X8, CODECHAL_MPEG2_IMT_FIELD_DUAL_PRIME }
+};
+
+//!
+//! \brief  Motion vector packing of each Intel motion type, the 8 packed MVs are
+//!         sPackedMVs0 followed by sPackedMVs1, packed[i] = mv[index[i]] >> shift[i]
+//!
+static const struct
+{
+    bool    packMvs0;
+    bool    packMvs1;
+    uint8_t index[8];
+    uint8_t shift[8];
+} CODECHAL_DECODE_MPEG2_MvPacking[] =
+{
+    { false, false, { 0, 1, 2, 3, 4, 5, 6, 7 }, { 0, 0, 0, 0, 0, 0, 0, 0 } },  // CODECHAL_MPEG2_IMT_NONE
+    { true,  false, { 0, 1, 2, 3, 4, 5, 6, 7 }, { 0, 0, 0, 0, 0, 0, 0, 0 } },  // CODECHAL_MPEG2_IMT_FRAME_FRAME
+    { true,  false, { 0, 1, 2, 3, 4, 5, 6, 7 }, { 0, 0, 0, 0, 0, 0, 0, 0 } },  // CODECHAL_MPEG2_IMT_FIELD_FIELD
+    { true,  false, { 0, 1, 2, 3, 4, 5, 6, 7 }, { 0, 0, 0, 0, 0, 0, 0, 0 } },  // CODECHAL_MPEG2_IMT_FIELD_DUAL_PRIME
+    { true,  true,  { 0, 1, 2, 3, 4, 5, 6, 7 }, { 0, 1, 0, 1, 0, 1, 0, 1 } },  // CODECHAL_MPEG2_IMT_FRAME_FIELD
+    { true,  true,  { 0, 1, 2, 3, 0, 1, 6, 7 }, { 0, 1, 0, 1, 0, 1, 0, 1 } },  // CODECHAL_MPEG2_IMT_FRAME_DUAL_PRIME
+    { true,  true,  { 0, 1, 2, 3, 4, 5, 6, 7 }, { 0, 0, 0, 0, 0, 0, 0, 0 } }   // CODECHAL_MPEG2_IMT_16X8
+};
+
 void CodechalDecodeMpeg2::PackMotionVectors(
     CODEC_PICTURE_FLAG          pic_flag,
     PMHW_VDBOX_MPEG2_MB_STATE   mpeg2MbState)
 {
     CodecDecodeMpeg2MbParmas *mbParams = mpeg2MbState->pMBParams;
 
-    uint16_t motionType     = mbParams->MBType.m_motionType;
-    uint16_t intelMotionType = CODECHAL_MPEG2_IMT_NONE;
-
     //convert to Intel Motion Type
-    if (pic_flag == PICTURE_FRAME)
+    uint8_t intelMotionType = CODECHAL_DECODE_MPEG2_IntelMotionType[pic_flag != PICTURE_FRAME][mbParams->MBType.m_motionType];
+    auto    packing         = &CODECHAL_DECODE_MPEG2_MvPacking[intelMotionType];
+
+    int16_t *mv = mbParams->m_motionVectors;
+    short    packedMVs[8];
+
+    for (uint32_t i = 0; i < 8; i++)
     {
-        switch(motionType)
-        {
-        case CodechalDecodeMcFrame:
-            intelMotionType = CODECHAL_MPEG2_IMT_FRAME_FRAME;
-            break;
-        case CodechalDecodeMcField:
-            intelMotionType = CODECHAL_MPEG2_IMT_FRAME_FIELD;
-            break;
-        case CodechalDecodeMcDmv:
-            intelMotionType = CODECHAL_MPEG2_IMT_FRAME_DUAL_PRIME;
-            break;
-        default:
-            break;
-        }
+        packedMVs[i] = (short)(mv[packing->index[i]] >> packing->shift[i]);
     }
-    else // must be field picture...
+
+    if (packing->packMvs0)
     {
-        switch(motionType)
-        {
-        case CodechalDecodeMcField:
-            intelMotionType = CODECHAL_MPEG2_IMT_FIELD_FIELD;
-            break;
-        case CodechalDecodeMcDmv:
-            intelMotionType = CODECHAL_MPEG2_IMT_FIELD_DUAL_PRIME;
-            break;
-        case CodechalDecodeMc16x8:
-            intelMotionType = CODECHAL_MPEG2_IMT_16X8;
-            break;
-        default:
-            break;
-        }
+        MOS_SecureMemcpy(mpeg2MbState->sPackedMVs0, sizeof(mpeg2MbState->sPackedMVs0), &packedMVs[0], sizeof(mpeg2MbState->sPackedMVs0));
     }
 
-    int16_t *mv = mbParams->m_motionVectors;
-
-    switch (intelMotionType)
-    {
-    case CODECHAL_MPEG2_IMT_16X8:
-    case CODECHAL_MPEG2_IMT_FIELD_FIELD:
-    case CODECHAL_MPEG2_IMT_FRAME_FRAME:
-    case CODECHAL_MPEG2_IMT_FIELD_DUAL_PRIME:
-        mpeg2MbState->sPackedMVs0[0] = (short)mv[CodechalDecodeRstFirstForwHorz];
-        mpeg2MbState->sPackedMVs0[1] = (short)mv[CodechalDecodeRstFirstForwVert];
-        mpeg2MbState->sPackedMVs0[2] = (short)mv[CodechalDecodeRstFirstBackHorz];
-        mpeg2MbState->sPackedMVs0[3] = (short)mv[CodechalDecodeRstFirstBackVert];
-        break;
-
-    case CODECHAL_MPEG2_IMT_FRAME_FIELD:
-    case CODECHAL_MPEG2_IMT_FRAME_DUAL_PRIME:
-        mpeg2MbState->sPackedMVs0[0] = (short)mv[CodechalDecodeRstFirstForwHorz];
-        mpeg2MbState->sPackedMVs0[1] = (short)(mv[CodechalDecodeRstFirstForwVert] >> 1) ;
-        mpeg2MbState->sPackedMVs0[2] = (short)mv[CodechalDecodeRstFirstBackHorz];
-        mpeg2MbState->sPackedMVs0[3] = (short)(mv[CodechalDecodeRstFirstBackVert] >> 1);
-        break;
-
-    default:
-        break;
-    }
-
-    switch (intelMotionType)
-    {
-    case CODECHAL_MPEG2_IMT_16X8:
-        mpeg2MbState->sPackedMVs1[0] = (short)mv[CodechalDecodeRstSecndForwHorz];
-        mpeg2MbState->sPackedMVs1[1] = (short)mv[CodechalDecodeRstSecndForwVert];
-        mpeg2MbState->sPackedMVs1[2] = (short)mv[CodechalDecodeRstSecndBackHorz];
-        mpeg2MbState->sPackedMVs1[3] = (short)mv[CodechalDecodeRstSecndBackVert];
-        break;
-
-    case CODECHAL_MPEG2_IMT_FRAME_DUAL_PRIME:
-        mpeg2MbState->sPackedMVs1[0] = (short)mv[CodechalDecodeRstFirstForwHorz];
-        mpeg2MbState->sPackedMVs1[1] = (short)(mv[CodechalDecodeRstFirstForwVert] >> 1);
-        mpeg2MbState->sPackedMVs1[2] = (short)mv[CodechalDecodeRstSecndBackHorz];
-        mpeg2MbState->sPackedMVs1[3] = (short)(mv[CodechalDecodeRstSecndBackVert] >> 1);
-        break;
-
-    case CODECHAL_MPEG2_IMT_FRAME_FIELD:
-        mpeg2MbState->sPackedMVs1[0] = (short)mv[CodechalDecodeRstSecndForwHorz];
-        mpeg2MbState->sPackedMVs1[1] = (short)(mv[CodechalDecodeRstSecndForwVert] >> 1);
-        mpeg2MbState->sPackedMVs1[2] = (short)mv[CodechalDecodeRstSecndBackHorz];
-        mpeg2MbState->sPackedMVs1[3] = (short)(mv[CodechalDecodeRstSecndBackVert] >> 1);
-        break;
-
-    default:
-        break;
+    if (packing->packMvs1)
+    {
+        MOS_SecureMemcpy(mpeg2MbState->sPackedMVs1, sizeof(mpeg2MbState->sPackedMVs1), &packedMVs[4], sizeof(mpeg2MbState->sPackedMVs1));
     }
 }
+
 MOS_STATUS CodechalDecodeMpeg2::InsertSkippedMacroblocks(
     PMHW_BATCH_BUFFER               batchBuffer,
     PMHW_VDBOX_MPEG2_MB_STATE       params,
@@ -1322,14 +1285,12 @@ MOS_STATUS CodechalDecodeMpeg2::InsertSkippedMacroblocks(
     MOS_ZeroMemory(params->sPackedMVs0,sizeof(params->sPackedMVs0));
     MOS_ZeroMemory(params->sPackedMVs1,sizeof(params->sPackedMVs1));
 
-    for (uint16_t i = 0; i < skippedMBs; i++)
-    {
-        params->pMBParams->m_mbAddr = nextMBStart + i;
-        CODECHAL_DECODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfdMpeg2ITObject(
-            nullptr,
-            batchBuffer,
-            params));
-    }
+    // skipped MBs only differ in position, add the whole run at once
+    CODECHAL_DECODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfdMpeg2SkippedITObjects(
+        batchBuffer,
+        params,
+        nextMBStart,
+        skippedMBs));
 
     return eStatus;
 }
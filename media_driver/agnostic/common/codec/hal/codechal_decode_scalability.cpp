@@ -29,6 +29,116 @@
 #include "codechal_decode_scalability.h"
 #include "mos_util_user_interface.h"
 
+//!
+//! \class   CodechalDecodeVdboxLoad
+//! \brief   Process wide count of the Vdbox pipes used by scalability decode contexts
+//!
+class CodechalDecodeVdboxLoad
+{
+public:
+    static CodechalDecodeVdboxLoad *Instance()
+    {
+        static CodechalDecodeVdboxLoad instance;
+        return &instance;
+    }
+
+    //!
+    //! \brief    Replace the pipes a context accounts for
+    //! \return   Pipes in use by the other contexts
+    //!
+    uint32_t Update(uint8_t ucOldPipeNum, uint8_t ucNewPipeNum)
+    {
+        uint32_t dwOtherPipesInUse;
+
+        if (m_mutex == nullptr)
+        {
+            return 0;
+        }
+
+        MOS_LockMutex(m_mutex);
+        dwOtherPipesInUse = m_pipesInUse - ucOldPipeNum;
+        m_pipesInUse      = dwOtherPipesInUse + ucNewPipeNum;
+        MOS_UnlockMutex(m_mutex);
+
+        return dwOtherPipesInUse;
+    }
+
+    //!
+    //! \brief    Select the pipe num of a context from the load of the other
+    //!           contexts and account for it, in one step so that concurrent
+    //!           contexts cannot both take the same free pipes
+    //! \return   Selected pipe num
+    //!
+    uint8_t SelectByLoad(uint8_t ucCandidatePipeNum, uint8_t ucCurPipeNum, uint8_t ucNumVdbox)
+    {
+        uint32_t dwOtherPipesInUse;
+        uint8_t  ucPipeNum;
+
+        if (m_mutex == nullptr)
+        {
+            return ucCandidatePipeNum;
+        }
+
+        MOS_LockMutex(m_mutex);
+        dwOtherPipesInUse = m_pipesInUse - ucCurPipeNum;
+        ucPipeNum         = CodecHalDecodeScalability_SelectPipeNumByLoad(
+            ucCandidatePipeNum,
+            ucCurPipeNum,
+            dwOtherPipesInUse,
+            ucNumVdbox);
+        m_pipesInUse      = dwOtherPipesInUse + ucPipeNum;
+        MOS_UnlockMutex(m_mutex);
+
+        return ucPipeNum;
+    }
+
+private:
+    CodechalDecodeVdboxLoad()
+    {
+        m_pipesInUse = 0;
+        m_mutex      = MOS_CreateMutex();
+
+        // The load is tracked for the process, not for the decoder MemNinja checks
+        MosMemAllocCounter--;
+        MOS_MEMNINJA_FREE_MESSAGE(m_mutex, __FUNCTION__, __FILE__, __LINE__);
+    }
+
+    ~CodechalDecodeVdboxLoad()
+    {
+        if (m_mutex)
+        {
+            MosMemAllocCounter++;
+            MOS_DestroyMutex(m_mutex);
+            m_mutex = nullptr;
+        }
+    }
+
+    uint32_t    m_pipesInUse;
+    PMOS_MUTEX  m_mutex;
+};
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to simulate decode contexts deciding their
+    //!           pipe num under load, a candidate of 0 releases the pipes
+    //!
+    MOS_FUNC_EXPORT uint8_t CodecHalDecodeScalability_UltSelectPipeNumByLoad(
+        uint8_t     ucCandidatePipeNum,
+        uint8_t     ucCurPipeNum,
+        uint8_t     ucNumVdbox)
+    {
+        return CodechalDecodeVdboxLoad::Instance()->SelectByLoad(ucCandidatePipeNum, ucCurPipeNum, ucNumVdbox);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 
 //!
 //! \brief    calculate secondary cmd buffer index 
@@ -572,6 +682,9 @@ void CodecHalDecodeScalability_Destroy (
     CODECHAL_DECODE_CHK_NULL_NO_STATUS_RETURN(pScalabilityState->pHwInterface->GetOsInterface());
     pOsInterface = pScalabilityState->pHwInterface->GetOsInterface();
 
+    CodechalDecodeVdboxLoad::Instance()->Update(pScalabilityState->ucLoadPipeNum, 0);
+    pScalabilityState->ucLoadPipeNum = 0;
+
     pOsInterface->pfnFreeResource(
         pOsInterface,
         &pScalabilityState->resSliceStateStreamOutBuffer);
@@ -1057,6 +1170,8 @@ MOS_STATUS CodecHalDecodeScalability_DecidePipeNum(
     if (pInitParams->usingSFC)
     {
         //using SFC can only work in single pipe mode.
+        CodechalDecodeVdboxLoad::Instance()->Update(pScalState->ucLoadPipeNum, pScalState->ucScalablePipeNum);
+        pScalState->ucLoadPipeNum = pScalState->ucScalablePipeNum;
         return MOS_STATUS_SUCCESS;
     }
 
@@ -1098,12 +1213,46 @@ MOS_STATUS CodecHalDecodeScalability_DecidePipeNum(
                     pScalState->ucScalablePipeNum   = CODECHAL_DECODE_HCP_Legacy_PIPE_NUM_1;
                 }
             }
+
+            if (pScalState->bLoadAwarePipeNum)
+            {
+                pScalState->ucScalablePipeNum = CodechalDecodeVdboxLoad::Instance()->SelectByLoad(
+                    pScalState->ucScalablePipeNum,
+                    pScalState->ucLoadPipeNum,
+                    pScalState->ucNumVdbox);
+                pScalState->ucLoadPipeNum = pScalState->ucScalablePipeNum;
+                return eStatus;
+            }
         }
     }
 
+    CodechalDecodeVdboxLoad::Instance()->Update(pScalState->ucLoadPipeNum, pScalState->ucScalablePipeNum);
+    pScalState->ucLoadPipeNum = pScalState->ucScalablePipeNum;
+
     return eStatus;
 }
 
+uint8_t CodecHalDecodeScalability_SelectPipeNumByLoad(
+    uint8_t                                    ucCandidatePipeNum,
+    uint8_t                                    ucCurPipeNum,
+    uint32_t                                   dwOtherPipesInUse,
+    uint8_t                                    ucNumVdbox)
+{
+    if (ucCandidatePipeNum <= CODECHAL_DECODE_HCP_Legacy_PIPE_NUM_1)
+    {
+        return ucCandidatePipeNum;
+    }
+
+    if (ucCurPipeNum == ucCandidatePipeNum)
+    {
+        // Stay scalable until every Vdbox already runs another stream
+        return (dwOtherPipesInUse >= ucNumVdbox) ? CODECHAL_DECODE_HCP_Legacy_PIPE_NUM_1 : ucCandidatePipeNum;
+    }
+
+    // Go scalable only if the pipes are free
+    return (dwOtherPipesInUse + ucCandidatePipeNum <= ucNumVdbox) ? ucCandidatePipeNum : CODECHAL_DECODE_HCP_Legacy_PIPE_NUM_1;
+}
+
 MOS_STATUS CodechalDecodeScalability_MapPipeNumToLRCACount(
     PCODECHAL_DECODE_SCALABILITY_STATE   pScalState,
     uint32_t                             *LRCACount)
@@ -1248,6 +1397,9 @@ MOS_STATUS CodechalDecodeScalability_DebugOvrdDecidePipeNum(
         return MOS_STATUS_INVALID_PARAMETER;
     }
 
+    CodechalDecodeVdboxLoad::Instance()->Update(pScalState->ucLoadPipeNum, pScalState->ucScalablePipeNum);
+    pScalState->ucLoadPipeNum = pScalState->ucScalablePipeNum;
+
     return eStatus;
 }
 #endif
@@ -1823,6 +1975,14 @@ MOS_STATUS CodecHalDecodeScalability_InitializeState (
     pScalabilityState->dbgOvrdWidthInMinCb = UserFeatureData.u32Data;
 #endif
 
+    MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_HCP_DECODE_LOAD_AWARE_PIPE_NUM_ID,
+        &UserFeatureData);
+    pScalabilityState->bLoadAwarePipeNum = UserFeatureData.i32Data ? true : false;
+    pScalabilityState->ucLoadPipeNum     = 0;
+
     // enable FE separate submission by default in multi-pipe mode
     if (hwInterface->GetMfxInterface()->GetNumVdbox() > 2)
     {
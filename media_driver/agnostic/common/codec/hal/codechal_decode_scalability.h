@@ -111,6 +111,8 @@ struct _CODECHAL_DECODE_SCALABILITY_STATE
     uint32_t                        uiFirstTileColWidth;
     uint32_t                        dwHcpDecModeSwtichTh1Width;
     uint32_t                        dwHcpDecModeSwtichTh2Width;
+    bool                            bLoadAwarePipeNum;              //!< Take Vdbox pipes used by other decode contexts into account
+    uint8_t                         ucLoadPipeNum;                  //!< Pipe num this context accounts for in the process Vdbox load
     MOS_RESOURCE                    resSliceStateStreamOutBuffer;
     MOS_RESOURCE                    resMvUpRightColStoreBuffer;
     MOS_RESOURCE                    resIntraPredUpRightColStoreBuffer;
@@ -243,6 +245,30 @@ MOS_STATUS CodecHalDecodeScalability_DecidePipeNum(
     PCODECHAL_DECODE_SCALABILITY_STATE         pScalState,
     PCODECHAL_DECODE_SCALABILITY_INIT_PARAMS   pInitParams);
 
+//!
+//! \brief    Select pipe num of scalability decode by Vdbox load
+//! \details  Trades per stream latency for aggregate throughput: a stream
+//!           only goes scalable when the Vdboxes are otherwise idle, and only
+//!           goes back to single pipe when the other decode contexts of the
+//!           process already occupy all Vdboxes. In between the current pipe
+//!           num is kept, which avoids gpu context switches on small load changes.
+//! \param    [in] ucCandidatePipeNum
+//!                pipe num decided from the picture size
+//! \param    [in] ucCurPipeNum
+//!                pipe num in use by this context, 0 if none yet
+//! \param    [in] dwOtherPipesInUse
+//!                pipes in use by the other decode contexts of the process
+//! \param    [in] ucNumVdbox
+//!                number of Vdboxes
+//! \return   uint8_t
+//!           selected pipe num
+//!
+uint8_t CodecHalDecodeScalability_SelectPipeNumByLoad(
+    uint8_t                                    ucCandidatePipeNum,
+    uint8_t                                    ucCurPipeNum,
+    uint32_t                                   dwOtherPipesInUse,
+    uint8_t                                    ucNumVdbox);
+
 //!
 //! \brief    Map the scalability pipe num to the LRCA count
 //! \param    [in] pScalState
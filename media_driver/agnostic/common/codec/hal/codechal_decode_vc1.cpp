@@ -139,9 +139,9 @@ MOS_STATUS CodechalDecodeVc1::GetVLC(const uint32_t* table, uint32_t &value)
 
 MOS_STATUS CodechalDecodeVc1::SkipWords(uint32_t dwordNumber, uint32_t &value)
 {
-    for (uint32_t i = 0; i < dwordNumber; i++)
+    if (dwordNumber > 0)
     {
-        value = SkipBits(16);
+        value = SkipBits(dwordNumber << 4);
         if (CODECHAL_DECODE_VC1_EOS == value)
         {
             return MOS_STATUS_UNKNOWN;
@@ -164,11 +164,18 @@ MOS_STATUS CodechalDecodeVc1::SkipBits(uint32_t bits, uint32_t &value)
     return MOS_STATUS_SUCCESS;
 }
 
-typedef union _CODECHAL_DECODE_VC1_BITSTREAM_BUFFER_VALUE
+MOS_STATUS CodechalDecodeVc1::SkipTileCode(const uint8_t *codeLength)
 {
-    uint32_t u32Value;
-    uint8_t  u8Value[sizeof(uint32_t)];
-} CODECHAL_DECODE_VC1_BITSTREAM_VALUE, *PCODECHAL_DECODE_VC1_BITSTREAM_VALUE;
+    uint32_t length = codeLength[PeekBits(CodechalDecodeVc1VlcLengthTable::m_maxBits)];
+    if (length == 0)
+    {
+        CODECHAL_DECODE_ASSERTMESSAGE("Code is not in VLC table.");
+        return MOS_STATUS_UNKNOWN;
+    }
+
+    uint32_t value;
+    return SkipBits(length, value);
+}
 
 typedef enum _CODECHAL_DECODE_VC1_MVMODE
 {
@@ -1424,214 +1431,211 @@ MOS_STATUS CodechalDecodeVc1::HandleSkipFrame()
 
 uint32_t CodechalDecodeVc1::PeekBits(uint32_t bitsRead)
 {
-    uint32_t value = 0;
-
     CODECHAL_DECODE_ASSERT((bitsRead) > 0 && (bitsRead) <= 32);
 
-    uint32_t *cache       = m_bitstream.pu32Cache;
-    int32_t   shiftOffset = m_bitstream.iBitOffset - (bitsRead);
-
-    if (shiftOffset >= 0)
+    if (m_bitstream.iValueBits < (int32_t)bitsRead)
     {
-        value = (*cache) >> (shiftOffset);
-    }
-    else
-    {
-        shiftOffset += 32;
-        value = (cache[0] << (32 - shiftOffset)) + (cache[1] >> shiftOffset);
+        FillBitstreamValue();
     }
 
-    return (value & ((1 << bitsRead) - 1));
+    // bits beyond the end of the bitstream are read as 0
+    return (uint32_t)(m_bitstream.u64Value >> (64 - bitsRead));
 }
 
-uint32_t CodechalDecodeVc1::UpdateBitstreamBuffer()
+void CodechalDecodeVc1::UpdateBitstreamBuffer()
 {
-    uint32_t *cache             = (uint32_t *)m_bitstream.CacheBuffer;
-    uint32_t *cacheEnd          = m_bitstream.pu32CacheEnd;
-    uint32_t *cacheDataEnd      = m_bitstream.pu32CacheDataEnd;
-    uint32_t  zeroNum           = m_bitstream.u32ZeroNum;
-    uint8_t * originalBitBuffer = m_bitstream.pOriginalBitBuffer;
-    uint8_t * originalBufferEnd = m_bitstream.pOriginalBufferEnd;
+    uint8_t *cache             = m_bitstream.CacheBuffer;
+    uint8_t *cacheEnd          = m_bitstream.CacheBuffer + CODECHAL_DECODE_VC1_BITSTRM_BUF_LEN;
+    uint32_t zeroNum           = m_bitstream.u32ZeroNum;
+    uint8_t *originalBitBuffer = m_bitstream.pOriginalBitBuffer;
+    uint8_t *originalBufferEnd = m_bitstream.pOriginalBufferEnd;
 
-    if (cacheDataEnd == cacheEnd)
+    if (!m_bitstream.bIsEBDU)
     {
-        *cache++ = *cacheEnd;
+        uint32_t size = (uint32_t)MOS_MIN(cacheEnd - cache, originalBufferEnd - originalBitBuffer);
+        MOS_SecureMemcpy(cache, size, originalBitBuffer, size);
+        cache += size;
+        originalBitBuffer += size;
     }
 
-    while (cache <= cacheEnd)
+    while (m_bitstream.bIsEBDU && cache < cacheEnd && originalBitBuffer < originalBufferEnd)
     {
-        uint32_t leftByte;
-        CODECHAL_DECODE_VC1_BITSTREAM_VALUE value;
-        if (m_bitstream.bIsEBDU)
-        {
-            // for EBDU, set dwLeftByte to 4 to remove emulation prevention bytes in the later while loop
-            leftByte = 4;
-            value.u32Value = 0;
-        }
-        else
-        {
-            leftByte = 0;
-            value.u8Value[3] = *originalBitBuffer++;
-            value.u8Value[2] = *originalBitBuffer++;
-            value.u8Value[1] = *originalBitBuffer++;
-            value.u8Value[0] = *originalBitBuffer++;
-        }
-
-        while (leftByte)
+        if (zeroNum < 2)
         {
-            if (originalBitBuffer >= originalBufferEnd) // End of the bitstream;
+            // Only a zero byte can start an emulation prevention sequence, copy the non-zero run at once
+            uint32_t size     = (uint32_t)MOS_MIN(cacheEnd - cache, originalBufferEnd - originalBitBuffer);
+            uint8_t *zeroByte = (uint8_t *)memchr(originalBitBuffer, 0, size);
+            if (zeroByte != nullptr)
             {
-                *cache = value.u32Value;
-                m_bitstream.pu32Cache          = (uint32_t *)m_bitstream.CacheBuffer;
-                m_bitstream.u32ZeroNum         = zeroNum;
-                m_bitstream.pOriginalBitBuffer = originalBitBuffer;
-                m_bitstream.pu32CacheDataEnd   = cache;
-                m_bitstream.iBitOffsetEnd      = leftByte * 8;
-                return 0;
+                size = (uint32_t)(zeroByte - originalBitBuffer);
             }
 
-            uint8_t data = *originalBitBuffer++;
-
-            if (zeroNum < 2)
+            if (size > 0)
             {
-                zeroNum = data ? 0 : zeroNum + 1;
+                MOS_SecureMemcpy(cache, size, originalBitBuffer, size);
+                cache += size;
+                originalBitBuffer += size;
+                zeroNum = 0;
+                continue;
             }
-            else if (zeroNum == 2)
+        }
+
+        uint8_t *errorPosition = originalBitBuffer;
+        uint8_t  data          = *originalBitBuffer++;
+        bool     isValid       = true;
+
+        if (zeroNum < 2)
+        {
+            zeroNum = data ? 0 : zeroNum + 1;
+        }
+        else if (zeroNum == 2)
+        {
+            if (data == 0x03)
             {
-                if (data == 0x03)
+                if (originalBitBuffer < originalBufferEnd)
                 {
-                    if (originalBitBuffer < originalBufferEnd)
-                    {
-                        data = *originalBitBuffer++;
-                        zeroNum = (data == 0);
-                    }
-                    else
-                    {
-                        CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Incomplete bitstream.");
-                        return(CODECHAL_DECODE_VC1_EOS);
-                    }
-
-                    if (data > 0x03)
-                    {
-                        CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Not a valid code 0x000003 %x.", data);
-                        return(CODECHAL_DECODE_VC1_EOS);
-                    }
+                    data = *originalBitBuffer++;
+                    zeroNum = (data == 0);
                 }
-                else if (data == 0x02)
+                else
                 {
-                    CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Not a valid code 0x000002.");
-                    return(CODECHAL_DECODE_VC1_EOS);
+                    CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Incomplete bitstream.");
+                    isValid = false;
                 }
-                else
+
+                if (isValid && data > 0x03)
                 {
-                    zeroNum = data ? 0 : (zeroNum + 1);
+                    CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Not a valid code 0x000003 %x.", data);
+                    isValid = false;
                 }
             }
-            else // zeroNum > 3
+            else if (data == 0x02)
             {
-                if (data == 0x00)
-                {
-                    zeroNum++;
-                }
-                else if (data == 0x01)
-                {
-                    zeroNum = 0;
-                }
-                else
-                {
-                    CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Not a start code 0x000001.");
-                    return(CODECHAL_DECODE_VC1_EOS);
-                }
+                CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Not a valid code 0x000002.");
+                isValid = false;
+            }
+            else
+            {
+                zeroNum = data ? 0 : (zeroNum + 1);
             }
+        }
+        else // zeroNum > 3
+        {
+            if (data == 0x00)
+            {
+                zeroNum++;
+            }
+            else if (data == 0x01)
+            {
+                zeroNum = 0;
+            }
+            else
+            {
+                CODECHAL_DECODE_ASSERTMESSAGE("VC1 Bitstream Parsing Error: Not a start code 0x000001.");
+                isValid = false;
+            }
+        }
 
-            leftByte--;
-            value.u8Value[leftByte] = data;
+        if (!isValid)
+        {
+            // Truncate the bitstream at the invalid code, reading beyond it returns EOS
+            originalBitBuffer              = errorPosition;
+            m_bitstream.pOriginalBufferEnd = errorPosition;
+            break;
         }
 
-        *cache = value.u32Value;
-        cache++;
+        *cache++ = data;
     }
 
-    m_bitstream.pu32Cache          = (uint32_t *)m_bitstream.CacheBuffer;
+    m_bitstream.pu8Cache           = m_bitstream.CacheBuffer;
+    m_bitstream.pu8CacheEnd        = cache;
     m_bitstream.u32ZeroNum         = zeroNum;
     m_bitstream.pOriginalBitBuffer = originalBitBuffer;
-    m_bitstream.iBitOffsetEnd      = 0;
-    m_bitstream.pu32CacheDataEnd   = m_bitstream.pu32CacheEnd;
+}
 
-    return 0;
+void CodechalDecodeVc1::FillBitstreamValue()
+{
+    while (m_bitstream.iValueBits <= 56)
+    {
+        if (m_bitstream.pu8Cache >= m_bitstream.pu8CacheEnd)
+        {
+            if (m_bitstream.pOriginalBitBuffer >= m_bitstream.pOriginalBufferEnd)
+            {
+                break;  // End of the bitstream
+            }
+
+            UpdateBitstreamBuffer();
+            continue;
+        }
+
+        m_bitstream.u64Value |= (uint64_t)(*m_bitstream.pu8Cache++) << (56 - m_bitstream.iValueBits);
+        m_bitstream.iValueBits += 8;
+    }
 }
 
 uint32_t CodechalDecodeVc1::GetBits(uint32_t bitsRead)
 {
-    uint32_t        value = 0;
-
     CODECHAL_DECODE_ASSERT((bitsRead > 0) && (bitsRead <= 32));
 
-    uint32_t *cache       = m_bitstream.pu32Cache;
-    int32_t   shiftOffset = m_bitstream.iBitOffset - (bitsRead);
-
-    if (shiftOffset >= 0)
-    {
-        value = (*cache) >> (shiftOffset);
-    }
-    else
+    if (m_bitstream.iValueBits < (int32_t)bitsRead)
     {
-        shiftOffset += 32;
-        value = (cache[0] << (32 - shiftOffset)) + (cache[1] >> shiftOffset);
-        m_bitstream.pu32Cache++;
+        FillBitstreamValue();
     }
 
-    value &= ((0x1 << bitsRead) - 1);
-    m_bitstream.iBitOffset = shiftOffset;
     m_bitstream.u32ProcessedBitNum += bitsRead;
 
-    if ((cache == m_bitstream.pu32CacheDataEnd) &&
-        (m_bitstream.iBitOffset < m_bitstream.iBitOffsetEnd))
+    if (m_bitstream.iValueBits < (int32_t)bitsRead)
     {
         return CODECHAL_DECODE_VC1_EOS;
     }
 
-    if (cache == m_bitstream.pu32CacheEnd)
-    {
-        if (UpdateBitstreamBuffer() == CODECHAL_DECODE_VC1_EOS)
-        {
-            return CODECHAL_DECODE_VC1_EOS;
-        }
-    }
+    uint32_t value = (uint32_t)(m_bitstream.u64Value >> (64 - bitsRead));
+    m_bitstream.u64Value <<= bitsRead;
+    m_bitstream.iValueBits -= bitsRead;
 
     return value;
 }
 
 uint32_t CodechalDecodeVc1::SkipBits(uint32_t bitsRead)
 {
-    CODECHAL_DECODE_ASSERT((bitsRead > 0) && (bitsRead <= 32));
-
-    uint32_t *cache       = m_bitstream.pu32Cache;
-    int32_t   shiftOffset = m_bitstream.iBitOffset - (bitsRead);
+    m_bitstream.u32ProcessedBitNum += bitsRead;
 
-    if (shiftOffset < 0)
+    if (bitsRead > (uint32_t)m_bitstream.iValueBits)
     {
-        shiftOffset += 32;
-        m_bitstream.pu32Cache++;
-    }
+        // Drop the bit window and skip whole bytes directly in the cache buffer
+        bitsRead -= m_bitstream.iValueBits;
+        m_bitstream.u64Value   = 0;
+        m_bitstream.iValueBits = 0;
 
-    m_bitstream.iBitOffset = shiftOffset;
-    m_bitstream.u32ProcessedBitNum += bitsRead;
+        while (bitsRead >= 8)
+        {
+            uint32_t bytes = (uint32_t)MOS_MIN(bitsRead >> 3, m_bitstream.pu8CacheEnd - m_bitstream.pu8Cache);
+            if (bytes == 0)
+            {
+                if (m_bitstream.pOriginalBitBuffer >= m_bitstream.pOriginalBufferEnd)
+                {
+                    return CODECHAL_DECODE_VC1_EOS;
+                }
 
-    if ((cache == m_bitstream.pu32CacheDataEnd) &&
-        (m_bitstream.iBitOffset < m_bitstream.iBitOffsetEnd))
-    {
-        return CODECHAL_DECODE_VC1_EOS;
-    }
+                UpdateBitstreamBuffer();
+                continue;
+            }
 
-    if (cache == m_bitstream.pu32CacheEnd)
-    {
-        if (UpdateBitstreamBuffer() == CODECHAL_DECODE_VC1_EOS)
+            m_bitstream.pu8Cache += bytes;
+            bitsRead -= bytes << 3;
+        }
+
+        FillBitstreamValue();
+
+        if (bitsRead > (uint32_t)m_bitstream.iValueBits)
         {
             return CODECHAL_DECODE_VC1_EOS;
         }
     }
 
+    m_bitstream.u64Value = (bitsRead < 64) ? (m_bitstream.u64Value << bitsRead) : 0;
+    m_bitstream.iValueBits -= bitsRead;
+
     return 0;
 }
 
@@ -1696,20 +1700,74 @@ MOS_STATUS CodechalDecodeVc1::InitialiseBitstream(
     m_bitstream.pOriginalBufferEnd = buffer + length;
     m_bitstream.u32ZeroNum         = 0;
     m_bitstream.u32ProcessedBitNum = 0;
-    m_bitstream.pu32Cache          = (uint32_t *)m_bitstream.CacheBuffer;
-    m_bitstream.pu32CacheEnd       = (uint32_t *)(m_bitstream.CacheBuffer + CODECHAL_DECODE_VC1_BITSTRM_BUF_LEN);
-    m_bitstream.pu32CacheDataEnd   = (uint32_t *)m_bitstream.CacheBuffer;
-    m_bitstream.iBitOffset         = 32;
-    m_bitstream.iBitOffsetEnd      = 32;
+    m_bitstream.pu8Cache           = m_bitstream.CacheBuffer;
+    m_bitstream.pu8CacheEnd        = m_bitstream.CacheBuffer;
+    m_bitstream.u64Value           = 0;
+    m_bitstream.iValueBits         = 0;
     m_bitstream.bIsEBDU            = isEBDU;
 
-    if (UpdateBitstreamBuffer() == CODECHAL_DECODE_VC1_EOS)
+    FillBitstreamValue();
+
+    return eStatus;
+}
+
+#if MOS_ULT_HOOKS_ENABLED
+MOS_STATUS CodechalDecodeVc1::UltRunBitstreamOps(
+    uint8_t                     *buffer,
+    uint32_t                    length,
+    bool                        isEBDU,
+    PCODECHAL_DECODE_VC1_ULT_OP ops,
+    uint32_t                    opNum)
+{
+    CODECHAL_DECODE_CHK_NULL_RETURN(ops);
+    CODECHAL_DECODE_CHK_STATUS_RETURN(InitialiseBitstream(buffer, length, isEBDU));
+
+    CODEC_VC1_PIC_PARAMS picParams;
+    MOS_ZeroMemory(&picParams, sizeof(picParams));
+    picParams.CurrPic.PicFlags = PICTURE_FRAME;
+
+    PCODEC_VC1_PIC_PARAMS vc1PicParams  = m_vc1PicParams;
+    uint16_t              picWidthInMb  = m_picWidthInMb;
+    uint16_t              picHeightInMb = m_picHeightInMb;
+    m_vc1PicParams                      = &picParams;
+
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < opNum; i++)
     {
-        return MOS_STATUS_UNKNOWN;
+        ops[i].value = 0;
+        switch (ops[i].type)
+        {
+        case CODECHAL_DECODE_VC1_ULT_GET_BITS:
+            ops[i].status = GetBits(ops[i].bits, ops[i].value);
+            break;
+        case CODECHAL_DECODE_VC1_ULT_SKIP_BITS:
+            ops[i].status = SkipBits(ops[i].bits, ops[i].value);
+            break;
+        case CODECHAL_DECODE_VC1_ULT_NORM2:
+            m_picWidthInMb  = ops[i].widthInMb;
+            m_picHeightInMb = ops[i].heightInMb;
+            ops[i].status   = BitplaneNorm2Mode();
+            break;
+        case CODECHAL_DECODE_VC1_ULT_NORM6:
+            m_picWidthInMb  = ops[i].widthInMb;
+            m_picHeightInMb = ops[i].heightInMb;
+            ops[i].status   = BitplaneNorm6Mode();
+            break;
+        default:
+            ops[i].status = MOS_STATUS_INVALID_PARAMETER;
+            eStatus       = MOS_STATUS_INVALID_PARAMETER;
+            break;
+        }
+        ops[i].processedBitNum = m_bitstream.u32ProcessedBitNum;
     }
 
+    m_vc1PicParams  = vc1PicParams;
+    m_picWidthInMb  = picWidthInMb;
+    m_picHeightInMb = picHeightInMb;
+
     return eStatus;
 }
+#endif
 
 MOS_STATUS CodechalDecodeVc1::BitplaneNorm2Mode()
 {
@@ -1732,17 +1790,44 @@ MOS_STATUS CodechalDecodeVc1::BitplaneNorm2Mode()
         count--;
     }
 
-    for (uint32_t i = 0; i < count / 2; i++)
+    // Each pair is coded as 0, 11, 100 or 101, so the code length is given by the next 3 bits
+    static const uint8_t codeLength[8] = { 1, 1, 1, 1, 3, 3, 2, 2 };
+
+    uint32_t pairs = count / 2;
+    while (pairs > 0)
     {
-        CODECHAL_DECODE_CHK_STATUS_RETURN(GetBits(1, value));
-        if (value)
+        if (m_bitstream.iValueBits < 3)
+        {
+            FillBitstreamValue();
+        }
+
+        if (m_bitstream.iValueBits < 3)
         {
+            // Less than 3 bits left in the bitstream
             CODECHAL_DECODE_CHK_STATUS_RETURN(GetBits(1, value));
-            if (value == 0)
+            if (value)
             {
                 CODECHAL_DECODE_CHK_STATUS_RETURN(GetBits(1, value));
+                if (value == 0)
+                {
+                    CODECHAL_DECODE_CHK_STATUS_RETURN(GetBits(1, value));
+                }
             }
+            pairs--;
+            continue;
         }
+
+        // Decode as many pairs as the bit window holds, then consume them at once
+        uint64_t window   = m_bitstream.u64Value;
+        uint32_t bitsLeft = (uint32_t)m_bitstream.iValueBits;
+        uint32_t bitsUsed = 0;
+        while (pairs > 0 && bitsUsed + 3 <= bitsLeft)
+        {
+            bitsUsed += codeLength[(window << bitsUsed) >> 61];
+            pairs--;
+        }
+
+        CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(bitsUsed, value));
     }
 
     return eStatus;
@@ -1759,6 +1844,8 @@ MOS_STATUS CodechalDecodeVc1::BitplaneNorm6Mode()
         frameFieldHeightInMb);
     uint16_t frameFieldWidthInMb = m_picWidthInMb;
 
+    static const CodechalDecodeVc1VlcLengthTable tileCodeLength(CODECHAL_DECODE_VC1_VldCode3x2Or2x3TilesTable);
+
     bool is2x3Tiled = (0 != frameFieldWidthInMb % 3) && (0 == frameFieldHeightInMb % 3);
 
     uint32_t heightInTiles, widthInTiles;
@@ -1773,7 +1860,7 @@ MOS_STATUS CodechalDecodeVc1::BitplaneNorm6Mode()
         {
             for (uint32_t i = 0; i < widthInTiles; i++)
             {
-                CODECHAL_DECODE_CHK_STATUS_RETURN(GetVLC(CODECHAL_DECODE_VC1_VldCode3x2Or2x3TilesTable, value));
+                CODECHAL_DECODE_CHK_STATUS_RETURN(SkipTileCode(tileCodeLength.m_length));
             }
         }
 
@@ -1789,7 +1876,7 @@ MOS_STATUS CodechalDecodeVc1::BitplaneNorm6Mode()
         {
             for (uint32_t i = 0; i < widthInTiles; i++)
             {
-                CODECHAL_DECODE_CHK_STATUS_RETURN(GetVLC(CODECHAL_DECODE_VC1_VldCode3x2Or2x3TilesTable, value));
+                CODECHAL_DECODE_CHK_STATUS_RETURN(SkipTileCode(tileCodeLength.m_length));
             }
         }
 
@@ -1804,8 +1891,7 @@ MOS_STATUS CodechalDecodeVc1::BitplaneNorm6Mode()
 
         if (value)
         {
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipWords(frameFieldHeightInMb >> 4, value));
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(frameFieldHeightInMb & 0xF, value));
+            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(frameFieldHeightInMb, value));
         }
     }
 
@@ -1816,9 +1902,7 @@ MOS_STATUS CodechalDecodeVc1::BitplaneNorm6Mode()
 
         if (value)
         {
-            uint32_t skipBits = frameFieldWidthInMb - residualX;
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipWords(skipBits >> 4, value));
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(skipBits & 0xF, value));
+            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(frameFieldWidthInMb - residualX, value));
         }
     }
 
@@ -1843,8 +1927,7 @@ MOS_STATUS CodechalDecodeVc1::BitplaneRowskipMode()
 
         if (value)
         {
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipWords(frameFieldWidthInMb >> 4, value));
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(frameFieldWidthInMb & 0xF, value));
+            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(frameFieldWidthInMb, value));
         }
     }
 
@@ -1871,8 +1954,7 @@ MOS_STATUS CodechalDecodeVc1::BitplaneColskipMode()
 
         if (value)
         {
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipWords(meFieldHeightInMb >> 4, value));
-            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(meFieldHeightInMb & 0xF, value));
+            CODECHAL_DECODE_CHK_STATUS_RETURN(SkipBits(meFieldHeightInMb, value));
         }
     }
 
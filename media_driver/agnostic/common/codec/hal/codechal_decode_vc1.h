@@ -66,7 +66,7 @@
 //! \def CODECHAL_DECODE_VC1_BITSTRM_BUF_LEN
 //! Bitstream Buffer Length
 //!
-#define CODECHAL_DECODE_VC1_BITSTRM_BUF_LEN             8
+#define CODECHAL_DECODE_VC1_BITSTRM_BUF_LEN             256
 
 //!
 //! \def CODECHAL_DECODE_VC1_STUFFING_BYTES
@@ -155,15 +155,41 @@ typedef struct _CODECHAL_DECODE_VC1_BITSTREAM
     uint8_t*    pOriginalBufferEnd;                                   // pointer to the end of the original uncapsuted bitstream
     uint32_t    u32ZeroNum;                                           // number of continuous zeros before the current bype.
     uint32_t    u32ProcessedBitNum;                                   // number of bits being processed from initiation
-    uint8_t     CacheBuffer[CODECHAL_DECODE_VC1_BITSTRM_BUF_LEN + 4]; // cache buffer of uncapsuted raw bitstream
-    uint32_t*   pu32Cache;                                            // pointer to the cache buffer
-    uint32_t*   pu32CacheEnd;                                         // pointer to the updating end of the cache buffer
-    uint32_t*   pu32CacheDataEnd;                                     // pointer to the last valid uint32_t of the cache buffer
-    int32_t     iBitOffset;                                           // offset = 32 is the MSB, offset = 1 is the LSB.
-    int32_t     iBitOffsetEnd;                                        // bit offset of the last valid uint32_t
+    uint8_t     CacheBuffer[CODECHAL_DECODE_VC1_BITSTRM_BUF_LEN];     // cache buffer of uncapsuted raw bitstream
+    uint8_t*    pu8Cache;                                             // pointer to the next unread byte of the cache buffer
+    uint8_t*    pu8CacheEnd;                                          // pointer to the end of valid bytes of the cache buffer
+    uint64_t    u64Value;                                             // bit window, the next bit to read is the MSB
+    int32_t     iValueBits;                                           // number of valid bits in the bit window
     bool        bIsEBDU;                                              // 1 if it is EBDU and emulation prevention bytes are present.
 } CODECHAL_DECODE_VC1_BITSTREAM, *PCODECHAL_DECODE_VC1_BITSTREAM;
 
+//!
+//! \enum   _CODECHAL_DECODE_VC1_ULT_OP_TYPE
+//! \brief  Operations of the VC1 bitstream reader run by the ULT
+//!
+typedef enum _CODECHAL_DECODE_VC1_ULT_OP_TYPE
+{
+    CODECHAL_DECODE_VC1_ULT_GET_BITS,
+    CODECHAL_DECODE_VC1_ULT_SKIP_BITS,
+    CODECHAL_DECODE_VC1_ULT_NORM2,
+    CODECHAL_DECODE_VC1_ULT_NORM6
+} CODECHAL_DECODE_VC1_ULT_OP_TYPE;
+
+//!
+//! \struct _CODECHAL_DECODE_VC1_ULT_OP
+//! \brief  Operation of the VC1 bitstream reader run by the ULT and its result
+//!
+typedef struct _CODECHAL_DECODE_VC1_ULT_OP
+{
+    CODECHAL_DECODE_VC1_ULT_OP_TYPE type;
+    uint32_t    bits;               // [in] number of bits to get or skip
+    uint16_t    widthInMb;          // [in] bitplane width of NORM2 and NORM6
+    uint16_t    heightInMb;         // [in] bitplane height of NORM2 and NORM6
+    uint32_t    value;              // [out] bits read, EOS if reading beyond the end of the bitstream
+    MOS_STATUS  status;             // [out] status of the operation
+    uint32_t    processedBitNum;    // [out] number of bits processed from the start of the bitstream
+} CODECHAL_DECODE_VC1_ULT_OP, *PCODECHAL_DECODE_VC1_ULT_OP;
+
 //!
 //! \struct _CODECHAL_DECODE_VC1_OLP_PARAMS
 //! \brief  Define variables of VC1 Olp params for hw cmd
@@ -320,6 +346,49 @@ typedef struct _CODECHAL_DECODE_VC1_KERNEL_HEADER_CM {
     CODECHAL_KERNEL_HEADER IC;
 } CODECHAL_DECODE_VC1_KERNEL_HEADER_CM, *PCODECHAL_DECODE_VC1_KERNEL_HEADER_CM;
 
+//!
+//! \class   CodechalDecodeVc1VlcLengthTable
+//! \brief   Code length of a VLC table indexed by the next max bits of the bitstream,
+//!          used to skip symbols with one lookup instead of walking the VLC table
+//!
+class CodechalDecodeVc1VlcLengthTable
+{
+public:
+    static const uint32_t m_maxBits = 13;  //!< Max code length supported
+
+    CodechalDecodeVc1VlcLengthTable(const uint32_t *table)
+    {
+        MOS_ZeroMemory(m_length, sizeof(m_length));
+
+        CODECHAL_DECODE_ASSERT(table[0] == m_maxBits);
+
+        uint32_t index = 1;
+        for (uint32_t codeLength = 1; codeLength <= table[0]; codeLength++)
+        {
+            uint32_t subtableSize = table[index++];
+            while (subtableSize--)
+            {
+                uint32_t code  = table[index];
+                uint32_t first = code << (m_maxBits - codeLength);
+                uint32_t last  = first + (1 << (m_maxBits - codeLength));
+
+                // Keep the shortest match, same as GetVLC
+                for (uint32_t i = first; i < last; i++)
+                {
+                    if (m_length[i] == 0)
+                    {
+                        m_length[i] = (uint8_t)codeLength;
+                    }
+                }
+
+                index += 2;
+            }
+        }
+    }
+
+    uint8_t m_length[1 << m_maxBits];  //!< Code length, 0 if the code is not in the VLC table
+};
+
 //*------------------------------------------------------------------------------
 //* Codec Definitions
 //*------------------------------------------------------------------------------
@@ -448,6 +517,32 @@ public:
     //!
     bool IsOlpNeeded() { return m_olpNeeded; };
 
+#if MOS_ULT_HOOKS_ENABLED
+    //!
+    //! \brief    Run bitstream reader operations on host memory, used by ULT
+    //! \details  Bitplanes are parsed as progressive frames of the size given
+    //!           by each operation, the picture state is restored afterwards
+    //! \param    [in] buffer
+    //!           Bitstream buffer
+    //! \param    [in] length
+    //!           Bitstream length in bytes
+    //! \param    [in] isEBDU
+    //!           Whether emulation prevention bytes are present
+    //! \param    [in,out] ops
+    //!           Operations to run in order, their results are returned in place
+    //! \param    [in] opNum
+    //!           Number of operations
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if all operations were run, else fail reason
+    //!
+    MOS_STATUS UltRunBitstreamOps(
+        uint8_t                     *buffer,
+        uint32_t                    length,
+        bool                        isEBDU,
+        PCODECHAL_DECODE_VC1_ULT_OP ops,
+        uint32_t                    opNum);
+#endif
+
     PCODEC_VC1_PIC_PARAMS m_vc1PicParams = nullptr;                           //!< VC1 Picture Params
     MOS_SURFACE           m_destSurface;                                      //!< Pointer to MOS_SURFACE of render surface
     PMOS_RESOURCE         m_presReferences[CODEC_MAX_NUM_REF_FRAME_NON_AVC];  //!< Reference Resources Handle list
@@ -824,6 +919,15 @@ private:
     //!
     MOS_STATUS SkipBits(uint32_t bits, uint32_t & value);
 
+    //!
+    //! \brief    Skip one Norm6 tile code from VC1 bitstream
+    //! \param    [in] codeLength
+    //!           Code length lookup table indexed by the next 13 bits
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS SkipTileCode(const uint8_t *codeLength);
+
     //!
     //! \brief    Read bits from VC1 bitstream
     //! \param    [in] bitsRead
@@ -834,11 +938,19 @@ private:
     uint32_t GetBits(uint32_t bitsRead);
 
     //!
-    //! \brief    Update VC1 bitstream memeber value
-    //! \return   uint32_t
-    //!           EOS if reaching end of stream, else bitstream value
+    //! \brief    Refill the VC1 bitstream cache buffer
+    //! \details  Copy the next bytes of the original bitstream to the cache buffer and
+    //!           remove emulation prevention bytes for EBDU. The bitstream is truncated
+    //!           at the first invalid code, so reading beyond it returns EOS
+    //! \return   void
     //!
-    uint32_t UpdateBitstreamBuffer();
+    void UpdateBitstreamBuffer();
+
+    //!
+    //! \brief    Refill the VC1 bitstream 64-bit bit window from the cache buffer
+    //! \return   void
+    //!
+    void FillBitstreamValue();
 
     //!
     //! \brief    Get VLC from VC1 bitstream according to VLC Table
@@ -854,12 +966,13 @@ private:
     //! \param    [in] bitsRead
     //!           Number of bits to be read
     //! \return   uint32_t
-    //!           EOS if reaching end of stream, else bitstream value
+    //!           Bitstream value, bits beyond the end of stream are read as 0
     //!
     uint32_t PeekBits(uint32_t bitsRead);
 
     //!
     //! \brief    Skip bits from VC1 bitstream
+    //! \details  Any number of bits can be skipped, whole bytes are skipped in the cache buffer
     //! \param    [in] bits
     //!           Number of bits to be skipped
     //! \return   uint32_t
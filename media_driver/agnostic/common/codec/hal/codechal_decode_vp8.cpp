@@ -54,17 +54,17 @@ void Vp8EntropyState::DecodeFill()
         while (shift >= loopEnd)
         {
             m_count += CHAR_BIT;
-            m_value |= (uint32_t)*m_buffer << shift;
+            m_value |= (uint64_t)*m_buffer << shift;
             ++m_buffer;
             shift -= CHAR_BIT;
         }
     }
 }
 
-uint32_t Vp8EntropyState::DecodeBool(int32_t probability)
+uint32_t Vp8EntropyState::DecodeBoolNoFill(int32_t probability)
 {
     uint32_t split     = 1 + (((m_range - 1) * probability) >> 8);
-    uint32_t bigSplit  = (uint32_t)split << (m_bdValueSize - 8);
+    uint64_t bigSplit  = (uint64_t)split << (m_bdValueSize - 8);
     uint32_t origRange = m_range;
     m_range            = split;
 
@@ -81,6 +81,13 @@ uint32_t Vp8EntropyState::DecodeBool(int32_t probability)
     m_value <<= shift;
     m_count -= shift;
 
+    return bit;
+}
+
+uint32_t Vp8EntropyState::DecodeBool(int32_t probability)
+{
+    uint32_t bit = DecodeBoolNoFill(probability);
+
     if (m_count < 0)
     {
         DecodeFill();
@@ -93,14 +100,55 @@ int32_t Vp8EntropyState::DecodeValue(int32_t bits)
 {
     int32_t retValue = 0;
 
+    if (m_count >= bits)
+    {
+        // Half probability bools normalize by at most 1 bit each, no refill needed
+        for (int32_t iBit = bits - 1; iBit >= 0; iBit--)
+        {
+            retValue |= (DecodeBoolNoFill(m_probHalf) << iBit);
+        }
+        return retValue;
+    }
+
     for (int32_t iBit = bits - 1; iBit >= 0; iBit--)
     {
-        retValue |= (DecodeBool(0x80) << iBit);
+        retValue |= (DecodeBool(m_probHalf) << iBit);
     }
 
     return retValue;
 }
 
+void Vp8EntropyState::ReadCoefProbs()
+{
+    const uint8_t *upProb   = &CoefUpdateProbs[0][0][0][0];
+    uint8_t       *prob     = &m_frameHead->FrameContext.CoefProbs[0][0][0][0];
+    uint8_t *const stopProb = prob + VP8_BLOCK_TYPES * VP8_COEF_BANDS * VP8_PREV_COEF_CONTEXTS * VP8_ENTROPY_NODES;
+
+    do
+    {
+        // Update flag takes at most 7 bits and the 8-bit literal at most 8 bits
+        if (m_count < m_maxCoefBits)
+        {
+            DecodeFill();
+        }
+
+        if (DecodeBoolNoFill(*upProb++))
+        {
+            uint32_t value = 0;
+            for (int32_t iBit = 7; iBit >= 0; iBit--)
+            {
+                value |= (DecodeBoolNoFill(m_probHalf) << iBit);
+            }
+            *prob = (uint8_t)value;
+        }
+    } while (++prob < stopProb);
+
+    if (m_count < 0)
+    {
+        DecodeFill();
+    }
+}
+
 void Vp8EntropyState::ParseFrameHeadInit()
 {
     if (m_frameHead->iFrameType == m_keyFrame)
@@ -552,18 +600,7 @@ MOS_STATUS Vp8EntropyState::ParseFrameHead(PCODEC_VP8_PIC_PARAMS vp8PicParams)
         m_frameHead->iRefreshLastFrame = false;
     }
 
-    for (int32_t i = 0; i < VP8_BLOCK_TYPES; i++)
-        for (int32_t j = 0; j < VP8_COEF_BANDS; j++)
-            for (int32_t k = 0; k < VP8_PREV_COEF_CONTEXTS; k++)
-                for (int32_t l = 0; l < VP8_ENTROPY_NODES; l++)
-                {
-                    uint8_t *const p = m_frameHead->FrameContext.CoefProbs[i][j][k] + l;
-
-                    if (DecodeBool(CoefUpdateProbs[i][j][k][l]))
-                    {
-                        *p = (uint8_t)DecodeValue(8);
-                    }
-                }
+    ReadCoefProbs();
 
     m_frameHead->iMbNoCoeffSkip = (int32_t)DecodeBool(m_probHalf);
     m_frameHead->iProbSkipFalse = 0;
@@ -613,7 +650,7 @@ MOS_STATUS Vp8EntropyState::ParseFrameHead(PCODEC_VP8_PIC_PARAMS vp8PicParams)
     }
 
     vp8PicParams->ucP0EntropyCount = 8 - (m_count & 0x07);
-    vp8PicParams->ucP0EntropyValue = (uint8_t)(m_value >> 24);
+    vp8PicParams->ucP0EntropyValue = (uint8_t)(m_value >> (m_bdValueSize - 8));
     vp8PicParams->uiP0EntropyRange = m_range;
 
     uint32_t firstPartitionAndUncompSize;
@@ -640,7 +677,8 @@ MOS_STATUS Vp8EntropyState::ParseFrameHead(PCODEC_VP8_PIC_PARAMS vp8PicParams)
         }
     }
 
-    uint32_t offsetCounter                      = ((m_count & 0x18) >> 3) + (((m_count & 0x07) != 0) ? 1 : 0);
+    // Whole and partial bytes still buffered in the entropy value, m_lotsOfBits is masked out
+    uint32_t offsetCounter                      = ((m_count & 0x38) >> 3) + (((m_count & 0x07) != 0) ? 1 : 0);
     vp8PicParams->uiFirstMbByteOffset           = (uint32_t)(m_buffer - m_bitstreamBuffer) - offsetCounter;
     vp8PicParams->uiPartitionSize[0]            = firstPartitionAndUncompSize - (uint32_t)(m_buffer - m_bitstreamBuffer) + offsetCounter;
     vp8PicParams->uiPartitionSize[partitionNum] = m_bitstreamBufferSize - firstPartitionAndUncompSize - (partitionNum - 1) * 3 - partitionSizeSum;
@@ -687,6 +725,35 @@ void Vp8EntropyState::Initialize(
     }
 }
 
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to check the frame head parsing on host
+    //!           memory, frame head and pic params are initialized by the caller
+    //!
+    MOS_FUNC_EXPORT MOS_STATUS CodecHalDecodeVp8_UltParseFrameHead(
+        uint8_t                         *bitstreamBuffer,
+        uint32_t                        bitstreamBufferSize,
+        PCODECHAL_DECODE_VP8_FRAME_HEAD vp8FrameHead,
+        PCODEC_VP8_PIC_PARAMS           vp8PicParams)
+    {
+        CODECHAL_DECODE_CHK_NULL_RETURN(bitstreamBuffer);
+        CODECHAL_DECODE_CHK_NULL_RETURN(vp8FrameHead);
+        CODECHAL_DECODE_CHK_NULL_RETURN(vp8PicParams);
+
+        Vp8EntropyState entropyState;
+        entropyState.Initialize(vp8FrameHead, bitstreamBuffer, bitstreamBufferSize);
+        return entropyState.ParseFrameHead(vp8PicParams);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 MOS_STATUS CodechalDecodeVp8::ParseFrameHead(uint8_t* bitstreamBuffer, uint32_t bitstreamBufferSize)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
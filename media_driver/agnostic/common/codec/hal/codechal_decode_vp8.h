@@ -274,9 +274,10 @@ class Vp8EntropyState
 public:
     const uint8_t  m_keyFrame    = 0;                                        //!< VP8 Key Frame Flag
     const uint8_t  m_interFrame  = 1;                                        //!< VP8 Inter Frame Flag
-    const uint32_t m_bdValueSize = ((uint32_t)sizeof(uint32_t) * CHAR_BIT);  // VP8 BD Value Size
+    const uint32_t m_bdValueSize = ((uint32_t)sizeof(uint64_t) * CHAR_BIT);  // VP8 BD Value Size
     const uint32_t m_lotsOfBits  = 0x40000000;                               //!< Offset for parsing frame head
     const uint8_t  m_probHalf    = 128;                                      //!< VP8 Half Probability
+    const int32_t  m_maxCoefBits = 15;                                       //!< Max bits consumed by one coef prob update
 
     //!
     //! \brief    Constructor
@@ -379,6 +380,17 @@ private:
     //!
     uint32_t DecodeBool(int32_t probability);
 
+    //!
+    //! \brief    Decode one bool without refilling the entropy value
+    //! \details  Caller must make sure enough bits are buffered, a single bool
+    //!           consumes at most 7 bits and a bool with half probability at most 1 bit
+    //! \param    [in] probability
+    //!           Probability to do entropy decode
+    //! \return   uint32_t
+    //!           return 1 if entropy decode value meets the requirement of probability, else 0
+    //!
+    uint32_t DecodeBoolNoFill(int32_t probability);
+
     //!
     //! \brief    Update Entropy Decode State according to Bits Number
     //! \param    [in] bits
@@ -388,6 +400,14 @@ private:
     //!
     int32_t DecodeValue(int32_t bits);
 
+    //!
+    //! \brief    Update Coefficient Probs in Frame Head
+    //! \details  Parse bitstream to update the coefficient probability tree,
+    //!           refill is done once per tree node instead of once per bool
+    //! \return   void
+    //!
+    void ReadCoefProbs();
+
     //!
     //! \brief    Update Loop Filter Info in VP8 Frame Header
     //! \param    [in] defaultFilterLvl
@@ -497,7 +517,7 @@ private:
     const uint8_t *m_bufferEnd;  //!< Pointer to Data Buffer End
     const uint8_t *m_buffer;     //!< Pointer to Data Buffer
     int32_t        m_count;      //!< Bits Count for Bitstream Buffer
-    uint32_t       m_value;      //!< Entropy Value
+    uint64_t       m_value;      //!< Entropy Value
     uint32_t       m_range;      //!< Entropy Range
 };
 
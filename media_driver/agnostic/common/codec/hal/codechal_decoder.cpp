@@ -1034,6 +1034,22 @@ MOS_STATUS CodechalDecode::Execute(void *params)
         m_osInterface,
         decodeParams->m_destSurface));
 
+    // Destination is overwritten, decoders which format it record the new content tag
+    m_destContentTag = m_osInterface->pfnGetResourceContentTag(m_osInterface, &decodeParams->m_destSurface->OsResource);
+    m_osInterface->pfnSetResourceContentTag(m_osInterface, &decodeParams->m_destSurface->OsResource, 0);
+
+#ifdef _DECODE_PROCESSING_SUPPORTED
+    // So is the SFC output
+    if (decodeParams->m_procParams != nullptr)
+    {
+        PCODECHAL_DECODE_PROCESSING_PARAMS procParams = (PCODECHAL_DECODE_PROCESSING_PARAMS)decodeParams->m_procParams;
+        if (procParams->pOutputSurface != nullptr)
+        {
+            m_osInterface->pfnSetResourceContentTag(m_osInterface, &procParams->pOutputSurface->OsResource, 0);
+        }
+    }
+#endif
+
     if(!m_isHybridDecoder)
     {
         CODECHAL_DECODE_CHK_STATUS_RETURN(m_osInterface->pfnSetGpuContext(
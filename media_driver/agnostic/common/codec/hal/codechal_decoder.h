@@ -1052,6 +1052,8 @@ protected:
     uint32_t                    m_width             = 0;
     //! \brief Picture Height
     uint32_t                    m_height            = 0;
+    //! \brief Content tag of the destination surface before the current picture
+    uint32_t                    m_destContentTag    = 0;
 
     //! \brief Picture level command buffer size is required
     uint32_t                    m_commandBufferSizeNeeded = 0;
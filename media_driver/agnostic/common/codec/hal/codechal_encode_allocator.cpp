@@ -251,6 +251,22 @@ uint16_t CodechalEncodeAllocator::GetResourceID(uint64_t resourceTag, Match leve
     return m_typeID;
 }
 
+uint64_t CodechalEncodeAllocator::GetPoolDesc(uint64_t resourceTag, MOS_FORMAT format)
+{
+    // decode the tag locally, m_tag holds the resource being allocated
+    uint16_t typeID = (uint16_t)resourceTag;
+    ResourceName name = (ResourceName)(typeID & ((1 << 11) - 1) & ~m_bufIndexMask);
+
+    // tracked buffers are scratch of identical size for every instance at the same resolution
+    if (!IsTrackedBuffer(name) || (typeID >> 14 & 3) == allocatorBatch)
+    {
+        return 0;
+    }
+
+    // allocator format only tells buffer from surface, MOS format tells NV12 from YUY2
+    return (resourceTag & m_poolDescMask) | ((uint64_t)format & 0x3FFF);
+}
+
 CodechalEncodeAllocator::CodechalEncodeAllocator(CodechalEncoderState* encoder)
     : CodechalAllocator(encoder->GetOsInterface())
 {
@@ -261,4 +277,6 @@ CodechalEncodeAllocator::CodechalEncodeAllocator(CodechalEncoderState* encoder)
 
 CodechalEncodeAllocator::~CodechalEncodeAllocator()
 {
+    // release here while GetPoolDesc() still resolves to this class
+    ReleaseAllResources();
 }
@@ -135,11 +135,13 @@ private:
 
     uint16_t SetResourceID(uint32_t codec, ResourceName name, uint8_t index);
     virtual uint16_t GetResourceID(uint64_t resourceTag, Match level) override;
+    virtual uint64_t GetPoolDesc(uint64_t resourceTag, MOS_FORMAT format) override;
 
     CodechalEncoderState*           m_encoder = nullptr;                //!< Pointer to ENCODER base class
 
     static const uint16_t           m_bufIndexMask = (1 << 5) - 1;
     static const uint16_t           m_bufNameMask = (1 << 14) - 1;
+    static const uint64_t           m_poolDescMask = 0xFFFFFFFF007FC000;    //!< type, format, tile and size bits of the tag
 
     union
     {
@@ -6789,6 +6789,13 @@ MOS_STATUS CodechalEncodeAvcEnc::ExecuteSliceLevel()
     packSlcHeaderParams.NalUnitType = m_nalUnitType;
     packSlcHeaderParams.wPictureCodingType = m_pictureCodingType;
     packSlcHeaderParams.bVdencEnabled = false;
+    packSlcHeaderParams.pSliceHeaderTemplate = &m_sliceHeaderTemplate;
+
+    // Slices of a new frame do not share header fields with the previous one
+    if (m_currPass == 0)
+    {
+        m_sliceHeaderTemplate.bValid = false;
+    }
 
     MHW_VDBOX_AVC_SLICE_STATE sliceState;
     MOS_ZeroMemory(&sliceState, sizeof(sliceState));
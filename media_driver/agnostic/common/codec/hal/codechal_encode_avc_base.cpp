@@ -562,32 +562,6 @@ MOS_STATUS CodecHalAvcEncode_GetProfileLevelMaxFrameSize(
     return eStatus;
 }
 
-static void PutVLCCode(BSBuffer *bsbuffer, uint32_t code)
-{
-    uint8_t   leadingZeroBits, bitcount;
-    uint32_t  code1, bits;
-
-    code1 = code + 1;
-    bitcount = 0;
-    while (code1)
-    {
-        code1 >>= 1;
-        bitcount++;
-    }
-
-    if (bitcount == 1)
-    {
-        PutBit(bsbuffer, 1);
-    }
-    else
-    {
-        leadingZeroBits = bitcount - 1;
-        bits = code + 1 - (1 << leadingZeroBits);
-        PutBits(bsbuffer, 1, leadingZeroBits + 1);
-        PutBits(bsbuffer, bits, leadingZeroBits);
-    }
-}
-
 //!
 //! \brief    Pack HRD data
 //!
@@ -1720,8 +1694,17 @@ uint16_t CodecHalAvcEncode_GetMaxNumSlicesAllowed(
     return maxAllowedNumSlices;
 }
 
-//Pack Slice Header
-MOS_STATUS CodecHalAvcEncode_PackSliceHeader(
+//!
+//! \brief    Pack the slice header fields from slice_type to cabac_init_idc
+//! \details  These fields are normally the same for all slices of a frame.
+//!
+//! \param    [in] params
+//!           Pointer to codechal encode Avc pack slice header parameter
+//!
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if call success, else fail reason
+//!
+static MOS_STATUS CodecHal_PackSliceHeader_SharedFields(
     PCODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS    params)
 {
     PCODEC_AVC_ENCODE_SEQUENCE_PARAMS      seqParams;
@@ -1733,12 +1716,6 @@ MOS_STATUS CodecHalAvcEncode_PackSliceHeader(
     bool                                   ref;
     MOS_STATUS                             eStatus = MOS_STATUS_SUCCESS;
 
-    CODECHAL_ENCODE_CHK_NULL_RETURN(params);
-    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pSeqParams);
-    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pPicParams);
-    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pAvcSliceParams);
-    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pBsBuffer);
-
     slcParams  = params->pAvcSliceParams;
     picParams  = params->pPicParams;
     seqParams  = params->pSeqParams;
@@ -1747,24 +1724,6 @@ MOS_STATUS CodecHalAvcEncode_PackSliceHeader(
     nalType     = params->NalUnitType;
     ref        = params->ppRefList[params->CurrReconPic.FrameIdx]->bUsedAsRef;
 
-    // Make slice header uint8_t aligned
-    while (bsbuffer->BitOffset)
-    {
-        PutBit(bsbuffer, 0);
-    }
-
-    // zero byte shall exist when the byte stream NAL unit syntax structure contains the first
-    // NAL unit of an access unit in decoding order, as specified by subclause 7.4.1.2.3.
-    // VDEnc Slice header packing handled by PAK does not need the 0 byte inserted
-    if (params->UserFlags.bDisableAcceleratorHeaderPacking && (!params->bVdencEnabled))
-    {
-        *bsbuffer->pCurrent = 0;
-        bsbuffer->pCurrent++;
-    }
-
-    SetNalUnit(&bsbuffer->pCurrent, (uint8_t)ref, nalType);
-
-    PutVLCCode(bsbuffer, slcParams->first_mb_in_slice);
     PutVLCCode(bsbuffer, slcParams->slice_type);
     PutVLCCode(bsbuffer, slcParams->pic_parameter_set_id);
 
@@ -1857,6 +1816,188 @@ MOS_STATUS CodecHalAvcEncode_PackSliceHeader(
         PutVLCCode(bsbuffer, slcParams->cabac_init_idc);
     }
 
+    return eStatus;
+}
+
+//!
+//! \brief    Check whether the slice header template matches the slice
+//! \details  Fields packed per slice and fields not in the header are left out
+//!           of the comparison.
+//!
+//! \param    [in] params
+//!           Pointer to codechal encode Avc pack slice header parameter
+//!
+//! \return   bool
+//!           true if the template bits can be used for the slice
+//!
+static bool CodecHal_PackSliceHeader_MatchTemplate(
+    PCODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS    params)
+{
+    PCODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE  sliceHeaderTemplate = params->pSliceHeaderTemplate;
+    PCODEC_AVC_ENCODE_SLICE_PARAMS              slcParams           = params->pAvcSliceParams;
+    PCODEC_AVC_ENCODE_SLICE_PARAMS              key                 = &sliceHeaderTemplate->SliceParams;
+
+    if (!sliceHeaderTemplate->bValid                                         ||
+        sliceHeaderTemplate->NalUnitType        != params->NalUnitType        ||
+        sliceHeaderTemplate->wPictureCodingType != params->wPictureCodingType ||
+        sliceHeaderTemplate->pPicParams         != params->pPicParams         ||
+        sliceHeaderTemplate->pSeqParams         != params->pSeqParams)
+    {
+        return false;
+    }
+
+    key->NumMbsForSlice                 = slcParams->NumMbsForSlice;
+    key->first_mb_in_slice              = slcParams->first_mb_in_slice;
+    key->slice_qp_delta                 = slcParams->slice_qp_delta;
+    key->sp_for_switch_flag             = slcParams->sp_for_switch_flag;
+    key->slice_qs_delta                 = slcParams->slice_qs_delta;
+    key->disable_deblocking_filter_idc  = slcParams->disable_deblocking_filter_idc;
+    key->slice_alpha_c0_offset_div2     = slcParams->slice_alpha_c0_offset_div2;
+    key->slice_beta_offset_div2         = slcParams->slice_beta_offset_div2;
+    key->slice_id                       = slcParams->slice_id;
+
+    return memcmp(key, slcParams, sizeof(*key)) == 0;
+}
+
+//!
+//! \brief    Save the shared slice header fields just packed into the template
+//!
+//! \param    [in] params
+//!           Pointer to codechal encode Avc pack slice header parameter
+//! \param    [in] start
+//!           Byte of the bitstream holding slice_type
+//! \param    [in] startBitOffset
+//!           Bit offset of slice_type in the start byte
+//!
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if call success, else fail reason
+//!
+static MOS_STATUS CodecHal_PackSliceHeader_SaveTemplate(
+    PCODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS    params,
+    uint8_t                                        *start,
+    uint32_t                                       startBitOffset)
+{
+    PCODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE  sliceHeaderTemplate = params->pSliceHeaderTemplate;
+    PCODEC_AVC_ENCODE_SLICE_PARAMS              slcParams           = params->pAvcSliceParams;
+    PBSBuffer                                   bsbuffer            = params->pBsBuffer;
+    BSBuffer                                    templateBuffer;
+    uint32_t                                    bitSize;
+
+    bitSize = (uint32_t)(bsbuffer->pCurrent - start) * 8 + bsbuffer->BitOffset - startBitOffset;
+    if ((bitSize >> 3) + 1 > sizeof(sliceHeaderTemplate->Data))
+    {
+        // Long prediction weight tables are packed per slice
+        return MOS_STATUS_SUCCESS;
+    }
+
+    MOS_ZeroMemory(&templateBuffer, sizeof(templateBuffer));
+    templateBuffer.pBase      = sliceHeaderTemplate->Data;
+    templateBuffer.pCurrent   = sliceHeaderTemplate->Data;
+    templateBuffer.BufferSize = sizeof(sliceHeaderTemplate->Data);
+    sliceHeaderTemplate->Data[0] = 0;
+    PutBitString(&templateBuffer, start, startBitOffset, bitSize);
+
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(
+        sliceHeaderTemplate->PicOrder,
+        sizeof(sliceHeaderTemplate->PicOrder),
+        slcParams->PicOrder,
+        sizeof(slcParams->PicOrder)));
+    sliceHeaderTemplate->NumReorder                  = slcParams->NumReorder;
+    sliceHeaderTemplate->RefPicListReorderingFlag[0] = slcParams->ref_pic_list_reordering_flag_l0;
+    sliceHeaderTemplate->RefPicListReorderingFlag[1] = slcParams->ref_pic_list_reordering_flag_l1;
+    sliceHeaderTemplate->BitSize                     = bitSize;
+    sliceHeaderTemplate->bValid                      = true;
+
+    return MOS_STATUS_SUCCESS;
+}
+
+//Pack Slice Header
+MOS_STATUS CodecHalAvcEncode_PackSliceHeader(
+    PCODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS    params)
+{
+    PCODEC_AVC_ENCODE_PIC_PARAMS           picParams;
+    PCODEC_AVC_ENCODE_SLICE_PARAMS         slcParams;
+    PBSBuffer                              bsbuffer;
+    PCODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE sliceHeaderTemplate;
+    uint8_t                                sliceType;
+    CODECHAL_ENCODE_AVC_NAL_UNIT_TYPE      nalType;
+    bool                                   ref;
+    MOS_STATUS                             eStatus = MOS_STATUS_SUCCESS;
+
+    CODECHAL_ENCODE_CHK_NULL_RETURN(params);
+    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pSeqParams);
+    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pPicParams);
+    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pAvcSliceParams);
+    CODECHAL_ENCODE_CHK_NULL_RETURN(params->pBsBuffer);
+
+    slcParams  = params->pAvcSliceParams;
+    picParams  = params->pPicParams;
+    bsbuffer   = params->pBsBuffer;
+    sliceType = Slice_Type[slcParams->slice_type];
+    nalType     = params->NalUnitType;
+    ref        = params->ppRefList[params->CurrReconPic.FrameIdx]->bUsedAsRef;
+
+    // Make slice header uint8_t aligned
+    while (bsbuffer->BitOffset)
+    {
+        PutBit(bsbuffer, 0);
+    }
+
+    // zero byte shall exist when the byte stream NAL unit syntax structure contains the first
+    // NAL unit of an access unit in decoding order, as specified by subclause 7.4.1.2.3.
+    // VDEnc Slice header packing handled by PAK does not need the 0 byte inserted
+    if (params->UserFlags.bDisableAcceleratorHeaderPacking && (!params->bVdencEnabled))
+    {
+        *bsbuffer->pCurrent = 0;
+        bsbuffer->pCurrent++;
+    }
+
+    SetNalUnit(&bsbuffer->pCurrent, (uint8_t)ref, nalType);
+
+    PutVLCCode(bsbuffer, slcParams->first_mb_in_slice);
+
+    sliceHeaderTemplate = params->pSliceHeaderTemplate;
+    if (sliceHeaderTemplate && CodecHal_PackSliceHeader_MatchTemplate(params))
+    {
+        // Same fields as the previous slice, reuse its bits and reference list reordering
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(
+            slcParams->PicOrder,
+            sizeof(slcParams->PicOrder),
+            sliceHeaderTemplate->PicOrder,
+            sizeof(sliceHeaderTemplate->PicOrder)));
+        slcParams->NumReorder                      = sliceHeaderTemplate->NumReorder;
+        slcParams->ref_pic_list_reordering_flag_l0 = sliceHeaderTemplate->RefPicListReorderingFlag[0];
+        slcParams->ref_pic_list_reordering_flag_l1 = sliceHeaderTemplate->RefPicListReorderingFlag[1];
+
+        PutBitString(bsbuffer, sliceHeaderTemplate->Data, 0, sliceHeaderTemplate->BitSize);
+    }
+    else
+    {
+        uint8_t *templateStart          = bsbuffer->pCurrent;
+        uint32_t templateStartBitOffset = bsbuffer->BitOffset;
+
+        if (sliceHeaderTemplate)
+        {
+            // Key on the slice parameters before packing updates the reference lists
+            sliceHeaderTemplate->bValid             = false;
+            sliceHeaderTemplate->NalUnitType        = params->NalUnitType;
+            sliceHeaderTemplate->wPictureCodingType = params->wPictureCodingType;
+            sliceHeaderTemplate->pPicParams         = params->pPicParams;
+            sliceHeaderTemplate->pSeqParams         = params->pSeqParams;
+            sliceHeaderTemplate->SliceParams        = *slcParams;
+        }
+
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(CodecHal_PackSliceHeader_SharedFields(params));
+
+        if (sliceHeaderTemplate)
+        {
+            CODECHAL_ENCODE_CHK_STATUS_RETURN(CodecHal_PackSliceHeader_SaveTemplate(
+                params,
+                templateStart,
+                templateStartBitOffset));
+        }
+    }
+
     PutVLCCode(bsbuffer, SIGNED(slcParams->slice_qp_delta));
 
     if (sliceType == SLICE_SP || sliceType == SLICE_SI)
@@ -1886,6 +2027,25 @@ MOS_STATUS CodecHalAvcEncode_PackSliceHeader(
     return eStatus;
 }
 
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to check slice header packing against the template
+    //!
+    MOS_FUNC_EXPORT MOS_STATUS CodecHalAvcEncode_UltPackSliceHeader(
+        PCODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS    params)
+    {
+        return CodecHalAvcEncode_PackSliceHeader(params);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 MOS_STATUS CodechalEncodeAvcBase::InitMmcState()
 {
 #ifdef _MMC_SUPPORTED
@@ -1909,6 +2069,7 @@ CodechalEncodeAvcBase::CodechalEncodeAvcBase(
     MOS_ZeroMemory(m_refList, CODEC_AVC_NUM_UNCOMPRESSED_SURFACE * sizeof(PCODEC_REF_LIST));
     MOS_ZeroMemory(m_avcFrameStoreID, CODEC_AVC_MAX_NUM_REF_FRAME * sizeof(CODEC_AVC_FRAME_STORE_ID));
     MOS_ZeroMemory(&m_nalUnitType, sizeof(CODECHAL_ENCODE_AVC_NAL_UNIT_TYPE));
+    MOS_ZeroMemory(&m_sliceHeaderTemplate, sizeof(m_sliceHeaderTemplate));
     MOS_ZeroMemory(&m_trellisQuantParams, sizeof(CODECHAL_ENCODE_AVC_TQ_PARAMS));
     MOS_ZeroMemory(m_distScaleFactorList0, 2*CODEC_AVC_MAX_NUM_REF_FRAME *sizeof(uint32_t));
     MOS_ZeroMemory(m_batchBufferForVdencImgStat, CODECHAL_ENCODE_RECYCLED_BUFFER_NUM * sizeof(MHW_BATCH_BUFFER));
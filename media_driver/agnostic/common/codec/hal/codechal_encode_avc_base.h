@@ -1160,6 +1160,32 @@ typedef struct _CODECHAL_ENCODE_AVC_PACK_PIC_HEADER_PARAMS
     bool                                   *pbNewSeqHeader;
 } CODECHAL_ENCODE_AVC_PACK_PIC_HEADER_PARAMS, *PCODECHAL_ENCODE_AVC_PACK_PIC_HEADER_PARAMS;
 
+#define CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE_SIZE     2048
+
+//!
+//! \struct    CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE
+//! \brief     Packed slice header fields shared by the slices of a frame
+//! \details   Holds slice_type up to cabac_init_idc of the last packed slice, with
+//!            the slice parameters they were packed from. A following slice with
+//!            the same parameters copies the bits instead of packing them again,
+//!            only first_mb_in_slice, slice_qp_delta and the deblocking fields are
+//!            packed per slice.
+//!
+typedef struct _CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE
+{
+    bool                                    bValid;
+    CODECHAL_ENCODE_AVC_NAL_UNIT_TYPE       NalUnitType;
+    uint16_t                                wPictureCodingType;
+    PCODEC_AVC_ENCODE_PIC_PARAMS            pPicParams;
+    PCODEC_AVC_ENCODE_SEQUENCE_PARAMS       pSeqParams;
+    CODEC_AVC_ENCODE_SLICE_PARAMS           SliceParams;        // slice parameters before packing
+    CODEC_PIC_REORDER                       PicOrder[2][32];    // reference lists after reordering
+    uint8_t                                 NumReorder;
+    uint8_t                                 RefPicListReorderingFlag[2];
+    uint32_t                                BitSize;
+    uint8_t                                 Data[CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE_SIZE];
+} CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE, *PCODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE;
+
 typedef struct _CODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS
 {
     PBSBuffer                               pBsBuffer;
@@ -1173,6 +1199,7 @@ typedef struct _CODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS
     CODECHAL_ENCODE_AVC_NAL_UNIT_TYPE       NalUnitType;
     uint16_t                                wPictureCodingType;
     bool                                    bVdencEnabled;
+    PCODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE  pSliceHeaderTemplate;   // optional, invalidate per frame
 } CODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS, *PCODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS;
 
 typedef struct _CODECHAL_ENCODE_AVC_VALIDATE_NUM_REFS_PARAMS
@@ -1687,6 +1714,7 @@ public:
     CODEC_AVC_FRAME_STORE_ID                 m_avcFrameStoreID[CODEC_AVC_MAX_NUM_REF_FRAME];     //!< Refer to CODEC_AVC_FRAME_STORE_ID
     CODECHAL_ENCODE_AVC_NAL_UNIT_TYPE           m_nalUnitType;                      //!< Nal unit type
     PCODECHAL_NAL_UNIT_PARAMS                   *m_nalUnitParams    = nullptr;      //!< Pointers to NAL unit parameters array
+    CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE   m_sliceHeaderTemplate;              //!< Slice header fields shared by the slices of a frame
     uint16_t                                    m_sliceHeight       = 0;            //!< Slice height
     uint8_t                                     m_biWeightNumB      = 0;            //!< Bi direction Weight B frames num
     bool                                        m_deblockingEnabled = false;        //!< Enable deblocking flag
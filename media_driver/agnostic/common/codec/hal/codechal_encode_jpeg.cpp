@@ -84,6 +84,13 @@ void CodechalEncodeJpegState::FreeResources()
 
     // Release Ref Lists
     CodecHalFreeDataList(m_refList, CODECHAL_NUM_UNCOMPRESSED_SURFACE_JPEG);
+
+    uint32_t hits   = 0;
+    uint32_t misses = 0;
+    GetHeaderCacheStats(hits, misses);
+    CODECHAL_ENCODE_VERBOSEMESSAGE("JPEG header cache: %u hits, %u misses.", hits, misses);
+    MOS_FreeMemory(m_headerCache);
+    m_headerCache = nullptr;
 }
 
 MOS_STATUS CodechalEncodeJpegState::InitializePicture(const EncoderParams& params)
@@ -564,6 +571,197 @@ MOS_STATUS CodechalEncodeJpegState::PackScanHeader(
     return eStatus;
 }
 
+MOS_STATUS CodechalEncodeJpegState::AddHeaderToCache(
+    BSBuffer                        *buffer)
+{
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    CODECHAL_ENCODE_CHK_NULL_RETURN(buffer);
+    CODECHAL_ENCODE_CHK_NULL_RETURN(buffer->pBase);
+
+    uint32_t byteSize = (buffer->BufferSize + 7) >> 3;
+    uint32_t offset   = MOS_ALIGN_CEIL(m_headerCache->m_dataSize, sizeof(uint32_t));
+
+    if (m_headerCache->m_numSegments >= CODECHAL_ENCODE_JPEG_MAX_NUM_HEADER_SEGMENTS ||
+        offset + byteSize > sizeof(m_headerCache->m_data))
+    {
+        CODECHAL_ENCODE_ASSERTMESSAGE("JPEG header cache is too small.");
+        eStatus = MOS_STATUS_NO_SPACE;
+    }
+    else
+    {
+        eStatus = MOS_SecureMemcpy(&m_headerCache->m_data[offset], sizeof(m_headerCache->m_data) - offset,
+            buffer->pBase, byteSize);
+        if (eStatus == MOS_STATUS_SUCCESS)
+        {
+            m_headerCache->m_segments[m_headerCache->m_numSegments].m_offset  = offset;
+            m_headerCache->m_segments[m_headerCache->m_numSegments].m_bitSize = buffer->BufferSize;
+            m_headerCache->m_numSegments++;
+            m_headerCache->m_dataSize = offset + byteSize;
+        }
+    }
+
+    MOS_FreeMemory(buffer->pBase);
+    buffer->pBase = nullptr;
+
+    return eStatus;
+}
+
+MOS_STATUS CodechalEncodeJpegState::UpdateHeaderCache(
+    bool                            useSingleDefaultQuantTable,
+    bool                            repeatHuffTable)
+{
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    if (m_headerCache == nullptr)
+    {
+        m_headerCache = (CodechalEncodeJpegHeaderCache *)MOS_AllocAndZeroMemory(sizeof(CodechalEncodeJpegHeaderCache));
+        CODECHAL_ENCODE_CHK_NULL_RETURN(m_headerCache);
+    }
+
+    uint32_t numHuffBuffers = MOS_MIN(m_encodeParams.dwNumHuffBuffers, JPEG_NUM_ENCODE_HUFF_BUFF);
+
+    // Only the Huffman buffers sent for this picture, the others may hold copies from the last picture
+    CodechalEncodeJpegHeaderCacheKey key;
+    MOS_ZeroMemory(&key, sizeof(key));
+    key.m_quantTables = *m_jpegQuantTables;
+    for (uint32_t i = 0; i < numHuffBuffers; i++)
+    {
+        key.m_huffmanTables.m_huffmanData[i] = m_jpegHuffmanTable->m_huffmanData[i];
+    }
+    key.m_numHuffBuffers                = numHuffBuffers;
+    key.m_picWidth                      = m_jpegPicParams->m_picWidth;
+    key.m_picHeight                     = m_jpegPicParams->m_picHeight;
+    key.m_inputSurfaceFormat            = m_jpegPicParams->m_inputSurfaceFormat;
+    key.m_numComponent                  = m_jpegPicParams->m_numComponent;
+    key.m_restartInterval               = m_jpegScanParams->m_restartInterval;
+    key.m_useSingleDefaultQuantTable    = useSingleDefaultQuantTable;
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(key.m_componentID, sizeof(key.m_componentID),
+        m_jpegPicParams->m_componentID, sizeof(m_jpegPicParams->m_componentID)));
+
+    if (m_headerCache->Lookup(key))
+    {
+        return eStatus;
+    }
+
+    // Convert encoded huffman table to actual table for HW
+    // We need a different params struct for JPEG Encode Huffman table because JPEG decode huffman table has Bits and codes,
+    // whereas JPEG encode huffman table has huffman code lengths and values
+    MHW_VDBOX_ENCODE_HUFF_TABLE_PARAMS *huffTableParams = m_headerCache->m_huffTableParams;
+    for (uint32_t i = 0; i < numHuffBuffers; i++)
+    {
+        CodechalEncodeJpegHuffTable huffmanTable;// intermediate table for each AC/DC component which will be copied to huffTableParams
+        MOS_ZeroMemory(&huffmanTable, sizeof(huffmanTable));
+
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(ConvertHuffDataToTable(m_jpegHuffmanTable->m_huffmanData[i], &huffmanTable));
+
+        huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].HuffTableID = m_jpegHuffmanTable->m_huffmanData[i].m_tableID;
+
+        if (m_jpegHuffmanTable->m_huffmanData[i].m_tableClass == 0) // DC table
+        {
+            CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(
+                huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pDCCodeValues,
+                JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint16_t),
+                &huffmanTable.m_huffCode,
+                JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint16_t)));
+
+            CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pDCCodeLength,
+                JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint8_t),
+                &huffmanTable.m_huffSize,
+                JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint8_t)));
+        }
+        else // AC Table
+        {
+            CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pACCodeValues,
+                JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint16_t),
+                &huffmanTable.m_huffCode,
+                JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint16_t)));
+
+            CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pACCodeLength,
+                JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint8_t),
+                &huffmanTable.m_huffSize,
+                JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint8_t)));
+        }
+    }
+
+    if (repeatHuffTable)
+    {
+        // Copy over huffman data to the other two data buffers for JPEG picture header
+        for (uint32_t i = 0; i < numHuffBuffers; i++)
+        {
+            m_jpegHuffmanTable->m_huffmanData[i + 2].m_tableClass = m_jpegHuffmanTable->m_huffmanData[i].m_tableClass;
+            m_jpegHuffmanTable->m_huffmanData[i + 2].m_tableID    = m_jpegHuffmanTable->m_huffmanData[i].m_tableID;
+
+            eStatus = MOS_SecureMemcpy(&m_jpegHuffmanTable->m_huffmanData[i + 2].m_bits[0],
+                sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_BITS,
+                &m_jpegHuffmanTable->m_huffmanData[i].m_bits[0],
+                sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_BITS);
+            if (eStatus != MOS_STATUS_SUCCESS)
+            {
+                CODECHAL_ENCODE_ASSERTMESSAGE("Failed to copy memory.");
+                return eStatus;
+            }
+
+            eStatus = MOS_SecureMemcpy(&m_jpegHuffmanTable->m_huffmanData[i + 2].m_huffVal[0],
+                sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_HUFFVAL,
+                &m_jpegHuffmanTable->m_huffmanData[i].m_huffVal[0],
+                sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_HUFFVAL);
+            if (eStatus != MOS_STATUS_SUCCESS)
+            {
+                CODECHAL_ENCODE_ASSERTMESSAGE("Failed to copy memory.");
+                return eStatus;
+            }
+        }
+    }
+
+    BSBuffer headerBuffer;
+    MOS_ZeroMemory(&headerBuffer, sizeof(headerBuffer));
+
+    // Add Quant Table for Y
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(PackQuantTable(&headerBuffer, jpegComponentY));
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(AddHeaderToCache(&headerBuffer));
+
+    // Since there is no U and V in monochrome format, donot add Quantization table header for U and V components
+    if (!useSingleDefaultQuantTable && m_jpegPicParams->m_inputSurfaceFormat != codechalJpegY8)
+    {
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(PackQuantTable(&headerBuffer, jpegComponentU));
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(AddHeaderToCache(&headerBuffer));
+
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(PackQuantTable(&headerBuffer, jpegComponentV));
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(AddHeaderToCache(&headerBuffer));
+    }
+
+    // Add Frame Header
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(PackFrameHeader(&headerBuffer, useSingleDefaultQuantTable));
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(AddHeaderToCache(&headerBuffer));
+
+    // Add Huffman Table for Y - DC table, Y- AC table, U/V - DC table, U/V - AC table
+    for (uint32_t i = 0; i < m_encodeParams.dwNumHuffBuffers; i++)
+    {
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(PackHuffmanTable(&headerBuffer, i));
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(AddHeaderToCache(&headerBuffer));
+    }
+
+    // Restart Interval - Add only if the restart interval is not zero
+    if (m_jpegScanParams->m_restartInterval != 0)
+    {
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(PackRestartInterval(&headerBuffer));
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(AddHeaderToCache(&headerBuffer));
+    }
+
+    // Add scan header, always the last header
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(PackScanHeader(&headerBuffer));
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(AddHeaderToCache(&headerBuffer));
+
+    m_headerCache->m_valid = true;
+
+    return eStatus;
+}
+
 MOS_STATUS CodechalEncodeJpegState::ExecutePictureLevel()
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
@@ -736,81 +934,14 @@ MOS_STATUS CodechalEncodeJpegState::ExecuteSliceLevel()
 
         CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxJpegFqmCmd(&cmdBuffer, &fqmParams, numQuantTables));
 
-        // set MFC_JPEG_HUFF_TABLE - Convert encoded huffman table to actual table for HW
-        // We need a different params struct for JPEG Encode Huffman table because JPEG decode huffman table has Bits and codes,
-        // whereas JPEG encode huffman table has huffman code lengths and values
-        MHW_VDBOX_ENCODE_HUFF_TABLE_PARAMS   huffTableParams[JPEG_MAX_NUM_HUFF_TABLE_INDEX];
-        for (uint32_t i = 0; i < m_encodeParams.dwNumHuffBuffers; i++)
-        {
-            CodechalEncodeJpegHuffTable huffmanTable;// intermediate table for each AC/DC component which will be copied to huffTableParams
-            MOS_ZeroMemory(&huffmanTable, sizeof(huffmanTable));
-
-            CODECHAL_ENCODE_CHK_STATUS_RETURN(ConvertHuffDataToTable(m_jpegHuffmanTable->m_huffmanData[i], &huffmanTable));
-
-            huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].HuffTableID = m_jpegHuffmanTable->m_huffmanData[i].m_tableID;
-
-            if (m_jpegHuffmanTable->m_huffmanData[i].m_tableClass == 0) // DC table
-            {
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(
-                    huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pDCCodeValues,
-                    JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint16_t),
-                    &huffmanTable.m_huffCode,
-                    JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint16_t)));
-
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pDCCodeLength,
-                    JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint8_t),
-                    &huffmanTable.m_huffSize,
-                    JPEG_NUM_HUFF_TABLE_DC_HUFFVAL * sizeof(uint8_t)));
-            }
-            else // AC Table
-            {
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pACCodeValues,
-                    JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint16_t),
-                    &huffmanTable.m_huffCode,
-                    JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint16_t)));
-
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(MOS_SecureMemcpy(huffTableParams[m_jpegHuffmanTable->m_huffmanData[i].m_tableID].pACCodeLength,
-                    JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint8_t),
-                    &huffmanTable.m_huffSize,
-                    JPEG_NUM_HUFF_TABLE_AC_HUFFVAL * sizeof(uint8_t)));
-            }
-        }
-
         // Send 2 huffman table commands - 1 for Luma and one for chroma for non-monchrome input formats
         // If only one table is sent by the app (2 buffers), send the same table for Luma and chroma
-        bool repeatHuffTable = false;
-        if ((m_encodeParams.dwNumHuffBuffers / 2 < JPEG_MAX_NUM_HUFF_TABLE_INDEX)
-            && (m_jpegPicParams->m_inputSurfaceFormat != codechalJpegY8))
-        {
-            repeatHuffTable = true;
-
-            // Copy over huffman data to the other two data buffers for JPEG picture header
-            for (uint32_t i = 0; i < m_encodeParams.dwNumHuffBuffers; i++)
-            {
-                m_jpegHuffmanTable->m_huffmanData[i + 2].m_tableClass = m_jpegHuffmanTable->m_huffmanData[i].m_tableClass;
-                m_jpegHuffmanTable->m_huffmanData[i + 2].m_tableID    = m_jpegHuffmanTable->m_huffmanData[i].m_tableID;
-
-                eStatus = MOS_SecureMemcpy(&m_jpegHuffmanTable->m_huffmanData[i + 2].m_bits[0],
-                    sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_BITS,
-                    &m_jpegHuffmanTable->m_huffmanData[i].m_bits[0],
-                    sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_BITS);
-                if (eStatus != MOS_STATUS_SUCCESS)
-                {
-                    CODECHAL_ENCODE_ASSERTMESSAGE("Failed to copy memory.");
-                    return eStatus;
-                }
+        bool repeatHuffTable = ((m_encodeParams.dwNumHuffBuffers / 2 < JPEG_MAX_NUM_HUFF_TABLE_INDEX)
+            && (m_jpegPicParams->m_inputSurfaceFormat != codechalJpegY8));
 
-                eStatus = MOS_SecureMemcpy(&m_jpegHuffmanTable->m_huffmanData[i + 2].m_huffVal[0],
-                    sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_HUFFVAL,
-                    &m_jpegHuffmanTable->m_huffmanData[i].m_huffVal[0],
-                    sizeof(uint8_t) * JPEG_NUM_HUFF_TABLE_AC_HUFFVAL);
-                if (eStatus != MOS_STATUS_SUCCESS)
-                {
-                    CODECHAL_ENCODE_ASSERTMESSAGE("Failed to copy memory.");
-                    return eStatus;
-                }
-            }
-        }
+        // set MFC_JPEG_HUFF_TABLE - Huffman tables and headers are rebuilt only when the tables change
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(UpdateHeaderCache(useSingleDefaultQuantTable, repeatHuffTable));
+        MHW_VDBOX_ENCODE_HUFF_TABLE_PARAMS *huffTableParams = m_headerCache->m_huffTableParams;
 
         // the number of huffman commands is half of the huffman buffers sent by the app, since AC and DC buffers are combined into one command
         for (uint32_t i = 0; i < m_encodeParams.dwNumHuffBuffers / 2; i++)
@@ -911,97 +1042,23 @@ MOS_STATUS CodechalEncodeJpegState::ExecuteSliceLevel()
             MOS_FreeMemory(appDataChunk);
         }
 
-        // Add Quant Table for Y
-        CODECHAL_ENCODE_CHK_STATUS_RETURN(PackQuantTable(pakInsertObjectParams.pBsBuffer, jpegComponentY));
-
-        pakInsertObjectParams.dwOffset                      = 0;
-        pakInsertObjectParams.dwBitSize                     = pakInsertObjectParams.pBsBuffer->BufferSize;
-        pakInsertObjectParams.bLastHeader                   = false;
-        pakInsertObjectParams.bEndOfSlice                   = false;
-        pakInsertObjectParams.bResetBitstreamStartingPos    = 1; // from discussion with HW Architect
-        CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxPakInsertObject(&cmdBuffer, nullptr,
-            &pakInsertObjectParams));
-        MOS_FreeMemory(pakInsertObjectParams.pBsBuffer->pBase);
-
-        if (!useSingleDefaultQuantTable)
-        {
-            // Since there is no U and V in monochrome format, donot add Quantization table header for U and V components
-            if (m_jpegPicParams->m_inputSurfaceFormat != codechalJpegY8)
-            {
-                // Add quant table for U
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(PackQuantTable(pakInsertObjectParams.pBsBuffer, jpegComponentU));
-                pakInsertObjectParams.dwOffset                      = 0;
-                pakInsertObjectParams.dwBitSize                     = pakInsertObjectParams.pBsBuffer->BufferSize;
-                pakInsertObjectParams.bLastHeader                   = false;
-                pakInsertObjectParams.bEndOfSlice                   = false;
-                pakInsertObjectParams.bResetBitstreamStartingPos    = 1; // from discussion with HW Architect
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxPakInsertObject(&cmdBuffer, nullptr,
-                    &pakInsertObjectParams));
-                MOS_FreeMemory(pakInsertObjectParams.pBsBuffer->pBase);
-
-                // Add quant table for V
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(PackQuantTable(pakInsertObjectParams.pBsBuffer, jpegComponentV));
-                pakInsertObjectParams.dwOffset                      = 0;
-                pakInsertObjectParams.dwBitSize                     = pakInsertObjectParams.pBsBuffer->BufferSize;
-                pakInsertObjectParams.bLastHeader                   = false;
-                pakInsertObjectParams.bEndOfSlice                   = false;
-                pakInsertObjectParams.bResetBitstreamStartingPos    = 1; // from discussion with HW Architect
-                CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxPakInsertObject(&cmdBuffer, nullptr,
-                    &pakInsertObjectParams));
-                MOS_FreeMemory(pakInsertObjectParams.pBsBuffer->pBase);
-            }
-        }
-
-        // Add Frame Header
-        CODECHAL_ENCODE_CHK_STATUS_RETURN(PackFrameHeader(pakInsertObjectParams.pBsBuffer, useSingleDefaultQuantTable));
-        pakInsertObjectParams.dwOffset                      = 0;
-        pakInsertObjectParams.dwBitSize                     = pakInsertObjectParams.pBsBuffer->BufferSize;
-        pakInsertObjectParams.bLastHeader                   = false;
-        pakInsertObjectParams.bEndOfSlice                   = false;
-        pakInsertObjectParams.bResetBitstreamStartingPos    = 1; // from discussion with HW Architect
-        CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxPakInsertObject(&cmdBuffer, nullptr,
-            &pakInsertObjectParams));
-        MOS_FreeMemory(pakInsertObjectParams.pBsBuffer->pBase);
-
-        // Add Huffman Table for Y - DC table, Y- AC table, U/V - DC table, U/V - AC table
-        for (uint32_t i = 0; i < m_encodeParams.dwNumHuffBuffers; i++)
+        // Add quant tables, frame header, Huffman tables, restart interval and scan header from the cache
+        pakInsertObjectParams.pBsBuffer->pBase      = m_headerCache->m_data;
+        pakInsertObjectParams.pBsBuffer->BitOffset  = 0;
+        pakInsertObjectParams.pBsBuffer->BufferSize = m_headerCache->m_dataSize * 8;
+        for (uint32_t i = 0; i < m_headerCache->m_numSegments; i++)
         {
-            CODECHAL_ENCODE_CHK_STATUS_RETURN(PackHuffmanTable(pakInsertObjectParams.pBsBuffer, i));
-            pakInsertObjectParams.dwOffset                      = 0;
-            pakInsertObjectParams.dwBitSize                     = pakInsertObjectParams.pBsBuffer->BufferSize;
-            pakInsertObjectParams.bLastHeader                   = false;
-            pakInsertObjectParams.bEndOfSlice                   = false;
-            pakInsertObjectParams.bResetBitstreamStartingPos    = 1; // from discussion with HW Architect
-            CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxPakInsertObject(&cmdBuffer, nullptr,
-                &pakInsertObjectParams));
-            MOS_FreeMemory(pakInsertObjectParams.pBsBuffer->pBase);
-        }
+            bool lastHeader = (i == m_headerCache->m_numSegments - 1); // scan header
 
-        // Restart Interval - Add only if the restart interval is not zero
-        if (m_jpegScanParams->m_restartInterval != 0)
-        {
-            CODECHAL_ENCODE_CHK_STATUS_RETURN(PackRestartInterval(pakInsertObjectParams.pBsBuffer));
-            pakInsertObjectParams.dwOffset                      = 0;
-            pakInsertObjectParams.dwBitSize                     = pakInsertObjectParams.pBsBuffer->BufferSize;
-            pakInsertObjectParams.bLastHeader                   = false;
-            pakInsertObjectParams.bEndOfSlice                   = false;
+            pakInsertObjectParams.dwOffset                      = m_headerCache->m_segments[i].m_offset;
+            pakInsertObjectParams.dwBitSize                     = m_headerCache->m_segments[i].m_bitSize;
+            pakInsertObjectParams.bLastHeader                   = lastHeader;
+            pakInsertObjectParams.bEndOfSlice                   = lastHeader;
             pakInsertObjectParams.bResetBitstreamStartingPos    = 1; // from discussion with HW Architect
             CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxPakInsertObject(&cmdBuffer, nullptr,
                 &pakInsertObjectParams));
-            MOS_FreeMemory(pakInsertObjectParams.pBsBuffer->pBase);
         }
 
-        // Add scan header
-        CODECHAL_ENCODE_CHK_STATUS_RETURN(PackScanHeader(pakInsertObjectParams.pBsBuffer));
-        pakInsertObjectParams.dwOffset                      = 0;
-        pakInsertObjectParams.dwBitSize                     = pakInsertObjectParams.pBsBuffer->BufferSize;
-        pakInsertObjectParams.bLastHeader                   = true;
-        pakInsertObjectParams.bEndOfSlice                   = true;
-        pakInsertObjectParams.bResetBitstreamStartingPos    = 1; // from discussion with HW Architect
-        CODECHAL_ENCODE_CHK_STATUS_RETURN(m_mfxInterface->AddMfxPakInsertObject(&cmdBuffer, nullptr,
-            &pakInsertObjectParams));
-        MOS_FreeMemory(pakInsertObjectParams.pBsBuffer->pBase);
-
         MOS_FreeMemory(pakInsertObjectParams.pBsBuffer);
     }
 
@@ -30,6 +30,9 @@
 
 #include "codechal_encoder_base.h"
 
+#define CODECHAL_ENCODE_JPEG_MAX_NUM_HEADER_SEGMENTS   10      // 3 quant tables, frame header, 4 Huffman tables, restart interval, scan header
+#define CODECHAL_ENCODE_JPEG_HEADER_CACHE_DATA_SIZE    2048
+
 //!
 //! \struct CodechalEncodeJpegHuffTable
 //! \brief Define the Huffman Table structure used by JPEG Encode
@@ -128,6 +131,87 @@ struct CodechalEncodeJpegScanHeader
 };
 #pragma pack(pop)
 
+//! \struct CodechalEncodeJpegHeaderCacheKey
+//! \brief Parameters the Huffman tables and packed headers of a JPEG picture are derived from
+struct CodechalEncodeJpegHeaderCacheKey
+{
+    CodecEncodeJpegQuantTable         m_quantTables;                  //!< Quant tables, after copying shared tables
+    CodecEncodeJpegHuffmanDataArray   m_huffmanTables;                //!< Huffman data sent by the application
+    uint32_t                          m_numHuffBuffers;               //!< Number of Huffman buffers
+    uint32_t                          m_picWidth;                     //!< Picture width
+    uint32_t                          m_picHeight;                    //!< Picture height
+    uint32_t                          m_inputSurfaceFormat;           //!< Input surface format
+    uint32_t                          m_numComponent;                 //!< Number of components
+    uint8_t                           m_componentID[4];               //!< Component identifiers
+    uint32_t                          m_restartInterval;              //!< Restart interval
+    uint32_t                          m_useSingleDefaultQuantTable;   //!< Luma quant table used for all components
+};
+
+//! \struct CodechalEncodeJpegHeaderSegment
+//! \brief One header inserted through MFC_JPEG_PAK_INSERT_OBJECT
+struct CodechalEncodeJpegHeaderSegment
+{
+    uint32_t  m_offset;     //!< Byte offset in the header data
+    uint32_t  m_bitSize;    //!< Header size in bits
+};
+
+//! \struct CodechalEncodeJpegHeaderCache
+//! \brief Huffman tables and packed headers of the last JPEG picture
+//! \details MJPEG streams keep the same tables and quality for long runs of frames,
+//!          such frames reuse the Huffman tables and copy the packed headers.
+struct CodechalEncodeJpegHeaderCache
+{
+    bool                                m_valid;                                                    //!< Cache holds the tables of m_key
+    uint32_t                            m_hash;                                                     //!< Hash of m_key
+    CodechalEncodeJpegHeaderCacheKey    m_key;                                                      //!< Parameters of the cached picture
+    MHW_VDBOX_ENCODE_HUFF_TABLE_PARAMS  m_huffTableParams[JPEG_MAX_NUM_HUFF_TABLE_INDEX];           //!< Huffman tables for MFC_JPEG_HUFF_TABLE_STATE
+    uint32_t                            m_numSegments;                                              //!< Number of packed headers
+    CodechalEncodeJpegHeaderSegment     m_segments[CODECHAL_ENCODE_JPEG_MAX_NUM_HEADER_SEGMENTS];   //!< Packed headers in bitstream order
+    uint32_t                            m_dataSize;                                                 //!< Bytes used in m_data
+    uint8_t                             m_data[CODECHAL_ENCODE_JPEG_HEADER_CACHE_DATA_SIZE];        //!< Packed header bytes
+    uint32_t                            m_hits;                                                     //!< Pictures which reused the cached headers
+    uint32_t                            m_misses;                                                   //!< Pictures which packed the headers
+
+    //! \brief    Hash a cache key with FNV-1a, the key is compared in full on a hash match
+    static uint32_t Hash(const CodechalEncodeJpegHeaderCacheKey &key)
+    {
+        const uint8_t *data = (const uint8_t *)&key;
+        uint32_t       hash = 2166136261u;
+
+        for (uint32_t i = 0; i < sizeof(key); i++)
+        {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+
+        return hash;
+    }
+
+    //! \brief    Look up the Huffman tables and headers of a picture
+    //! \details  On a miss the cache is emptied for key, the caller converts the tables,
+    //!           packs the headers into it and sets m_valid once they are complete.
+    //! \param    [in] key
+    //!           Parameters of the picture
+    //! \return   true if the cache holds the tables and headers of key
+    bool Lookup(const CodechalEncodeJpegHeaderCacheKey &key)
+    {
+        uint32_t hash = Hash(key);
+        if (m_valid && m_hash == hash && memcmp(&m_key, &key, sizeof(key)) == 0)
+        {
+            m_hits++;
+            return true;
+        }
+
+        m_misses++;
+        m_valid       = false;
+        m_hash        = hash;
+        m_key         = key;
+        m_numSegments = 0;
+        m_dataSize    = 0;
+        MOS_ZeroMemory(m_huffTableParams, sizeof(m_huffTableParams));
+        return false;
+    }
+};
+
 //!  JPEG Encoder State class
 //!
 //!This class defines the JPEG encoder state, it includes
@@ -174,6 +258,22 @@ public:
 
     MOS_STATUS ExecuteKernelFunctions() { return MOS_STATUS_SUCCESS;};
 
+    //!
+    //! \brief    Get the header cache counters since the resources were allocated
+    //!
+    //! \param    [out] hits
+    //!           Pictures which reused the cached headers
+    //! \param    [out] misses
+    //!           Pictures which packed the headers
+    //!
+    //! \return   void
+    //!
+    void GetHeaderCacheStats(uint32_t &hits, uint32_t &misses) const
+    {
+        hits   = m_headerCache ? m_headerCache->m_hits : 0;
+        misses = m_headerCache ? m_headerCache->m_misses : 0;
+    }
+
 #if USE_CODECHAL_DEBUG_TOOL
     MOS_STATUS DumpQuantTables(
         CodecEncodeJpegQuantTable *quantTable);
@@ -203,6 +303,7 @@ public:
     // Other
     uint32_t                                    m_appDataSize         = 0;                                     //!< Pointer to Application data size
     bool                                        m_jpegQuantMatrixSent  = false;                                //!< JPEG: bool to tell if quant matrix was sent by the app or not
+    CodechalEncodeJpegHeaderCache               *m_headerCache         = nullptr;                               //!< Huffman tables and headers of the last picture
 
 protected:
     //!
@@ -381,6 +482,28 @@ protected:
     //!
     MOS_STATUS PackScanHeader(
         BSBuffer                        *buffer);
+
+    //! \brief    Get the Huffman tables and packed headers of the current picture
+    //! \details  Reuses the cache when the quant tables, Huffman tables and picture parameters
+    //!           match the cached picture, else converts the Huffman tables and packs the
+    //!           headers into the cache.
+    //! \param    [in] useSingleDefaultQuantTable
+    //!           The flag of using single default Quant Table
+    //! \param    [in] repeatHuffTable
+    //!           The flag of using the luma Huffman tables for chroma
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    MOS_STATUS UpdateHeaderCache(
+        bool                            useSingleDefaultQuantTable,
+        bool                            repeatHuffTable);
+
+    //! \brief    Append a packed header to the header cache and free it
+    //! \param    [in] buffer
+    //!           Bitstream buffer returned by one of the Pack functions
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    MOS_STATUS AddHeaderToCache(
+        BSBuffer                        *buffer);
 };
 
 #endif __CODECHAL_ENCODER_JPEG_H__
@@ -1178,6 +1178,9 @@ MOS_STATUS CodechalEncoderState::InitCommon()
     if(encodeParams->psReconSurface)
     {
         m_reconSurface     = *(encodeParams->psReconSurface);         // used by all except JPEG
+
+        // Recon surface is overwritten, content formatted by the driver is gone
+        m_osInterface->pfnSetResourceContentTag(m_osInterface, &encodeParams->psReconSurface->OsResource, 0);
     }
 
     if(encodeParams->pBSBuffer)
@@ -3596,9 +3599,12 @@ MOS_STATUS CodechalEncoderState::GetStatusReport(
 
     uint16_t index = 0;
 
+    // codecStatus[0] is overwritten by the first report, sample the query order once
+    bool sequential = codecStatus->bSequential;
+
     for (auto i = 0; i < numStatus; i++)
     {
-        if(codecStatus->bSequential)
+        if(sequential)
         {
             index = (encodeStatusBuf->wFirstIndex + i) & (CODECHAL_ENCODE_STATUS_NUM - 1);
         }
@@ -2329,57 +2329,115 @@ static void PutBit(BSBuffer *bsbuffer, uint32_t code)
     }
 }
 
-static void PutBitsSub(BSBuffer *bsbuffer, uint32_t code, uint32_t length)
+static void PutBits(BSBuffer *bsbuffer, uint32_t code, uint32_t length)
 {
-    uint8_t *byte = bsbuffer->pCurrent;
-
-    // make sure that the number of bits given is <= 24
-    CODECHAL_ENCODE_ASSERT(length <= 24);
-
-    code <<= (32 - length);
+    uint8_t  *byte = bsbuffer->pCurrent;
+    uint32_t totalBits, numBytes;
+    uint64_t word;
 
-    // shift field so that the given code begins at the current bit
-    // offset in the most significant byte of the 32-bit word
-    length += bsbuffer->BitOffset;
-    code >>= bsbuffer->BitOffset;
+    // only support up to 32 bits based on current usage
+    CODECHAL_ENCODE_ASSERT(length <= 32);
 
-    // write bytes back into memory, big-endian
-    byte[0] = (uint8_t)((code >> 24) | byte[0]);
-    byte[1] = (uint8_t)(code >> 16);
-    if (length > 16)
+    if (length == 0)
     {
-        byte[2] = (uint8_t)(code >> 8);
-        byte[3] = (uint8_t)code;
+        return;
     }
-    else
+
+    // merge the pending bits of the current byte and the code into one
+    // 64-bit word starting at its most significant bit, bits of code
+    // above length are shifted out
+    totalBits = bsbuffer->BitOffset + length;
+    word      = ((uint64_t)byte[0] << 56) | (((uint64_t)code << (64 - length)) >> bsbuffer->BitOffset);
+
+    // write bytes back into memory, big-endian, up to and including the
+    // new current byte so that it is cleared for the next write
+    numBytes = (totalBits >> 3) + 1;
+    for (uint32_t i = 0; i < numBytes; i++)
     {
-        byte[2] = 0;
+        byte[i] = (uint8_t)(word >> (56 - 8 * i));
     }
 
     // update bitstream pointer and bit offset
-    bsbuffer->pCurrent += (length >> 3);
-    bsbuffer->BitOffset = (length & 7);
+    bsbuffer->pCurrent += (totalBits >> 3);
+    bsbuffer->BitOffset = (uint8_t)(totalBits & 7);
 }
 
-static void PutBits(BSBuffer *bsbuffer, uint32_t code, uint32_t length)
+static uint32_t CountLeadingZeros(uint32_t value)
 {
-    uint32_t code1, code2;
+#if defined(__GNUC__)
+    return value ? (uint32_t)__builtin_clz(value) : 32;
+#else
+    uint32_t count = 32;
+    while (value)
+    {
+        value >>= 1;
+        count--;
+    }
+    return count;
+#endif
+}
 
-    // temp solution, only support up to 32 bits based on current usage
-    CODECHAL_ENCODE_ASSERT(length <= 32);
+//!
+//! \brief    Write an unsigned exp-Golomb code, ue(v)
+//! \details  leadingZeroBits zeros followed by code + 1 in leadingZeroBits + 1 bits,
+//!           the length is taken from the leading zero count of code + 1.
+//!
+static void PutVLCCode(BSBuffer *bsbuffer, uint32_t code)
+{
+    uint32_t codeNum, leadingZeroBits;
 
-    if (length >= 24)
-    {
-        code1 = code & 0xFFFF;
-        code2 = code >> 16;
+    // code + 1 must not wrap
+    CODECHAL_ENCODE_ASSERT(code < 0xFFFFFFFF);
 
-        // high bits go first
-        PutBitsSub(bsbuffer, code2, length - 16);
-        PutBitsSub(bsbuffer, code1, 16);
+    codeNum         = code + 1;
+    leadingZeroBits = 31 - CountLeadingZeros(codeNum);
+
+    if (leadingZeroBits < 16)
+    {
+        // zeros are the high bits of the code word
+        PutBits(bsbuffer, codeNum, 2 * leadingZeroBits + 1);
     }
     else
     {
-        PutBitsSub(bsbuffer, code, length);
+        PutBits(bsbuffer, 0, leadingZeroBits);
+        PutBits(bsbuffer, codeNum, leadingZeroBits + 1);
+    }
+}
+
+//!
+//! \brief    Copy a bit string into the bitstream
+//!
+//! \param    [in] bsbuffer
+//!           Bitstream to write
+//! \param    [in] data
+//!           Bit string, most significant bit first
+//! \param    [in] bitOffset
+//!           Offset of the first bit in data
+//! \param    [in] bitSize
+//!           Number of bits to copy
+//!
+static void PutBitString(BSBuffer *bsbuffer, const uint8_t *data, uint32_t bitOffset, uint32_t bitSize)
+{
+    while (bitSize)
+    {
+        const uint8_t *byte      = data + (bitOffset >> 3);
+        uint32_t       bitInByte = bitOffset & 7;
+        uint32_t       code, length;
+
+        if (bitInByte == 0 && bitSize >= 32)
+        {
+            code   = ((uint32_t)byte[0] << 24) | ((uint32_t)byte[1] << 16) | ((uint32_t)byte[2] << 8) | byte[3];
+            length = 32;
+        }
+        else
+        {
+            length = MOS_MIN(8 - bitInByte, bitSize);
+            code   = byte[0] >> (8 - bitInByte - length);
+        }
+
+        PutBits(bsbuffer, code, length);
+        bitOffset += length;
+        bitSize   -= length;
     }
 }
 
@@ -3836,6 +3836,13 @@ MOS_STATUS CodechalVdencAvcState::ExecuteSliceLevel()
     packSlcHeaderParams.NalUnitType = m_nalUnitType;
     packSlcHeaderParams.wPictureCodingType = m_pictureCodingType;
     packSlcHeaderParams.bVdencEnabled = true;
+    packSlcHeaderParams.pSliceHeaderTemplate = &m_sliceHeaderTemplate;
+
+    // Slices of a new frame do not share header fields with the previous one
+    if (m_currPass == 0)
+    {
+        m_sliceHeaderTemplate.bValid = false;
+    }
 
     MHW_VDBOX_AVC_SLICE_STATE sliceState;
     MOS_ZeroMemory(&sliceState, sizeof(sliceState));
@@ -441,6 +441,177 @@ finish:
     return eStatus;
 }
 
+#define MHW_POLYPHASE_CACHE_SIZE        64
+#define MHW_POLYPHASE_CACHE_MAX_COEFS   (NUM_HW_POLYPHASE_TABLES * NUM_POLYPHASE_Y_ENTRIES)
+
+typedef enum _MHW_POLYPHASE_TABLE_TYPE
+{
+    MHW_POLYPHASE_TABLE_Y = 0,
+    MHW_POLYPHASE_TABLE_UV,
+    MHW_POLYPHASE_TABLE_UV_OFFSET
+} MHW_POLYPHASE_TABLE_TYPE;
+
+//!
+//! \brief  Inputs of a polyphase table calculation
+//! \details All members are 32 bit so the key has no padding and is compared bytewise.
+//!          Float inputs are compared by bit pattern, a hit is bit exact.
+//!
+typedef struct _MHW_POLYPHASE_CACHE_KEY
+{
+    uint32_t    dwType;             //!< MHW_POLYPHASE_TABLE_TYPE
+    uint32_t    dwPlane;
+    uint32_t    dwFormat;
+    uint32_t    dwHwPhase;
+    uint32_t    bUse8x8Filter;
+    int32_t     iUvPhaseOffset;
+    float       fScaleFactor;
+    float       fParam;             //!< High pass strength for Y, Lanczos factor for UV
+} MHW_POLYPHASE_CACHE_KEY;
+
+//!
+//! \brief  Process wide cache of polyphase coefficient tables
+//! \details Composite and SFC scaling recalculate the tables whenever the scale
+//!          factor differs from the one of their previous call, which happens
+//!          on every call for multi-layer composition and multi-output scaling.
+//!          Tables are kept per calculation input and replaced round robin.
+//!
+class MhwPolyphaseCache
+{
+public:
+    static MhwPolyphaseCache *Instance()
+    {
+        static MhwPolyphaseCache instance;
+        return &instance;
+    }
+
+    bool Lookup(const MHW_POLYPHASE_CACHE_KEY *key, int32_t *coefs, uint32_t count)
+    {
+        bool found = false;
+
+        if (m_mutex == nullptr || count > MHW_POLYPHASE_CACHE_MAX_COEFS)
+        {
+            return false;
+        }
+
+        MOS_LockMutex(m_mutex);
+        for (uint32_t i = 0; i < MHW_POLYPHASE_CACHE_SIZE; i++)
+        {
+            Entry *entry = &m_entries[i];
+            if (entry->count == count && memcmp(&entry->key, key, sizeof(*key)) == 0)
+            {
+                MOS_SecureMemcpy(coefs, count * sizeof(int32_t), entry->coefs, count * sizeof(int32_t));
+                found = true;
+                break;
+            }
+        }
+        if (found)
+        {
+            m_hits++;
+        }
+        else
+        {
+            m_misses++;
+        }
+        MOS_UnlockMutex(m_mutex);
+
+        return found;
+    }
+
+    void Insert(const MHW_POLYPHASE_CACHE_KEY *key, const int32_t *coefs, uint32_t count)
+    {
+        if (m_mutex == nullptr || count > MHW_POLYPHASE_CACHE_MAX_COEFS)
+        {
+            return;
+        }
+
+        MOS_LockMutex(m_mutex);
+        Entry *entry = &m_entries[m_next];
+        m_next       = (m_next + 1) % MHW_POLYPHASE_CACHE_SIZE;
+        entry->key   = *key;
+        entry->count = count;
+        MOS_SecureMemcpy(entry->coefs, sizeof(entry->coefs), coefs, count * sizeof(int32_t));
+        MOS_UnlockMutex(m_mutex);
+    }
+
+    void GetStats(uint64_t *hits, uint64_t *misses)
+    {
+        if (m_mutex == nullptr)
+        {
+            *hits   = 0;
+            *misses = 0;
+            return;
+        }
+
+        MOS_LockMutex(m_mutex);
+        *hits   = m_hits;
+        *misses = m_misses;
+        MOS_UnlockMutex(m_mutex);
+    }
+
+private:
+    MhwPolyphaseCache()
+    {
+        MOS_ZeroMemory(m_entries, sizeof(m_entries));
+        m_next   = 0;
+        m_hits   = 0;
+        m_misses = 0;
+
+        m_mutex = MOS_CreateMutex();
+
+        // Tables outlive the composite and SFC instances MemNinja checks
+        MosMemAllocCounter--;
+        MOS_MEMNINJA_FREE_MESSAGE(m_mutex, __FUNCTION__, __FILE__, __LINE__);
+    }
+
+    ~MhwPolyphaseCache()
+    {
+        if (m_mutex != nullptr)
+        {
+            // Count the mutex back in for MOS_DestroyMutex to take out
+            MosMemAllocCounter++;
+            MOS_DestroyMutex(m_mutex);
+            m_mutex = nullptr;
+        }
+    }
+
+    struct Entry
+    {
+        MHW_POLYPHASE_CACHE_KEY key;
+        uint32_t                count;      //!< 0 if the entry is unused
+        int32_t                 coefs[MHW_POLYPHASE_CACHE_MAX_COEFS];
+    };
+
+    Entry       m_entries[MHW_POLYPHASE_CACHE_SIZE];
+    uint32_t    m_next;
+    uint64_t    m_hits;
+    uint64_t    m_misses;
+    PMOS_MUTEX  m_mutex;
+};
+
+//!
+//! \brief      Get polyphase table cache statistics
+//! \param      uint64_t*   pHits
+//!             [out]   Tables served from the cache
+//! \param      uint64_t*   pMisses
+//!             [out]   Tables calculated
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if success, else fail reason
+//!
+MOS_STATUS Mhw_GetPolyphaseCacheStats(
+    uint64_t        *pHits,
+    uint64_t        *pMisses)
+{
+    MOS_STATUS              eStatus = MOS_STATUS_SUCCESS;
+
+    MHW_CHK_NULL(pHits);
+    MHW_CHK_NULL(pMisses);
+
+    MhwPolyphaseCache::Instance()->GetStats(pHits, pMisses);
+
+finish:
+    return eStatus;
+}
+
 //!
 //! \brief      Sets Nearest Mode Table for Gen75/9, across SFC and Render engine to set the sampler states
 //! \details    This function sets Coefficients for Nearest Mode
@@ -541,6 +712,7 @@ MOS_STATUS Mhw_CalcPolyphaseTablesY(
     float                   fLanczosT;
     int32_t                 iCenterPixel;
     int32_t                 iSumQuantCoefs;
+    MHW_POLYPHASE_CACHE_KEY CacheKey;
 
     MHW_FUNCTION_ENTER;
 
@@ -556,6 +728,19 @@ MOS_STATUS Mhw_CalcPolyphaseTablesY(
         dwNumEntries = NUM_POLYPHASE_UV_ENTRIES;
     }
 
+    MOS_ZeroMemory(&CacheKey, sizeof(CacheKey));
+    CacheKey.dwType         = MHW_POLYPHASE_TABLE_Y;
+    CacheKey.dwPlane        = dwPlane;
+    CacheKey.dwFormat       = srcFmt;
+    CacheKey.dwHwPhase      = dwHwPhase;
+    CacheKey.bUse8x8Filter  = bUse8x8Filter;
+    CacheKey.fScaleFactor   = fScaleFactor;
+    CacheKey.fParam         = fHPStrength;
+    if (MhwPolyphaseCache::Instance()->Lookup(&CacheKey, iCoefs, dwHwPhase * dwNumEntries))
+    {
+        goto finish;
+    }
+
     MOS_ZeroMemory(fPhaseCoefs    , sizeof(fPhaseCoefs));
     MOS_ZeroMemory(fPhaseCoefsCopy, sizeof(fPhaseCoefsCopy));
 
@@ -653,6 +838,8 @@ MOS_STATUS Mhw_CalcPolyphaseTablesY(
         }
     }
 
+    MhwPolyphaseCache::Instance()->Insert(&CacheKey, iCoefs, dwHwPhase * dwNumEntries);
+
 finish:
     return eStatus;
 }
@@ -680,12 +867,24 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUV(
     int32_t     minCoef[MHW_SCALER_UV_WIN_SIZE];
     int32_t     maxCoef[MHW_SCALER_UV_WIN_SIZE];
     int32_t     i, j;
+    int32_t     *piCoefsBase;
+    MHW_POLYPHASE_CACHE_KEY CacheKey;
     MOS_STATUS              eStatus = MOS_STATUS_SUCCESS;
 
     MHW_FUNCTION_ENTER;
 
     MHW_CHK_NULL(piCoefs);
 
+    MOS_ZeroMemory(&CacheKey, sizeof(CacheKey));
+    CacheKey.dwType         = MHW_POLYPHASE_TABLE_UV;
+    CacheKey.fScaleFactor   = fInverseScaleFactor;
+    CacheKey.fParam         = fLanczosT;
+    if (MhwPolyphaseCache::Instance()->Lookup(&CacheKey, piCoefs, MHW_SCALER_UV_WIN_SIZE * MHW_TABLE_PHASE_COUNT))
+    {
+        goto finish;
+    }
+    piCoefsBase     = piCoefs;
+
     phaseCount      = MHW_TABLE_PHASE_COUNT;
     centerPixel     = (MHW_SCALER_UV_WIN_SIZE / 2) - 1;
     startOffset     = (double)(-centerPixel);
@@ -742,6 +941,8 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUV(
         }
     }
 
+    MhwPolyphaseCache::Instance()->Insert(&CacheKey, piCoefsBase, MHW_SCALER_UV_WIN_SIZE * phaseCount);
+
 finish:
     return eStatus;
 }
@@ -774,12 +975,25 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUVOffset(
     int32_t     maxCoef[MHW_SCALER_UV_WIN_SIZE];
     int32_t     i, j;
     int32_t     adjusted_phase;
+    int32_t     *piCoefsBase;
+    MHW_POLYPHASE_CACHE_KEY CacheKey;
     MOS_STATUS              eStatus = MOS_STATUS_SUCCESS;
 
     MHW_FUNCTION_ENTER;
 
     MHW_CHK_NULL(piCoefs);
 
+    MOS_ZeroMemory(&CacheKey, sizeof(CacheKey));
+    CacheKey.dwType         = MHW_POLYPHASE_TABLE_UV_OFFSET;
+    CacheKey.iUvPhaseOffset = iUvPhaseOffset;
+    CacheKey.fScaleFactor   = fInverseScaleFactor;
+    CacheKey.fParam         = fLanczosT;
+    if (MhwPolyphaseCache::Instance()->Lookup(&CacheKey, piCoefs, MHW_SCALER_UV_WIN_SIZE * MHW_TABLE_PHASE_COUNT))
+    {
+        goto finish;
+    }
+    piCoefsBase = piCoefs;
+
     phaseCount = MHW_TABLE_PHASE_COUNT;
     centerPixel = (MHW_SCALER_UV_WIN_SIZE / 2) - 1;
     startOffset = (double)(-centerPixel +
@@ -838,10 +1052,59 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUVOffset(
         }
     }
 
+    MhwPolyphaseCache::Instance()->Insert(&CacheKey, piCoefsBase, MHW_SCALER_UV_WIN_SIZE * phaseCount);
+
 finish:
     return eStatus;
 }
 
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to calculate a polyphase table of type
+    //!           MHW_POLYPHASE_TABLE_TYPE through the cache. fScaleFactor is the
+    //!           inverse scale factor and fParam the Lanczos factor of UV tables,
+    //!           fParam the high pass strength of Y tables.
+    //!
+    MOS_FUNC_EXPORT MOS_STATUS Mhw_UltCalcPolyphaseTable(
+        uint32_t        dwType,
+        int32_t         *piCoefs,
+        float           fScaleFactor,
+        float           fParam,
+        uint32_t        dwPlane,
+        uint32_t        dwFormat,
+        bool            bUse8x8Filter,
+        uint32_t        dwHwPhase,
+        int32_t         iUvPhaseOffset)
+    {
+        switch (dwType)
+        {
+        case MHW_POLYPHASE_TABLE_Y:
+            return Mhw_CalcPolyphaseTablesY(piCoefs, fScaleFactor, dwPlane, (MOS_FORMAT)dwFormat, fParam, bUse8x8Filter, dwHwPhase);
+        case MHW_POLYPHASE_TABLE_UV:
+            return Mhw_CalcPolyphaseTablesUV(piCoefs, fParam, fScaleFactor);
+        case MHW_POLYPHASE_TABLE_UV_OFFSET:
+            return Mhw_CalcPolyphaseTablesUVOffset(piCoefs, fParam, fScaleFactor, iUvPhaseOffset);
+        default:
+            return MOS_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    MOS_FUNC_EXPORT MOS_STATUS Mhw_UltGetPolyphaseCacheStats(
+        uint64_t        *pHits,
+        uint64_t        *pMisses)
+    {
+        return Mhw_GetPolyphaseCacheStats(pHits, pMisses);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 //!
 //! \brief    Allocate BB
 //! \details  Allocated Batch Buffer
@@ -654,6 +654,10 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUVOffset(
     float       fInverseScaleFactor,
     int32_t     iUvPhaseOffset);
 
+MOS_STATUS Mhw_GetPolyphaseCacheStats(
+    uint64_t        *pHits,
+    uint64_t        *pMisses);
+
 MOS_STATUS Mhw_AllocateBb(
     PMOS_INTERFACE          pOsInterface,
     PMHW_BATCH_BUFFER       pBatchBuffer,
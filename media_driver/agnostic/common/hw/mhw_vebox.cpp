@@ -195,6 +195,208 @@ finish:
     return eStatus;
 }
 
+uint64_t MhwVeboxInterface::HashVeboxStateParams(
+    const void                              *pData,
+    uint32_t                                dwSize,
+    uint64_t                                ui64Hash)
+{
+    const uint8_t   *pByte = (const uint8_t *)pData;
+
+    if (ui64Hash == 0)
+    {
+        ui64Hash = 0xcbf29ce484222325ULL;
+    }
+
+    for (uint32_t i = 0; i < dwSize; i++)
+    {
+        ui64Hash ^= pByte[i];
+        ui64Hash *= 0x100000001b3ULL;
+    }
+
+    return ui64Hash ? ui64Hash : 1;
+}
+
+MOS_STATUS MhwVeboxInterface::UpdateVeboxDndiState(
+    PMHW_VEBOX_DNDI_PARAMS                  pVeboxDndiParams,
+    bool                                    bStateUpdatedByGpu)
+{
+    PMHW_VEBOX_HEAP_STATE   pVeboxCurState;
+    uint64_t                ui64Hash;
+    MOS_STATUS              eStatus = MOS_STATUS_SUCCESS;
+
+    MHW_CHK_NULL(pVeboxDndiParams);
+    MHW_CHK_NULL(m_veboxHeap);
+
+    pVeboxCurState = &m_veboxHeap->pStates[m_veboxHeap->uiCurState];
+    ui64Hash       = HashVeboxStateParams(pVeboxDndiParams, sizeof(*pVeboxDndiParams), 0);
+
+    // The hash only selects the candidate, the params are compared in full
+    if (!bStateUpdatedByGpu                             &&
+        pVeboxCurState->ui64DndiStateHash == ui64Hash   &&
+        !memcmp(&pVeboxCurState->DndiParams, pVeboxDndiParams, sizeof(*pVeboxDndiParams)))
+    {
+        m_veboxHeap->dwDndiStateReused++;
+        goto finish;
+    }
+
+    pVeboxCurState->ui64DndiStateHash = 0;
+    MHW_CHK_STATUS(AddVeboxDndiState(pVeboxDndiParams));
+
+    // A state the GPU modifies no longer matches its params
+    if (!bStateUpdatedByGpu)
+    {
+        pVeboxCurState->DndiParams        = *pVeboxDndiParams;
+        pVeboxCurState->ui64DndiStateHash = ui64Hash;
+    }
+    m_veboxHeap->dwDndiStateWritten++;
+
+finish:
+    return eStatus;
+}
+
+MOS_STATUS MhwVeboxInterface::UpdateVeboxIecpState(
+    PMHW_VEBOX_IECP_PARAMS                  pVeboxIecpParams)
+{
+    PMHW_VEBOX_HEAP_STATE   pVeboxCurState;
+    uint64_t                ui64Hash;
+    bool                    bUseLut;
+    MOS_STATUS              eStatus = MOS_STATUS_SUCCESS;
+
+    MHW_CHK_NULL(pVeboxIecpParams);
+    MHW_CHK_NULL(m_veboxHeap);
+
+    pVeboxCurState = &m_veboxHeap->pStates[m_veboxHeap->uiCurState];
+
+    // LUT contents are not covered by the hash, always build
+    bUseLut = pVeboxIecpParams->s3DLutParams.pLUT                            ||
+              pVeboxIecpParams->s1DLutParams.p1DLUT                          ||
+              pVeboxIecpParams->s1DLutParams.pCCM                            ||
+              pVeboxIecpParams->CapPipeParams.ICCColorConversionParams.pLUT;
+
+    ui64Hash = HashVeboxStateParams(pVeboxIecpParams, sizeof(*pVeboxIecpParams), 0);
+    if (pVeboxIecpParams->pfCscCoeff)
+    {
+        ui64Hash = HashVeboxStateParams(pVeboxIecpParams->pfCscCoeff, 9 * sizeof(float), ui64Hash);
+    }
+    if (pVeboxIecpParams->pfCscInOffset)
+    {
+        ui64Hash = HashVeboxStateParams(pVeboxIecpParams->pfCscInOffset, 3 * sizeof(float), ui64Hash);
+    }
+    if (pVeboxIecpParams->pfCscOutOffset)
+    {
+        ui64Hash = HashVeboxStateParams(pVeboxIecpParams->pfCscOutOffset, 3 * sizeof(float), ui64Hash);
+    }
+
+    if (!bUseLut && pVeboxCurState->ui64IecpStateHash == ui64Hash)
+    {
+        m_veboxHeap->dwIecpStateReused++;
+        goto finish;
+    }
+
+    pVeboxCurState->ui64IecpStateHash = 0;
+    MHW_CHK_STATUS(AddVeboxIecpState(pVeboxIecpParams));
+    pVeboxCurState->ui64IecpStateHash = bUseLut ? 0 : ui64Hash;
+    m_veboxHeap->dwIecpStateWritten++;
+
+finish:
+    return eStatus;
+}
+
+#if MOS_ULT_HOOKS_ENABLED
+//!
+//! \brief  VEBOX interface of the ULT, records the DNDI states built
+//!
+class MhwVeboxInterfaceUlt : public MhwVeboxInterface
+{
+public:
+    MhwVeboxInterfaceUlt(PMOS_INTERFACE pOsInterface) : MhwVeboxInterface(pOsInterface) {}
+
+    MOS_STATUS AddVeboxVertexTable(MHW_CSPACE) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS AddVeboxState(PMOS_COMMAND_BUFFER, PMHW_VEBOX_STATE_CMD_PARAMS, bool) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS AddVeboxSurfaces(PMOS_COMMAND_BUFFER, PMHW_VEBOX_SURFACE_STATE_CMD_PARAMS) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS AddVeboxDiIecp(PMOS_COMMAND_BUFFER, PMHW_VEBOX_DI_IECP_CMD_PARAMS) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS AddVeboxGamutState(PMHW_VEBOX_IECP_PARAMS, PMHW_VEBOX_GAMUT_PARAMS) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS AddVeboxIecpState(PMHW_VEBOX_IECP_PARAMS) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS AddVeboxIecpAceState(PMHW_VEBOX_IECP_PARAMS) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS VeboxAdjustBoundary(PMHW_VEBOX_SURFACE_PARAMS, uint32_t *, uint32_t *, bool) { return MOS_STATUS_SUCCESS; }
+    MOS_STATUS AddVeboxSurfaceControlBits(PMHW_VEBOX_SURFACE_CNTL_PARAMS, uint32_t *) { return MOS_STATUS_SUCCESS; }
+
+    MOS_STATUS AddVeboxDndiState(PMHW_VEBOX_DNDI_PARAMS)
+    {
+        m_bDndiStateWritten = true;
+        return MOS_STATUS_SUCCESS;
+    }
+
+    bool m_bDndiStateWritten = false;
+};
+
+MOS_STATUS MhwVeboxInterface::UltRunDndiStateOps(
+    uint32_t                                uiNumInstances,
+    PMHW_VEBOX_ULT_DNDI_OP                  pOps,
+    uint32_t                                dwOpNum)
+{
+    MOS_INTERFACE   OsInterface;
+    MOS_STATUS      eStatus = MOS_STATUS_SUCCESS;
+
+    MHW_CHK_NULL_RETURN(pOps);
+    if (uiNumInstances == 0)
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    MOS_ZeroMemory(&OsInterface, sizeof(OsInterface));
+    MhwVeboxInterfaceUlt VeboxInterface(&OsInterface);
+
+    VeboxInterface.m_veboxHeap = (PMHW_VEBOX_HEAP)MOS_AllocAndZeroMemory(
+        sizeof(MHW_VEBOX_HEAP) + uiNumInstances * sizeof(MHW_VEBOX_HEAP_STATE));
+    MHW_CHK_NULL_RETURN(VeboxInterface.m_veboxHeap);
+    VeboxInterface.m_veboxHeap->pStates = (PMHW_VEBOX_HEAP_STATE)(VeboxInterface.m_veboxHeap + 1);
+
+    for (uint32_t i = 0; i < dwOpNum; i++)
+    {
+        PMHW_VEBOX_ULT_DNDI_OP pOp = &pOps[i];
+
+        if (pOp->uiState >= uiNumInstances)
+        {
+            pOp->eStatus = MOS_STATUS_INVALID_PARAMETER;
+        }
+        else
+        {
+            VeboxInterface.m_veboxHeap->uiCurState = pOp->uiState;
+            VeboxInterface.m_bDndiStateWritten     = false;
+            pOp->eStatus  = VeboxInterface.UpdateVeboxDndiState(&pOp->DndiParams, pOp->bStateUpdatedByGpu);
+            pOp->bWritten = VeboxInterface.m_bDndiStateWritten;
+        }
+
+        if (pOp->eStatus != MOS_STATUS_SUCCESS)
+        {
+            eStatus = pOp->eStatus;
+        }
+    }
+
+    MOS_FreeMemory(VeboxInterface.m_veboxHeap);
+    VeboxInterface.m_veboxHeap = nullptr;
+
+    return eStatus;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT MOS_STATUS MhwVebox_UltRunDndiStateOps(
+        uint32_t                                uiNumInstances,
+        PMHW_VEBOX_ULT_DNDI_OP                  pOps,
+        uint32_t                                dwOpNum)
+    {
+        return MhwVeboxInterface::UltRunDndiStateOps(uiNumInstances, pOps, dwOpNum);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 MOS_STATUS MhwVeboxInterface::GetVeboxHeapInfo(
     const MHW_VEBOX_HEAP     **ppVeboxHeap)
 {
@@ -331,6 +533,10 @@ MOS_STATUS MhwVeboxInterface::DestroyHeap()
 
     if (m_veboxHeap)
     {
+        MHW_NORMALMESSAGE("Vebox state reuse: DNDI %d reused / %d built, IECP %d reused / %d built.",
+            m_veboxHeap->dwDndiStateReused, m_veboxHeap->dwDndiStateWritten,
+            m_veboxHeap->dwIecpStateReused, m_veboxHeap->dwIecpStateWritten);
+
         if (!Mos_ResourceIsNull(&m_veboxHeap->DriverResource))
         {
             if (m_veboxHeap->pLockedDriverResourceMem)
@@ -748,6 +748,9 @@ typedef struct _MHW_VEBOX_HEAP_STATE
 {
     bool        bBusy;                                      // true if the state is in use (must sync before use)
     uint32_t    dwSyncTag;                                  // Vebox heap state sync tag
+    uint64_t    ui64DndiStateHash;                          // Hash of the params the DNDI state was built from, 0 if unknown
+    uint64_t    ui64IecpStateHash;                          // Hash of the params the IECP states were built from, 0 if unknown
+    MHW_VEBOX_DNDI_PARAMS   DndiParams;                     // Params the DNDI state was built from, valid if ui64DndiStateHash is not 0
 } MHW_VEBOX_HEAP_STATE, *PMHW_VEBOX_HEAP_STATE;
 
 //!
@@ -777,8 +780,26 @@ typedef struct _MHW_VEBOX_HEAP
     volatile uint32_t       *pSync;                                              // Pointer to sync area (when locked)
     uint32_t                dwNextTag;                                          // Next sync tag value to use
     uint32_t                dwSyncTag;                                          // Last sync tag completed
+
+    // Indirect state reuse statistics
+    uint32_t                dwDndiStateReused;                                  // DNDI states found already built in the instance
+    uint32_t                dwDndiStateWritten;                                 // DNDI states built
+    uint32_t                dwIecpStateReused;                                  // IECP states found already built in the instance
+    uint32_t                dwIecpStateWritten;                                 // IECP states built
 } MHW_VEBOX_HEAP, *PMHW_VEBOX_HEAP;
 
+//!
+//! \brief  DNDI state update run by the ULT on a host copy of the VEBOX heap and its result
+//!
+typedef struct _MHW_VEBOX_ULT_DNDI_OP
+{
+    MHW_VEBOX_DNDI_PARAMS   DndiParams;                     // [in] params of the update
+    uint32_t                uiState;                        // [in] heap instance to update
+    bool                    bStateUpdatedByGpu;             // [in] the DNDI state is modified on the GPU after the update
+    bool                    bWritten;                       // [out] the DNDI state was built by AddVeboxDndiState
+    MOS_STATUS              eStatus;                        // [out] status of the update
+} MHW_VEBOX_ULT_DNDI_OP, *PMHW_VEBOX_ULT_DNDI_OP;
+
 //!
 //! \brief  VEBOX settings Structure
 //!
@@ -1105,6 +1126,58 @@ public:
     //!
     MOS_STATUS UpdateVeboxSync();
 
+    //!
+    //! \brief    Update VEBOX DNDI State
+    //! \details  Builds the DNDI state of the current heap instance through
+    //!           AddVeboxDndiState unless the instance already holds a state
+    //!           built from identical params. Clients using this must not
+    //!           write the DNDI state by other means, except on the GPU after
+    //!           an update with bStateUpdatedByGpu set.
+    //! \param    [in] pVeboxDndiParams
+    //!           Pointer to VEBOX DNDI State Params
+    //! \param    [in] bStateUpdatedByGpu
+    //!           The DNDI state is modified on the GPU after this update, e.g. by
+    //!           the auto denoise kernel. The state is always built and not reused.
+    //! \return   MOS_STATUS
+    //!
+    MOS_STATUS UpdateVeboxDndiState(
+        PMHW_VEBOX_DNDI_PARAMS                  pVeboxDndiParams,
+        bool                                    bStateUpdatedByGpu = false);
+
+    //!
+    //! \brief    Update VEBOX IECP States
+    //! \details  Builds the IECP states of the current heap instance through
+    //!           AddVeboxIecpState unless the instance already holds states
+    //!           built from identical params. States using LUTs are always
+    //!           built. Clients using this must not write the IECP states by
+    //!           other means.
+    //! \param    [in, out] pVeboxIecpParams
+    //!           Pointer to VEBOX IECP State Params
+    //! \return   MOS_STATUS
+    //!
+    MOS_STATUS UpdateVeboxIecpState(
+        PMHW_VEBOX_IECP_PARAMS                  pVeboxIecpParams);
+
+#if MOS_ULT_HOOKS_ENABLED
+    //!
+    //! \brief    Run DNDI state updates for ULT
+    //! \details  Runs UpdateVeboxDndiState on a host copy of the VEBOX heap with
+    //!           an AddVeboxDndiState that only records the call
+    //! \param    [in] uiNumInstances
+    //!           Number of heap instances
+    //! \param    [in, out] pOps
+    //!           Updates to run and their results
+    //! \param    [in] dwOpNum
+    //!           Number of updates
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if all updates succeeded, else fail reason
+    //!
+    static MOS_STATUS UltRunDndiStateOps(
+        uint32_t                                uiNumInstances,
+        PMHW_VEBOX_ULT_DNDI_OP                  pOps,
+        uint32_t                                dwOpNum);
+#endif
+
 private:
     //!
     //! \brief    Refresh Vebox Sync
@@ -1114,6 +1187,22 @@ private:
     //!
     void RefreshVeboxSync();
 
+    //!
+    //! \brief    Hash VEBOX state params
+    //! \details  64 bit FNV-1a, never returns 0
+    //! \param    [in] pData
+    //!           Params to hash
+    //! \param    [in] dwSize
+    //!           Size of params
+    //! \param    [in] ui64Hash
+    //!           Hash to continue from, 0 to start a new hash
+    //! \return   uint64_t
+    //!
+    static uint64_t HashVeboxStateParams(
+        const void                              *pData,
+        uint32_t                                dwSize,
+        uint64_t                                ui64Hash);
+
     //! \brief    Vebox heap instance in use
     int                    m_veboxHeapInUse = 0;
 
@@ -1123,4 +1212,49 @@ private:
     MHW_VEBOX_SETTINGS     m_veboxSettings;
 };
 
+//!
+//! \brief    Fill STMM history
+//! \details  Sets the 2 STMM bytes of every 4 byte element of a locked STMM
+//!           surface to DNDI_HISTORY_INITVALUE. The denoise history bytes are
+//!           left untouched, so the fill is done with 16 bit stores, 4 elements
+//!           per iteration, instead of a fill call per element.
+//! \param    [in] pData
+//!           Locked STMM surface
+//! \param    [in] dwWidth
+//!           Surface width in bytes
+//! \param    [in] dwHeight
+//!           Surface height
+//! \param    [in] dwPitch
+//!           Surface pitch
+//! \return   void
+//!
+static __inline void Mhw_FillSTMMHistory(
+    uint8_t                 *pData,
+    uint32_t                dwWidth,
+    uint32_t                dwHeight,
+    uint32_t                dwPitch)
+{
+    const uint16_t  wInitValue = (DNDI_HISTORY_INITVALUE << 8) | DNDI_HISTORY_INITVALUE;
+    uint32_t        dwElements = dwWidth >> 2;
+
+    for (uint32_t y = 0; y < dwHeight; y++)
+    {
+        uint16_t    *pWord = (uint16_t *)(pData + y * dwPitch);
+        uint32_t    x      = 0;
+
+        for (; x + 4 <= dwElements; x += 4, pWord += 8)
+        {
+            pWord[0] = wInitValue;
+            pWord[2] = wInitValue;
+            pWord[4] = wInitValue;
+            pWord[6] = wInitValue;
+        }
+
+        for (; x < dwElements; x++, pWord += 2)
+        {
+            pWord[0] = wInitValue;
+        }
+    }
+}
+
 #endif // __MHW_VEBOX_H__
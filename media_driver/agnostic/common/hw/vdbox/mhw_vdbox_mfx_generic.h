@@ -1132,24 +1132,18 @@ protected:
         typename TMfxCmds::MFD_IT_OBJECT_MPEG2_INLINE_DATA_CMD m_inlineData;
     };
 
-    MOS_STATUS AddMfdMpeg2ITObject(
-        PMOS_COMMAND_BUFFER cmdBuffer,
-        PMHW_BATCH_BUFFER batchBuffer,
+    //!
+    //! \brief    Set up Mfd mpeg2 IT object command from MB state
+    //! \param    [out] cmd
+    //!           Command to be set up
+    //! \param    [in] params
+    //!           Params structure used to populate the HW command
+    //! \return   void
+    //!
+    void SetMfdMpeg2ITObject(
+        MFD_MPEG2_IT_OBJECT_CMD &cmd,
         PMHW_VDBOX_MPEG2_MB_STATE params)
     {
-        MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
-
-        MHW_FUNCTION_ENTER;
-
-        MHW_MI_CHK_NULL(params);
-
-        if (cmdBuffer == nullptr && batchBuffer == nullptr)
-        {
-            MHW_ASSERTMESSAGE("No valid buffer to add the command to!");
-            return MOS_STATUS_INVALID_PARAMETER;
-        }
-
-        MFD_MPEG2_IT_OBJECT_CMD cmd;
         cmd.m_inlineData.DW0.MacroblockIntraType = mpeg2Vc1MacroblockIntra;
 
         typename TMfxCmds::MFD_IT_OBJECT_MPEG2_INLINE_DATA_CMD *inlineDataMpeg2 = &(cmd.m_inlineData);
@@ -1193,12 +1187,89 @@ protected:
                 inlineDataMpeg2->DW5.Value = *point++;
             }
         }
+    }
+
+    MOS_STATUS AddMfdMpeg2ITObject(
+        PMOS_COMMAND_BUFFER cmdBuffer,
+        PMHW_BATCH_BUFFER batchBuffer,
+        PMHW_VDBOX_MPEG2_MB_STATE params)
+    {
+        MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+        MHW_FUNCTION_ENTER;
+
+        MHW_MI_CHK_NULL(params);
+        MHW_MI_CHK_NULL(params->pMBParams);
+
+        if (cmdBuffer == nullptr && batchBuffer == nullptr)
+        {
+            MHW_ASSERTMESSAGE("No valid buffer to add the command to!");
+            return MOS_STATUS_INVALID_PARAMETER;
+        }
+
+        MFD_MPEG2_IT_OBJECT_CMD cmd;
+        SetMfdMpeg2ITObject(cmd, params);
 
         MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, sizeof(cmd)));
 
         return eStatus;
     }
 
+    MOS_STATUS AddMfdMpeg2SkippedITObjects(
+        PMHW_BATCH_BUFFER batchBuffer,
+        PMHW_VDBOX_MPEG2_MB_STATE params,
+        uint16_t startMbAddr,
+        uint16_t numMbs)
+    {
+        MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+        MHW_FUNCTION_ENTER;
+
+        MHW_MI_CHK_NULL(batchBuffer);
+        MHW_MI_CHK_NULL(batchBuffer->pData);
+        MHW_MI_CHK_NULL(params);
+        MHW_MI_CHK_NULL(params->pMBParams);
+
+        int32_t cmdSize = sizeof(MFD_MPEG2_IT_OBJECT_CMD);
+        int32_t runSize = cmdSize * numMbs;
+        if (batchBuffer->iRemaining < runSize)
+        {
+            MHW_ASSERTMESSAGE("Unable to add command (no space).");
+            return MOS_STATUS_UNKNOWN;
+        }
+
+        // Build the command once, only the MB position changes along the run
+        MFD_MPEG2_IT_OBJECT_CMD cmd;
+        auto mbParams      = params->pMBParams;
+        uint16_t mbAddr    = mbParams->m_mbAddr;
+        mbParams->m_mbAddr = startMbAddr;
+        SetMfdMpeg2ITObject(cmd, params);
+        mbParams->m_mbAddr = mbAddr;
+
+        uint32_t horzOrigin = cmd.m_inlineData.DW1.Horzorigin;
+        uint32_t vertOrigin = cmd.m_inlineData.DW1.Vertorigin;
+        auto     cmdOut     = (MFD_MPEG2_IT_OBJECT_CMD *)(batchBuffer->pData + batchBuffer->iCurrent);
+
+        for (uint16_t i = 0; i < numMbs; i++)
+        {
+            cmd.m_inlineData.DW1.Horzorigin  = horzOrigin;
+            cmd.m_inlineData.DW1.Vertorigin  = vertOrigin;
+            cmd.m_inlineData.DW0.Lastmbinrow = (horzOrigin == (uint32_t)(params->wPicWidthInMb - 1));
+            *cmdOut++ = cmd;
+
+            if (++horzOrigin == params->wPicWidthInMb)
+            {
+                horzOrigin = 0;
+                vertOrigin++;
+            }
+        }
+
+        batchBuffer->iCurrent   += runSize;
+        batchBuffer->iRemaining -= runSize;
+
+        return eStatus;
+    }
+
     MOS_STATUS AddMfcMpeg2SliceGroupCmd(
         PMOS_COMMAND_BUFFER cmdBuffer,
         PMHW_VDBOX_MPEG2_SLICE_STATE mpeg2SliceState)
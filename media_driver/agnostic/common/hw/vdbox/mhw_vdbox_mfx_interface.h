@@ -1708,6 +1708,29 @@ public:
         PMHW_BATCH_BUFFER batchBuffer,
         PMHW_VDBOX_MPEG2_MB_STATE params) = 0;
 
+    //!
+    //! \brief    Adds Mfd mpeg2 IT object commands for a run of skipped macroblocks in batch buffer
+    //! \details  The command is built once from params and copied for each macroblock of the run,
+    //!           only the macroblock position is patched. params->pMBParams->m_mbAddr is ignored
+    //!
+    //! \param    [in] batchBuffer
+    //!           Batch buffer to add to VDBOX_BUFFER_START
+    //! \param    [in] params
+    //!           Params structure used to populate the HW command
+    //! \param    [in] startMbAddr
+    //!           Address of the first skipped macroblock
+    //! \param    [in] numMbs
+    //!           Number of skipped macroblocks
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    virtual MOS_STATUS AddMfdMpeg2SkippedITObjects(
+        PMHW_BATCH_BUFFER batchBuffer,
+        PMHW_VDBOX_MPEG2_MB_STATE params,
+        uint16_t startMbAddr,
+        uint16_t numMbs) = 0;
+
     //!
     //! \brief    Adds Mpeg2 Group Slice State command in command buffer
     //!
@@ -67,6 +67,13 @@
 //! Command res info dumps are a debug feature so should not be enabled in release builds
 #define MOS_COMMAND_RESINFO_DUMP_SUPPORTED (_DEBUG || _RELEASE_INTERNAL)
 
+//! Test hooks for devult are only exported from non-production drivers, or when built with MEDIA_ULT_HOOKS
+#if (_DEBUG || _RELEASE_INTERNAL || MEDIA_ULT_HOOKS)
+#define MOS_ULT_HOOKS_ENABLED 1
+#else
+#define MOS_ULT_HOOKS_ENABLED 0
+#endif
+
 typedef FILE*                   PFILE;                      //!< Pointer to a File
 typedef FILE**                  PPFILE;                     //!< Pointer to a PFILE
 typedef HMODULE*                PHMODULE;                   //!< Pointer to an HMODULE
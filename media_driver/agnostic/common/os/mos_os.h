@@ -519,6 +519,10 @@ typedef struct _MOS_INTERFACE
     GMM_CLIENT_CONTEXT* (* pfnGetGmmClientContext) (
         PMOS_INTERFACE              pOsInterface);
 
+    //!< Device the resources are allocated from, resources may be shared by OS interfaces of the same device
+    void* (* pfnGetDeviceHandle) (
+        PMOS_INTERFACE              pOsInterface);
+
     MOS_STATUS (* pfnIsGpuContextValid) (
         PMOS_INTERFACE              pOsInterface,
         MOS_GPU_CONTEXT             GpuContext);
@@ -746,6 +750,16 @@ typedef struct _MOS_INTERFACE
         PMOS_INTERFACE              pOsInterface,
         PMOS_RESOURCE               pResource);
 
+    //!< Content the driver last formatted the resource with, 0 if unknown or written since
+    uint32_t (* pfnGetResourceContentTag) (
+        PMOS_INTERFACE              pOsInterface,
+        PMOS_RESOURCE               pResource);
+
+    void (* pfnSetResourceContentTag) (
+        PMOS_INTERFACE              pOsInterface,
+        PMOS_RESOURCE               pResource,
+        uint32_t                    tag);
+
     MOS_STATUS (* pfnSetPatchEntry) (
         PMOS_INTERFACE              pOsInterface,
         PMOS_PATCH_ENTRY_PARAMS     pParams);
@@ -264,6 +264,15 @@ static MOS_USER_FEATURE_VALUE MOSUserFeatureDescFields[__MOS_USER_FEATURE_KEY_MA
      MOS_USER_FEATURE_VALUE_TYPE_INT32,
      "0",
      "Linux Performance Tag"),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_DEFERRED_SURFACE_RELEASE_ID,
+     "Deferred Surface Release",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_BOOL,
+     "0",
+     "Release the allocations of destroyed surfaces on a worker thread instead of the destroying thread. (Default 0: Disable "),
     MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_ENABLE_ID,
      "Perf Profiler Enable",
      __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
@@ -372,6 +381,24 @@ static MOS_USER_FEATURE_VALUE MOSUserFeatureDescFields[__MOS_USER_FEATURE_KEY_MA
      MOS_USER_FEATURE_VALUE_TYPE_UINT32,
      "0",
      "Performance Profiler Memory Information Register"),
+    MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_DRAIN_INTERVAL,
+     "Perf Profiler Drain Interval",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "0",
+     "Performance Profiler interval in ms of draining completed data to the output file. (Default 0: save at exit "),
+    MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_FILE_SIZE_LIMIT,
+     "Perf Profiler File Size Limit",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "0",
+     "Performance Profiler output file size in bytes before rotation when draining. (Default 0: no rotation "),
     MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_DISABLE_KMD_WATCHDOG_ID,
      "Disable KMD Watchdog",
      __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
@@ -1371,6 +1398,24 @@ MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ENCODE_BRC_SOFTWARE_ID,
      MOS_USER_FEATURE_VALUE_TYPE_UINT32,
      "0",
      "Enable Compute Context. default:0 disabled."),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_ENCODE_SLICE_SEGMENT_OUTPUT_ID,
+     "Encode Slice Segment Output",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "Encode",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_BOOL,
+     "0",
+     "Return AVC/HEVC coded buffers as one VACodedBufferSegment per slice when slice sizes are reported by PAK. (Default 0: Disable "),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_ENCODE_TRACKED_BUFFER_POOL_SIZE_ID,
+     "Encode Tracked Buffer Pool Size",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "Encode",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "0",
+     "Size in MB of the process wide pool that keeps released encoder tracked buffers for other encoder instances on the same device. (Default 0: Disable "),
     MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_DECODE_ENABLE_COMPUTE_CONTEXT_ID,
         "Enable Compute Context",
         __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
@@ -2387,6 +2432,24 @@ MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ENCODE_BRC_SOFTWARE_ID,
      MOS_USER_FEATURE_VALUE_TYPE_UINT32,
      "0",
      "MDF EMU Enable"),
+     MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_PATH_ID,
+     __MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_PATH,
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "MDF",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_STRING,
+     "",
+     "Directory where jitter finalized kernel binaries are cached across processes. (Default empty: in-memory cache only "),
+     MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_SIZE_ID,
+     __MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_SIZE,
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "MDF",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "64",
+     "Size limit in MB of the JIT binary cache, in memory and on disk each. (Default 64, 0: Disable "),
      MOS_DECLARE_UF_KEY(__VPHAL_VEBOX_OUTPUTPIPE_MODE_ID,
      "VPOutputPipe Mode",
      __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
@@ -2747,6 +2810,15 @@ MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ENCODE_BRC_SOFTWARE_ID,
      MOS_USER_FEATURE_VALUE_TYPE_UINT32,
      "0",
      "Hcp Decode mode switch single pipe <-> 2/3 pipe"),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_HCP_DECODE_LOAD_AWARE_PIPE_NUM_ID,
+     "HCP Decode Load Aware Pipe Num",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "Decode",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_BOOL,
+     "1",
+     "Take Vdbox pipes used by other decode contexts into account when deciding scalable decode pipe num. (Default 1: Enable "),
     MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_HEVC_ENCODE_ENABLE_VE_DEBUG_OVERRIDE,
      "Enable VE Debug Override",
      __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
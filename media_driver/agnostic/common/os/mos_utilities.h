@@ -173,6 +173,7 @@ typedef enum _MOS_USER_FEATURE_VALUE_ID
     __MEDIA_USER_FEATURE_VALUE_SIM_IN_USE_ID,
     __MEDIA_USER_FEATURE_VALUE_FORCE_VDBOX_ID,
     __MEDIA_USER_FEATURE_VALUE_LINUX_PERFORMANCETAG_ENABLE_ID,
+    __MEDIA_USER_FEATURE_VALUE_DEFERRED_SURFACE_RELEASE_ID,
     __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_OUTPUT_FILE,
     __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_BUFFER_SIZE,
@@ -185,6 +186,8 @@ typedef enum _MOS_USER_FEATURE_VALUE_ID
     __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_REGISTER_6,
     __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_REGISTER_7,
     __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_REGISTER_8,
+    __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_DRAIN_INTERVAL,
+    __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_FILE_SIZE_LIMIT,
     __MEDIA_USER_FEATURE_VALUE_DISABLE_KMD_WATCHDOG_ID,
     __MEDIA_USER_FEATURE_VALUE_SINGLE_TASK_PHASE_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_MFE_MBENC_ENABLE_ID,
@@ -203,6 +206,8 @@ typedef enum _MOS_USER_FEATURE_VALUE_ID
     __MEDIA_USER_FEATURE_VALUE_ENCODE_ENABLE_FRAME_TRACKING_ID,
     __MEDIA_USER_FEATURE_VALUE_ENCODE_USED_VDBOX_NUM_ID,
     __MEDIA_USER_FEATURE_VALUE_ENCODE_ENABLE_COMPUTE_CONTEXT_ID,
+    __MEDIA_USER_FEATURE_VALUE_ENCODE_SLICE_SEGMENT_OUTPUT_ID,
+    __MEDIA_USER_FEATURE_VALUE_ENCODE_TRACKED_BUFFER_POOL_SIZE_ID,
     __MEDIA_USER_FEATURE_VALUE_DECODE_ENABLE_COMPUTE_CONTEXT_ID,
     __MEDIA_USER_FEATURE_VALUE_AVC_ENCODE_ME_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_AVC_ENCODE_16xME_ENABLE_ID,
@@ -422,6 +427,8 @@ typedef enum _MOS_USER_FEATURE_VALUE_ID
     __MEDIA_USER_FEATURE_VALUE_MDF_CURBE_DUMP_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_MDF_SURFACE_DUMP_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_MDF_EMU_MODE_ENABLE_ID,
+    __MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_PATH_ID,
+    __MEDIA_USER_FEATURE_VALUE_MDF_JIT_CACHE_SIZE_ID,
     __MEDIA_USER_FEATURE_ENABLE_RENDER_ENGINE_MMC_ID,
     __VPHAL_VEBOX_OUTPUTPIPE_MODE_ID,
     __VPHAL_VEBOX_FEATURE_INUSE_ID,
@@ -469,6 +476,7 @@ typedef enum _MOS_USER_FEATURE_VALUE_ID
     __MEDIA_USER_FEATURE_VALUE_VEBOX_SPLIT_RATIO_ID,
     __MEDIA_USER_FEATURE_VALUE_HCP_DECODE_MODE_SWITCH_THRESHOLD1_ID,
     __MEDIA_USER_FEATURE_VALUE_HCP_DECODE_MODE_SWITCH_THRESHOLD2_ID,
+    __MEDIA_USER_FEATURE_VALUE_HCP_DECODE_LOAD_AWARE_PIPE_NUM_ID,
     __MEDIA_USER_FEATURE_VALUE_HEVC_ENCODE_ENABLE_VE_DEBUG_OVERRIDE,
     __MEDIA_USER_FEATURE_VALUE_HEVC_ENCODE_ENABLE_HW_SEMAPHORE,
     __MEDIA_USER_FEATURE_VALUE_HEVC_ENCODE_ENABLE_VDBOX_HW_SEMAPHORE,
@@ -912,6 +912,10 @@ typedef struct _RENDERHAL_STATE_HEAP
     RENDERHAL_MEDIA_STATE_LIST  FreeStates;                                     // Free media state objects (pool)
     RENDERHAL_MEDIA_STATE_LIST  ReservedStates;                                 // Reserved media states
     RENDERHAL_MEDIA_STATE_LIST  SubmittedStates;                                // Submitted media states
+    int32_t                     iMediaStatePoolInc;                             // Number of media states added on next pool extension
+    uint32_t                    dwMediaStatePoolHits;                           // Media states obtained from the free pool
+    uint32_t                    dwMediaStatePoolMisses;                         // Media state requests that required a pool extension
+    uint32_t                    dwMediaStatePoolExtends;                        // Number of pool extensions
 
     //---------------------------
     // Surface State Heap
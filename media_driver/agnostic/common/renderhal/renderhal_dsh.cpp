@@ -34,7 +34,10 @@ MOS_STATUS RenderHal_AllocateDebugSurface(
 
 //!
 //! \brief    Extend the media state pool
-//! \details  Extends the media state pool by adding 16 media state objects
+//! \details  Extends the media state pool. The first extension adds 16 media
+//!           state objects; every following extension doubles the increment
+//!           (up to RENDERHAL_DSH_DYN_STATE_MAX_INC), so that deep submission
+//!           queues settle after a few extensions instead of growing in small steps
 //! \param    PRENDERHAL_STATE_HEAP pStateHeap
 //!           [in] Pointer to the state heap
 //! \return   MOS_STATUS
@@ -52,7 +55,7 @@ MOS_STATUS RenderHal_DSH_ExtendMediaStatePool(
     MHW_RENDERHAL_ASSERT(pStateHeap);
     //---------------------------------------
 
-    int32_t iCount = RENDERHAL_DSH_DYN_STATE_INC;
+    int32_t iCount = MOS_MAX(pStateHeap->iMediaStatePoolInc, RENDERHAL_DSH_DYN_STATE_INC);
 
     // Extend pool and get pointer to first element of the new pool object
     PRENDERHAL_MEDIA_STATE      pFirst, pLast, pPrev;
@@ -66,8 +69,15 @@ MOS_STATUS RenderHal_DSH_ExtendMediaStatePool(
         goto finish;
     }
 
-    // Increment size of the list
+    // Increment size of the list, next extension is twice as large
     pList->iCount += iCount;
+    pStateHeap->iMediaStatePoolInc = MOS_MIN(iCount * 2, RENDERHAL_DSH_DYN_STATE_MAX_INC);
+    pStateHeap->dwMediaStatePoolExtends++;
+
+    // Extensions are rare once the pool has settled, report the counters with each
+    MHW_RENDERHAL_NORMALMESSAGE("Media state pool extended by %d to %u states: %u hits, %u misses, %u extensions.",
+        iCount, pStateHeap->pMediaStatesMemPool->m_dwObjCount,
+        pStateHeap->dwMediaStatePoolHits, pStateHeap->dwMediaStatePoolMisses, pStateHeap->dwMediaStatePoolExtends);
 
     // Initialize new doubled linked list and internal structure
     iSize = pStateHeap->pMediaStatesMemPool->m_dwObjSize; // enough for media state and dynamic state objects
@@ -100,7 +110,7 @@ finish:
 //!
 //! \brief    Get a media state from the pool
 //! \details  Returns a pointer to a media state from the pool
-//!           If pool is empty, the pool is extended (adds 16 media states)
+//!           If pool is empty, the pool is extended (see RenderHal_DSH_ExtendMediaStatePool)
 //! \param    PRENDERHAL_STATE_HEAP pStateHeap
 //!           [in] Pointer to the state heap
 //! \return   PRENDERHAL_MEDIA_STATE pointer to a media state
@@ -120,8 +130,13 @@ PRENDERHAL_MEDIA_STATE RenderHal_DSH_GetMediaStateFromPool(
     // If pool is empty, extend pool of free media states
     if (pList->iCount == 0)
     {
+        pStateHeap->dwMediaStatePoolMisses++;
         MHW_RENDERHAL_CHK_STATUS(RenderHal_DSH_ExtendMediaStatePool(pStateHeap));
     }
+    else
+    {
+        pStateHeap->dwMediaStatePoolHits++;
+    }
 
     // Get Element from the head of the list
     pMediaState = pList->pHead;
@@ -168,17 +183,19 @@ void RenderHal_DSH_ReturnMediaStateToPool(
 
     PRENDERHAL_MEDIA_STATE_LIST pList = &pStateHeap->FreeStates;
 
-    // Attach element to the head of the list
-    pMediaState->pPrev = pList->pTail;
-    pList->pTail = pMediaState;
-    if (pMediaState->pPrev)
+    // Attach element to the head of the list - most recently retired media
+    // state is handed out first (still warm in cache)
+    pMediaState->pPrev = nullptr;
+    pMediaState->pNext = pList->pHead;
+    pList->pHead = pMediaState;
+    if (pMediaState->pNext)
     {
-        pMediaState->pPrev->pNext = pMediaState;
+        pMediaState->pNext->pPrev = pMediaState;
     }
     else
     {   // List was empty - insert first element
         MHW_ASSERT(pList->iCount == 0);
-        pList->pHead = pMediaState;
+        pList->pTail = pMediaState;
     }
     pList->iCount++;
 
@@ -598,6 +615,12 @@ MOS_STATUS RenderHal_DSH_AllocateStateHeaps(
     MOS_ZeroMemory(&pStateHeap->KernelsSubmitted     , sizeof(RENDERHAL_KRN_ALLOC_LIST));
     MOS_ZeroMemory(&pStateHeap->KernelAllocationPool , sizeof(RENDERHAL_KRN_ALLOC_LIST));
 
+    // Media state pool statistics
+    pStateHeap->iMediaStatePoolInc      = RENDERHAL_DSH_DYN_STATE_INC;
+    pStateHeap->dwMediaStatePoolHits    = 0;
+    pStateHeap->dwMediaStatePoolMisses  = 0;
+    pStateHeap->dwMediaStatePoolExtends = 0;
+
     // Create pool of media state objects
     iSize = sizeof(RENDERHAL_MEDIA_STATE) + sizeof(RENDERHAL_DYNAMIC_STATE) + 16; // Media state object + Dynamic states object (co-located)
 
@@ -754,6 +777,9 @@ MOS_STATUS RenderHal_DSH_FreeStateHeaps(PRENDERHAL_INTERFACE pRenderHal)
         pStateHeap->pSshBuffer = nullptr;
     }
 
+    MHW_RENDERHAL_NORMALMESSAGE("Media state pool: %u hits, %u misses, %u extensions.",
+        pStateHeap->dwMediaStatePoolHits, pStateHeap->dwMediaStatePoolMisses, pStateHeap->dwMediaStatePoolExtends);
+
     if(pStateHeap->pMediaStatesMemPool)
     {
         MOS_Delete(pStateHeap->pMediaStatesMemPool);
@@ -844,6 +870,10 @@ finish:
 //!
 //! \brief    Refresh Sync
 //! \details  Update Sync tags
+//!           Submitted media states and submitted kernels are kept in submission
+//!           order (tags are non-decreasing from head to tail), so both lists are
+//!           retired from the head and the walk stops at the first object that
+//!           is still in flight - only newly completed objects are visited
 //! \param    PRENDERHAL_INTERFACE pRenderHal
 //!           [in] Pointer to Hardware Interface Structure
 //! \return   MOS_STATUS
@@ -913,7 +943,6 @@ MOS_STATUS RenderHal_DSH_RefreshSync(PRENDERHAL_INTERFACE pRenderHal)
 
     pNextMediaState = nullptr;
     pCurMediaState  = pList->pHead;
-    iStatesInUse    = 0;
     for (; pCurMediaState != nullptr; pCurMediaState = pNextMediaState)
     {
         // Save next media state before moving current state back to pool (if complete)
@@ -922,93 +951,93 @@ MOS_STATUS RenderHal_DSH_RefreshSync(PRENDERHAL_INTERFACE pRenderHal)
         if (!pCurMediaState->bBusy) continue;
 
         // The condition below is valid when sync tag wraps from 2^32-1 to 0
-        if ((int32_t)(dwCurrentFrameId - pCurMediaState->dwSyncTag) >= 0)
+        // States are retired in submission order - all following states are still in flight
+        if ((int32_t)(dwCurrentFrameId - pCurMediaState->dwSyncTag) < 0)
         {
-            pDynamicState = pCurMediaState->pDynamicState;
-            pCurMediaState->bBusy = false;
-            if (pRenderHal->bKerneltimeDump)
-            {
-                uint64_t uiNS;
-                uint8_t *pCurrentPtr;
-                uint64_t uiStartTime;
-                uint64_t uiEndTime;
-                uint64_t uiDiff;
-                double  TimeMS;
-                uint32_t uiComponent;
-                uint32_t performanceSize = sizeof(uint64_t) * 2 + sizeof(RENDERHAL_COMPONENT);
-                uint8_t *data = (uint8_t*)MOS_AllocAndZeroMemory(performanceSize);
-                if (data == nullptr)
-                {
-                    eStatus = MOS_STATUS_NO_SPACE;
-                    goto finish;
-                }
-                // Dump Kernel execution time when media state is being freed
-                pDynamicState->memoryBlock.ReadData(data, pDynamicState->Performance.dwOffset, performanceSize);
-                pCurrentPtr = data;
-                uiStartTime = *((uint64_t *)pCurrentPtr);
-                pCurrentPtr += sizeof(uint64_t);
-                uiEndTime = *((uint64_t *)pCurrentPtr);
-                pCurrentPtr += sizeof(uint64_t);
-                uiComponent = *((RENDERHAL_COMPONENT *)pCurrentPtr);
-                if (uiComponent < (uint32_t)RENDERHAL_COMPONENT_COUNT)
-                {
-                    // Convert ticks to ns
-                    uiDiff = uiEndTime - uiStartTime;
-                    uiNS = 0;
-                    pRenderHal->pfnConvertToNanoSeconds(pRenderHal, uiDiff, &uiNS);
+            break;
+        }
 
-                    TimeMS = ((double)uiNS) / (1000 * 1000); // Convert to ms (double)
+        pDynamicState = pCurMediaState->pDynamicState;
+        pCurMediaState->bBusy = false;
+        if (pRenderHal->bKerneltimeDump)
+        {
+            uint64_t uiNS;
+            uint8_t *pCurrentPtr;
+            uint64_t uiStartTime;
+            uint64_t uiEndTime;
+            uint64_t uiDiff;
+            double  TimeMS;
+            uint32_t uiComponent;
+            uint32_t performanceSize = sizeof(uint64_t) * 2 + sizeof(RENDERHAL_COMPONENT);
+            uint8_t *data = (uint8_t*)MOS_AllocAndZeroMemory(performanceSize);
+            if (data == nullptr)
+            {
+                eStatus = MOS_STATUS_NO_SPACE;
+                goto finish;
+            }
+            // Dump Kernel execution time when media state is being freed
+            pDynamicState->memoryBlock.ReadData(data, pDynamicState->Performance.dwOffset, performanceSize);
+            pCurrentPtr = data;
+            uiStartTime = *((uint64_t *)pCurrentPtr);
+            pCurrentPtr += sizeof(uint64_t);
+            uiEndTime = *((uint64_t *)pCurrentPtr);
+            pCurrentPtr += sizeof(uint64_t);
+            uiComponent = *((RENDERHAL_COMPONENT *)pCurrentPtr);
+            if (uiComponent < (uint32_t)RENDERHAL_COMPONENT_COUNT)
+            {
+                // Convert ticks to ns
+                uiDiff = uiEndTime - uiStartTime;
+                uiNS = 0;
+                pRenderHal->pfnConvertToNanoSeconds(pRenderHal, uiDiff, &uiNS);
 
-                    pRenderHal->kernelTime[uiComponent] += TimeMS;
-                }
+                TimeMS = ((double)uiNS) / (1000 * 1000); // Convert to ms (double)
 
-                MOS_SafeFreeMemory(data);
+                pRenderHal->kernelTime[uiComponent] += TimeMS;
             }
 
-            // Detach from submitted states, return to pool
-            *((pCurMediaState->pNext) ? &(pCurMediaState->pNext->pPrev) : &(pList->pTail)) = pCurMediaState->pPrev;
-            *((pCurMediaState->pPrev) ? &(pCurMediaState->pPrev->pNext) : &(pList->pHead)) = pCurMediaState->pNext;
-            pCurMediaState->pPrev = pCurMediaState->pNext = nullptr;
-            pList->iCount--;
-
-            // Return media state object back to pool
-            RenderHal_DSH_ReturnMediaStateToPool(pStateHeap, pCurMediaState);
-        }
-        else
-        {
-            iStatesInUse++;
+            MOS_SafeFreeMemory(data);
         }
+
+        // Detach from submitted states, return to pool
+        *((pCurMediaState->pNext) ? &(pCurMediaState->pNext->pPrev) : &(pList->pTail)) = pCurMediaState->pPrev;
+        *((pCurMediaState->pPrev) ? &(pCurMediaState->pPrev->pNext) : &(pList->pHead)) = pCurMediaState->pNext;
+        pCurMediaState->pPrev = pCurMediaState->pNext = nullptr;
+        pList->iCount--;
+
+        // Return media state object back to pool
+        RenderHal_DSH_ReturnMediaStateToPool(pStateHeap, pCurMediaState);
     }
+    iStatesInUse = pList->iCount;
 
-    // Refresh kernels
-    iKernelsInUse  = 0;
+    // Refresh kernels - kernels are moved to the tail of the submitted list when
+    // touched, so the list is sorted by sync tag
     pKrnAllocation = pStateHeap->KernelsSubmitted.pHead;
     for ( ; pKrnAllocation != nullptr; pKrnAllocation = pNext)
     {
         pNext = pKrnAllocation->pNext;
 
-        // Move kernels back to allocated list (kernel remains cached)
-        if ((int32_t)(dwCurrentFrameId - pKrnAllocation->dwSync) >= 0)
+        // Kernel still being executed - all following kernels were submitted later
+        if ((int32_t)(dwCurrentFrameId - pKrnAllocation->dwSync) < 0)
         {
-            RenderHal_DSH_KernelAttach(&pStateHeap->KernelsAllocated, pKrnAllocation, false);
+            break;
+        }
 
-            // Kernel block is flagged for removal (growing ISH) - delete block, mark kernel as stale
-            if (pKrnAllocation->pMemoryBlock && pKrnAllocation->pMemoryBlock->bDelete)
-            {
-                pMhwStateHeap->FreeDynamicBlockDyn(MHW_ISH_TYPE, pKrnAllocation->pMemoryBlock, dwCurrentFrameId);
-                pKrnAllocation->dwFlags = RENDERHAL_KERNEL_ALLOCATION_USED;
-            }
-            else
-            {
-                // Mark kernel as in use, not locked
-                pKrnAllocation->dwFlags = RENDERHAL_KERNEL_ALLOCATION_USED;
-            }
+        // Move kernels back to allocated list (kernel remains cached)
+        RenderHal_DSH_KernelAttach(&pStateHeap->KernelsAllocated, pKrnAllocation, false);
+
+        // Kernel block is flagged for removal (growing ISH) - delete block, mark kernel as stale
+        if (pKrnAllocation->pMemoryBlock && pKrnAllocation->pMemoryBlock->bDelete)
+        {
+            pMhwStateHeap->FreeDynamicBlockDyn(MHW_ISH_TYPE, pKrnAllocation->pMemoryBlock, dwCurrentFrameId);
+            pKrnAllocation->dwFlags = RENDERHAL_KERNEL_ALLOCATION_USED;
         }
         else
         {
-            iKernelsInUse++;
+            // Mark kernel as in use, not locked
+            pKrnAllocation->dwFlags = RENDERHAL_KERNEL_ALLOCATION_USED;
         }
     }
+    iKernelsInUse = pStateHeap->KernelsSubmitted.iCount;
 
     // Refresh blocks
     pMhwStateHeap->RefreshDynamicHeapDyn(MHW_ISH_TYPE, dwCurrentFrameId);
@@ -32,8 +32,9 @@
 // Absolute max number of interface descriptors
 #define RENDERHAL_DSH_MAX_MEDIA_IDs 16
 
-// Media dynamic state pool increment
-#define RENDERHAL_DSH_DYN_STATE_INC 16
+// Media dynamic state pool increment (initial and maximum - pool extensions double up to the maximum)
+#define RENDERHAL_DSH_DYN_STATE_INC     16
+#define RENDERHAL_DSH_DYN_STATE_MAX_INC 256
 
 // Kernel allocation pool increment
 #define RENDERHAL_DSH_KRN_ALLOC_INC 16
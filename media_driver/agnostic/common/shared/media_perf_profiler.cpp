@@ -25,11 +25,16 @@
 //! \details  
 //!
 
+#include <stdio.h>
+#include <string>
+#include <vector>
 #include "media_perf_profiler.h"
 
 #define UMD_PERF_LOG            8
 #define NAME_LEN                60
 #define LOCAL_STRING_SIZE       64
+#define INVALID_NODE_INDEX      0xFFFFFFFF
+#define DRAIN_SLEEP_SLICE       10
 #define OFFSET_OF(TYPE, MEMBER) ((size_t) & ((TYPE *)0)->MEMBER )
 
 typedef enum _UMD_PERF_MODE
@@ -68,6 +73,11 @@ struct NodeHeader
 
 #define BASE_OF_NODE(perfDataIndex) (sizeof(NodeHeader) + (sizeof(PerfEntry) * perfDataIndex))
 
+// Timestamps are stored 8 bytes aligned, so the end timestamp of a node
+// overlaps the (unused) node index of the next node.
+#define BEGIN_TS_OF_NODE(perfDataIndex) MOS_ALIGN_CEIL(BASE_OF_NODE(perfDataIndex) + OFFSET_OF(PerfEntry, beginTimeClockValue), 8)
+#define END_TS_OF_NODE(perfDataIndex)   MOS_ALIGN_CEIL(BASE_OF_NODE(perfDataIndex) + OFFSET_OF(PerfEntry, endTimeClockValue), 8)
+
 #define CHK_STATUS_RETURN(_stmt)                   \
 {                                                  \
     MOS_STATUS stmtStatus = (MOS_STATUS)(_stmt);   \
@@ -170,11 +180,22 @@ void MediaPerfProfiler::Destroy(MediaPerfProfiler* profiler, void* context, MOS_
     profiler->m_ref--;
 
     profiler->m_contextIndexMap.erase(context);
+    profiler->m_contextInstanceMap.erase(context);
 
     if (profiler->m_ref == 0)
     {
         if (profiler->m_initialized == true)
         {
+            if (profiler->m_drainThread != 0)
+            {
+                // The drain thread does not take the mutex, so it is joined
+                // with the mutex held and no instance can reference the
+                // profiler before the buffer is freed
+                profiler->m_drainStop = true;
+                MOS_WaitThread(profiler->m_drainThread);
+                profiler->m_drainThread = 0;
+            }
+
             profiler->SavePerfData(osInterface);
     
             osInterface->pfnFreeResource(
@@ -207,6 +228,7 @@ MOS_STATUS MediaPerfProfiler::Initialize(void* context, MOS_INTERFACE *osInterfa
     MOS_LockMutex(m_mutex);
 
     m_contextIndexMap[context] = 0;
+    m_contextInstanceMap[context] = ++m_instanceNum;
 
     if (m_initialized == true)
     {
@@ -251,6 +273,30 @@ MOS_STATUS MediaPerfProfiler::Initialize(void* context, MOS_INTERFACE *osInterfa
         &userFeatureData);
     m_timerReg = userFeatureData.u32Data;
 
+    // Read ring mode settings
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_DRAIN_INTERVAL,
+        &userFeatureData);
+    m_drainInterval = userFeatureData.u32Data;
+
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_PERF_PROFILER_FILE_SIZE_LIMIT,
+        &userFeatureData);
+    m_fileSizeLimit = userFeatureData.u32Data;
+
+    // Leave room for the end timestamp of the last node
+    if (m_bufferSize < BASE_OF_NODE(1) + sizeof(uint32_t))
+    {
+        MOS_UnlockMutex(m_mutex);
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+    m_nodeNum       = (m_bufferSize - sizeof(NodeHeader) - sizeof(uint32_t)) / sizeof(PerfEntry);
+    m_perfDataIndex = 0;
+
     // Read memory information register address
     int8_t regIndex = 0;
     for (regIndex = 0; regIndex < 8; regIndex++)
@@ -316,6 +362,25 @@ MOS_STATUS MediaPerfProfiler::Initialize(void* context, MOS_INTERFACE *osInterfa
             osInterface,
             &m_perfStoreBuffer);
 
+    if (m_drainInterval != 0)
+    {
+        // Keep the buffer locked for the drain thread
+        MOS_ZeroMemory(&lockFlags, sizeof(MOS_LOCK_PARAMS));
+        m_perfStoreData = (uint8_t*)osInterface->pfnLockResource(
+            osInterface,
+            &m_perfStoreBuffer,
+            &lockFlags);
+
+        CHK_NULL_UNLOCK_MUTEX_RETURN(m_perfStoreData);
+
+        m_drainIndex   = 0;
+        m_fileSize     = 0;
+        m_droppedNodes = 0;
+        m_drainStop    = false;
+        m_latencyStats.clear();
+        m_drainThread  = MOS_CreateThread((void*)DrainThread, this);
+    }
+
     m_initialized = true;
 
     MOS_UnlockMutex(m_mutex);
@@ -412,15 +477,61 @@ MOS_STATUS MediaPerfProfiler::AddPerfCollectStartCmd(void* context,
     CHK_NULL_RETURN(m_mutex);
 
     uint32_t perfDataIndex = 0;
+    uint32_t instanceId    = 0;
 
     MOS_LockMutex(m_mutex);
 
-    perfDataIndex = m_perfDataIndex;
-    m_perfDataIndex++;
+    if (m_drainInterval != 0)
+    {
+        perfDataIndex = m_perfDataIndex % m_nodeNum;
+    }
+    else if (m_perfDataIndex < m_nodeNum)
+    {
+        perfDataIndex = m_perfDataIndex;
+    }
+    else
+    {
+        // Buffer full, only saved at destroy
+        perfDataIndex = INVALID_NODE_INDEX;
+    }
 
-    MOS_UnlockMutex(m_mutex);
+    if (perfDataIndex != INVALID_NODE_INDEX)
+    {
+        m_perfDataIndex++;
+    }
 
     m_contextIndexMap[context] = perfDataIndex;
+    instanceId                 = m_contextInstanceMap[context];
+
+    MOS_UnlockMutex(m_mutex);
+
+    if (perfDataIndex == INVALID_NODE_INDEX)
+    {
+        return status;
+    }
+
+    if (m_drainInterval != 0)
+    {
+        CHK_STATUS_RETURN(StoreData(
+            miInterface,
+            cmdBuffer,
+            BASE_OF_NODE(perfDataIndex) + OFFSET_OF(PerfEntry, instanceId),
+            instanceId));
+
+        // A node overwritten before it was drained still holds the end
+        // timestamp of the previous lap, clear it until this one completes
+        CHK_STATUS_RETURN(StoreData(
+            miInterface,
+            cmdBuffer,
+            END_TS_OF_NODE(perfDataIndex),
+            0));
+
+        CHK_STATUS_RETURN(StoreData(
+            miInterface,
+            cmdBuffer,
+            END_TS_OF_NODE(perfDataIndex) + sizeof(uint32_t),
+            0));
+    }
 
     bool             rcsEngineUsed = false;
     MOS_GPU_CONTEXT  gpuContext;
@@ -463,8 +574,7 @@ MOS_STATUS MediaPerfProfiler::AddPerfCollectStartCmd(void* context,
     }
 
     // The address of timestamp must be 8 bytes aligned.
-    uint32_t offset = BASE_OF_NODE(perfDataIndex) + OFFSET_OF(PerfEntry, beginTimeClockValue);
-    offset = MOS_ALIGN_CEIL(offset, 8);
+    uint32_t offset = BEGIN_TS_OF_NODE(perfDataIndex);
 
     if (rcsEngineUsed)
     {
@@ -499,6 +609,7 @@ MOS_STATUS MediaPerfProfiler::AddPerfCollectEndCmd(void* context,
     CHK_NULL_RETURN(osInterface);
     CHK_NULL_RETURN(miInterface);
     CHK_NULL_RETURN(cmdBuffer);
+    CHK_NULL_RETURN(m_mutex);
 
     MOS_GPU_CONTEXT  gpuContext;
     bool             rcsEngineUsed = false;
@@ -507,7 +618,14 @@ MOS_STATUS MediaPerfProfiler::AddPerfCollectEndCmd(void* context,
     gpuContext     = osInterface->pfnGetGpuContext(osInterface);
     rcsEngineUsed = MOS_RCS_ENGINE_USED(gpuContext);
 
+    MOS_LockMutex(m_mutex);
     perfDataIndex = m_contextIndexMap[context];
+    MOS_UnlockMutex(m_mutex);
+
+    if (perfDataIndex == INVALID_NODE_INDEX)
+    {
+        return status;
+    }
 
     int8_t regIndex = 0;
     for (regIndex = 0; regIndex < 8; regIndex++)
@@ -523,8 +641,7 @@ MOS_STATUS MediaPerfProfiler::AddPerfCollectEndCmd(void* context,
     }
 
     // The address of timestamp must be 8 bytes aligned.
-    uint32_t offset = BASE_OF_NODE(perfDataIndex) + OFFSET_OF(PerfEntry, endTimeClockValue);
-    offset = MOS_ALIGN_CEIL(offset, 8);
+    uint32_t offset = END_TS_OF_NODE(perfDataIndex);
 
     if (rcsEngineUsed)
     {
@@ -549,6 +666,20 @@ MOS_STATUS MediaPerfProfiler::SavePerfData(MOS_INTERFACE *osInterface)
     MOS_STATUS status = MOS_STATUS_SUCCESS;
 
     CHK_NULL_RETURN(osInterface);
+
+    if (m_perfStoreData != nullptr)
+    {
+        // Ring mode, drain what is left
+        status = DrainPerfData();
+        SaveLatencyStats();
+
+        osInterface->pfnUnlockResource(
+            osInterface,
+            &m_perfStoreBuffer);
+        m_perfStoreData = nullptr;
+
+        return status;
+    }
     
     if (m_perfDataIndex > 0)
     {
@@ -575,6 +706,273 @@ MOS_STATUS MediaPerfProfiler::SavePerfData(MOS_INTERFACE *osInterface)
     return status;
 }
 
+void *MediaPerfProfiler::DrainThread(void *data)
+{
+    MediaPerfProfiler *profiler = (MediaPerfProfiler *)data;
+
+    while (!profiler->m_drainStop)
+    {
+        for (uint32_t elapsed = 0;
+             elapsed < profiler->m_drainInterval && !profiler->m_drainStop;
+             elapsed += DRAIN_SLEEP_SLICE)
+        {
+            MOS_Sleep(DRAIN_SLEEP_SLICE);
+        }
+
+        if (profiler->DrainPerfData() == MOS_STATUS_SUCCESS)
+        {
+            profiler->SaveLatencyStats();
+        }
+    }
+
+    return nullptr;
+}
+
+MOS_STATUS MediaPerfProfiler::DrainPerfData()
+{
+    std::vector<uint8_t> nodes;
+    uint32_t             perfDataIndex = 0;
+
+    CHK_NULL_RETURN(m_perfStoreData);
+
+    perfDataIndex = m_perfDataIndex;
+
+    // Nodes already reused by new submissions are lost
+    if (perfDataIndex - m_drainIndex > m_nodeNum)
+    {
+        m_droppedNodes += perfDataIndex - m_drainIndex - m_nodeNum;
+        m_drainIndex    = perfDataIndex - m_nodeNum;
+    }
+
+    for (; m_drainIndex != perfDataIndex; m_drainIndex++)
+    {
+        uint32_t  node    = m_drainIndex % m_nodeNum;
+        PerfEntry *entry  = (PerfEntry *)(m_perfStoreData + BASE_OF_NODE(node));
+        uint64_t  *beginTS = (uint64_t *)(m_perfStoreData + BEGIN_TS_OF_NODE(node));
+        uint64_t  *endTS   = (uint64_t *)(m_perfStoreData + END_TS_OF_NODE(node));
+
+        if (*endTS == 0)
+        {
+            // Nodes complete out of order across engines, only give up on
+            // a node once it is half the ring behind
+            if (perfDataIndex - m_drainIndex <= m_nodeNum / 2)
+            {
+                break;
+            }
+            m_droppedNodes++;
+            continue;
+        }
+
+        uint64_t         latency = (*endTS > *beginTS) ? (*endTS - *beginTS) : 0;
+        uint64_t         key     = ((uint64_t)entry->instanceId << 32) | entry->engineTag;
+        PerfLatencyStats &stats  = m_latencyStats[key];
+        uint32_t         bin     = 0;
+
+        while (bin < PERF_LATENCY_HISTOGRAM_BINS - 1 && (latency >> (bin + 1)) != 0)
+        {
+            bin++;
+        }
+
+        if (stats.count == 0 || latency < stats.min)
+        {
+            stats.min = latency;
+        }
+        stats.max = MOS_MAX(stats.max, latency);
+        stats.sum += latency;
+        stats.count++;
+        stats.histogram[bin]++;
+
+        // Same layout as the buffer: skip the node index, which the end
+        // timestamp of the previous node overlaps, and take the end timestamp
+        // overlapping the next one
+        size_t size = nodes.size();
+        nodes.resize(size + sizeof(PerfEntry));
+        MOS_SecureMemcpy(&nodes[size], sizeof(PerfEntry), (uint8_t *)entry + sizeof(uint32_t), sizeof(PerfEntry));
+
+        *endTS = 0;
+    }
+
+    if (nodes.empty())
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    if (m_fileSizeLimit != 0 && m_fileSize != 0 && m_fileSize + nodes.size() > m_fileSizeLimit)
+    {
+        char rotatedFileName[MOS_MAX_PATH_LENGTH + 3];
+        MOS_SecureStringPrint(rotatedFileName, sizeof(rotatedFileName), sizeof(rotatedFileName), "%s.1", m_outputFileName);
+        rename(m_outputFileName, rotatedFileName);
+        m_fileSize = 0;
+    }
+
+    if (m_fileSize == 0)
+    {
+        // New file starts with the header and the node index of first node
+        uint32_t header[2] = { 0 };
+        MOS_SecureMemcpy(header, sizeof(header), m_perfStoreData, sizeof(NodeHeader));
+        CHK_STATUS_RETURN(MOS_WriteFileFromPtr(m_outputFileName, header, sizeof(header)));
+        m_fileSize = sizeof(header);
+    }
+
+    CHK_STATUS_RETURN(MOS_AppendFileFromPtr(m_outputFileName, &nodes[0], (uint32_t)nodes.size()));
+    m_fileSize += nodes.size();
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MediaPerfProfiler::SaveLatencyStats()
+{
+    char        fileName[MOS_MAX_PATH_LENGTH + 8];
+    char        line[MOS_MAX_PATH_LENGTH];
+    std::string text;
+
+    MOS_SecureStringPrint(line, sizeof(line), sizeof(line),
+        "# Latency in GPU timestamp ticks, dropped nodes %u\n"
+        "# Percentiles are interpolated within log2 histogram bins\n", m_droppedNodes);
+    text += line;
+
+    for (auto &it : m_latencyStats)
+    {
+        const PerfLatencyStats &stats = it.second;
+        uint64_t               percentile[3] = { 0 };
+        const uint32_t         percent[3]    = { 50, 90, 99 };
+
+        // Latencies are taken as evenly spread over the bin the percentile falls in
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            uint64_t rank  = (stats.count * percent[i] + 99) / 100;
+            uint64_t count = 0;
+            for (uint32_t bin = 0; bin < PERF_LATENCY_HISTOGRAM_BINS; bin++)
+            {
+                if (count + stats.histogram[bin] >= rank)
+                {
+                    uint64_t lower = (bin == 0) ? 0 : (1ULL << bin);
+                    uint64_t upper = (bin < PERF_LATENCY_HISTOGRAM_BINS - 1) ? (2ULL << bin) : stats.max;
+                    percentile[i]  = lower + (uint64_t)((double)(upper - lower) * (rank - count) / stats.histogram[bin]);
+                    percentile[i]  = MOS_MIN(MOS_MAX(percentile[i], stats.min), stats.max);
+                    break;
+                }
+                count += stats.histogram[bin];
+            }
+        }
+
+        MOS_SecureStringPrint(line, sizeof(line), sizeof(line),
+            "instance %u engine %u count %llu min %llu avg %llu p50 %llu p90 %llu p99 %llu max %llu\n",
+            (uint32_t)(it.first >> 32), (uint32_t)it.first,
+            (unsigned long long)stats.count, (unsigned long long)stats.min,
+            (unsigned long long)(stats.sum / stats.count),
+            (unsigned long long)percentile[0], (unsigned long long)percentile[1],
+            (unsigned long long)percentile[2], (unsigned long long)stats.max);
+        text += line;
+    }
+
+    MOS_SecureStringPrint(fileName, sizeof(fileName), sizeof(fileName), "%s.stats", m_outputFileName);
+
+    return MOS_WriteFileFromPtr(fileName, (void *)text.c_str(), (uint32_t)text.size());
+}
+
+#if MOS_ULT_HOOKS_ENABLED
+MOS_STATUS MediaPerfProfiler::UltRunRingOps(
+    uint32_t              nodeNum,
+    const char            *outputFileName,
+    PPERF_PROFILER_ULT_OP ops,
+    uint32_t              opNum)
+{
+    CHK_NULL_RETURN(outputFileName);
+    CHK_NULL_RETURN(ops);
+
+    if (nodeNum == 0 || strlen(outputFileName) > MOS_MAX_PATH_LENGTH)
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    MediaPerfProfiler profiler;
+    profiler.m_drainInterval = 1;
+    profiler.m_nodeNum       = nodeNum;
+    profiler.m_perfStoreData = (uint8_t *)MOS_AllocAndZeroMemory(BASE_OF_NODE(nodeNum) + sizeof(uint64_t));
+    CHK_NULL_RETURN(profiler.m_perfStoreData);
+    MOS_SecureStringPrint(profiler.m_outputFileName, sizeof(profiler.m_outputFileName),
+        sizeof(profiler.m_outputFileName), "%s", outputFileName);
+
+    MOS_STATUS status = MOS_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < opNum; i++)
+    {
+        PPERF_PROFILER_ULT_OP op = &ops[i];
+        op->status               = MOS_STATUS_SUCCESS;
+
+        switch (op->type)
+        {
+        case PERF_PROFILER_ULT_SUBMIT:
+        {
+            // What the commands of AddPerfCollectStartCmd store in ring mode
+            op->node         = profiler.m_perfDataIndex++ % nodeNum;
+            PerfEntry *entry = (PerfEntry *)(profiler.m_perfStoreData + BASE_OF_NODE(op->node));
+            entry->instanceId = op->instanceId;
+            entry->engineTag  = op->engineTag;
+            *(uint64_t *)(profiler.m_perfStoreData + BEGIN_TS_OF_NODE(op->node)) = op->timeStamp;
+            *(uint64_t *)(profiler.m_perfStoreData + END_TS_OF_NODE(op->node))   = 0;
+            break;
+        }
+        case PERF_PROFILER_ULT_COMPLETE:
+            if (op->node >= nodeNum)
+            {
+                op->status = MOS_STATUS_INVALID_PARAMETER;
+                break;
+            }
+            *(uint64_t *)(profiler.m_perfStoreData + END_TS_OF_NODE(op->node)) = op->timeStamp;
+            break;
+        case PERF_PROFILER_ULT_DRAIN:
+        {
+            uint32_t fileSize = profiler.m_fileSize;
+            op->status        = profiler.DrainPerfData();
+            if (op->status == MOS_STATUS_SUCCESS)
+            {
+                op->status = profiler.SaveLatencyStats();
+            }
+            // A new output file starts with the header and the node index of the first node
+            if (fileSize == 0 && profiler.m_fileSize != 0)
+            {
+                fileSize = sizeof(uint32_t) * 2;
+            }
+            op->drainedNodes = (profiler.m_fileSize - fileSize) / sizeof(PerfEntry);
+            op->droppedNodes = profiler.m_droppedNodes;
+            break;
+        }
+        default:
+            op->status = MOS_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (op->status != MOS_STATUS_SUCCESS)
+        {
+            status = op->status;
+        }
+    }
+
+    MOS_FreeMemory(profiler.m_perfStoreData);
+    profiler.m_perfStoreData = nullptr;
+
+    return status;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT MOS_STATUS MediaPerfProfiler_UltRunRingOps(
+        uint32_t              nodeNum,
+        const char            *outputFileName,
+        PPERF_PROFILER_ULT_OP ops,
+        uint32_t              opNum)
+    {
+        return MediaPerfProfiler::UltRunRingOps(nodeNum, outputFileName, ops, opNum);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 PerfGPUNode MediaPerfProfiler::GpuContextToGpuNode(MOS_GPU_CONTEXT context)
 {
     PerfGPUNode node = PERF_GPU_NODE_UNKNOW;
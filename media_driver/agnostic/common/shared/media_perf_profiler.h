@@ -26,12 +26,55 @@
 #ifndef __MEDIA_PERF_PROFILER_H__
 #define __MEDIA_PERF_PROFILER_H__
 
+#include <atomic>
 #include <map>
 #include "mos_os.h"
 #include "mhw_mi.h"
 
 using Map = std::map<void*, uint32_t>;
 
+#define PERF_LATENCY_HISTOGRAM_BINS 64
+
+//!
+//! \brief  Latency statistics of the perf nodes of one instance on one engine,
+//!         in GPU timestamp ticks. Histogram bin n counts latencies in [2^n, 2^(n+1)).
+//!
+struct PerfLatencyStats
+{
+    uint64_t    count;
+    uint64_t    sum;
+    uint64_t    min;
+    uint64_t    max;
+    uint64_t    histogram[PERF_LATENCY_HISTOGRAM_BINS];
+};
+
+using StatsMap = std::map<uint64_t, PerfLatencyStats>;
+
+//!
+//! \brief  Operations of the ring mode run by the ULT on a host copy of the perf data buffer
+//!
+typedef enum _PERF_PROFILER_ULT_OP_TYPE
+{
+    PERF_PROFILER_ULT_SUBMIT,       //!< Reserve a node and write what the start commands store
+    PERF_PROFILER_ULT_COMPLETE,     //!< Write the end timestamp of a node
+    PERF_PROFILER_ULT_DRAIN         //!< Drain the completed nodes and save the statistics
+} PERF_PROFILER_ULT_OP_TYPE;
+
+//!
+//! \brief  Operation of the ring mode run by the ULT and its result
+//!
+typedef struct _PERF_PROFILER_ULT_OP
+{
+    PERF_PROFILER_ULT_OP_TYPE   type;
+    uint32_t    instanceId;         //!< [in] instance id of the submitted node
+    uint32_t    engineTag;          //!< [in] engine of the submitted node
+    uint32_t    node;               //!< [out] node of the submission, [in] node to complete
+    uint64_t    timeStamp;          //!< [in] begin timestamp of the submission, end timestamp of the completion
+    uint32_t    drainedNodes;       //!< [out] nodes written to the output file by the drain
+    uint32_t    droppedNodes;       //!< [out] nodes dropped so far
+    MOS_STATUS  status;             //!< [out] status of the operation
+} PERF_PROFILER_ULT_OP, *PPERF_PROFILER_ULT_OP;
+
 /*! \brief In order to align GPU node value for all of OS,
 *   we redifine the GPU node value here.
 */
@@ -122,6 +165,29 @@ public:
         MhwMiInterface *miInterface,
         MOS_COMMAND_BUFFER *cmdBuffer);
 
+#if MOS_ULT_HOOKS_ENABLED
+    //!
+    //! \brief    Run the ring mode of a profiler on a host buffer, used by ULT
+    //!
+    //! \param    [in] nodeNum
+    //!           Number of perf data nodes in the buffer
+    //! \param    [in] outputFileName
+    //!           Output file, the statistics are saved next to it
+    //! \param    [in, out] ops
+    //!           Operations to run in order, with their results
+    //! \param    [in] opNum
+    //!           Number of operations
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    static MOS_STATUS UltRunRingOps(
+        uint32_t              nodeNum,
+        const char            *outputFileName,
+        PPERF_PROFILER_ULT_OP ops,
+        uint32_t              opNum);
+#endif
+
 private:
     //!
     //! \brief    Constructor
@@ -218,6 +284,36 @@ private:
     //!
     MOS_STATUS SavePerfData(MOS_INTERFACE *osInterface);
 
+    //!
+    //! \brief    Drain thread of ring mode
+    //!
+    //! \param    [in] data
+    //!           Pointer of profiler
+    //!
+    //! \return   void *
+    //!
+    static void *DrainThread(void *data);
+
+    //!
+    //! \brief    Drain completed perf data nodes of ring mode
+    //! \details  Appends the nodes completed since last drain to the output
+    //!           file, rotating it when exceeding the size limit, and adds
+    //!           their latency to the statistics. Only called from the drain
+    //!           thread, or after it has stopped.
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS DrainPerfData();
+
+    //!
+    //! \brief    Save latency statistics in to a text file next to the output file
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS SaveLatencyStats();
+
     //!
     //! \brief    Convert GPU context to GPU node 
     //!
@@ -245,7 +341,7 @@ protected:
     PMOS_MUTEX                 m_mutex = nullptr;       //!< Mutex for protecting data of profiler when refereced multi times
 
     int32_t                    m_profilerEnabled = 0;   //!< UMD Perf Profiler enable or not
-    uint32_t                   m_perfDataIndex = 0;     //!< The index of performance data node in buffer
+    std::atomic<uint32_t>      m_perfDataIndex{0};      //!< The index of performance data node in buffer, read by drain thread without the mutex
     uint32_t                   m_ref = 0;               //!< The number of refereces
     uint32_t                   m_bufferSize = 10000000; //!< The size of perf data buffer
     uint32_t                   m_timerReg = 0;          //!< registers of Timer
@@ -253,6 +349,20 @@ protected:
 
     bool                       m_initialized = false;   //!< Indicate whether profiler was initialized
     char                       m_outputFileName[MOS_MAX_PATH_LENGTH + 1];  //!< Name of output file
+
+    // Ring mode, enabled by a drain interval
+    uint32_t                   m_drainInterval = 0;     //!< Interval in ms of draining completed nodes, 0 to save at destroy
+    uint32_t                   m_fileSizeLimit = 0;     //!< Output file size before rotation, 0 for no rotation
+    uint32_t                   m_nodeNum = 0;           //!< Number of perf data nodes in buffer
+    uint32_t                   m_drainIndex = 0;        //!< Index of the next node to drain
+    uint32_t                   m_fileSize = 0;          //!< Size of current output file
+    uint32_t                   m_droppedNodes = 0;      //!< Nodes overwritten or never completed before drain
+    uint32_t                   m_instanceNum = 0;       //!< Number of Codechal/VPHal instances profiled so far
+    uint8_t                    *m_perfStoreData = nullptr;  //!< Perf data buffer, locked while draining
+    MOS_THREADHANDLE           m_drainThread = 0;       //!< Drain thread
+    std::atomic<bool>          m_drainStop{false};      //!< Request drain thread to exit
+    Map                        m_contextInstanceMap;    //!< Map between CodecHal/VPHal and instance id
+    StatsMap                   m_latencyStats;          //!< Latency statistics by instance id and engine
 };
 
 #endif // __MEDIA_PERF_PROFILER_H__
@@ -6572,6 +6572,8 @@ void CompositeState::Destroy()
     PMOS_INTERFACE                      pOsInterface;
     PMHW_BATCH_BUFFER                   pBuffer;
     int32_t                             i;
+    uint64_t                            ui64PolyphaseHits;
+    uint64_t                            ui64PolyphaseMisses;
 
     VPHAL_RENDER_ASSERT(m_pRenderHal);
     VPHAL_RENDER_ASSERT(m_pOsInterface);
@@ -6607,6 +6609,13 @@ void CompositeState::Destroy()
 
     // Destroy sampler 8x8 state table parameters
     VpHal_RndrCommonDestroyAVSParams(&m_AvsParameters);
+
+    // The polyphase table cache is process wide, shared with SFC
+    if (Mhw_GetPolyphaseCacheStats(&ui64PolyphaseHits, &ui64PolyphaseMisses) == MOS_STATUS_SUCCESS)
+    {
+        VPHAL_RENDER_NORMALMESSAGE("Polyphase table cache: %llu hits, %llu misses",
+            (unsigned long long)ui64PolyphaseHits, (unsigned long long)ui64PolyphaseMisses);
+    }
 }
 
 //! \brief    Initialize interface for Composite
@@ -1624,8 +1624,11 @@ MOS_STATUS VPHAL_VEBOX_STATE::VeboxSetupIndirectStates(
 
     if (pRenderData->GetVeboxStateParams()->pVphalVeboxDndiParams)
     {
-        VPHAL_RENDER_CHK_STATUS(pVeboxInterface->AddVeboxDndiState(
-            pRenderData->GetVeboxStateParams()->pVphalVeboxDndiParams));
+        // Reuses the DNDI state of the heap instance when params are unchanged,
+        // except with auto denoise, whose update kernel rewrites the state on the GPU
+        VPHAL_RENDER_CHK_STATUS(pVeboxInterface->UpdateVeboxDndiState(
+            pRenderData->GetVeboxStateParams()->pVphalVeboxDndiParams,
+            pRenderData->bAutoDenoise));
     }
 
     // Set IECP State Params
@@ -1642,7 +1645,7 @@ MOS_STATUS VPHAL_VEBOX_STATE::VeboxSetupIndirectStates(
         VPHAL_RENDER_CHK_STATUS(m_IECP->InitParams(
             pSrcSurface->ColorSpace,
             &VeboxIecpParams));
-        VPHAL_RENDER_CHK_STATUS(pVeboxInterface->AddVeboxIecpState(
+        VPHAL_RENDER_CHK_STATUS(pVeboxInterface->UpdateVeboxIecpState(
             &VeboxIecpParams));
     }
 
@@ -2336,8 +2339,6 @@ MOS_STATUS VPHAL_VEBOX_STATE::VeboxInitSTMMHistory(
 {
     MOS_STATUS          eStatus;
     PMOS_INTERFACE      pOsInterface;
-    uint32_t            dwSize;
-    int32_t             x, y;
     uint8_t*            pByte;
     MOS_LOCK_PARAMS     LockFlags;
     PVPHAL_VEBOX_STATE  pVeboxState = this;
@@ -2358,20 +2359,12 @@ MOS_STATUS VPHAL_VEBOX_STATE::VeboxInitSTMMHistory(
 
     VPHAL_RENDER_CHK_NULL(pByte);
 
-    dwSize = pVeboxState->STMMSurfaces[iSurfaceIndex].dwWidth >> 2;
-
-    // Fill STMM surface with DN history init values.
-    for (y = 0; y < (int32_t)pVeboxState->STMMSurfaces[iSurfaceIndex].dwHeight; y++)
-    {
-        for (x = 0; x < (int32_t)dwSize; x++)
-        {
-            MOS_FillMemory(pByte, 2, DNDI_HISTORY_INITVALUE);
-            // skip denosie history init.
-            pByte += 4;
-        }
-
-        pByte += pVeboxState->STMMSurfaces[iSurfaceIndex].dwPitch - pVeboxState->STMMSurfaces[iSurfaceIndex].dwWidth;
-    }
+    // Fill STMM surface with DN history init values, skip denoise history init.
+    Mhw_FillSTMMHistory(
+        pByte,
+        pVeboxState->STMMSurfaces[iSurfaceIndex].dwWidth,
+        pVeboxState->STMMSurfaces[iSurfaceIndex].dwHeight,
+        pVeboxState->STMMSurfaces[iSurfaceIndex].dwPitch);
 
     // Unlock the surface
     VPHAL_RENDER_CHK_STATUS(pOsInterface->pfnUnlockResource(
@@ -344,3 +344,104 @@ MOS_STATUS MhwVdboxMfxInterfaceG9Skl::AddMfxPipeBufAddrCmd(
 
     return eStatus;
 }
+
+#if MOS_ULT_HOOKS_ENABLED
+// Host only OS interface, the IT object commands do not touch the device
+static void MhwVdboxMfxUltGetPlatform(PMOS_INTERFACE osInterface, PLATFORM *platform)
+{
+    MOS_ZeroMemory(platform, sizeof(*platform));
+}
+
+static MEDIA_FEATURE_TABLE *MhwVdboxMfxUltGetSkuTable(PMOS_INTERFACE osInterface)
+{
+    static MEDIA_FEATURE_TABLE skuTable;
+    return &skuTable;
+}
+
+static MEDIA_WA_TABLE *MhwVdboxMfxUltGetWaTable(PMOS_INTERFACE osInterface)
+{
+    static MEDIA_WA_TABLE waTable;
+    return &waTable;
+}
+
+static MEDIA_SYSTEM_INFO *MhwVdboxMfxUltGetGtSystemInfo(PMOS_INTERFACE osInterface)
+{
+    static MEDIA_SYSTEM_INFO gtSystemInfo;
+    return &gtSystemInfo;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to add the MPEG-2 IT objects of a run of
+    //!           skipped MBs of a P picture into pData, dwLoops times from the
+    //!           start of pData. bPerMb adds one object per MB, as coded MBs
+    //!           are, instead of the run at once. pdwSize is the size of pData
+    //!           in and the bytes added by one loop out.
+    //!
+    MOS_FUNC_EXPORT MOS_STATUS MhwVdboxMfx_UltAddMpeg2SkippedITObjects(
+        uint16_t        wPicWidthInMb,
+        uint16_t        wPicHeightInMb,
+        uint16_t        wStartMbAddr,
+        uint16_t        wNumMbs,
+        bool            bPerMb,
+        uint32_t        dwLoops,
+        uint8_t         *pData,
+        uint32_t        *pdwSize)
+    {
+        MHW_MI_CHK_NULL(pData);
+        MHW_MI_CHK_NULL(pdwSize);
+
+        MOS_INTERFACE osInterface;
+        MOS_ZeroMemory(&osInterface, sizeof(osInterface));
+        osInterface.pfnGetPlatform     = MhwVdboxMfxUltGetPlatform;
+        osInterface.pfnGetSkuTable     = MhwVdboxMfxUltGetSkuTable;
+        osInterface.pfnGetWaTable      = MhwVdboxMfxUltGetWaTable;
+        osInterface.pfnGetGtSystemInfo = MhwVdboxMfxUltGetGtSystemInfo;
+        MhwVdboxMfxInterfaceG9Skl mfxInterface(&osInterface, nullptr, nullptr, true);
+
+        CodecDecodeMpeg2MbParmas mbParams;
+        MOS_ZeroMemory(&mbParams, sizeof(mbParams));
+        mbParams.MBType.m_motionFwd  = 1;
+        mbParams.MBType.m_motionType = 2;
+
+        MHW_VDBOX_MPEG2_MB_STATE mbState;
+        MOS_ZeroMemory(&mbState, sizeof(mbState));
+        mbState.wPicWidthInMb  = wPicWidthInMb;
+        mbState.wPicHeightInMb = wPicHeightInMb;
+        mbState.wPicCodingType = P_TYPE;
+        mbState.pMBParams      = &mbParams;
+
+        MHW_BATCH_BUFFER batchBuffer;
+        MOS_ZeroMemory(&batchBuffer, sizeof(batchBuffer));
+        batchBuffer.pData = pData;
+
+        for (uint32_t loop = 0; loop < dwLoops; loop++)
+        {
+            batchBuffer.iCurrent   = 0;
+            batchBuffer.iRemaining = *pdwSize;
+
+            if (bPerMb)
+            {
+                for (uint16_t i = 0; i < wNumMbs; i++)
+                {
+                    mbParams.m_mbAddr = wStartMbAddr + i;
+                    MHW_MI_CHK_STATUS(mfxInterface.AddMfdMpeg2ITObject(nullptr, &batchBuffer, &mbState));
+                }
+            }
+            else
+            {
+                MHW_MI_CHK_STATUS(mfxInterface.AddMfdMpeg2SkippedITObjects(&batchBuffer, &mbState, wStartMbAddr, wNumMbs));
+            }
+        }
+        *pdwSize = batchBuffer.iCurrent;
+
+        return MOS_STATUS_SUCCESS;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // MOS_ULT_HOOKS_ENABLED
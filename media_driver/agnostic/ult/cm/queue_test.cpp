@@ -22,11 +22,18 @@
 
 #include "cm_test.h"
 
+using CMRT_UMD::CmEvent;
 using CMRT_UMD::CmQueue;
+typedef int32_t (*SetUltTasksFinishedFunc)(CMRT_UMD::CmDevice *device);
+
 class QueueTest: public CmTest
 {
 public:
-    QueueTest(): m_queue(nullptr) {}
+    static const uint32_t WIDTH = 64;
+    static const uint32_t HEIGHT = 64;
+
+    QueueTest(): m_queue(nullptr), m_surface(nullptr),
+                 m_setUltTasksFinished(nullptr) {}
 
     ~QueueTest() {}
 
@@ -53,8 +60,161 @@ public:
         return CM_SUCCESS;
     }//===================
 
+    //*-------------------------------------------------------------------------
+    //| Staged copy from a source with unaligned address and stride, which the
+    //| plain copy rejects. The source holds only the rows the copy reads.
+    //*-------------------------------------------------------------------------
+    int32_t StagedCopyUnaligned()
+    {
+        if (!FindTasksFinishedHook())
+        {
+            return CM_SUCCESS;
+        }
+        const uint32_t stride = WIDTH + 3;
+        const uint32_t height_stride = HEIGHT/2;
+        const uint32_t size = stride*(height_stride + height_stride/2);
+        int32_t result = CreateQueueAndSurface();
+
+        uint8_t *buffer = new uint8_t[size + 1];
+        uint8_t *source = buffer + 1;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            source[i] = i%255;
+        }
+
+        CmEvent *event = CM_NO_EVENT;
+        int32_t plain_result = m_queue->EnqueueCopyCPUToGPUFullStride(
+            m_surface, source, stride, height_stride,
+            CM_FASTCOPY_OPTION_NONBLOCKING, event);
+        EXPECT_EQ(CM_GPUCOPY_INVALID_STRIDE, plain_result);
+
+        event = CM_NO_EVENT;
+        result |= m_queue->EnqueueCopyCPUToGPUFullStride(
+            m_surface, source, stride, height_stride,
+            CM_FASTCOPY_OPTION_STAGED, event);
+        EXPECT_EQ(CM_SUCCESS, result);
+
+        // The source is not referenced by the copy in flight
+        delete[] buffer;
+
+        return result | DestroySurface();
+    }//==================================
+
+    //*-------------------------------------------------------------------------
+    //| Staged copy returns its event unless CM_NO_EVENT is passed.
+    //*-------------------------------------------------------------------------
+    int32_t StagedCopyEvent()
+    {
+        if (!FindTasksFinishedHook())
+        {
+            return CM_SUCCESS;
+        }
+        uint8_t source[WIDTH*HEIGHT*3/2] = {0};
+        int32_t result = CreateQueueAndSurface();
+
+        CmEvent *event = CM_NO_EVENT;
+        result |= m_queue->EnqueueCopyCPUToGPUFullStride(
+            m_surface, source, 0, 0, CM_FASTCOPY_OPTION_STAGED, event);
+        EXPECT_EQ(CM_SUCCESS, result);
+        EXPECT_EQ(nullptr, event);
+
+        event = nullptr;
+        result |= m_queue->EnqueueCopyCPUToGPUFullStride(
+            m_surface, source, 0, 0, CM_FASTCOPY_OPTION_STAGED, event);
+        EXPECT_EQ(CM_SUCCESS, result);
+        EXPECT_NE(nullptr, event);
+
+        // The pool keeps its own reference on the event
+        result |= FinishTasks();
+        result |= m_queue->DestroyEvent(event);
+        EXPECT_EQ(CM_SUCCESS, result);
+
+        return result | DestroySurface();
+    }//==================================
+
+    //*-------------------------------------------------------------------------
+    //| Staging buffers are reused once the copy reading them finished, and
+    //| not while it is in flight.
+    //*-------------------------------------------------------------------------
+    int32_t StagedCopyReuse()
+    {
+        if (!FindTasksFinishedHook())
+        {
+            return CM_SUCCESS;
+        }
+        uint8_t source[WIDTH*HEIGHT*3/2] = {0};
+        const DriverSymbols &symbols = m_driverLoader.GetDriverSymbols();
+        CmEvent *events[3] = {nullptr, nullptr, nullptr};
+        int32_t allocs[3] = {0, 0, 0};
+        int32_t result = CreateQueueAndSurface();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            if (i == 1)
+            {
+                // The first copy finished, its buffer is taken by the second
+                result |= FinishTasks();
+                result |= events[0]->GetStatus(m_status);
+                EXPECT_EQ(CM_STATUS_FINISHED, m_status);
+            }
+
+            // Events are held here so that only staging buffers are counted
+            int32_t count = symbols.MOS_GetMemNinjaCounter();
+            result |= m_queue->EnqueueCopyCPUToGPUFullStride(
+                m_surface, source, 0, 0, CM_FASTCOPY_OPTION_STAGED, events[i]);
+            allocs[i] = symbols.MOS_GetMemNinjaCounter() - count;
+        }
+        EXPECT_EQ(CM_SUCCESS, result);
+
+        // The third copy needs a new buffer, the second one is in flight
+        EXPECT_LT(allocs[1], allocs[2]);
+
+        result |= FinishTasks();
+        for (int i = 0; i < 3; ++i)
+        {
+            result |= m_queue->DestroyEvent(events[i]);
+        }
+
+        return result | DestroySurface();
+    }//==================================
+
 private:
+    int32_t CreateQueueAndSurface()
+    {
+        int32_t result = m_mockDevice->CreateQueue(m_queue);
+        EXPECT_EQ(CM_SUCCESS, result);
+        result |= m_mockDevice->CreateSurface2D(
+            WIDTH, HEIGHT, CM_SURFACE_FORMAT_NV12, m_surface);
+        EXPECT_EQ(CM_SUCCESS, result);
+        return result;
+    }
+
+    //! Staged copies are skipped if the driver does not export the hook
+    bool FindTasksFinishedHook()
+    {
+        m_setUltTasksFinished = (SetUltTasksFinishedFunc)GetUltHook(
+            "CmDevice_SetUltTasksFinished");
+        return nullptr != m_setUltTasksFinished;
+    }
+
+    //! Reports the copies in flight finished, no GPU runs them in mock
+    int32_t FinishTasks()
+    {
+        return m_setUltTasksFinished(m_mockDevice.operator->());
+    }
+
+    int32_t DestroySurface()
+    {
+        int32_t result = FinishTasks();
+        result |= m_mockDevice->DestroySurface(m_surface);
+        EXPECT_EQ(CM_SUCCESS, result);
+        return result;
+    }
+
     CmQueue *m_queue;
+    CMRT_UMD::CmSurface2D *m_surface;
+    CM_STATUS m_status;
+    SetUltTasksFinishedFunc m_setUltTasksFinished;
 };//=================
 
 TEST_F(QueueTest, CreateTwice)
@@ -70,3 +230,24 @@ TEST_F(QueueTest, EnqueueWithoutTask)
                      [this]() { return EnqueueWithoutTask(); });
     return;
 }//========
+
+TEST_F(QueueTest, StagedCopyUnaligned)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return StagedCopyUnaligned(); });
+    return;
+}//========
+
+TEST_F(QueueTest, StagedCopyEvent)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return StagedCopyEvent(); });
+    return;
+}//========
+
+TEST_F(QueueTest, StagedCopyReuse)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return StagedCopyReuse(); });
+    return;
+}//========
@@ -20,6 +20,7 @@
 * OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include <thread>
 #include "cm_test.h"
 
 class Surface2DTest: public CmTest
@@ -131,6 +132,57 @@ public:
         return m_mockDevice->DestroySurface(m_surface);
     }//================================================
 
+    //*-------------------------------------------------------------------------
+    //| Writes and reads back two surfaces from two threads at the same time.
+    //*-------------------------------------------------------------------------
+    int32_t ConcurrentReadWrite()
+    {
+        static const uint32_t LOOP_COUNT = 16;
+        CMRT_UMD::CmSurface2D *surfaces[2] = {nullptr, nullptr};
+        int32_t thread_results[2] = {CM_SUCCESS, CM_SUCCESS};
+        int32_t result = CM_SUCCESS;
+
+        for (int i = 0; i < 2; ++i)
+        {
+            result |= m_mockDevice->CreateSurface2D(
+                WIDTH, HEIGHT, CM_SURFACE_FORMAT_A8R8G8B8, surfaces[i]);
+        }
+        if (CM_SUCCESS != result)
+        {
+            return result;
+        }
+
+        auto ReadWriteLoop = [&](int i)
+        {
+            uint8_t to_surface[4*WIDTH*HEIGHT];
+            uint8_t from_surface[4*WIDTH*HEIGHT];
+            for (uint32_t loop = 0; loop < LOOP_COUNT; ++loop)
+            {
+                memset(to_surface, i*LOOP_COUNT + loop, sizeof(to_surface));
+                thread_results[i] |= surfaces[i]->WriteSurface(to_surface,
+                                                               nullptr);
+                thread_results[i] |= surfaces[i]->ReadSurface(from_surface,
+                                                              nullptr);
+                if (memcmp(to_surface, from_surface, sizeof(to_surface)))
+                {
+                    thread_results[i] = CM_FAILURE;
+                }
+            }
+        };
+        std::thread first_thread(ReadWriteLoop, 0);
+        std::thread second_thread(ReadWriteLoop, 1);
+        first_thread.join();
+        second_thread.join();
+
+        EXPECT_EQ(CM_SUCCESS, thread_results[0]);
+        EXPECT_EQ(CM_SUCCESS, thread_results[1]);
+        for (int i = 0; i < 2; ++i)
+        {
+            result |= m_mockDevice->DestroySurface(surfaces[i]);
+        }
+        return result | thread_results[0] | thread_results[1];
+    }//===================================================
+
     uint32_t GetAllocationSize(uint32_t width,
                                uint32_t height,
                                CM_SURFACE_FORMAT format)
@@ -301,3 +353,10 @@ TEST_F(Surface2DTest, GetInfo)
 
     return;
 }//========
+
+TEST_F(Surface2DTest, ConcurrentReadWrite)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return ConcurrentReadWrite(); });
+    return;
+}//========
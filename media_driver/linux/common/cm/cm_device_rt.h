@@ -569,6 +569,8 @@ protected:
 
     uint32_t m_isDriverStoreEnabled;
 
+    bool m_isMockRuntimeEnabled;
+
     CmNotifierGroup *m_notifierGroup;
 
 private:
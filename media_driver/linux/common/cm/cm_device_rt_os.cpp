@@ -62,6 +62,8 @@ void CmDeviceRT::ConstructOSSpecific(uint32_t devCreateOption)
 {
     m_pfnReleaseVaSurface = nullptr;
 
+    m_isMockRuntimeEnabled = (devCreateOption & CM_DEVICE_CONFIG_MOCK_RUNTIME_ENABLE) ? true : false;
+
     // If use dynamic states.
     m_cmHalCreateOption.dynamicStateHeap = (devCreateOption & CM_DEVICE_CONFIG_DSH_DISABLE_MASK) ? false : true;
     if (m_cmHalCreateOption.dynamicStateHeap)
@@ -233,6 +235,18 @@ int32_t CmDeviceRT::LoadJITDll()
 {
     int result = 0;
 
+    if (m_isMockRuntimeEnabled && nullptr == m_hJITDll)
+    {
+        // ULT provides stub JIT functions in the executable
+        m_fJITCompile = (pJITCompile)dlsym(RTLD_DEFAULT, JITCOMPILE_FUNCTION_STR);
+        m_fFreeBlock = (pFreeBlock)dlsym(RTLD_DEFAULT, FREEBLOCK_FUNCTION_STR);
+        m_fJITVersion = (pJITVersion)dlsym(RTLD_DEFAULT, JITVERSION_FUNCTION_STR);
+        if (m_fJITCompile && m_fFreeBlock && m_fJITVersion)
+        {
+            return result;
+        }
+    }
+
     if (nullptr == m_hJITDll)
     {
         m_hJITDll = dlopen( "libigc.so", RTLD_LAZY );
@@ -486,3 +500,51 @@ int32_t CmDeviceRT::ReadVtuneProfilingFlag()
     return CM_SUCCESS;
 }
 }  // namespace
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Write the start and end timestamps of all tasks submitted on the
+//|             device, so that they are reported finished. Used by ULT, where no
+//|             GPU executes the command buffers.
+//| Returns:    Result of the operation.
+//*-----------------------------------------------------------------------------
+MOS_FUNC_EXPORT int32_t CmDevice_SetUltTasksFinished(CMRT_UMD::CmDevice *device)
+{
+    CMRT_UMD::CmDeviceRT *deviceRT = static_cast<CMRT_UMD::CmDeviceRT *>(device);
+    if (deviceRT == nullptr)
+    {
+        return CM_NULL_POINTER;
+    }
+
+    PCM_CONTEXT_DATA cmData = (PCM_CONTEXT_DATA)deviceRT->GetAccelData();
+    if (cmData == nullptr || cmData->cmHalState == nullptr)
+    {
+        return CM_NULL_POINTER;
+    }
+
+    PCM_HAL_STATE state = cmData->cmHalState;
+    for (int32_t taskId = 0; taskId < (int32_t)state->cmDeviceParam.maxTasks; taskId++)
+    {
+        if (state->taskStatusTable[taskId] == CM_INVALID_INDEX)
+        {
+            continue;
+        }
+
+        // Same layout as read by HalCm_QueryTask_Linux
+        int64_t *syncStart = (int64_t *)(state->renderTimeStampResource.data +
+                                         state->pfnGetTaskSyncLocation(state, taskId));
+        syncStart[0] = 0;
+        syncStart[1] = 0;
+    }
+
+    return CM_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif
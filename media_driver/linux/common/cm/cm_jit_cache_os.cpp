@@ -0,0 +1,126 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      cm_jit_cache_os.cpp
+//! \brief     Contains Linux-dependent CmJitCache member functions.
+//!
+
+#include "cm_jit_cache.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <vector>
+#include <algorithm>
+
+namespace CMRT_UMD
+{
+//*-----------------------------------------------------------------------------
+//| Purpose:    Hash identifying the jitter library build: path, size and
+//|             modification time of the library the compile function is in
+//| Returns:    Jitter hash, 0 if unknown.
+//*-----------------------------------------------------------------------------
+uint64_t CmJitCache::GetJitterHash(pJITCompile jitCompile)
+{
+    Dl_info     info;
+    struct stat st;
+    uint64_t    hash = CM_JIT_CACHE_FNV_OFFSET;
+
+    if (jitCompile == nullptr || dladdr((void *)jitCompile, &info) == 0 || info.dli_fname == nullptr)
+    {
+        return 0;
+    }
+
+    hash = Hash(hash, info.dli_fname, strlen(info.dli_fname));
+    if (stat(info.dli_fname, &st) == 0)
+    {
+        hash = Hash(hash, &st.st_size, sizeof(st.st_size));
+        hash = Hash(hash, &st.st_mtime, sizeof(st.st_mtime));
+    }
+
+    return hash;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Remove least recently written cache files until the cache
+//|             directory fits in the limit. Called unlocked.
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::TrimDisk(const std::string &path, uint64_t limit)
+{
+    struct CacheFile
+    {
+        std::string name;
+        uint64_t    size;
+        time_t      mtime;
+    };
+
+    std::vector<CacheFile>  files;
+    uint64_t                total   = 0;
+    size_t                  extLen  = strlen(CM_JIT_CACHE_FILE_EXT);
+    DIR                     *dir    = opendir(path.c_str());
+    struct dirent           *ent    = nullptr;
+
+    if (dir == nullptr)
+    {
+        return;
+    }
+
+    while ((ent = readdir(dir)) != nullptr)
+    {
+        size_t      len = strlen(ent->d_name);
+        struct stat st;
+
+        if (len <= extLen || strcmp(ent->d_name + len - extLen, CM_JIT_CACHE_FILE_EXT) != 0)
+        {
+            continue;
+        }
+
+        std::string name = path + ent->d_name;
+        if (stat(name.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+        {
+            files.push_back({name, (uint64_t)st.st_size, st.st_mtime});
+            total += st.st_size;
+        }
+    }
+    closedir(dir);
+
+    if (total <= limit)
+    {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(),
+        [](const CacheFile &a, const CacheFile &b) { return a.mtime < b.mtime; });
+
+    for (auto &file : files)
+    {
+        if (total <= limit)
+        {
+            break;
+        }
+        if (remove(file.name.c_str()) == 0)
+        {
+            total -= file.size;
+        }
+    }
+}
+}  // namespace
@@ -164,6 +164,10 @@ public:
 
     int32_t SetVaSurfaceID(VASurfaceID vaSurface, void *vaDisplay);
 
+    //Lock held by CPU read/write of this surface
+    CSync* GetReadWriteLock()
+    { return &m_criticalSectionReadWrite; }
+
 protected:
     CmSurface2DRT(unsigned int handle,
                   unsigned int width,
@@ -199,6 +203,9 @@ protected:
 
     CM_FRAME_TYPE m_frameType;
 
+    // Protect CPU read/write of this surface
+    CSync m_criticalSectionReadWrite;
+
 private:
     CmSurface2DRT(const CmSurface2DRT& other);
     CmSurface2DRT& operator=(const CmSurface2DRT& other);
@@ -239,6 +239,11 @@ int32_t CmFillMosResource( VASurfaceID        vaSurfaceID,
     // for wrapper to new MOS MODS interface
     osResource->bConvertedFromDDIResource = true;
 
+    // CM kernels write the surface behind the back of the DDI, drop the content
+    // formatted by the driver and keep the surface out of the pool and content tags
+    surface->uiContentTag = 0;
+    surface->bShared      = true;
+
     return CM_SUCCESS;
 }
 
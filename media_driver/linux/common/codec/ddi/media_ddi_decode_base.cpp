@@ -24,6 +24,7 @@
 //! \brief    The class implementation of DdiDecodeBase  for all decoders
 //!
 
+#include <algorithm>
 #include "media_libva_decoder.h"
 #include "media_libva_util.h"
 #include "media_ddi_decode_base.h"
@@ -644,6 +645,11 @@ VAStatus DdiMediaDecode::EndPicture(
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
     }
 
+    // Status report slots written by this frame, recorded once the frame is submitted
+    CodechalDecode     *decoder     = dynamic_cast<CodechalDecode *>(m_ddiDecodeCtx->pCodecHal);
+    PDDI_MEDIA_SURFACE  rtSurface   = (&(m_ddiDecodeCtx->RTtbl))->pCurrentRT;
+    uint32_t            statusIndex = decoder ? decoder->GetDecodeStatusBuf()->m_currIndex : 0;
+
     MOS_STATUS status = m_ddiDecodeCtx->pCodecHal->Execute((void *)(&m_ddiDecodeCtx->DecodeParams));
     if (status != MOS_STATUS_SUCCESS)
     {
@@ -658,10 +664,38 @@ VAStatus DdiMediaDecode::EndPicture(
     {
         return VA_STATUS_ERROR_DECODING_ERROR;
     }
+
+    if (decoder && decoder->IsStatusQueryReportingEnabled())
+    {
+        while (statusIndex != decoder->GetDecodeStatusBuf()->m_currIndex)
+        {
+            m_ddiDecodeCtx->pStatusReportSurfaces[statusIndex] = rtSurface;
+            statusIndex = (statusIndex + 1) & (CODECHAL_DECODE_STATUS_NUM - 1);
+        }
+    }
     DDI_FUNCTION_EXIT(VA_STATUS_SUCCESS);
     return VA_STATUS_SUCCESS;
 }
 
+void DdiMediaDecode::ClearStatusReportSurfaces(
+    DDI_MEDIA_SURFACE **surfaces,
+    uint32_t            numSurfaces)
+{
+    if (m_ddiDecodeCtx == nullptr || surfaces == nullptr || numSurfaces == 0)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < CODECHAL_DECODE_STATUS_NUM; i++)
+    {
+        PDDI_MEDIA_SURFACE surface = m_ddiDecodeCtx->pStatusReportSurfaces[i];
+        if (surface && std::binary_search(surfaces, surfaces + numSurfaces, surface))
+        {
+            m_ddiDecodeCtx->pStatusReportSurfaces[i] = nullptr;
+        }
+    }
+}
+
 VAStatus DdiMediaDecode::CreateBuffer(
     VABufferType             type,
     uint32_t                 size,
@@ -684,7 +718,7 @@ VAStatus DdiMediaDecode::CreateBuffer(
         return VA_STATUS_ERROR_INVALID_PARAMETER;
     }
 
-    buf               = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+    buf               = DdiMediaUtil_AllocMediaBuffer(m_ddiDecodeCtx->pMediaCtx, m_ddiDecodeCtx->pParamSlab);
     if (buf == nullptr)
     {
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
@@ -695,7 +729,6 @@ VAStatus DdiMediaDecode::CreateBuffer(
     buf->format       = Media_Format_Buffer;
     buf->uiOffset     = 0;
     buf->bCFlushReq   = false;
-    buf->pMediaCtx    = m_ddiDecodeCtx->pMediaCtx;
 
     switch ((int32_t)type)
     {
@@ -724,18 +757,30 @@ VAStatus DdiMediaDecode::CreateBuffer(
             buf->format     = Media_Format_CPU;
             break;
         case VAIQMatrixBufferType:
-            buf->pData      = (uint8_t*)MOS_AllocAndZeroMemory(size * numElements);
+            va = DdiMediaUtil_AllocParamBuffer(buf, size * numElements, data == nullptr);
+            if (va != VA_STATUS_SUCCESS)
+            {
+                goto CleanUpandReturn;
+            }
             buf->format     = Media_Format_CPU;
             break;
         case VAProbabilityBufferType:
             buf->pData      = (uint8_t*)(&(m_ddiDecodeCtx->BufMgr.Codec_Param.Codec_Param_VP8.ProbabilityDataVP8));
             break;
         case VAProcFilterParameterBufferType:
-            buf->pData      = (uint8_t*)MOS_AllocAndZeroMemory(sizeof(VAProcPipelineCaps));
+            va = DdiMediaUtil_AllocParamBuffer(buf, sizeof(VAProcPipelineCaps), true);
+            if (va != VA_STATUS_SUCCESS)
+            {
+                goto CleanUpandReturn;
+            }
             buf->format     = Media_Format_CPU;
             break;
         case VAProcPipelineParameterBufferType:
-            buf->pData      = (uint8_t*)MOS_AllocAndZeroMemory(sizeof(VAProcPipelineParameterBuffer));
+            va = DdiMediaUtil_AllocParamBuffer(buf, sizeof(VAProcPipelineParameterBuffer), true);
+            if (va != VA_STATUS_SUCCESS)
+            {
+                goto CleanUpandReturn;
+            }
             buf->format     = Media_Format_CPU;
             break;
         case VADecodeStreamoutBufferType:
@@ -757,14 +802,18 @@ VAStatus DdiMediaDecode::CreateBuffer(
             break;
         }
         case VAHuffmanTableBufferType:
-            buf->pData      = (uint8_t*)MOS_AllocAndZeroMemory(size * numElements);
+            va = DdiMediaUtil_AllocParamBuffer(buf, size * numElements, data == nullptr);
+            if (va != VA_STATUS_SUCCESS)
+            {
+                goto CleanUpandReturn;
+            }
             buf->format     = Media_Format_CPU;
             break;
         default:
             va = m_ddiDecodeCtx->pCpDdiInterface->CreateBuffer(type, buf, size, numElements);
             if (va  == VA_STATUS_ERROR_UNSUPPORTED_BUFFERTYPE)
             {
-                MOS_FreeMemory(buf);
+                DdiMediaUtil_FreeMediaBuffer(buf);
                 return va;
             }
             break;
@@ -809,8 +858,8 @@ VAStatus DdiMediaDecode::CreateBuffer(
 CleanUpandReturn:
     if(buf)
     {
-        MOS_FreeMemory(buf->pData);
-        MOS_FreeMemory(buf);
+        DdiMediaUtil_FreeParamBuffer(buf);
+        DdiMediaUtil_FreeMediaBuffer(buf);
     }
     return va;
 
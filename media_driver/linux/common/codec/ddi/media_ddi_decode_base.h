@@ -302,6 +302,22 @@ public:
     {
         return false;
     }
+
+    //!
+    //! \brief    Drop the status report back-references of destroyed surfaces
+    //! \details  Status report slots still pointing at any of the surfaces are
+    //!           cleared, later retirement of these slots falls back to the
+    //!           surface heap lookup.
+    //!
+    //! \param    [in] surfaces
+    //!           Surfaces being destroyed, sorted by address
+    //! \param    [in] numSurfaces
+    //!           Number of surfaces
+    //!
+    void ClearStatusReportSurfaces(
+        DDI_MEDIA_SURFACE **surfaces,
+        uint32_t            numSurfaces);
+
 protected:
     //! \brief    the decode_config_attr related with Decode_CONTEXT
     DDI_DECODE_CONFIG_ATTR *m_ddiDecodeAttr = nullptr;
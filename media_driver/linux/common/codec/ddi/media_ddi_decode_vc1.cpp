@@ -28,6 +28,7 @@
 
 #include "media_ddi_decode_vc1.h"
 #include "mos_solo_generic.h"
+#include "codechal_decode_vc1.h"
 #include "codechal_memdecomp.h"
 #include "media_ddi_decode_const.h"
 #include "media_ddi_factory.h"
@@ -1080,6 +1081,42 @@ CleanUpandReturn:
     return vaStatus;
 }
 
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to run the bitstream reader of a VC1
+    //!           decode context on host memory
+    //!
+    MOS_FUNC_EXPORT VAStatus DdiDecodeVc1_UltRunBitstreamOps(
+        VADriverContextP            ctx,
+        VAContextID                 context,
+        uint8_t                     *buffer,
+        uint32_t                    length,
+        bool                        isEBDU,
+        PCODECHAL_DECODE_VC1_ULT_OP ops,
+        uint32_t                    opNum)
+    {
+        DDI_CHK_NULL(ctx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        uint32_t            ctxType = DDI_MEDIA_CONTEXT_TYPE_NONE;
+        PDDI_DECODE_CONTEXT decCtx  = (PDDI_DECODE_CONTEXT)DdiMedia_GetContextFromContextID(ctx, context, &ctxType);
+        DDI_CHK_NULL(decCtx, "nullptr decCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        DDI_CHK_CONDITION(ctxType != DDI_MEDIA_CONTEXT_TYPE_DECODER, "Not a decode context", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+        CodechalDecodeVc1 *decoder = dynamic_cast<CodechalDecodeVc1 *>(decCtx->pCodecHal);
+        DDI_CHK_NULL(decoder, "nullptr decoder", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+        MOS_STATUS status = decoder->UltRunBitstreamOps(buffer, length, isEBDU, ops, opNum);
+        return (status == MOS_STATUS_SUCCESS) ? VA_STATUS_SUCCESS : VA_STATUS_ERROR_INVALID_PARAMETER;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 extern template class MediaDdiFactory<DdiMediaDecode, DDI_DECODE_CONFIG_ATTR>;
 
 static bool vc1Registered =
@@ -102,6 +102,7 @@ VAStatus DdiEncodeBase::AddToStatusReportQueue(void *codedBuf)
     m_encodeCtx->statusReportBuf.infos[idx].pCodedBuf = codedBuf;
     m_encodeCtx->statusReportBuf.infos[idx].uiSize    = 0;
     m_encodeCtx->statusReportBuf.infos[idx].uiStatus  = 0;
+    m_encodeCtx->statusReportBuf.infos[idx].uiNumSlices = 0;
     MOS_STATUS status = m_encodeCtx->pCpDdiInterface->StoreCounterToStatusReport(&m_encodeCtx->statusReportBuf.infos[idx]);
     if (status != MOS_STATUS_SUCCESS)
     {
@@ -113,6 +114,24 @@ VAStatus DdiEncodeBase::AddToStatusReportQueue(void *codedBuf)
 
 }
 
+// Overrides the slice segment output user feature if not negative, set by the ULT
+static int32_t ultSliceSegmentOutput = -1;
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT void DdiEncode_SetUltSliceSegmentOutput(int32_t enable)
+    {
+        ultSliceSegmentOutput = enable;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 VAStatus DdiEncodeBase::InitCompBuffer()
 {
     DDI_CHK_NULL(m_encodeCtx, "Null m_encodeCtx.", VA_STATUS_ERROR_INVALID_CONTEXT);
@@ -133,6 +152,24 @@ VAStatus DdiEncodeBase::InitCompBuffer()
 
     DDI_CHK_RET(m_encodeCtx->pCpDdiInterface->InitHdcp2Buffer(bufMgr), "fail to init hdcp2 buffer!");
 
+    // Per slice segments rely on the slice sizes reported by PAK. Only HEVC
+    // VDEnc reports them at this time, other encoders keep a single segment.
+    m_encodeCtx->bSliceSegmentOutput = false;
+    if (m_encodeCtx->wModeType == CODECHAL_ENCODE_MODE_AVC || m_encodeCtx->wModeType == CODECHAL_ENCODE_MODE_HEVC)
+    {
+        MOS_USER_FEATURE_VALUE_DATA userFeatureData;
+        MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+        MOS_UserFeature_ReadValue_ID(
+            nullptr,
+            __MEDIA_USER_FEATURE_VALUE_ENCODE_SLICE_SEGMENT_OUTPUT_ID,
+            &userFeatureData);
+        if (ultSliceSegmentOutput >= 0)
+        {
+            userFeatureData.i32Data = ultSliceSegmentOutput;
+        }
+        m_encodeCtx->bSliceSegmentOutput = userFeatureData.i32Data ? true : false;
+    }
+
     return VA_STATUS_SUCCESS;
 }
 
@@ -153,6 +190,18 @@ void DdiEncodeBase::FreeCompBuffer()
     // free status report struct
     MOS_FreeMemory(bufMgr->pCodedBufferSegment);
     bufMgr->pCodedBufferSegment = nullptr;
+
+    MOS_FreeMemory(bufMgr->pSliceCodedBufferSegments);
+    bufMgr->pSliceCodedBufferSegments     = nullptr;
+    bufMgr->uiNumSliceCodedBufferSegments = 0;
+
+    for (int32_t i = 0; i < DDI_ENCODE_MAX_STATUS_REPORT_BUFFER; i++)
+    {
+        MOS_FreeMemory(m_encodeCtx->statusReportBuf.infos[i].pSliceSizes);
+        m_encodeCtx->statusReportBuf.infos[i].pSliceSizes = nullptr;
+        m_encodeCtx->statusReportBuf.infos[i].uiNumSlices = 0;
+        m_encodeCtx->statusReportBuf.infos[i].uiMaxSlices = 0;
+    }
 }
 
 VAStatus DdiEncodeBase::StatusReport(
@@ -166,110 +215,168 @@ VAStatus DdiEncodeBase::StatusReport(
     m_encodeCtx->BufMgr.pCodedBufferSegment->status    = 0;
 
     //when this function is called, there must be a frame is ready, will wait until get the right information.
-    uint32_t size         = 0;
-    int32_t  index        = 0;
-    uint32_t status       = 0;
-    uint32_t timeOutCount = 0;
-    VAStatus eStatus      = VA_STATUS_SUCCESS;
+    uint32_t size    = 0;
+    uint32_t status  = 0;
+    VAStatus eStatus = QueryStatusReport(mediaBuf, &size, &status);
+    if (eStatus == VA_STATUS_ERROR_NOT_ENOUGH_BUFFER || eStatus == VA_STATUS_ERROR_ENCODING_ERROR)
+    {
+        return eStatus;
+    }
+    else if (eStatus != VA_STATUS_SUCCESS)
+    {
+        return VA_STATUS_ERROR_OPERATION_FAILED;
+    }
+
+    // the first segment in the single-link list: pointer for the coded bitstream and the size
+    m_encodeCtx->BufMgr.pCodedBufferSegment->buf    = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
+    m_encodeCtx->BufMgr.pCodedBufferSegment->size   = size;
+    m_encodeCtx->BufMgr.pCodedBufferSegment->status = status;
+
+    // HDCP2 owns the second segment, keep the frame as a single segment then
+    if (m_encodeCtx->bSliceSegmentOutput && !m_encodeCtx->pCpDdiInterface->IsHdcp2Enabled())
+    {
+        DDI_CHK_RET(SetSliceSegments(mediaBuf, size, status), "fail to set slice segments!");
+    }
+
+    *buf = m_encodeCtx->BufMgr.pCodedBufferSegment;
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus DdiEncodeBase::QueryStatusReport(
+    DDI_MEDIA_BUFFER    *mediaBuf,
+    uint32_t            *size,
+    uint32_t            *status)
+{
+    DDI_CHK_NULL(m_encodeCtx, "Null m_encodeCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(m_encodeCtx->pCodecHal, "Null m_encodeCtx->pCodecHal", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(mediaBuf, "Null mediaBuf", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(size, "Null size", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(status, "Null status", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+    CodechalEncoderState *encoder = dynamic_cast<CodechalEncoderState *>(m_encodeCtx->pCodecHal);
+    DDI_CHK_NULL(encoder, "Null codechal encoder", VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    // Get encoded frame information from status buffer queue.
-    while (VA_STATUS_SUCCESS == (eStatus = GetSizeFromStatusReportBuffer(mediaBuf, &size, &status, &index)))
+    int32_t  index             = 0;
+    bool     statusFenceWaited = false;
+    VAStatus eStatus           = GetSizeFromStatusReportBuffer(mediaBuf, size, status, &index);
+    if (eStatus != VA_STATUS_SUCCESS)
+    {
+        return eStatus;
+    }
+
+    // The report may already have been drained along with an earlier frame
+    if ((*size != 0) || (*status & VA_CODED_BUF_STATUS_BAD_BITSTREAM))
     {
-        if ((index >= 0) && (size != 0))  //Get the matched encoded buffer information
+        return VA_STATUS_SUCCESS;
+    }
+
+    // Completion fence of the frame writing the coded buffer
+    mos_bo_wait_rendering(mediaBuf->bo);
+
+    while (true)
+    {
+        bool incomplete = false;
+        DDI_CHK_RET(DrainStatusReports(&incomplete), "fail to drain status reports!");
+
+        eStatus = GetSizeFromStatusReportBuffer(mediaBuf, size, status, &index);
+        if (eStatus != VA_STATUS_SUCCESS)
         {
-            // the first segment in the single-link list: pointer for the coded bitstream and the size
-            m_encodeCtx->BufMgr.pCodedBufferSegment->buf    = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-            m_encodeCtx->BufMgr.pCodedBufferSegment->size   = size;
-            m_encodeCtx->BufMgr.pCodedBufferSegment->status = status;
-            break;
+            return eStatus;
         }
-        else if ((index >= 0) && (size == 0) && (status & VA_CODED_BUF_STATUS_BAD_BITSTREAM))
+
+        if ((*size != 0) || (*status & VA_CODED_BUF_STATUS_BAD_BITSTREAM))
         {
-            m_encodeCtx->BufMgr.pCodedBufferSegment->buf    = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-            m_encodeCtx->BufMgr.pCodedBufferSegment->size   = size;
-            m_encodeCtx->BufMgr.pCodedBufferSegment->status = status;
-            break;
+            return VA_STATUS_SUCCESS;
         }
 
-        mos_bo_wait_rendering(mediaBuf->bo);
-
-        EncodeStatusReport *encodeStatusReport = (EncodeStatusReport*)m_encodeCtx->pEncodeStatusReport;
-        encodeStatusReport->bSequential = true;  //Query the encoded frame status in sequential.
-
-        uint16_t numStatus = 1;
-        MOS_STATUS mosStatus = MOS_STATUS_SUCCESS;
-        mosStatus = m_encodeCtx->pCodecHal->GetStatusReport(encodeStatusReport, numStatus);
-        if (MOS_STATUS_NOT_ENOUGH_BUFFER == mosStatus)
+        if (!incomplete)
         {
-            return VA_STATUS_ERROR_NOT_ENOUGH_BUFFER;
-        } else if (MOS_STATUS_SUCCESS != mosStatus)
+            DDI_ASSERTMESSAGE("No status report available for the coded buffer.");
+            return VA_STATUS_ERROR_OPERATION_FAILED;
+        }
+
+        if (statusFenceWaited)
         {
-            return VA_STATUS_ERROR_ENCODING_ERROR;
+            //if HW didn't response in time, assume there is an error in encoding process, return error to App.
+            // The error belongs to this coded buffer only. The update position is left alone, so older
+            // frames still get their own reports, and a late report of this frame replaces the error.
+            *size   = 0;
+            *status = VA_CODED_BUF_STATUS_BAD_BITSTREAM;
+            m_encodeCtx->statusReportBuf.infos[index].uiSize   = *size;
+            m_encodeCtx->statusReportBuf.infos[index].uiStatus = *status;
+            DDI_ASSERTMESSAGE("Something unexpected happened in HW, return error to application");
+            return VA_STATUS_SUCCESS;
         }
 
-        if (CODECHAL_STATUS_SUCCESSFUL == encodeStatusReport[0].CodecStatus)
+        // Coded buffer is idle while PAK status is still pending, wait on the status buffer fence instead of polling
+        EncodeStatusBuffer *encodeStatusBuf = encoder->m_pakEnabled ? &encoder->m_encodeStatusBuf : &encoder->m_encodeStatusBufRcs;
+        mos_gem_bo_wait(encodeStatusBuf->resStatusBuffer.bo, DDI_ENCODE_STATUS_REPORT_TIMEOUT_NS);
+        statusFenceWaited = true;
+    }
+}
+
+VAStatus DdiEncodeBase::DrainStatusReports(bool *incomplete)
+{
+    DDI_CHK_NULL(m_encodeCtx, "Null m_encodeCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(m_encodeCtx->pCpDdiInterface, "Null m_encodeCtx->pCpDdiInterface", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(m_encodeCtx->pEncodeStatusReport, "Null m_encodeCtx->pEncodeStatusReport", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(incomplete, "Null incomplete", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    CodechalEncoderState *encoder = dynamic_cast<CodechalEncoderState *>(m_encodeCtx->pCodecHal);
+    DDI_CHK_NULL(encoder, "Null codechal encoder", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+    *incomplete = false;
+
+    uint32_t numPending = (m_encodeCtx->statusReportBuf.ulHeadPosition + DDI_ENCODE_MAX_STATUS_REPORT_BUFFER -
+        m_encodeCtx->statusReportBuf.ulUpdatePosition) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
+    if (numPending == 0)
+    {
+        return VA_STATUS_SUCCESS;
+    }
+
+    uint32_t            firstSlot          = m_encodeCtx->statusReportBuf.ulUpdatePosition;
+    EncodeStatusReport *encodeStatusReport = (EncodeStatusReport*)m_encodeCtx->pEncodeStatusReport;
+    encodeStatusReport->bSequential = true;  //Query the encoded frame status in sequential.
+
+    MOS_STATUS mosStatus = m_encodeCtx->pCodecHal->GetStatusReport(encodeStatusReport, (uint16_t)numPending);
+    if (MOS_STATUS_NOT_ENOUGH_BUFFER == mosStatus)
+    {
+        return VA_STATUS_ERROR_NOT_ENOUGH_BUFFER;
+    }
+    else if (MOS_STATUS_SUCCESS != mosStatus)
+    {
+        return VA_STATUS_ERROR_ENCODING_ERROR;
+    }
+
+    for (uint32_t i = 0; i < numPending; i++)
+    {
+        // Report i belongs to the i-th pending entry, whatever happened to the entries before it
+        uint32_t                      slot = (firstSlot + i) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
+        DDI_ENCODE_STATUS_REPORT_INFO *info = &m_encodeCtx->statusReportBuf.infos[slot];
+        m_encodeCtx->statusReportBuf.ulUpdatePosition = slot;
+
+        // With inline status update a frame whose coded buffer is idle but has no status
+        // failed in HW. One still running is not complete yet, nor are the frames after it.
+        bool stillRunning = (CODECHAL_STATUS_INCOMPLETE == encodeStatusReport[i].CodecStatus) &&
+            (!encoder->m_inlineEncodeStatusUpdate || info->pCodedBuf == nullptr || mos_bo_busy((MOS_LINUX_BO *)info->pCodedBuf));
+
+        if (CODECHAL_STATUS_SUCCESSFUL == encodeStatusReport[i].CodecStatus)
         {
-            // Only AverageQP is reported at this time. Populate other bits with relevant informaiton later;
-            status = (encodeStatusReport[0].AverageQp & VA_CODED_BUF_STATUS_PICTURE_AVE_QP_MASK);
-            status = status | ((encodeStatusReport[0].NumberPasses) & 0xf)<<24;
-            // fill hdcp related buffer
-            DDI_CHK_RET(m_encodeCtx->pCpDdiInterface->StatusReportForHdcp2Buffer(&m_encodeCtx->BufMgr, encodeStatusReport), "fail to get hdcp2 status report!");
-            if (UpdateStatusReportBuffer(encodeStatusReport[0].bitstreamSize, status) != VA_STATUS_SUCCESS)
-            {
-                m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-                m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-                m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-                m_encodeCtx->statusReportBuf.ulUpdatePosition = (m_encodeCtx->statusReportBuf.ulUpdatePosition + 1) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
-                break;
-            }
-            //Add encoded frame information into status buffer queue.
-            continue;
+            DDI_CHK_RET(CompleteStatusReport(&encodeStatusReport[i]), "fail to complete status report!");
         }
-        else if (CODECHAL_STATUS_INCOMPLETE == encodeStatusReport[0].CodecStatus)
+        else if (stillRunning)
         {
-            bool inlineEncodeStatusUpdate;
-            CodechalEncoderState *encoder = dynamic_cast<CodechalEncoderState *>(m_encodeCtx->pCodecHal);
-            DDI_CHK_NULL(encoder, "Null codechal encoder", VA_STATUS_ERROR_INVALID_CONTEXT);
-            inlineEncodeStatusUpdate = encoder->m_inlineEncodeStatusUpdate;
-
-            if (inlineEncodeStatusUpdate)
-            {
-                m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-                m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-                m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-                UpdateStatusReportBuffer(encodeStatusReport[0].bitstreamSize, m_encodeCtx->BufMgr.pCodedBufferSegment->status);
-                DDI_ASSERTMESSAGE("Something unexpected happened in HW, return error to application");
-                break;
-            }
-            // Wait until encode PAK complete, sometimes we application detect encoded buffer object is Idle, may Enc done, but Pak not.
-            uint32_t maxTimeOut                               = 100000;  //set max sleep times to 100000 = 1s, other wise return error.
-            if (timeOutCount < maxTimeOut)
-            {
-                //sleep 10 us to wait encode complete, it won't impact the performance.
-                uint32_t sleepTime                            = 10;      //sleep 10 us when encode is not complete.
-                usleep(sleepTime);
-                timeOutCount++;
-                continue;
-            }
-            else
-            {
-                //if HW didn't response in 1s, assume there is an error in encoding process, return error to App.
-                m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-                m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-                m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-                UpdateStatusReportBuffer(encodeStatusReport[0].bitstreamSize, m_encodeCtx->BufMgr.pCodedBufferSegment->status);
-                DDI_ASSERTMESSAGE("Something unexpected happened in HW, return error to application");
-                break;
-            }
+            // Frames complete in submission order, the rest are still pending as well
+            *incomplete = true;
+            break;
         }
-        else if (CODECHAL_STATUS_ERROR == encodeStatusReport[0].CodecStatus)
+        else if (CODECHAL_STATUS_INCOMPLETE == encodeStatusReport[i].CodecStatus ||
+                 CODECHAL_STATUS_ERROR == encodeStatusReport[i].CodecStatus)
         {
             DDI_NORMALMESSAGE("Encoding failure due to HW issue");
-            m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-            m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-            m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-            UpdateStatusReportBuffer(encodeStatusReport[0].bitstreamSize, m_encodeCtx->BufMgr.pCodedBufferSegment->status);
-            break;
+            info->uiSize   = 0;
+            info->uiStatus = VA_CODED_BUF_STATUS_BAD_BITSTREAM;
+            m_encodeCtx->statusReportBuf.ulUpdatePosition = (slot + 1) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
         }
         else
         {
@@ -277,12 +384,132 @@ VAStatus DdiEncodeBase::StatusReport(
         }
     }
 
-    if (eStatus != VA_STATUS_SUCCESS)
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus DdiEncodeBase::CompleteStatusReport(EncodeStatusReport *encodeStatusReport)
+{
+    DDI_CHK_NULL(m_encodeCtx, "Null m_encodeCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(m_encodeCtx->pCpDdiInterface, "Null m_encodeCtx->pCpDdiInterface", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(encodeStatusReport, "Null encodeStatusReport", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    // Only AverageQP is reported at this time. Populate other bits with relevant informaiton later;
+    uint32_t status = (encodeStatusReport->AverageQp & VA_CODED_BUF_STATUS_PICTURE_AVE_QP_MASK);
+    status = status | ((encodeStatusReport->NumberPasses) & 0xf)<<24;
+    // fill hdcp related buffer
+    DDI_CHK_RET(m_encodeCtx->pCpDdiInterface->StatusReportForHdcp2Buffer(&m_encodeCtx->BufMgr, encodeStatusReport), "fail to get hdcp2 status report!");
+    if (m_encodeCtx->bSliceSegmentOutput)
     {
-        return VA_STATUS_ERROR_OPERATION_FAILED;
+        DDI_CHK_RET(SaveSliceSizes(encodeStatusReport), "fail to save slice sizes!");
+    }
+    if (UpdateStatusReportBuffer(encodeStatusReport->bitstreamSize, status) != VA_STATUS_SUCCESS)
+    {
+        m_encodeCtx->statusReportBuf.ulUpdatePosition = (m_encodeCtx->statusReportBuf.ulUpdatePosition + 1) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
     }
 
-    *buf = m_encodeCtx->BufMgr.pCodedBufferSegment;
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus DdiEncodeBase::SaveSliceSizes(EncodeStatusReport *encodeStatusReport)
+{
+    DDI_CHK_NULL(m_encodeCtx, "Null m_encodeCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(encodeStatusReport, "Null encodeStatusReport", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    // Sizes belong to the entry UpdateStatusReportBuffer fills next
+    DDI_ENCODE_STATUS_REPORT_INFO *info = &m_encodeCtx->statusReportBuf.infos[m_encodeCtx->statusReportBuf.ulUpdatePosition];
+    info->uiNumSlices = 0;
+
+    uint32_t numSlices = encodeStatusReport->NumberSlices;
+    if (encodeStatusReport->pSliceSizes == nullptr || numSlices == 0)
+    {
+        return VA_STATUS_SUCCESS;
+    }
+
+    if (info->uiMaxSlices < numSlices)
+    {
+        MOS_FreeMemory(info->pSliceSizes);
+        info->pSliceSizes = (uint16_t *)MOS_AllocMemory(numSlices * sizeof(uint16_t));
+        info->uiMaxSlices = 0;
+        DDI_CHK_NULL(info->pSliceSizes, "Null info->pSliceSizes", VA_STATUS_ERROR_ALLOCATION_FAILED);
+        info->uiMaxSlices = numSlices;
+    }
+
+    MOS_SecureMemcpy(info->pSliceSizes, info->uiMaxSlices * sizeof(uint16_t),
+        encodeStatusReport->pSliceSizes, numSlices * sizeof(uint16_t));
+    info->uiNumSlices = numSlices;
+
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus DdiEncodeBase::SetSliceSegments(
+    DDI_MEDIA_BUFFER    *mediaBuf,
+    uint32_t            size,
+    uint32_t            status)
+{
+    DDI_CHK_NULL(m_encodeCtx, "Null m_encodeCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(mediaBuf, "Null mediaBuf", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    DDI_CODEC_COM_BUFFER_MGR *bufMgr  = &(m_encodeCtx->BufMgr);
+    VACodedBufferSegment     *segment = bufMgr->pCodedBufferSegment;
+    segment->next = nullptr;
+
+    uint32_t frameSize   = 0;
+    uint32_t frameStatus = 0;
+    int32_t  index       = 0;
+    if (size == 0 || segment->buf == nullptr ||
+        GetSizeFromStatusReportBuffer(mediaBuf, &frameSize, &frameStatus, &index) != VA_STATUS_SUCCESS)
+    {
+        return VA_STATUS_SUCCESS;
+    }
+
+    DDI_ENCODE_STATUS_REPORT_INFO *info = &m_encodeCtx->statusReportBuf.infos[index];
+    if (info->uiNumSlices <= 1)
+    {
+        return VA_STATUS_SUCCESS;
+    }
+
+    // Slices which do not fit the frame mean a stale report, keep the frame segment
+    uint32_t slicesSize = 0;
+    for (uint32_t i = 0; i < info->uiNumSlices; i++)
+    {
+        slicesSize += info->pSliceSizes[i];
+    }
+    if (slicesSize > size)
+    {
+        DDI_ASSERTMESSAGE("Slice sizes exceed the coded frame size.");
+        return VA_STATUS_SUCCESS;
+    }
+
+    uint32_t numSegments = info->uiNumSlices - 1;
+    if (bufMgr->uiNumSliceCodedBufferSegments < numSegments)
+    {
+        MOS_FreeMemory(bufMgr->pSliceCodedBufferSegments);
+        bufMgr->pSliceCodedBufferSegments     = (VACodedBufferSegment *)MOS_AllocAndZeroMemory(numSegments * sizeof(VACodedBufferSegment));
+        bufMgr->uiNumSliceCodedBufferSegments = 0;
+        DDI_CHK_NULL(bufMgr->pSliceCodedBufferSegments, "Null bufMgr->pSliceCodedBufferSegments", VA_STATUS_ERROR_ALLOCATION_FAILED);
+        bufMgr->uiNumSliceCodedBufferSegments = numSegments;
+    }
+
+    uint8_t *base   = (uint8_t *)segment->buf;
+    uint32_t offset = info->pSliceSizes[0];
+    segment->size   = info->pSliceSizes[0];
+    for (uint32_t i = 1; i < info->uiNumSlices; i++)
+    {
+        VACodedBufferSegment *sliceSegment = &bufMgr->pSliceCodedBufferSegments[i - 1];
+        sliceSegment->buf        = base + offset;
+        sliceSegment->size       = info->pSliceSizes[i];
+        sliceSegment->bit_offset = 0;
+        sliceSegment->status     = status;
+        sliceSegment->next       = nullptr;
+
+        segment->next = sliceSegment;
+        segment       = sliceSegment;
+        offset       += info->pSliceSizes[i];
+    }
+
+    // Bytes after the last reported slice stay with the last segment
+    segment->size += size - slicesSize;
+
     return VA_STATUS_SUCCESS;
 }
 
@@ -877,15 +1104,14 @@ VAStatus DdiEncodeBase::CreateBuffer(
         return VA_STATUS_ERROR_INVALID_PARAMETER;
     }
 
-    DDI_MEDIA_BUFFER *buf = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+    PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+
+    DDI_MEDIA_BUFFER *buf = DdiMediaUtil_AllocMediaBuffer(mediaCtx, m_encodeCtx->pParamSlab);
     if (buf == nullptr)
     {
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
     }
 
-    PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
-
-    buf->pMediaCtx    = mediaCtx;
     buf->iNumElements = elementsNum;
     buf->uiType       = type;
     buf->uiOffset     = 0;
@@ -1247,8 +1473,9 @@ VAStatus DdiEncodeBase::CreateBuffer(
         (VAEncMacroblockDisableSkipMapBufferType != (int32_t)type) &&
         (VAProbabilityBufferType != (int32_t)type))
     {
-        buf->pData = (uint8_t*)MOS_AllocAndZeroMemory(bufSize);
-        if (nullptr == buf->pData)
+        // Fully written below when data is given
+        va = DdiMediaUtil_AllocParamBuffer(buf, bufSize, data == nullptr);
+        if (VA_STATUS_SUCCESS != va)
         {
             va = VA_STATUS_ERROR_ALLOCATION_FAILED;
             CleanUpBufferandReturn(buf);
@@ -1300,8 +1527,8 @@ void DdiEncodeBase::CleanUpBufferandReturn(DDI_MEDIA_BUFFER *buf)
 {
     if (buf)
     {
-        MOS_FreeMemory(buf->pData);
-        MOS_FreeMemory(buf);
+        DdiMediaUtil_FreeParamBuffer(buf);
+        DdiMediaUtil_FreeMediaBuffer(buf);
     }
 }
 
@@ -96,6 +96,27 @@ public:
         DDI_MEDIA_BUFFER *mediaBuf,
         void             **buf);
 
+    //!
+    //! \brief    Query the status report of a coded buffer
+    //! \details  Readiness is driven by the completion fence of the coded
+    //!           buffer. All reports completed by then are fetched from
+    //!           codechal in one call and recorded in the status report queue.
+    //!
+    //! \param    [in] mediaBuf
+    //!           Pointer to DDI_MEDIA_BUFFER
+    //! \param    [out] size
+    //!           Coded bitstream size
+    //! \param    [out] status
+    //!           VA coded buffer status
+    //!
+    //! \return   VAStatus
+    //!           VA_STATUS_SUCCESS if the report is available, else fail reason
+    //!
+    VAStatus QueryStatusReport(
+        DDI_MEDIA_BUFFER *mediaBuf,
+        uint32_t         *size,
+        uint32_t         *status);
+
     //!
     //! \brief    Report Status for Enc buffer.
     //!
@@ -208,6 +229,19 @@ public:
         DDI_MEDIA_BUFFER               *buf,
         DDI_ENCODE_PRE_ENC_BUFFER_TYPE typeIdx);
 
+    //!
+    //! \brief    Record a successful status report
+    //! \details  Fills the oldest pending status report queue entry with the
+    //!           coded size, status and slice sizes of a frame PAK completed.
+    //!
+    //! \param    [in] encodeStatusReport
+    //!           Pointer to the codechal status report of the frame
+    //!
+    //! \return   VAStatus
+    //!           VA_STATUS_SUCCESS if successful, else fail reason
+    //!
+    VAStatus CompleteStatusReport(EncodeStatusReport *encodeStatusReport);
+
     //!
     //! \brief    Create Encode buffer
     //! \details  Create Encode buffer
@@ -396,6 +430,54 @@ protected:
     //!
     VAStatus UpdatePreEncStatusReportBuffer(uint32_t status);
 
+    //!
+    //! \brief    Drain completed status reports
+    //! \details  Fetches the reports of all frames pending in the status report
+    //!           queue in one call and records them in submission order, up to
+    //!           the first one which is not complete yet.
+    //!
+    //! \param    [out] incomplete
+    //!           Set if a pending frame has not completed yet
+    //!
+    //! \return   VAStatus
+    //!           VA_STATUS_SUCCESS if successful, else fail reason
+    //!
+    VAStatus DrainStatusReports(bool *incomplete);
+
+    //!
+    //! \brief    Save the slice sizes of a completed frame
+    //! \details  Keeps the per slice coded sizes reported by PAK with the
+    //!           status report queue entry being updated, for slice segment output.
+    //!
+    //! \param    [in] encodeStatusReport
+    //!           Pointer to the codechal status report of the frame
+    //!
+    //! \return   VAStatus
+    //!           VA_STATUS_SUCCESS if successful, else fail reason
+    //!
+    VAStatus SaveSliceSizes(EncodeStatusReport *encodeStatusReport);
+
+    //!
+    //! \brief    Split the coded buffer segment into slice segments
+    //! \details  Chains one VACodedBufferSegment per slice behind the first
+    //!           segment when slice sizes were saved for the coded buffer.
+    //!           The single frame segment is kept otherwise.
+    //!
+    //! \param    [in] mediaBuf
+    //!           Pointer to the coded buffer
+    //! \param    [in] size
+    //!           Coded frame size
+    //! \param    [in] status
+    //!           VA coded buffer status
+    //!
+    //! \return   VAStatus
+    //!           VA_STATUS_SUCCESS if successful, else fail reason
+    //!
+    VAStatus SetSliceSegments(
+        DDI_MEDIA_BUFFER *mediaBuf,
+        uint32_t         size,
+        uint32_t         status);
+
     //!
     //! \brief    Get Size From Status Report Buffer
     //! \details  Get the coded buffer size, status and the index from Status
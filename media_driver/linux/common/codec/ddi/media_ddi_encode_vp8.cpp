@@ -208,120 +208,39 @@ VAStatus DdiEncodeVp8::StatusReport(
     m_encodeCtx->BufMgr.pCodedBufferSegment->status    = 0;
 
     //when this function is called, there must be a frame is ready, will wait until get the right information.
-    uint32_t size         = 0;
-    int32_t  index        = 0;
-    uint32_t status       = 0;
-    uint32_t timeOutCount = 0;
-    VAStatus vaStatus     = VA_STATUS_SUCCESS;
-
-    // Get encoded frame information from status buffer queue.
-    while (VA_STATUS_SUCCESS == (vaStatus = GetSizeFromStatusReportBuffer(mediaBuf, &size, &status, &index)))
+    uint32_t size     = 0;
+    uint32_t status   = 0;
+    VAStatus vaStatus = QueryStatusReport(mediaBuf, &size, &status);
+    if (vaStatus != VA_STATUS_SUCCESS)
     {
-        if ((index >= 0) && (size != 0))  //Get the matched encoded buffer information
-        {
-            uint32_t sizeOfExtStatusReportBuf          = 0;  //reset or not used
-
-            // the first segment in the single-link list: pointer for the coded bitstream and the size
-            m_encodeCtx->BufMgr.pCodedBufferSegment->buf    = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-            m_encodeCtx->BufMgr.pCodedBufferSegment->size   = size;
-            m_encodeCtx->BufMgr.pCodedBufferSegment->status = status;
-
-            //making a segment for the StatusReport: pointer for the StatusReport and the size of it
-            VACodedBufferSegment *pVACodedBufferSegmentForStatusReport;
-            pVACodedBufferSegmentForStatusReport = m_encodeCtx->BufMgr.pCodedBufferSegmentForStatusReport;
-            DDI_CHK_NULL(pVACodedBufferSegmentForStatusReport, "nullptr check in pVACodedBufferSegmentForStatusReport", VA_STATUS_ERROR_INVALID_CONTEXT);
-
-            pVACodedBufferSegmentForStatusReport->size = sizeOfExtStatusReportBuf;
-            pVACodedBufferSegmentForStatusReport->buf  = (void *)((char *)(m_encodeCtx->BufMgr.pCodedBufferSegment->buf) + size);
-            pVACodedBufferSegmentForStatusReport->next = nullptr;
-
-            VACodedBufferSegment *pFindTheLastEntry;
-            pFindTheLastEntry = m_encodeCtx->BufMgr.pCodedBufferSegment;
-            // if HDCP2 is enabled, the second segment for counter values is already there  So, move the connection as the third one
-            if (m_encodeCtx->pCpDdiInterface->IsHdcp2Enabled())
-                pFindTheLastEntry = (VACodedBufferSegment *)pFindTheLastEntry->next;
-            // connect Status report here
-            pFindTheLastEntry->next = pVACodedBufferSegmentForStatusReport;
+        return vaStatus;
+    }
 
-            break;
-        }
+    // the first segment in the single-link list: pointer for the coded bitstream and the size
+    m_encodeCtx->BufMgr.pCodedBufferSegment->buf    = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
+    m_encodeCtx->BufMgr.pCodedBufferSegment->size   = size;
+    m_encodeCtx->BufMgr.pCodedBufferSegment->status = status;
 
-        mos_bo_wait_rendering(mediaBuf->bo);
+    if (size != 0)
+    {
+        uint32_t sizeOfExtStatusReportBuf          = 0;  //reset or not used
 
-        EncodeStatusReport* encodeStatusReport = (EncodeStatusReport*)m_encodeCtx->pEncodeStatusReport;
-        encodeStatusReport->bSequential = true;  //Query the encoded frame status in sequential.
+        //making a segment for the StatusReport: pointer for the StatusReport and the size of it
+        VACodedBufferSegment *pVACodedBufferSegmentForStatusReport;
+        pVACodedBufferSegmentForStatusReport = m_encodeCtx->BufMgr.pCodedBufferSegmentForStatusReport;
+        DDI_CHK_NULL(pVACodedBufferSegmentForStatusReport, "nullptr check in pVACodedBufferSegmentForStatusReport", VA_STATUS_ERROR_INVALID_CONTEXT);
 
-        uint16_t numStatus = 1;
-        m_encodeCtx->pCodecHal->GetStatusReport(encodeStatusReport, numStatus);
+        pVACodedBufferSegmentForStatusReport->size = sizeOfExtStatusReportBuf;
+        pVACodedBufferSegmentForStatusReport->buf  = (void *)((char *)(m_encodeCtx->BufMgr.pCodedBufferSegment->buf) + size);
+        pVACodedBufferSegmentForStatusReport->next = nullptr;
 
-        if (CODECHAL_STATUS_SUCCESSFUL == encodeStatusReport[0].CodecStatus)
-        {
-            // Only AverageQP is reported at this time. Populate other bits with relevant informaiton later;
-            status = (encodeStatusReport[0].AverageQp & VA_CODED_BUF_STATUS_PICTURE_AVE_QP_MASK);
-            // fill hdcp related buffer
-            DDI_CHK_RET(m_encodeCtx->pCpDdiInterface->StatusReportForHdcp2Buffer(&m_encodeCtx->BufMgr, encodeStatusReport), "fail to get hdcp2 status report!");
-            if (UpdateStatusReportBuffer(encodeStatusReport[0].bitstreamSize, status) != VA_STATUS_SUCCESS)
-            {
-                m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-                m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-                m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-                m_encodeCtx->statusReportBuf.ulUpdatePosition = (m_encodeCtx->statusReportBuf.ulUpdatePosition + 1) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
-                break;
-            }
-            //Add encoded frame information into status buffer queue.
-            continue;
-        }
-        else if (CODECHAL_STATUS_INCOMPLETE == encodeStatusReport[0].CodecStatus)
-        {
-            CodechalEncoderState *encoder = dynamic_cast<CodechalEncoderState *>(m_encodeCtx->pCodecHal);
-            if (encoder != nullptr && encoder->m_inlineEncodeStatusUpdate)
-            {
-                m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-                m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-                m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-                m_encodeCtx->statusReportBuf.ulUpdatePosition = (m_encodeCtx->statusReportBuf.ulUpdatePosition + 1) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
-                DDI_ASSERTMESSAGE("Something unexpected happened in HW, return error to application");
-                break;
-            }
-            // Wait until encode PAK complete, sometimes we application detect encoded buffer object is Idle, may Enc done, but Pak not.
-            uint32_t maxTimeOut                               = 100000;  //set max sleep times to 100000 = 1s, other wise return error.
-            if (timeOutCount < maxTimeOut)
-            {
-                //sleep 10 us to wait encode complete, it won't impact the performance.
-                uint32_t sleepTime                            = 10;      //sleep 10 us when encode is not complete.
-                usleep(sleepTime);
-                timeOutCount++;
-                continue;
-            }
-            else
-            {
-                //if HW didn't response in 1s, assume there is an error in encoding process, return error to App.
-                m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-                m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-                m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-                m_encodeCtx->statusReportBuf.ulUpdatePosition = (m_encodeCtx->statusReportBuf.ulUpdatePosition + 1) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
-                DDI_ASSERTMESSAGE("Something unexpected happened in HW, return error to application");
-                break;
-            }
-        }
-        else if (CODECHAL_STATUS_ERROR == encodeStatusReport[0].CodecStatus)
-        {
-            DDI_NORMALMESSAGE("Encoding failure due to HW issue");
-            m_encodeCtx->BufMgr.pCodedBufferSegment->buf  = DdiMediaUtil_LockBuffer(mediaBuf, MOS_LOCKFLAG_READONLY);
-            m_encodeCtx->BufMgr.pCodedBufferSegment->size = 0;
-            m_encodeCtx->BufMgr.pCodedBufferSegment->status |= VA_CODED_BUF_STATUS_BAD_BITSTREAM;
-            m_encodeCtx->statusReportBuf.ulUpdatePosition = (m_encodeCtx->statusReportBuf.ulUpdatePosition + 1) % DDI_ENCODE_MAX_STATUS_REPORT_BUFFER;
-            break;
-        }
-        else
-        {
-            break;
-        }
-    }
-
-    if (vaStatus != VA_STATUS_SUCCESS)
-    {
-        return vaStatus;
+        VACodedBufferSegment *pFindTheLastEntry;
+        pFindTheLastEntry = m_encodeCtx->BufMgr.pCodedBufferSegment;
+        // if HDCP2 is enabled, the second segment for counter values is already there  So, move the connection as the third one
+        if (m_encodeCtx->pCpDdiInterface->IsHdcp2Enabled())
+            pFindTheLastEntry = (VACodedBufferSegment *)pFindTheLastEntry->next;
+        // connect Status report here
+        pFindTheLastEntry->next = pVACodedBufferSegmentForStatusReport;
     }
 
     *buf = m_encodeCtx->BufMgr.pCodedBufferSegment;
@@ -153,6 +153,49 @@ VAStatus DdiDecode_EndPicture (
     return VA_STATUS_ERROR_UNIMPLEMENTED;
 }
 
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to complete the status reports of all
+    //!           submitted frames of a decode context, as the GPU would
+    //!
+    MOS_FUNC_EXPORT VAStatus DdiDecode_SetUltFramesCompleted(
+        VADriverContextP    ctx,
+        VAContextID         context)
+    {
+        DDI_CHK_NULL(ctx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        uint32_t            ctxType = DDI_MEDIA_CONTEXT_TYPE_NONE;
+        PDDI_DECODE_CONTEXT decCtx  = (PDDI_DECODE_CONTEXT)DdiMedia_GetContextFromContextID(ctx, context, &ctxType);
+        DDI_CHK_NULL(decCtx, "nullptr decCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        DDI_CHK_CONDITION(ctxType != DDI_MEDIA_CONTEXT_TYPE_DECODER, "Not a decode context", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+        CodechalDecode *decoder = dynamic_cast<CodechalDecode *>(decCtx->pCodecHal);
+        DDI_CHK_NULL(decoder, "nullptr decoder", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+        CodechalDecodeStatusBuffer *decodeStatusBuf = decoder->GetDecodeStatusBuf();
+        DDI_CHK_NULL(decodeStatusBuf, "nullptr decodeStatusBuf", VA_STATUS_ERROR_INVALID_CONTEXT);
+        DDI_CHK_NULL(decodeStatusBuf->m_data, "nullptr decodeStatusBuf->m_data", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+        for (uint16_t index = decodeStatusBuf->m_firstIndex; index != decodeStatusBuf->m_currIndex;
+            index = (index + 1) & (CODECHAL_DECODE_STATUS_NUM - 1))
+        {
+            decodeStatusBuf->m_decodeStatus[index].m_hwStoredData       = CODECHAL_STATUS_QUERY_END_FLAG;
+            decodeStatusBuf->m_decodeStatus[index].m_mmioErrorStatusReg = 0;
+            decodeStatusBuf->m_decodeStatus[index].m_mmioMBCountReg     = 0;
+        }
+        *decodeStatusBuf->m_data = decodeStatusBuf->m_swStoreData;
+
+        return VA_STATUS_SUCCESS;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 /*
  * Send decode buffers to the server.
  * Buffers are automatically destroyed afterwards
@@ -200,6 +243,8 @@ void DdiDecodeCleanUp(
         {
             decCtx->m_ddiDecode->DestroyContext(ctx);
         MOS_Delete(decCtx->m_ddiDecode);
+            // buffers still alive keep their own reference to the slab
+            DdiMediaUtil_ReleaseParamSlab(decCtx->pParamSlab);
             MOS_FreeMemory(decCtx);
             decCtx = nullptr;
         }
@@ -301,6 +346,7 @@ VAStatus DdiDecode_CreateContext (
 
     decCtx->pMediaCtx                       = mediaCtx;
     decCtx->m_ddiDecode                     = ddiDecBase;
+    decCtx->pParamSlab                      = DdiMediaUtil_CreateParamSlab();
 
     mosCtx.bufmgr                = mediaCtx->pDrmBufMgr;
     mosCtx.m_gpuContextMgr       = mediaCtx->m_gpuContextMgr;
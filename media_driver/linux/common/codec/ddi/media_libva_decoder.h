@@ -74,11 +74,16 @@ struct DDI_DECODE_CONTEXT
     DDI_CODEC_RENDER_TARGET_TABLE   RTtbl;
     DDI_CODEC_COM_BUFFER_MGR        BufMgr;
     PDDI_MEDIA_CONTEXT              pMediaCtx;
+    // Recycled parameter buffer memory of this context, nullptr if not created
+    PDDI_MEDIA_PARAM_SLAB           pParamSlab;
     // Add a list to track DPB.
     VASurfaceID                     RecListSurfaceID[CODEC_AVC_NUM_UNCOMPRESSED_SURFACE];
     uint32_t                        dwSliceParamBufNum;
     uint32_t                        dwSliceCtrlBufNum;
     uint32_t                        uiDecProcessingType;
+    // Render target of each decode status report slot, indexed like the codechal
+    // decode status buffer, so vaSyncSurface retires a report without a heap scan
+    PDDI_MEDIA_SURFACE              pStatusReportSurfaces[CODECHAL_DECODE_STATUS_NUM];
 };
 
 typedef struct DDI_DECODE_CONTEXT *PDDI_DECODE_CONTEXT;
@@ -166,6 +166,54 @@ VAStatus DdiEncode_StatusReport(
     return vaStatus;
 }
 
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to complete the oldest pending coded
+    //!           buffer of an encode context with the given slice sizes, as PAK would.
+    //!           In production only HEVC VDEnc reports slice sizes, the ULT has no
+    //!           HEVC VDEnc test data and completes AVC frames with them instead.
+    //!           Slice segments are output only if enabled for the context.
+    //!
+    MOS_FUNC_EXPORT VAStatus DdiEncode_UltCompleteCodedBuffer(
+        VADriverContextP    ctx,
+        VAContextID         context,
+        VABufferID          codedBuf,
+        uint32_t            frameSize,
+        uint16_t            *sliceSizes,
+        uint32_t            numSlices)
+    {
+        DDI_CHK_NULL(ctx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+        DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        PDDI_ENCODE_CONTEXT encCtx = DdiEncode_GetEncContextFromContextID(ctx, context);
+        DDI_CHK_NULL(encCtx, "nullptr encCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        DDI_CHK_NULL(encCtx->m_encode, "nullptr encCtx->m_encode", VA_STATUS_ERROR_INVALID_CONTEXT);
+        DDI_CHK_CONDITION(numSlices > 0xff, "Too many slices", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+        DDI_MEDIA_BUFFER *mediaBuf = DdiMedia_GetBufferFromVABufferID(mediaCtx, codedBuf);
+        DDI_CHK_NULL(mediaBuf, "nullptr mediaBuf", VA_STATUS_ERROR_INVALID_BUFFER);
+        DDI_ENCODE_STATUS_REPORT_INFO *info = &encCtx->statusReportBuf.infos[encCtx->statusReportBuf.ulUpdatePosition];
+        DDI_CHK_CONDITION(info->pCodedBuf != mediaBuf->bo, "Coded buffer is not the oldest pending one", VA_STATUS_ERROR_INVALID_BUFFER);
+
+        EncodeStatusReport encodeStatusReport;
+        MOS_ZeroMemory(&encodeStatusReport, sizeof(encodeStatusReport));
+        encodeStatusReport.CodecStatus   = CODECHAL_STATUS_SUCCESSFUL;
+        encodeStatusReport.bitstreamSize = frameSize;
+        encodeStatusReport.NumberSlices  = (uint8_t)numSlices;
+        encodeStatusReport.pSliceSizes   = sliceSizes;
+
+        return encCtx->m_encode->CompleteStatusReport(&encodeStatusReport);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 //!
 //! \brief  Clean and free encode context structure
 //!
@@ -186,6 +234,7 @@ void DdiEncodeCleanUp(PDDI_ENCODE_CONTEXT encCtx)
         encCtx->pCpDdiInterface = nullptr;
     }
 
+    DdiMediaUtil_ReleaseParamSlab(encCtx->pParamSlab);
     MOS_FreeMemory(encCtx);
     encCtx = nullptr;
 
@@ -337,6 +386,7 @@ VAStatus DdiEncode_CreateContext(
     encCtx->targetUsage           = TARGETUSAGE_RT_SPEED;
     // Attach PMEDIDA_DRIVER_CONTEXT
     encCtx->pMediaCtx = mediaDrvCtx;
+    encCtx->pParamSlab = DdiMediaUtil_CreateParamSlab();
 
     encCtx->pCpDdiInterface->SetHdcp2Enabled(flag);
     encCtx->pCpDdiInterface->SetCpParams(CP_TYPE_NONE, encCtx->m_encode->m_codechalSettings);
@@ -463,6 +513,8 @@ VAStatus DdiEncode_DestroyContext(VADriverContextP ctx, VAContextID context)
         encCtx->m_encode = nullptr;
     }
 
+    // buffers still alive keep their own reference to the slab
+    DdiMediaUtil_ReleaseParamSlab(encCtx->pParamSlab);
     MOS_FreeMemory(encCtx);
     encCtx = nullptr;
 
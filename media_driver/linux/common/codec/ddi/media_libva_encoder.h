@@ -36,6 +36,9 @@
 
 #define DDI_ENCODE_MAX_STATUS_REPORT_BUFFER    CODECHAL_ENCODE_STATUS_NUM
 
+// max wait on the status buffer fence once the coded buffer is idle, HW is assumed hung after it
+#define DDI_ENCODE_STATUS_REPORT_TIMEOUT_NS    1000000000ll
+
 typedef enum _DDI_ENCODE_FEI_ENC_BUFFER_TYPE
 {
     FEI_ENC_BUFFER_TYPE_MVDATA     = 0,
@@ -58,6 +61,9 @@ typedef struct _DDI_ENCODE_STATUS_REPORT_INFO
     uint32_t        uiSize;                 //encoded frame size
     uint32_t        uiStatus;               // Encode frame status
     uint32_t        uiInputCtr[4];          // Counter for HDCP2 session
+    uint16_t       *pSliceSizes;            // Coded size of each slice, slice segment output only
+    uint32_t        uiNumSlices;            // Number of valid entries in pSliceSizes
+    uint32_t        uiMaxSlices;            // Allocated entries of pSliceSizes
 } DDI_ENCODE_STATUS_REPORT_INFO;
 
 // ENC output buffer checking for FEI_ENC case only
@@ -161,12 +167,16 @@ typedef struct _DDI_ENCODE_CONTEXT
     bool                              bVdencActive;
     //VDENC Dynamic slice enabling
     bool                              EnableSliceLevelRateCtrl;
+    //Return one coded buffer segment per slice
+    bool                              bSliceSegmentOutput;
     //Per-MB Qp control
     bool                              bMBQpEnable;
 
     DDI_CODEC_RENDER_TARGET_TABLE     RTtbl;
     DDI_CODEC_COM_BUFFER_MGR          BufMgr;
     PDDI_MEDIA_CONTEXT                pMediaCtx;
+    // Recycled parameter buffer memory of this context, nullptr if not created
+    PDDI_MEDIA_PARAM_SLAB             pParamSlab;
 
     uint8_t                           targetUsage;
 
@@ -24,6 +24,7 @@
 //! \brief    Defines base class for DDI media encode/decoder.
 //!
 
+#include <algorithm>
 #include "media_ddi_base.h"
 
 int32_t DdiMediaBase::GetRenderTargetID(DDI_CODEC_RENDER_TARGET_TABLE *rtTbl, DDI_MEDIA_SURFACE *surface)
@@ -179,3 +180,21 @@ VAStatus DdiMediaBase::UnRegisterRTSurfaces(DDI_CODEC_RENDER_TARGET_TABLE *rtTbl
     return VA_STATUS_SUCCESS;
 }
 
+VAStatus DdiMediaBase::UnRegisterRTSurfaces(DDI_CODEC_RENDER_TARGET_TABLE *rtTbl, DDI_MEDIA_SURFACE **surfaces, uint32_t numSurfaces)
+{
+    DDI_CHK_NULL(rtTbl, "nullptr rtTbl", VA_STATUS_ERROR_INVALID_PARAMETER);
+    DDI_CHK_NULL(surfaces, "nullptr surfaces", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    for (uint32_t i = 0; i < DDI_MEDIA_MAX_SURFACE_NUMBER_CONTEXT; i++)
+    {
+        if (rtTbl->pRT[i] != nullptr &&
+            std::binary_search(surfaces, surfaces + numSurfaces, rtTbl->pRT[i]))
+        {
+            rtTbl->pRT[i] = nullptr;
+            rtTbl->ucRTFlag[i] = SURFACE_STATE_INACTIVE;
+            rtTbl->iNumRenderTargets--;
+        }
+    }
+    return VA_STATUS_SUCCESS;
+}
+
@@ -142,6 +142,22 @@ public:
     //!
     VAStatus UnRegisterRTSurfaces(DDI_CODEC_RENDER_TARGET_TABLE *rtTbl, DDI_MEDIA_SURFACE *surface);
 
+    //!
+    //! \brief    Unregister Render Target Surfaces
+    //! \details  Unregister a batch of surfaces in render target table in one pass
+    //!
+    //! \param    [in] rtTbl
+    //!           Pointer to DDI_CODEC_RENDER_TARGET_TABLE
+    //! \param    [in] surfaces
+    //!           Surfaces to unregister, sorted by address
+    //! \param    [in] numSurfaces
+    //!           Number of surfaces
+    //!
+    //! \return   VAStatus
+    //!           VA_STATUS_SUCCESS if success, else fail reason
+    //!
+    VAStatus UnRegisterRTSurfaces(DDI_CODEC_RENDER_TARGET_TABLE *rtTbl, DDI_MEDIA_SURFACE **surfaces, uint32_t numSurfaces);
+
 protected:
     //!
     //! \brief    Get Render Target Index
@@ -31,6 +31,7 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
+#include <algorithm>
 
 #ifndef ANDROID
 #include <X11/Xutil.h>
@@ -49,6 +50,7 @@
 
 #include "hwinfo_linux.h"
 #include "codechal_memdecomp.h"
+#include "codechal_allocator.h"
 #include "mos_solo_generic.h"
 #include "media_libva_caps.h"
 #include "media_interfaces_mmd.h"
@@ -1347,6 +1349,9 @@ VAStatus DdiMedia__Initialize (
     DdiMediaUtil_InitMutex(&mediaCtx->VpMutex);
     DdiMediaUtil_InitMutex(&mediaCtx->CmMutex);
     DdiMediaUtil_InitMutex(&mediaCtx->MfeMutex);
+
+    DdiMediaUtil_InitSurfacePool(mediaCtx);
+    DdiMediaUtil_InitSurfaceReaper(mediaCtx);
 #ifndef ANDROID
     DdiMediaUtil_InitMutex(&mediaCtx->PutSurfaceRenderMutex);
     DdiMediaUtil_InitMutex(&mediaCtx->PutSurfaceSwapBufferMutex);
@@ -1455,6 +1460,22 @@ VAStatus DdiMedia__Initialize (
         }
     }
 
+    // the encoder resource pool frees resources with its own OS context of the device,
+    // which must not refer to the perf data or CP context of any codec instance
+    MOS_CONTEXT poolCtx           = {};
+    poolCtx.bufmgr                = mediaCtx->pDrmBufMgr;
+    poolCtx.m_gpuContextMgr       = mediaCtx->m_gpuContextMgr;
+    poolCtx.m_cmdBufMgr           = mediaCtx->m_cmdBufMgr;
+    poolCtx.fd                    = mediaCtx->fd;
+    poolCtx.iDeviceId             = mediaCtx->iDeviceId;
+    poolCtx.SkuTable              = mediaCtx->SkuTable;
+    poolCtx.WaTable               = mediaCtx->WaTable;
+    poolCtx.gtSystemInfo          = *mediaCtx->pGtSystemInfo;
+    poolCtx.platform              = mediaCtx->platform;
+    poolCtx.ppMediaMemDecompState = &mediaCtx->pMediaMemDecompState;
+    poolCtx.pfnMemoryDecompress   = mediaCtx->pfnMemoryDecompress;
+    CodechalResourcePool::CreateDevice(&poolCtx);
+
     DdiMediaUtil_UnLockMutex(&GlobalMutex);
 
     return VA_STATUS_SUCCESS;
@@ -1520,6 +1541,12 @@ static VAStatus DdiMedia_Terminate (
 
     mediaCtx->SkuTable.reset();
     mediaCtx->WaTable.reset();
+    // release pending and recycled surface allocations before the buffer manager
+    DdiMediaUtil_DestroySurfaceReaper(mediaCtx);
+    DdiMediaUtil_DestroySurfacePool(mediaCtx);
+    // encoder resources pooled on the device are kept until it goes away
+    CodechalResourcePool::DestroyDevice(mediaCtx->pDrmBufMgr);
+
     // destroy libdrm buffer manager
     mos_bufmgr_destroy(mediaCtx->pDrmBufMgr);
 
@@ -1604,6 +1631,7 @@ static VAStatus DdiMedia_Terminate (
     MOS_utilities_close();
 
     // Free GMM memory.
+    DdiMediaUtil_FlushGmmLayoutCache();
     GmmDestroyGlobalContext();
 
     DdiMediaUtil_UnLockMutex(&GlobalMutex);
@@ -1836,12 +1864,34 @@ static VAStatus DdiMedia_DestroySurfaces (
     DDI_CHK_NULL  (mediaCtx,                  "nullptr mediaCtx",               VA_STATUS_ERROR_INVALID_CONTEXT);
     DDI_CHK_NULL  (mediaCtx->pSurfaceHeap,    "nullptr mediaCtx->pSurfaceHeap", VA_STATUS_ERROR_INVALID_CONTEXT);
 
+    PDDI_MEDIA_SURFACE *mediaSurfaces = (PDDI_MEDIA_SURFACE *)MOS_AllocAndZeroMemory(num_surfaces * sizeof(PDDI_MEDIA_SURFACE));
+    DDI_CHK_NULL(mediaSurfaces, "nullptr mediaSurfaces", VA_STATUS_ERROR_ALLOCATION_FAILED);
+
     PDDI_MEDIA_SURFACE surface = nullptr;
     for(int32_t i = 0; i < num_surfaces; i++)
     {
-        DDI_CHK_LESS((uint32_t)surfaces[i], mediaCtx->pSurfaceHeap->uiAllocatedHeapElements, "Invalid surfaces", VA_STATUS_ERROR_INVALID_SURFACE);
-        surface = DdiMedia_GetSurfaceFromVASurfaceID(mediaCtx, surfaces[i]);
-        DDI_CHK_NULL(surface, "nullptr surface", VA_STATUS_ERROR_INVALID_SURFACE);
+        if ((uint32_t)surfaces[i] >= mediaCtx->pSurfaceHeap->uiAllocatedHeapElements ||
+            (surface = DdiMedia_GetSurfaceFromVASurfaceID(mediaCtx, surfaces[i])) == nullptr)
+        {
+            DDI_ASSERTMESSAGE("Invalid surfaces");
+            MOS_FreeMemory(mediaSurfaces);
+            return VA_STATUS_ERROR_INVALID_SURFACE;
+        }
+        mediaSurfaces[i] = surface;
+    }
+
+    // Sorted for the RT table walk, a surface listed twice would be released twice
+    std::sort(mediaSurfaces, mediaSurfaces + num_surfaces);
+    if (std::adjacent_find(mediaSurfaces, mediaSurfaces + num_surfaces) != mediaSurfaces + num_surfaces)
+    {
+        DDI_ASSERTMESSAGE("Surface destroyed twice");
+        MOS_FreeMemory(mediaSurfaces);
+        return VA_STATUS_ERROR_INVALID_SURFACE;
+    }
+
+    for(int32_t i = 0; i < num_surfaces; i++)
+    {
+        surface = mediaSurfaces[i];
         if(surface->pCurrentFrameSemaphore)
         {
             DdiMediaUtil_WaitSemaphore(surface->pCurrentFrameSemaphore);
@@ -1854,11 +1904,10 @@ static VAStatus DdiMedia_DestroySurfaces (
         }
     }
 
+    PDDI_MEDIA_SURFACE pendingSurfaces = nullptr;
     for(int32_t i = 0; i < num_surfaces; i++)
     {
-        DDI_CHK_LESS((uint32_t)surfaces[i], mediaCtx->pSurfaceHeap->uiAllocatedHeapElements, "Invalid surfaces", VA_STATUS_ERROR_INVALID_SURFACE);
-        surface = DdiMedia_GetSurfaceFromVASurfaceID(mediaCtx, surfaces[i]);
-        DDI_CHK_NULL(surface, "nullptr surface", VA_STATUS_ERROR_INVALID_SURFACE);
+        surface = mediaSurfaces[i];
         if(surface->pCurrentFrameSemaphore)
         {
             DdiMediaUtil_DestroySemaphore(surface->pCurrentFrameSemaphore);
@@ -1871,15 +1920,24 @@ static VAStatus DdiMedia_DestroySurfaces (
             surface->pReferenceFrameSemaphore = nullptr;
         }
 
-        DdiMediaUtil_UnRegisterRTSurfaces(ctx, surface);
+        surface->pNextPending = pendingSurfaces;
+        pendingSurfaces       = surface;
+    }
+
+    // One pass over the decode/encode contexts for the whole batch
+    DdiMediaUtil_UnRegisterRTSurfaces(ctx, mediaSurfaces, (uint32_t)num_surfaces);
+    MOS_FreeMemory(mediaSurfaces);
 
-        DdiMediaUtil_FreeSurface(surface);
-        MOS_FreeMemory(surface);
-        DdiMediaUtil_LockMutex(&mediaCtx->SurfaceMutex);
+    DdiMediaUtil_LockMutex(&mediaCtx->SurfaceMutex);
+    for(int32_t i = 0; i < num_surfaces; i++)
+    {
         DdiMediaUtil_ReleasePMediaSurfaceFromHeap(mediaCtx->pSurfaceHeap, (uint32_t)surfaces[i]);
         mediaCtx->uiNumSurfaces--;
-        DdiMediaUtil_UnLockMutex(&mediaCtx->SurfaceMutex);
     }
+    DdiMediaUtil_UnLockMutex(&mediaCtx->SurfaceMutex);
+
+    // bo and GMM info are released by the surface reaper if deferred release is enabled
+    DdiMediaUtil_ReapSurfaces(mediaCtx, pendingSurfaces);
 
     return VA_STATUS_SUCCESS;
 }
@@ -2433,6 +2491,59 @@ static VAStatus DdiMedia_DestroyContext (
     }
 }
 
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //!
+    //! \brief    Exported for the ULT to read the parameter slab statistics of
+    //!           a context, as allocs, hits, frees and released blocks
+    //!
+    MOS_FUNC_EXPORT VAStatus DdiMedia_GetUltParamSlabStats(
+        VADriverContextP    ctx,
+        VAContextID         context,
+        uint64_t            stats[4])
+    {
+        DDI_CHK_NULL(ctx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
+        DDI_CHK_NULL(stats, "nullptr stats", VA_STATUS_ERROR_INVALID_PARAMETER);
+        PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+        DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+        uint32_t              ctxType = DDI_MEDIA_CONTEXT_TYPE_NONE;
+        void                 *ctxPtr  = DdiMedia_GetContextFromContextID(ctx, context, &ctxType);
+        PDDI_MEDIA_PARAM_SLAB slab    = nullptr;
+        DDI_CHK_NULL(ctxPtr, "nullptr ctxPtr", VA_STATUS_ERROR_INVALID_CONTEXT);
+        switch (ctxType)
+        {
+            case DDI_MEDIA_CONTEXT_TYPE_DECODER:
+                slab = ((PDDI_DECODE_CONTEXT)ctxPtr)->pParamSlab;
+                break;
+            case DDI_MEDIA_CONTEXT_TYPE_ENCODER:
+                slab = ((PDDI_ENCODE_CONTEXT)ctxPtr)->pParamSlab;
+                break;
+            case DDI_MEDIA_CONTEXT_TYPE_VP:
+                slab = ((PDDI_VP_CONTEXT)ctxPtr)->pParamSlab;
+                break;
+            default:
+                return VA_STATUS_ERROR_INVALID_CONTEXT;
+        }
+        DDI_CHK_NULL(slab, "nullptr slab", VA_STATUS_ERROR_INVALID_CONTEXT);
+
+        DdiMediaUtil_LockMutex(&mediaCtx->BufferMutex);
+        stats[0] = slab->uiAllocs;
+        stats[1] = slab->uiHits;
+        stats[2] = __sync_fetch_and_add(&slab->uiFrees, 0);
+        stats[3] = __sync_fetch_and_add(&slab->uiReleased, 0);
+        DdiMediaUtil_UnLockMutex(&mediaCtx->BufferMutex);
+        return VA_STATUS_SUCCESS;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 static VAStatus DdiMedia_CreateBuffer (
     VADriverContextP    ctx,
     VAContextID         context,
@@ -2515,7 +2626,7 @@ static VAStatus DdiMedia_BufferSetNumElements (
     if(buf->uiType == VASliceParameterBufferType &&
        buf->iNumElements < num_elements)
     {
-        MOS_FreeMemory(buf->pData);
+        DdiMediaUtil_FreeParamBuffer(buf);
         buf->iSize = buf->iSize / buf->iNumElements;
         buf->pData = (uint8_t*)MOS_AllocAndZeroMemory(buf->iSize * num_elements);
         buf->iSize = buf->iSize * num_elements;
@@ -2985,11 +3096,11 @@ VAStatus DdiMedia_DestroyBuffer (
         case VAPictureParameterBufferType:
             break;
         case VAImageBufferType:
-            MOS_FreeMemory(buf->pData);
+            DdiMediaUtil_FreeParamBuffer(buf);
             break;
         case VAProcPipelineParameterBufferType:
         case VAProcFilterParameterBufferType:
-            MOS_FreeMemory(buf->pData);
+            DdiMediaUtil_FreeParamBuffer(buf);
             break;
         case VAIQMatrixBufferType:
         case VAHuffmanTableBufferType:
@@ -2998,7 +3109,7 @@ VAStatus DdiMedia_DestroyBuffer (
         case VAEncSequenceParameterBufferType:
         case VAEncPackedHeaderDataBufferType:
         case VAEncPackedHeaderParameterBufferType:
-            MOS_FreeMemory(buf->pData);
+            DdiMediaUtil_FreeParamBuffer(buf);
             break;
         case VABufferTypeMax:
             DdiMediaUtil_UnRefBufObjInMediaBuffer(buf);
@@ -3019,7 +3130,7 @@ VAStatus DdiMedia_DestroyBuffer (
             break;
 #endif
         case VAStatsStatisticsParameterBufferType:
-            MOS_FreeMemory(buf->pData);
+            DdiMediaUtil_FreeParamBuffer(buf);
             break;
         case VAStatsStatisticsBufferType:
         case VAStatsStatisticsBottomFieldBufferType:
@@ -3089,13 +3200,13 @@ VAStatus DdiMedia_DestroyBuffer (
             DdiMediaUtil_FreeBuffer(buf);
             break;
         default: // do not handle any un-listed buffer type
-            MOS_FreeMemory(buf->pData);
+            DdiMediaUtil_FreeParamBuffer(buf);
             break;
             //return va_STATUS_SUCCESS;
     }
-    MOS_FreeMemory(buf);
 
     DdiMedia_DestroyBufFromVABufferID(mediaCtx, buffer_id);
+    DdiMediaUtil_FreeMediaBuffer(buf);
 
     return VA_STATUS_SUCCESS;
 }
@@ -3131,6 +3242,8 @@ static VAStatus DdiMedia_BeginPicture (
     if(ctxType == DDI_MEDIA_CONTEXT_TYPE_VP)
     {
         surface->curStatusReport.vpp.status = VPREP_NOTAVAILABLE;
+        // Render target is overwritten by VP, decode updates the tag in CodecHal
+        surface->uiContentTag = 0;
     }
     DdiMediaUtil_UnLockMutex(&mediaCtx->SurfaceMutex);
 
@@ -3300,6 +3413,11 @@ static VAStatus DdiMedia_SyncSurface (
 
                 for (i = 0; i < uNumCompletedReport; i++)
                 {
+                    // GetStatusReport retires the oldest slot, take its render target first
+                    uint32_t           slot          = decodeStatusBuf->m_firstIndex;
+                    PDDI_MEDIA_SURFACE reportSurface = decCtx->pStatusReportSurfaces[slot];
+                    decCtx->pStatusReportSurfaces[slot] = nullptr;
+
                     CodechalDecodeStatusReport tempNewReport;
                     MOS_ZeroMemory(&tempNewReport, sizeof(CodechalDecodeStatusReport));
                     MOS_STATUS eStatus = decoder->GetStatusReport(&tempNewReport, 1);
@@ -3314,30 +3432,43 @@ static VAStatus DdiMedia_SyncSurface (
 
                     if ((tempNewReport.m_codecStatus == CODECHAL_STATUS_SUCCESSFUL) || (tempNewReport.m_codecStatus == CODECHAL_STATUS_ERROR) || (tempNewReport.m_codecStatus == CODECHAL_STATUS_INCOMPLETE))
                     {
-                        DdiMediaUtil_LockMutex(&mediaCtx->SurfaceMutex);
-                        PDDI_MEDIA_SURFACE_HEAP_ELEMENT mediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)mediaCtx->pSurfaceHeap->pHeapBase;
-
-                        int32_t j = 0;
-                        for (j = 0; j < mediaCtx->pSurfaceHeap->uiAllocatedHeapElements; j++, mediaSurfaceHeapElmt++)
+                        // The slot back-reference is only trusted while it still owns the reported bo,
+                        // otherwise search the surface heap for the owner.
+                        bool heapLocked = false;
+                        if (reportSurface == nullptr || reportSurface->bo != bo)
                         {
-                            if (mediaSurfaceHeapElmt != nullptr &&
-                                    mediaSurfaceHeapElmt->pSurface != nullptr &&
-                                    bo == mediaSurfaceHeapElmt->pSurface->bo)
+                            reportSurface = nullptr;
+                            heapLocked    = true;
+
+                            DdiMediaUtil_LockMutex(&mediaCtx->SurfaceMutex);
+                            PDDI_MEDIA_SURFACE_HEAP_ELEMENT mediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)mediaCtx->pSurfaceHeap->pHeapBase;
+                            for (int32_t j = 0; j < mediaCtx->pSurfaceHeap->uiAllocatedHeapElements; j++, mediaSurfaceHeapElmt++)
+                            {
+                                if (mediaSurfaceHeapElmt != nullptr &&
+                                        mediaSurfaceHeapElmt->pSurface != nullptr &&
+                                        bo == mediaSurfaceHeapElmt->pSurface->bo)
+                                {
+                                    reportSurface = mediaSurfaceHeapElmt->pSurface;
+                                    break;
+                                }
+                            }
+
+                            if (reportSurface == nullptr)
                             {
-                                mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.status = (uint32_t)tempNewReport.m_codecStatus;
-                                mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.errMbNum = (uint32_t)tempNewReport.m_numMbsAffected;
-                                mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.crcValue = (decoder->GetStandard() == CODECHAL_AVC)?(uint32_t)tempNewReport.m_frameCrc:0;
-                                mediaSurfaceHeapElmt->pSurface->curStatusReportQueryState = DDI_MEDIA_STATUS_REPORT_QUREY_STATE_COMPLETED;
-                                break;
+                                DdiMediaUtil_UnLockMutex(&mediaCtx->SurfaceMutex);
+                                return VA_STATUS_ERROR_OPERATION_FAILED;
                             }
                         }
 
-                        if (j == mediaCtx->pSurfaceHeap->uiAllocatedHeapElements)
+                        reportSurface->curStatusReport.decode.status = (uint32_t)tempNewReport.m_codecStatus;
+                        reportSurface->curStatusReport.decode.errMbNum = (uint32_t)tempNewReport.m_numMbsAffected;
+                        reportSurface->curStatusReport.decode.crcValue = (decoder->GetStandard() == CODECHAL_AVC)?(uint32_t)tempNewReport.m_frameCrc:0;
+                        reportSurface->curStatusReportQueryState = DDI_MEDIA_STATUS_REPORT_QUREY_STATE_COMPLETED;
+
+                        if (heapLocked)
                         {
                             DdiMediaUtil_UnLockMutex(&mediaCtx->SurfaceMutex);
-                            return VA_STATUS_ERROR_OPERATION_FAILED;
                         }
-                        DdiMediaUtil_UnLockMutex(&mediaCtx->SurfaceMutex);
                     }
                     else
                     {
@@ -4095,7 +4226,8 @@ VAStatus DdiMedia_DeriveImage (
          vaimg->pitches[0]               = mediaSurface->iPitch;
          vaimg->pitches[1]               =
          vaimg->pitches[2]               = mediaSurface->iPitch;
-         vaimg->offsets[1]               = mediaSurface->iHeight * mediaSurface->iPitch;
+         vaimg->offsets[1]               = mediaSurface->uiPlaneOffset[1] ?
+                                           mediaSurface->uiPlaneOffset[1] : mediaSurface->iHeight * mediaSurface->iPitch;
          vaimg->offsets[2]               = vaimg->offsets[1] + 2;
         break;
      default:
@@ -4105,7 +4237,9 @@ VAStatus DdiMedia_DeriveImage (
         vaimg->pitches[0]               = mediaSurface->iPitch;
         vaimg->pitches[1]               =
         vaimg->pitches[2]               = mediaSurface->iPitch;
-        vaimg->offsets[1]               = mediaSurface->iHeight * mediaSurface->iPitch;
+        // UV plane offset reported by GMM when the surface layout is known
+        vaimg->offsets[1]               = mediaSurface->uiPlaneOffset[1] ?
+                                          mediaSurface->uiPlaneOffset[1] : mediaSurface->iHeight * mediaSurface->iPitch;
         vaimg->offsets[2]               = vaimg->offsets[1] + 1;
         break;
     }
@@ -4130,6 +4264,7 @@ VAStatus DdiMedia_DeriveImage (
     buf->TileType     = mediaSurface->TileType;
     buf->pSurface     = mediaSurface;
     mos_bo_reference(mediaSurface->bo);
+    mediaSurface->bShared = true;
 
     DdiMediaUtil_LockMutex(&mediaCtx->BufferMutex);
     PDDI_MEDIA_BUFFER_HEAP_ELEMENT bufferHeapElement = DdiMediaUtil_AllocPMediaBufferFromHeap(mediaCtx->pBufferHeap);
@@ -5589,6 +5724,7 @@ VAStatus DdiMedia_ExportSurfaceHandle(
         //LOGE("Failed drm_intel_gem_export_to_prime operation!!!\n");
         return VA_STATUS_ERROR_OPERATION_FAILED;
     }
+    mediaSurface->bShared = true;
     uint32_t tiling, swizzle;
     if(mos_bo_get_tiling(mediaSurface->bo,&tiling, &swizzle))
     {
@@ -5881,6 +6017,7 @@ MEDIAAPI_EXPORT VAStatus DdiMedia_ExtGetSurfaceHandle(
                 //LOGE("Failed drm_intel_gem_export_to_prime operation!!!\n");
                 return VA_STATUS_ERROR_OPERATION_FAILED;
             }
+            mediaSurface->bShared = true;
         }
     }
     else
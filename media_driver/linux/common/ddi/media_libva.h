@@ -272,6 +272,8 @@ typedef struct _DDI_CODEC_COM_BUFFER_MGR
     VAProcPipelineParameterBuffer                ProcPipelineParamBuffer;
     VAProcFilterParameterBuffer                  ProcFilterParamBuffer;
     VACodedBufferSegment                        *pCodedBufferSegmentForStatusReport; // for extended Status report such as long-term reference for VP8-F encode
+    VACodedBufferSegment                        *pSliceCodedBufferSegments; // segments after the first one in slice segment output mode
+    uint32_t                                     uiNumSliceCodedBufferSegments; // allocated count of pSliceCodedBufferSegments
     void                                        *pCodecParamReserved;
     uint32_t                                     bitstreamBufferOffset = 0;
 
@@ -159,6 +159,16 @@ void DdiMedia_MediaSurfaceToMosResource(DDI_MEDIA_SURFACE *mediaSurface, MOS_RES
     mosResource->pGmmResInfo   = mediaSurface->pGmmResourceInfo;
     mosResource->dwGfxAddress  = 0;
 
+    // Content of shared or application allocated surfaces may change outside of the driver
+    if (mediaSurface->bShared || mediaSurface->pSurfDesc)
+    {
+        mosResource->pContentTag = nullptr;
+    }
+    else
+    {
+        mosResource->pContentTag = &mediaSurface->uiContentTag;
+    }
+
     // for MOS wrapper
     mosResource->bConvertedFromDDIResource = true;
 
@@ -216,6 +226,7 @@ void DdiMedia_MediaBufferToMosResource(DDI_MEDIA_BUFFER *mediaBuffer, MOS_RESOUR
     }
     mosResource->dwGfxAddress  = 0;
     mosResource->pGmmResInfo   = mediaBuffer->pGmmResourceInfo;
+    mosResource->pContentTag   = nullptr;
 
     // for MOS wrapper
     mosResource->bConvertedFromDDIResource = true;
@@ -271,6 +271,10 @@ typedef struct _DDI_MEDIA_SURFACE
     PDDI_MEDIA_CONTEXT      pMediaCtx; // Media driver Context
     PMEDIA_SEM_T            pCurrentFrameSemaphore;   // to sync render target for hybrid decoding multi-threading mode
     PMEDIA_SEM_T            pReferenceFrameSemaphore; // to sync reference frame surface. when this semaphore is posted, the surface is not used as reference frame, and safe to be destroied
+    uint32_t                bShared;                  // bo is referenced outside of the surface (derived image, exported handle), never recycled
+    uint32_t                uiContentTag;             // content the driver last formatted the surface with, 0 if unknown or written since
+    struct _DDI_MEDIA_SURFACE *pNextPending;          // next destroyed surface waiting for the surface reaper
+    uint32_t                uiPlaneOffset[3];         // Y, U and V plane offsets of the GMM layout, U is 0 if not known
 } DDI_MEDIA_SURFACE, *PDDI_MEDIA_SURFACE;
 
 typedef struct _DDI_MEDIA_BUFFER
@@ -300,6 +304,8 @@ typedef struct _DDI_MEDIA_BUFFER
     PDDI_MEDIA_SURFACE     pSurface;
     GMM_RESOURCE_INFO     *pGmmResourceInfo; // GMM resource descriptor
     PDDI_MEDIA_CONTEXT     pMediaCtx; // Media driver Context
+    uint32_t               uiSlabSize; // Size class of pData taken from the parameter slab, 0 if allocated directly
+    struct _DDI_MEDIA_PARAM_SLAB *pParamSlab; // Slab of the creating context, holds a reference, nullptr if none
 } DDI_MEDIA_BUFFER, *PDDI_MEDIA_BUFFER;
 
 typedef struct _DDI_MEDIA_SURFACE_HEAP_ELEMENT
@@ -340,6 +346,124 @@ typedef struct _DDI_MEDIA_HEAP
     void               *pFirstFreeHeapElement;
 }DDI_MEDIA_HEAP, *PDDI_MEDIA_HEAP;
 
+// Surface pool limits - memory held by destroyed surfaces kept for re-creation
+#define DDI_MEDIA_SURFACE_POOL_MAX_SIZE     (128 * 1024 * 1024)
+#define DDI_MEDIA_SURFACE_POOL_MAX_ENTRIES  64
+
+//!
+//! \struct DDI_MEDIA_SURFACE_POOL_ENTRY
+//! \brief  Allocation (bo and GMM layout) of a destroyed surface, kept for re-creation
+//!
+typedef struct _DDI_MEDIA_SURFACE_POOL_ENTRY
+{
+    // Key - tiling is derived from format and usage hint
+    DDI_MEDIA_FORMAT        format;
+    int32_t                 iWidth;
+    int32_t                 iRealHeight;
+    uint32_t                surfaceUsageHint;
+
+    // Allocation
+    MOS_LINUX_BO           *bo;
+    GMM_RESOURCE_INFO      *pGmmResourceInfo;
+    int32_t                 iHeight;
+    int32_t                 iPitch;
+    uint32_t                TileType;
+    uint32_t                uiPlaneOffset[3];
+
+    struct _DDI_MEDIA_SURFACE_POOL_ENTRY *pPrev;
+    struct _DDI_MEDIA_SURFACE_POOL_ENTRY *pNext;
+}DDI_MEDIA_SURFACE_POOL_ENTRY, *PDDI_MEDIA_SURFACE_POOL_ENTRY;
+
+//!
+//! \struct DDI_MEDIA_SURFACE_POOL
+//! \brief  LRU pool of destroyed surface allocations, bounded by size and entry count
+//!
+typedef struct _DDI_MEDIA_SURFACE_POOL
+{
+    PDDI_MEDIA_SURFACE_POOL_ENTRY pHead;        // Most recently released
+    PDDI_MEDIA_SURFACE_POOL_ENTRY pTail;        // Least recently released, evicted first
+    uint32_t            uiNumEntries;
+    uint64_t            uiPooledSize;           // Bytes held by pooled allocations
+    uint64_t            uiMaxPooledSize;
+    uint32_t            uiMaxEntries;
+
+    // Statistics
+    uint32_t            uiHits;                 // Surfaces created from the pool
+    uint32_t            uiMisses;               // Surfaces allocated from scratch
+    uint32_t            uiEvictions;            // Pooled allocations released to make room
+
+    MEDIA_MUTEX_T       PoolMutex;
+}DDI_MEDIA_SURFACE_POOL, *PDDI_MEDIA_SURFACE_POOL;
+
+//!
+//! \struct DDI_MEDIA_SURFACE_REAPER
+//! \brief  Destroyed surfaces whose allocations are released on a worker thread
+//!
+typedef struct _DDI_MEDIA_SURFACE_REAPER
+{
+    bool                bEnabled;
+    bool                bStop;
+    PDDI_MEDIA_SURFACE  pHead;                  // Pending surfaces, linked by pNextPending
+    pthread_t           Thread;
+    MEDIA_SEM_T         PendingSem;             // Posted for each queued batch and on stop
+    MEDIA_MUTEX_T       ReaperMutex;
+
+    // Statistics
+    uint32_t            uiBatches;              // Batches queued by vaDestroySurfaces
+    uint32_t            uiReleased;             // Surfaces released by the worker thread
+}DDI_MEDIA_SURFACE_REAPER, *PDDI_MEDIA_SURFACE_REAPER;
+
+// Parameter slab size classes - 256B, 1KB, 4KB, 16KB, 64KB
+#define DDI_MEDIA_PARAM_SLAB_NUM_CLASSES    5
+#define DDI_MEDIA_PARAM_SLAB_MIN_SHIFT      8
+#define DDI_MEDIA_PARAM_SLAB_CLASS_SHIFT    2
+#define DDI_MEDIA_PARAM_SLAB_MAX_CACHED     32      // Free blocks kept per class
+
+typedef struct _DDI_MEDIA_PARAM_SLAB_BLOCK
+{
+    struct _DDI_MEDIA_PARAM_SLAB_BLOCK *pNext;
+}DDI_MEDIA_PARAM_SLAB_BLOCK, *PDDI_MEDIA_PARAM_SLAB_BLOCK;
+
+//!
+//! \struct DDI_MEDIA_PARAM_SLAB_CLASS
+//! \brief  Free blocks of one size class
+//! \details Blocks are popped by buffer creation, which is serialized by
+//!          BufferMutex. Destroyed buffers push their blocks to pReturned
+//!          without locking, the allocating side takes the whole returned
+//!          list at once when its own list runs empty.
+//!
+typedef struct _DDI_MEDIA_PARAM_SLAB_CLASS
+{
+    PDDI_MEDIA_PARAM_SLAB_BLOCK pFree;          // Owned by the allocating side
+    PDDI_MEDIA_PARAM_SLAB_BLOCK pReturned;      // Lock free stack of freed blocks
+    uint32_t            uiBlockSize;
+    uint32_t            uiNumCached;            // Blocks in both lists
+}DDI_MEDIA_PARAM_SLAB_CLASS, *PDDI_MEDIA_PARAM_SLAB_CLASS;
+
+//!
+//! \struct DDI_MEDIA_PARAM_SLAB
+//! \brief  Recycled CPU memory of VA parameter buffers and their descriptors
+//! \details One slab per decode, encode or VP context, so contexts running on
+//!          different threads do not share free lists. The context and every
+//!          buffer created on it hold a reference, a buffer destroyed after its
+//!          context still returns its blocks to a valid slab, and the last
+//!          reference frees the cached blocks. Blocks are still popped with
+//!          BufferMutex held.
+//!
+typedef struct _DDI_MEDIA_PARAM_SLAB
+{
+    DDI_MEDIA_PARAM_SLAB_CLASS Classes[DDI_MEDIA_PARAM_SLAB_NUM_CLASSES];
+    DDI_MEDIA_PARAM_SLAB_CLASS BufferClass;     // DDI_MEDIA_BUFFER descriptors
+
+    // Statistics
+    uint64_t            uiAllocs;               // Blocks handed out
+    uint64_t            uiHits;                 // Blocks served from the free lists
+    uint64_t            uiFrees;                // Blocks returned
+    uint64_t            uiReleased;             // Returned blocks freed as the class was full
+
+    uint32_t            uiRefCount;             // Owning context and buffers created on it
+}DDI_MEDIA_PARAM_SLAB, *PDDI_MEDIA_PARAM_SLAB;
+
 #ifndef ANDROID
 typedef struct _DDI_X11_FUNC_TABLE
 {
@@ -373,6 +497,8 @@ struct DDI_MEDIA_CONTEXT
 
     PDDI_MEDIA_HEAP     pSurfaceHeap;
     uint32_t            uiNumSurfaces;
+    DDI_MEDIA_SURFACE_POOL SurfacePool;
+    DDI_MEDIA_SURFACE_REAPER SurfaceReaper;
 
     PDDI_MEDIA_HEAP     pBufferHeap;
     uint32_t            uiNumBufs;
@@ -34,6 +34,8 @@
 #include <fcntl.h>
 #include <dlfcn.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <algorithm>
 
 #include "media_libva_util.h"
 #include "mos_utilities.h"
@@ -265,6 +267,148 @@ bool DdiMediaUtil_IsExternalSurface(PDDI_MEDIA_SURFACE surface)
     return true;
 }
 
+// GMM layout cache - surface/buffer allocations repeat a few layouts many times.
+// Entries keep a prototype resource info per set of create params, allocations
+// get a copy of it together with the cached pitch/size/height and plane offsets.
+#define DDI_MEDIA_GMM_LAYOUT_CACHE_SIZE 32
+
+typedef struct _DDI_MEDIA_GMM_LAYOUT
+{
+    uint32_t                uiPitch;
+    uint32_t                uiSize;
+    uint32_t                uiHeight;
+    uint32_t                uiPlaneOffset[3];   // Render offsets of the Y, U and V planes
+} DDI_MEDIA_GMM_LAYOUT, *PDDI_MEDIA_GMM_LAYOUT;
+
+typedef struct _DDI_MEDIA_GMM_LAYOUT_CACHE_ENTRY
+{
+    GMM_RESCREATE_PARAMS    gmmParams;
+    GMM_RESOURCE_INFO      *pGmmResourceInfo;
+    DDI_MEDIA_GMM_LAYOUT    layout;
+} DDI_MEDIA_GMM_LAYOUT_CACHE_ENTRY;
+
+static DDI_MEDIA_GMM_LAYOUT_CACHE_ENTRY gmmLayoutCache[DDI_MEDIA_GMM_LAYOUT_CACHE_SIZE];
+static uint32_t                         gmmLayoutCacheNext;
+static uint32_t                         gmmLayoutCacheHits;
+static uint32_t                         gmmLayoutCacheMisses;
+static MEDIA_MUTEX_T                    gmmLayoutCacheMutex = MEDIA_MUTEX_INITIALIZER;
+
+//!
+//! \brief  Query the render offsets of the Y, U and V planes from GMM
+//!
+//! \param  [in] gmmResourceInfo
+//!         GMM resource info
+//! \param  [out] planeOffset
+//!         Offsets of the Y, U and V planes
+//!
+static void DdiMediaUtil_GetGmmPlaneOffsets(
+    GMM_RESOURCE_INFO   *gmmResourceInfo,
+    uint32_t             planeOffset[3])
+{
+    const GMM_YUV_PLANE planes[3] = { GMM_PLANE_Y, GMM_PLANE_U, GMM_PLANE_V };
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        GMM_REQ_OFFSET_INFO reqInfo;
+        MOS_ZeroMemory(&reqInfo, sizeof(reqInfo));
+        reqInfo.ReqRender = true;
+        reqInfo.Plane     = planes[i];
+        reqInfo.Frame     = GMM_DISPLAY_BASE;
+        reqInfo.CubeFace  = __GMM_NO_CUBE_MAP;
+        gmmResourceInfo->GetOffset(reqInfo);
+        planeOffset[i]    = reqInfo.Render.Offset;
+    }
+}
+
+//!
+//! \brief  Create GMM resource info through the layout cache
+//! \details Create params must be zero initialized (MOS_ZeroMemory) as they
+//!          are compared bytewise. The returned resource info is owned by the
+//!          caller and released with GmmResFree.
+//!
+//! \param  [in] gmmParams
+//!         GMM create params
+//! \param  [out] layout
+//!         Pitch, size and height of the resource
+//!
+//! \return GMM_RESOURCE_INFO *
+//!     Resource info, nullptr if creation failed
+//!
+static GMM_RESOURCE_INFO *DdiMediaUtil_GmmResCreateCached(
+    GMM_RESCREATE_PARAMS    *gmmParams,
+    PDDI_MEDIA_GMM_LAYOUT   layout)
+{
+    GMM_RESOURCE_INFO *gmmResourceInfo = nullptr;
+
+    DdiMediaUtil_LockMutex(&gmmLayoutCacheMutex);
+    for (uint32_t i = 0; i < DDI_MEDIA_GMM_LAYOUT_CACHE_SIZE; i++)
+    {
+        DDI_MEDIA_GMM_LAYOUT_CACHE_ENTRY *entry = &gmmLayoutCache[i];
+        if (entry->pGmmResourceInfo &&
+            memcmp(&entry->gmmParams, gmmParams, sizeof(GMM_RESCREATE_PARAMS)) == 0)
+        {
+            gmmResourceInfo = GmmResCopy(entry->pGmmResourceInfo);
+            if (gmmResourceInfo)
+            {
+                *layout = entry->layout;
+                gmmLayoutCacheHits++;
+                DdiMediaUtil_UnLockMutex(&gmmLayoutCacheMutex);
+                return gmmResourceInfo;
+            }
+            break;
+        }
+    }
+    gmmLayoutCacheMisses++;
+    DdiMediaUtil_UnLockMutex(&gmmLayoutCacheMutex);
+
+    gmmResourceInfo = GmmResCreate(gmmParams);
+    if (nullptr == gmmResourceInfo)
+    {
+        return nullptr;
+    }
+
+    layout->uiPitch  = (uint32_t)gmmResourceInfo->GetRenderPitch();
+    layout->uiSize   = (uint32_t)gmmResourceInfo->GetSizeSurface();
+    layout->uiHeight = gmmResourceInfo->GetBaseHeight();
+    DdiMediaUtil_GetGmmPlaneOffsets(gmmResourceInfo, layout->uiPlaneOffset);
+
+    // Keep a prototype, replacing entries round robin
+    GMM_RESOURCE_INFO *prototype = GmmResCopy(gmmResourceInfo);
+    if (prototype)
+    {
+        DdiMediaUtil_LockMutex(&gmmLayoutCacheMutex);
+        DDI_MEDIA_GMM_LAYOUT_CACHE_ENTRY *entry = &gmmLayoutCache[gmmLayoutCacheNext];
+        gmmLayoutCacheNext = (gmmLayoutCacheNext + 1) % DDI_MEDIA_GMM_LAYOUT_CACHE_SIZE;
+        if (entry->pGmmResourceInfo)
+        {
+            GmmResFree(entry->pGmmResourceInfo);
+        }
+        entry->gmmParams        = *gmmParams;
+        entry->pGmmResourceInfo = prototype;
+        entry->layout           = *layout;
+        DdiMediaUtil_UnLockMutex(&gmmLayoutCacheMutex);
+    }
+
+    return gmmResourceInfo;
+}
+
+void DdiMediaUtil_FlushGmmLayoutCache()
+{
+    DdiMediaUtil_LockMutex(&gmmLayoutCacheMutex);
+    for (uint32_t i = 0; i < DDI_MEDIA_GMM_LAYOUT_CACHE_SIZE; i++)
+    {
+        if (gmmLayoutCache[i].pGmmResourceInfo)
+        {
+            GmmResFree(gmmLayoutCache[i].pGmmResourceInfo);
+        }
+    }
+    MOS_ZeroMemory(gmmLayoutCache, sizeof(gmmLayoutCache));
+    DDI_VERBOSEMESSAGE("GMM layout cache: %d hits, %d misses.", gmmLayoutCacheHits, gmmLayoutCacheMisses);
+    gmmLayoutCacheNext   = 0;
+    gmmLayoutCacheHits   = 0;
+    gmmLayoutCacheMisses = 0;
+    DdiMediaUtil_UnLockMutex(&gmmLayoutCacheMutex);
+}
+
 //!
 //! \brief  Allocate surface
 //! 
@@ -303,6 +447,13 @@ VAStatus DdiMediaUtil_AllocateSurface(
     VAStatus hRes         = VA_STATUS_SUCCESS;
     int32_t alignedHeight = height;
 
+    // Re-use the allocation of a recently destroyed surface with the same layout
+    if (!DdiMediaUtil_IsExternalSurface(mediaSurface) &&
+        DdiMediaUtil_AcquireSurfaceFromPool(mediaDrvCtx, format, width, height, mediaSurface))
+    {
+        return VA_STATUS_SUCCESS;
+    }
+
     switch (format)
     {
         case Media_Format_X8R8G8B8:
@@ -489,7 +640,8 @@ VAStatus DdiMediaUtil_AllocateSurface(
        
     gmmParams.Flags.Gpu.Video = true;
 
-    mediaSurface->pGmmResourceInfo = gmmResourceInfo = GmmResCreate(&gmmParams);
+    DDI_MEDIA_GMM_LAYOUT        gmmLayout;
+    mediaSurface->pGmmResourceInfo = gmmResourceInfo = DdiMediaUtil_GmmResCreateCached(&gmmParams, &gmmLayout);
 
     if(nullptr == gmmResourceInfo)
     {
@@ -500,9 +652,9 @@ VAStatus DdiMediaUtil_AllocateSurface(
     uint32_t    gmmPitch;
     uint32_t    gmmSize;
     uint32_t    gmmHeight;
-    gmmPitch    = (uint32_t)gmmResourceInfo->GetRenderPitch();
-    gmmSize     = (uint32_t)gmmResourceInfo->GetSizeSurface();
-    gmmHeight   = gmmResourceInfo->GetBaseHeight();
+    gmmPitch    = gmmLayout.uiPitch;
+    gmmSize     = gmmLayout.uiSize;
+    gmmHeight   = gmmLayout.uiHeight;
 
     if ( 0 == gmmPitch || 0 == gmmSize || 0 == gmmHeight)
     {
@@ -595,6 +747,16 @@ VAStatus DdiMediaUtil_AllocateSurface(
         mediaSurface->TileType    = tileformat;
         mediaSurface->isTiled     = (tileformat != I915_TILING_NONE) ? 1 : 0;
         mediaSurface->pData       = (uint8_t*) bo->virt;
+        // The GMM offsets only apply if the bo kept the pitch of the layout
+        if ((uint32_t)pitch == gmmPitch)
+        {
+            MOS_SecureMemcpy(mediaSurface->uiPlaneOffset, sizeof(mediaSurface->uiPlaneOffset),
+                gmmLayout.uiPlaneOffset, sizeof(gmmLayout.uiPlaneOffset));
+        }
+        else
+        {
+            MOS_ZeroMemory(mediaSurface->uiPlaneOffset, sizeof(mediaSurface->uiPlaneOffset));
+        }
         DDI_VERBOSEMESSAGE("Alloc %7d bytes (%d x %d resource).",gmmSize, width, height);
     }
     else
@@ -665,7 +827,8 @@ VAStatus DdiMediaUtil_AllocateBuffer(
     gmmParams.Flags.Gpu.Video       = true;
     gmmParams.Flags.Info.Linear     = true;
 
-    mediaBuffer->pGmmResourceInfo = GmmResCreate(&gmmParams);
+    DDI_MEDIA_GMM_LAYOUT    gmmLayout;
+    mediaBuffer->pGmmResourceInfo = DdiMediaUtil_GmmResCreateCached(&gmmParams, &gmmLayout);
 
     DDI_CHK_NULL(mediaBuffer->pGmmResourceInfo, "pGmmResourceInfo is nullptr", VA_STATUS_ERROR_INVALID_BUFFER);
     GmmResOverrideAllocationSize(mediaBuffer->pGmmResourceInfo, mediaBuffer->iSize);
@@ -718,7 +881,8 @@ VAStatus DdiMediaUtil_Allocate2DBuffer(
     gmmParams.Flags.Info.Linear = true;
     gmmParams.Flags.Gpu.Video   = true;
     GMM_RESOURCE_INFO          *gmmResourceInfo;
-    mediaBuffer->pGmmResourceInfo = gmmResourceInfo = GmmResCreate(&gmmParams);
+    DDI_MEDIA_GMM_LAYOUT        gmmLayout;
+    mediaBuffer->pGmmResourceInfo = gmmResourceInfo = DdiMediaUtil_GmmResCreateCached(&gmmParams, &gmmLayout);
 
     if(nullptr == gmmResourceInfo)
     {
@@ -729,9 +893,9 @@ VAStatus DdiMediaUtil_Allocate2DBuffer(
     uint32_t    gmmPitch;
     uint32_t    gmmSize;
     uint32_t    gmmHeight;
-    gmmPitch    = (uint32_t)gmmResourceInfo->GetRenderPitch();
-    gmmSize     = (uint32_t)gmmResourceInfo->GetSizeSurface();
-    gmmHeight   = gmmResourceInfo->GetBaseHeight();
+    gmmPitch    = gmmLayout.uiPitch;
+    gmmSize     = gmmLayout.uiSize;
+    gmmHeight   = gmmLayout.uiHeight;
 
     MOS_LINUX_BO  *bo;
     bo = mos_bo_alloc(bufmgr, "Media 2D Buffer", gmmSize, 4096); 
@@ -823,6 +987,10 @@ void* DdiMediaUtil_LockSurface(DDI_MEDIA_SURFACE  *surface, uint32_t flag)
 {
     DDI_CHK_NULL(surface, "nullptr surface", nullptr);
     DDI_CHK_NULL(surface->bo, "nullptr surface->bo", nullptr);
+    if (flag & MOS_LOCKFLAG_WRITEONLY)
+    {
+        surface->uiContentTag = 0;
+    }
     if((false == surface->bMapped) && (0 == surface->iRefCount))
     {
         if (surface->pMediaCtx->bIsAtomSOC)
@@ -1043,7 +1211,12 @@ void DdiMediaUtil_FreeSurface(DDI_MEDIA_SURFACE *surface)
             DdiMediaUtil_UnlockSurface(surface);
             DDI_VERBOSEMESSAGE("DDI: try to free a locked surface.");
         }
-        mos_bo_unreference(surface->bo);
+
+        // Pool takes over bo and GMM info if the allocation can be recycled
+        if (!DdiMediaUtil_ReleaseSurfaceToPool(surface))
+        {
+            mos_bo_unreference(surface->bo);
+        }
         surface->bo = nullptr;
     }
 
@@ -1054,6 +1227,620 @@ void DdiMediaUtil_FreeSurface(DDI_MEDIA_SURFACE *surface)
     }
 }
 
+static void DdiMediaUtil_DetachSurfacePoolEntry(
+    PDDI_MEDIA_SURFACE_POOL       pool,
+    PDDI_MEDIA_SURFACE_POOL_ENTRY entry)
+{
+    // Detach from LRU list
+    *(entry->pPrev ? &entry->pPrev->pNext : &pool->pHead) = entry->pNext;
+    *(entry->pNext ? &entry->pNext->pPrev : &pool->pTail) = entry->pPrev;
+    pool->uiNumEntries--;
+    pool->uiPooledSize -= entry->bo->size;
+}
+
+void DdiMediaUtil_InitSurfacePool(PDDI_MEDIA_CONTEXT mediaCtx)
+{
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", );
+
+    PDDI_MEDIA_SURFACE_POOL pool = &mediaCtx->SurfacePool;
+    pool->pHead           = nullptr;
+    pool->pTail           = nullptr;
+    pool->uiNumEntries    = 0;
+    pool->uiPooledSize    = 0;
+    pool->uiMaxPooledSize = DDI_MEDIA_SURFACE_POOL_MAX_SIZE;
+    pool->uiMaxEntries    = DDI_MEDIA_SURFACE_POOL_MAX_ENTRIES;
+    pool->uiHits          = 0;
+    pool->uiMisses        = 0;
+    pool->uiEvictions     = 0;
+    DdiMediaUtil_InitMutex(&pool->PoolMutex);
+}
+
+void DdiMediaUtil_DestroySurfacePool(PDDI_MEDIA_CONTEXT mediaCtx)
+{
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", );
+
+    PDDI_MEDIA_SURFACE_POOL pool = &mediaCtx->SurfacePool;
+    DdiMediaUtil_LockMutex(&pool->PoolMutex);
+    while (pool->pHead)
+    {
+        PDDI_MEDIA_SURFACE_POOL_ENTRY entry = pool->pHead;
+        DdiMediaUtil_DetachSurfacePoolEntry(pool, entry);
+        mos_bo_unreference(entry->bo);
+        GmmResFree(entry->pGmmResourceInfo);
+        MOS_FreeMemory(entry);
+    }
+    DDI_VERBOSEMESSAGE("Surface pool: %u hits, %u misses, %u evictions.",
+        pool->uiHits, pool->uiMisses, pool->uiEvictions);
+    DdiMediaUtil_UnLockMutex(&pool->PoolMutex);
+    DdiMediaUtil_DestroyMutex(&pool->PoolMutex);
+}
+
+bool DdiMediaUtil_AcquireSurfaceFromPool(
+    PDDI_MEDIA_CONTEXT mediaCtx,
+    DDI_MEDIA_FORMAT   format,
+    int32_t            width,
+    int32_t            height,
+    PDDI_MEDIA_SURFACE mediaSurface)
+{
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", false);
+    DDI_CHK_NULL(mediaSurface, "nullptr mediaSurface", false);
+
+    PDDI_MEDIA_SURFACE_POOL       pool  = &mediaCtx->SurfacePool;
+    PDDI_MEDIA_SURFACE_POOL_ENTRY entry = nullptr;
+
+    DdiMediaUtil_LockMutex(&pool->PoolMutex);
+    for (entry = pool->pHead; entry != nullptr; entry = entry->pNext)
+    {
+        // Skip allocations still referenced by pending GPU work
+        if (entry->format           == format &&
+            entry->iWidth           == width  &&
+            entry->iRealHeight      == height &&
+            entry->surfaceUsageHint == mediaSurface->surfaceUsageHint &&
+            !mos_bo_busy(entry->bo))
+        {
+            DdiMediaUtil_DetachSurfacePoolEntry(pool, entry);
+            break;
+        }
+    }
+
+    if (entry == nullptr)
+    {
+        pool->uiMisses++;
+        DdiMediaUtil_UnLockMutex(&pool->PoolMutex);
+        return false;
+    }
+    pool->uiHits++;
+    DdiMediaUtil_UnLockMutex(&pool->PoolMutex);
+
+    mediaSurface->format           = format;
+    mediaSurface->iWidth           = width;
+    mediaSurface->iHeight          = entry->iHeight;
+    mediaSurface->iRealHeight      = height;
+    mediaSurface->iPitch           = entry->iPitch;
+    mediaSurface->iRefCount        = 0;
+    mediaSurface->bo               = entry->bo;
+    mediaSurface->pGmmResourceInfo = entry->pGmmResourceInfo;
+    mediaSurface->TileType         = entry->TileType;
+    mediaSurface->isTiled          = (entry->TileType != I915_TILING_NONE) ? 1 : 0;
+    mediaSurface->pData            = (uint8_t*) entry->bo->virt;
+    mediaSurface->bMapped          = false;
+    MOS_SecureMemcpy(mediaSurface->uiPlaneOffset, sizeof(mediaSurface->uiPlaneOffset),
+        entry->uiPlaneOffset, sizeof(entry->uiPlaneOffset));
+
+    MOS_FreeMemory(entry);
+    return true;
+}
+
+bool DdiMediaUtil_ReleaseSurfaceToPool(PDDI_MEDIA_SURFACE mediaSurface)
+{
+    DDI_CHK_NULL(mediaSurface, "nullptr mediaSurface", false);
+
+    PDDI_MEDIA_CONTEXT mediaCtx = mediaSurface->pMediaCtx;
+    if (mediaCtx == nullptr                         ||
+        mediaSurface->bo == nullptr                 ||
+        mediaSurface->pGmmResourceInfo == nullptr   ||
+        mediaSurface->bShared                       ||
+        DdiMediaUtil_IsExternalSurface(mediaSurface))
+    {
+        return false;
+    }
+
+    PDDI_MEDIA_SURFACE_POOL pool = &mediaCtx->SurfacePool;
+    if (mediaSurface->bo->size > pool->uiMaxPooledSize || pool->uiMaxEntries == 0)
+    {
+        return false;
+    }
+
+    PDDI_MEDIA_SURFACE_POOL_ENTRY entry = (PDDI_MEDIA_SURFACE_POOL_ENTRY)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_SURFACE_POOL_ENTRY));
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    entry->format           = mediaSurface->format;
+    entry->iWidth           = mediaSurface->iWidth;
+    entry->iRealHeight      = mediaSurface->iRealHeight;
+    entry->surfaceUsageHint = mediaSurface->surfaceUsageHint;
+    entry->bo               = mediaSurface->bo;
+    entry->pGmmResourceInfo = mediaSurface->pGmmResourceInfo;
+    entry->iHeight          = mediaSurface->iHeight;
+    entry->iPitch           = mediaSurface->iPitch;
+    entry->TileType         = mediaSurface->TileType;
+    MOS_SecureMemcpy(entry->uiPlaneOffset, sizeof(entry->uiPlaneOffset),
+        mediaSurface->uiPlaneOffset, sizeof(mediaSurface->uiPlaneOffset));
+
+    DdiMediaUtil_LockMutex(&pool->PoolMutex);
+
+    // Evict least recently released allocations to stay within the limits
+    while (pool->pTail &&
+           (pool->uiNumEntries >= pool->uiMaxEntries ||
+            pool->uiPooledSize + entry->bo->size > pool->uiMaxPooledSize))
+    {
+        PDDI_MEDIA_SURFACE_POOL_ENTRY evicted = pool->pTail;
+        DdiMediaUtil_DetachSurfacePoolEntry(pool, evicted);
+        mos_bo_unreference(evicted->bo);
+        GmmResFree(evicted->pGmmResourceInfo);
+        MOS_FreeMemory(evicted);
+        pool->uiEvictions++;
+    }
+
+    // Attach at head (most recently released)
+    entry->pPrev = nullptr;
+    entry->pNext = pool->pHead;
+    *(pool->pHead ? &pool->pHead->pPrev : &pool->pTail) = entry;
+    pool->pHead = entry;
+    pool->uiNumEntries++;
+    pool->uiPooledSize += entry->bo->size;
+
+    DdiMediaUtil_UnLockMutex(&pool->PoolMutex);
+
+    mediaSurface->pGmmResourceInfo = nullptr;
+    return true;
+}
+
+// Overrides the deferred surface release user feature if not negative, set by the ULT
+static int32_t ultDeferredSurfaceRelease = -1;
+
+#if MOS_ULT_HOOKS_ENABLED
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOS_FUNC_EXPORT void DdiMediaUtil_SetUltDeferredSurfaceRelease(int32_t enable)
+    {
+        ultDeferredSurfaceRelease = enable;
+    }
+
+    MOS_FUNC_EXPORT bool DdiMediaUtil_GetUltSurfaceReaperBatches(VADriverContextP ctx, uint32_t *batches)
+    {
+        if (ctx == nullptr || batches == nullptr)
+        {
+            return false;
+        }
+
+        PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+        if (mediaCtx == nullptr || !mediaCtx->SurfaceReaper.bEnabled)
+        {
+            return false;
+        }
+
+        DdiMediaUtil_LockMutex(&mediaCtx->SurfaceReaper.ReaperMutex);
+        *batches = mediaCtx->SurfaceReaper.uiBatches;
+        DdiMediaUtil_UnLockMutex(&mediaCtx->SurfaceReaper.ReaperMutex);
+        return true;
+    }
+
+    MOS_FUNC_EXPORT bool DdiMediaUtil_SetUltSurfacePoolMaxEntries(VADriverContextP ctx, uint32_t maxEntries)
+    {
+        if (ctx == nullptr)
+        {
+            return false;
+        }
+
+        PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+        if (mediaCtx == nullptr)
+        {
+            return false;
+        }
+
+        DdiMediaUtil_LockMutex(&mediaCtx->SurfacePool.PoolMutex);
+        mediaCtx->SurfacePool.uiMaxEntries = maxEntries;
+        DdiMediaUtil_UnLockMutex(&mediaCtx->SurfacePool.PoolMutex);
+        return true;
+    }
+
+    // planeOffset is filled with the offsets kept on the surface, or queried from
+    // its GMM resource info if fresh is set
+    MOS_FUNC_EXPORT bool DdiMediaUtil_GetUltSurfacePlaneOffsets(
+        VADriverContextP ctx,
+        VASurfaceID      surfaceId,
+        bool             fresh,
+        uint32_t         planeOffset[3])
+    {
+        if (ctx == nullptr || planeOffset == nullptr)
+        {
+            return false;
+        }
+
+        PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+        if (mediaCtx == nullptr)
+        {
+            return false;
+        }
+
+        PDDI_MEDIA_SURFACE surface = DdiMedia_GetSurfaceFromVASurfaceID(mediaCtx, surfaceId);
+        if (surface == nullptr || surface->pGmmResourceInfo == nullptr)
+        {
+            return false;
+        }
+
+        if (fresh)
+        {
+            DdiMediaUtil_GetGmmPlaneOffsets(surface->pGmmResourceInfo, planeOffset);
+        }
+        else
+        {
+            MOS_SecureMemcpy(planeOffset, 3 * sizeof(uint32_t), surface->uiPlaneOffset, sizeof(surface->uiPlaneOffset));
+        }
+        return true;
+    }
+
+    // stats is filled with the hits, misses and evictions of the surface pool
+    MOS_FUNC_EXPORT bool DdiMediaUtil_GetUltSurfacePoolStats(VADriverContextP ctx, uint32_t stats[3])
+    {
+        if (ctx == nullptr || stats == nullptr)
+        {
+            return false;
+        }
+
+        PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+        if (mediaCtx == nullptr)
+        {
+            return false;
+        }
+
+        DdiMediaUtil_LockMutex(&mediaCtx->SurfacePool.PoolMutex);
+        stats[0] = mediaCtx->SurfacePool.uiHits;
+        stats[1] = mediaCtx->SurfacePool.uiMisses;
+        stats[2] = mediaCtx->SurfacePool.uiEvictions;
+        DdiMediaUtil_UnLockMutex(&mediaCtx->SurfacePool.PoolMutex);
+        return true;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+static void *DdiMediaUtil_SurfaceReaperThread(void *arg)
+{
+    PDDI_MEDIA_SURFACE_REAPER reaper = (PDDI_MEDIA_SURFACE_REAPER)arg;
+    bool                      stop   = false;
+
+    while (!stop)
+    {
+        DdiMediaUtil_WaitSemaphore(&reaper->PendingSem);
+
+        // Take the whole pending list, surfaces queued before stop are still released
+        DdiMediaUtil_LockMutex(&reaper->ReaperMutex);
+        PDDI_MEDIA_SURFACE surface = reaper->pHead;
+        reaper->pHead = nullptr;
+        stop          = reaper->bStop;
+        DdiMediaUtil_UnLockMutex(&reaper->ReaperMutex);
+
+        while (surface)
+        {
+            PDDI_MEDIA_SURFACE next = surface->pNextPending;
+            DdiMediaUtil_FreeSurface(surface);
+            MOS_FreeMemory(surface);
+            surface = next;
+            reaper->uiReleased++;
+        }
+    }
+
+    return nullptr;
+}
+
+void DdiMediaUtil_InitSurfaceReaper(PDDI_MEDIA_CONTEXT mediaCtx)
+{
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", );
+
+    PDDI_MEDIA_SURFACE_REAPER reaper = &mediaCtx->SurfaceReaper;
+    reaper->bEnabled   = false;
+    reaper->bStop      = false;
+    reaper->pHead      = nullptr;
+    reaper->uiBatches  = 0;
+    reaper->uiReleased = 0;
+
+    MOS_USER_FEATURE_VALUE_DATA userFeatureData;
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_DEFERRED_SURFACE_RELEASE_ID,
+        &userFeatureData);
+    if (ultDeferredSurfaceRelease >= 0)
+    {
+        userFeatureData.i32Data = ultDeferredSurfaceRelease;
+    }
+    if (!userFeatureData.i32Data)
+    {
+        return;
+    }
+
+    DdiMediaUtil_InitMutex(&reaper->ReaperMutex);
+    sem_init(&reaper->PendingSem, 0, 0);
+    if (pthread_create(&reaper->Thread, nullptr, DdiMediaUtil_SurfaceReaperThread, reaper) != 0)
+    {
+        DDI_NORMALMESSAGE("Cannot create surface reaper thread, surfaces are released synchronously.");
+        DdiMediaUtil_DestroySemaphore(&reaper->PendingSem);
+        DdiMediaUtil_DestroyMutex(&reaper->ReaperMutex);
+        return;
+    }
+    reaper->bEnabled = true;
+}
+
+void DdiMediaUtil_DestroySurfaceReaper(PDDI_MEDIA_CONTEXT mediaCtx)
+{
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", );
+
+    PDDI_MEDIA_SURFACE_REAPER reaper = &mediaCtx->SurfaceReaper;
+    if (!reaper->bEnabled)
+    {
+        return;
+    }
+
+    DdiMediaUtil_LockMutex(&reaper->ReaperMutex);
+    reaper->bStop = true;
+    DdiMediaUtil_UnLockMutex(&reaper->ReaperMutex);
+    DdiMediaUtil_PostSemaphore(&reaper->PendingSem);
+    pthread_join(reaper->Thread, nullptr);
+
+    DDI_VERBOSEMESSAGE("Surface reaper: %d batches, %d surfaces released.",
+        reaper->uiBatches, reaper->uiReleased);
+    reaper->bEnabled = false;
+    DdiMediaUtil_DestroySemaphore(&reaper->PendingSem);
+    DdiMediaUtil_DestroyMutex(&reaper->ReaperMutex);
+}
+
+void DdiMediaUtil_ReapSurfaces(PDDI_MEDIA_CONTEXT mediaCtx, PDDI_MEDIA_SURFACE surfaces)
+{
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", );
+
+    PDDI_MEDIA_SURFACE_REAPER reaper = &mediaCtx->SurfaceReaper;
+    if (surfaces == nullptr)
+    {
+        return;
+    }
+
+    if (reaper->bEnabled)
+    {
+        PDDI_MEDIA_SURFACE tail = surfaces;
+        while (tail->pNextPending)
+        {
+            tail = tail->pNextPending;
+        }
+
+        DdiMediaUtil_LockMutex(&reaper->ReaperMutex);
+        tail->pNextPending = reaper->pHead;
+        reaper->pHead      = surfaces;
+        reaper->uiBatches++;
+        DdiMediaUtil_UnLockMutex(&reaper->ReaperMutex);
+        DdiMediaUtil_PostSemaphore(&reaper->PendingSem);
+        return;
+    }
+
+    while (surfaces)
+    {
+        PDDI_MEDIA_SURFACE next = surfaces->pNextPending;
+        DdiMediaUtil_FreeSurface(surfaces);
+        MOS_FreeMemory(surfaces);
+        surfaces = next;
+    }
+}
+
+PDDI_MEDIA_PARAM_SLAB DdiMediaUtil_CreateParamSlab()
+{
+    PDDI_MEDIA_PARAM_SLAB slab = (PDDI_MEDIA_PARAM_SLAB)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_PARAM_SLAB));
+    DDI_CHK_NULL(slab, "nullptr slab", nullptr);
+
+    for (uint32_t i = 0; i < DDI_MEDIA_PARAM_SLAB_NUM_CLASSES; i++)
+    {
+        slab->Classes[i].uiBlockSize = 1 << (DDI_MEDIA_PARAM_SLAB_MIN_SHIFT + i * DDI_MEDIA_PARAM_SLAB_CLASS_SHIFT);
+    }
+    slab->BufferClass.uiBlockSize = sizeof(DDI_MEDIA_BUFFER);
+    slab->uiRefCount              = 1;
+    return slab;
+}
+
+static void DdiMediaUtil_FreeParamSlabClass(PDDI_MEDIA_PARAM_SLAB_CLASS slabClass)
+{
+    PDDI_MEDIA_PARAM_SLAB_BLOCK lists[2] = { slabClass->pFree, slabClass->pReturned };
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        while (lists[i])
+        {
+            PDDI_MEDIA_PARAM_SLAB_BLOCK block = lists[i];
+            lists[i] = block->pNext;
+            MOS_FreeMemory(block);
+        }
+    }
+    slabClass->pFree       = nullptr;
+    slabClass->pReturned   = nullptr;
+    slabClass->uiNumCached = 0;
+}
+
+void DdiMediaUtil_ReleaseParamSlab(PDDI_MEDIA_PARAM_SLAB slab)
+{
+    if (slab == nullptr || __sync_sub_and_fetch(&slab->uiRefCount, 1) != 0)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < DDI_MEDIA_PARAM_SLAB_NUM_CLASSES; i++)
+    {
+        DdiMediaUtil_FreeParamSlabClass(&slab->Classes[i]);
+    }
+    DdiMediaUtil_FreeParamSlabClass(&slab->BufferClass);
+    DDI_VERBOSEMESSAGE("Parameter slab: %" PRIu64 " allocs, %" PRIu64 " hits, %" PRIu64 " frees, %" PRIu64 " released.",
+        slab->uiAllocs, slab->uiHits, slab->uiFrees, slab->uiReleased);
+    MOS_FreeMemory(slab);
+}
+
+// Caller holds BufferMutex - the only consumer of the class lists
+static void *DdiMediaUtil_PopParamSlabBlock(
+    PDDI_MEDIA_PARAM_SLAB       slab,
+    PDDI_MEDIA_PARAM_SLAB_CLASS slabClass)
+{
+    slab->uiAllocs++;
+    if (slabClass->pFree == nullptr)
+    {
+        // Taking the whole returned list at once is not exposed to ABA
+        slabClass->pFree = __sync_lock_test_and_set(&slabClass->pReturned, nullptr);
+    }
+
+    PDDI_MEDIA_PARAM_SLAB_BLOCK block = slabClass->pFree;
+    if (block == nullptr)
+    {
+        return MOS_AllocMemory(slabClass->uiBlockSize);
+    }
+    slabClass->pFree = block->pNext;
+    __sync_fetch_and_sub(&slabClass->uiNumCached, 1);
+    slab->uiHits++;
+    return block;
+}
+
+// Lock free, called from any thread destroying a buffer
+static void DdiMediaUtil_PushParamSlabBlock(
+    PDDI_MEDIA_PARAM_SLAB       slab,
+    PDDI_MEDIA_PARAM_SLAB_CLASS slabClass,
+    void                       *ptr)
+{
+    __sync_fetch_and_add(&slab->uiFrees, 1);
+    if (__sync_add_and_fetch(&slabClass->uiNumCached, 1) > DDI_MEDIA_PARAM_SLAB_MAX_CACHED)
+    {
+        __sync_fetch_and_sub(&slabClass->uiNumCached, 1);
+        __sync_fetch_and_add(&slab->uiReleased, 1);
+        MOS_FreeMemory(ptr);
+        return;
+    }
+
+    PDDI_MEDIA_PARAM_SLAB_BLOCK block = (PDDI_MEDIA_PARAM_SLAB_BLOCK)ptr;
+    PDDI_MEDIA_PARAM_SLAB_BLOCK head;
+    do
+    {
+        head         = slabClass->pReturned;
+        block->pNext = head;
+    } while (!__sync_bool_compare_and_swap(&slabClass->pReturned, head, block));
+}
+
+DDI_MEDIA_BUFFER* DdiMediaUtil_AllocMediaBuffer(PDDI_MEDIA_CONTEXT mediaCtx, PDDI_MEDIA_PARAM_SLAB slab)
+{
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", nullptr);
+
+    DDI_MEDIA_BUFFER *buf = nullptr;
+    if (slab)
+    {
+        buf = (DDI_MEDIA_BUFFER *)DdiMediaUtil_PopParamSlabBlock(slab, &slab->BufferClass);
+    }
+    else
+    {
+        buf = (DDI_MEDIA_BUFFER *)MOS_AllocMemory(sizeof(DDI_MEDIA_BUFFER));
+    }
+    if (buf == nullptr)
+    {
+        return nullptr;
+    }
+    MOS_ZeroMemory(buf, sizeof(DDI_MEDIA_BUFFER));
+    buf->pMediaCtx = mediaCtx;
+    if (slab)
+    {
+        __sync_fetch_and_add(&slab->uiRefCount, 1);
+        buf->pParamSlab = slab;
+    }
+    return buf;
+}
+
+void DdiMediaUtil_FreeMediaBuffer(DDI_MEDIA_BUFFER *buf)
+{
+    if (buf == nullptr)
+    {
+        return;
+    }
+    PDDI_MEDIA_PARAM_SLAB slab = buf->pParamSlab;
+    if (slab == nullptr)
+    {
+        MOS_FreeMemory(buf);
+        return;
+    }
+
+    // The descriptor goes back before the reference it held is dropped
+    DdiMediaUtil_PushParamSlabBlock(slab, &slab->BufferClass, buf);
+    DdiMediaUtil_ReleaseParamSlab(slab);
+}
+
+VAStatus DdiMediaUtil_AllocParamBuffer(DDI_MEDIA_BUFFER *buf, uint32_t size, bool zero)
+{
+    DDI_CHK_NULL(buf, "nullptr buf", VA_STATUS_ERROR_INVALID_BUFFER);
+
+    PDDI_MEDIA_PARAM_SLAB       slab      = buf->pParamSlab;
+    PDDI_MEDIA_PARAM_SLAB_CLASS slabClass = nullptr;
+    for (uint32_t i = 0; slab && i < DDI_MEDIA_PARAM_SLAB_NUM_CLASSES; i++)
+    {
+        if (size <= slab->Classes[i].uiBlockSize)
+        {
+            slabClass = &slab->Classes[i];
+            break;
+        }
+    }
+
+    if (slabClass == nullptr)
+    {
+        // Larger than the biggest class
+        buf->pData      = (uint8_t*)MOS_AllocAndZeroMemory(size);
+        buf->uiSlabSize = 0;
+    }
+    else
+    {
+        buf->pData      = (uint8_t*)DdiMediaUtil_PopParamSlabBlock(slab, slabClass);
+        buf->uiSlabSize = slabClass->uiBlockSize;
+        if (buf->pData && zero)
+        {
+            MOS_ZeroMemory(buf->pData, size);
+        }
+    }
+
+    return (buf->pData == nullptr) ? VA_STATUS_ERROR_ALLOCATION_FAILED : VA_STATUS_SUCCESS;
+}
+
+void DdiMediaUtil_FreeParamBuffer(DDI_MEDIA_BUFFER *buf)
+{
+    DDI_CHK_NULL(buf, "nullptr buf", );
+
+    if (buf->pData == nullptr)
+    {
+        return;
+    }
+
+    PDDI_MEDIA_PARAM_SLAB slab = buf->pParamSlab;
+    if (slab && buf->uiSlabSize)
+    {
+        for (uint32_t i = 0; i < DDI_MEDIA_PARAM_SLAB_NUM_CLASSES; i++)
+        {
+            if (slab->Classes[i].uiBlockSize == buf->uiSlabSize)
+            {
+                DdiMediaUtil_PushParamSlabBlock(slab, &slab->Classes[i], buf->pData);
+                buf->pData      = nullptr;
+                buf->uiSlabSize = 0;
+                return;
+            }
+        }
+    }
+
+    MOS_FreeMemory(buf->pData);
+    buf->pData      = nullptr;
+    buf->uiSlabSize = 0;
+}
+
 
 // should ref_count added for bo?
 void DdiMediaUtil_FreeBuffer(DDI_MEDIA_BUFFER  *buf)
@@ -1067,8 +1854,7 @@ void DdiMediaUtil_FreeBuffer(DDI_MEDIA_BUFFER  *buf)
     }
     if (buf->format == Media_Format_CPU)
     {
-        MOS_FreeMemory(buf->pData);
-        buf->pData = nullptr;
+        DdiMediaUtil_FreeParamBuffer(buf);
     }
     else
     {
@@ -1386,13 +2172,26 @@ int32_t DdiMediaUtil_OpenGraphicsAdaptor(char *devName)
 VAStatus DdiMediaUtil_UnRegisterRTSurfaces(
     VADriverContextP    ctx,
     PDDI_MEDIA_SURFACE surface)
+{
+    DDI_CHK_NULL(surface, "nullptr surface!", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    return DdiMediaUtil_UnRegisterRTSurfaces(ctx, &surface, 1);
+}
+
+VAStatus DdiMediaUtil_UnRegisterRTSurfaces(
+    VADriverContextP    ctx,
+    PDDI_MEDIA_SURFACE *surfaces,
+    uint32_t            numSurfaces)
 {
     DDI_CHK_NULL(ctx,"nullptr context!", VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx   = DdiMedia_GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,"nullptr mediaCtx!", VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(surface, "nullptr surface!", VA_STATUS_ERROR_INVALID_PARAMETER);
-    
-    //Look through all decode contexts to unregister the surface in each decode context's RTtable.
+    DDI_CHK_NULL(surfaces, "nullptr surfaces!", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    // RT tables are matched against the batch by binary search
+    std::sort(surfaces, surfaces + numSurfaces);
+
+    //Look through all decode contexts to unregister the surfaces in each decode context's RTtable.
     if (mediaCtx->pDecoderCtxHeap != nullptr)
     {
         PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT decVACtxHeapBase;
@@ -1406,8 +2205,8 @@ VAStatus DdiMediaUtil_UnRegisterRTSurfaces(
                 PDDI_DECODE_CONTEXT  decCtx = (PDDI_DECODE_CONTEXT)decVACtxHeapBase[j].pVaContext;
                 if (decCtx && decCtx->m_ddiDecode)
                 {
-                    //not check the return value since the surface may not be registered in the context. pay attention to LOGW.
-                    decCtx->m_ddiDecode->UnRegisterRTSurfaces(&decCtx->RTtbl, surface);
+                    decCtx->m_ddiDecode->UnRegisterRTSurfaces(&decCtx->RTtbl, surfaces, numSurfaces);
+                    decCtx->m_ddiDecode->ClearStatusReportSurfaces(surfaces, numSurfaces);
                 }
             }
         }
@@ -1426,8 +2225,7 @@ VAStatus DdiMediaUtil_UnRegisterRTSurfaces(
                 PDDI_ENCODE_CONTEXT  pEncCtx = (PDDI_ENCODE_CONTEXT)pEncVACtxHeapBase[j].pVaContext;
                 if (pEncCtx && pEncCtx->m_encode)
                 {
-                    //not check the return value since the surface may not be registered in the context. pay attention to LOGW.
-                    pEncCtx->m_encode->UnRegisterRTSurfaces(&pEncCtx->RTtbl, surface);
+                    pEncCtx->m_encode->UnRegisterRTSurfaces(&pEncCtx->RTtbl, surfaces, numSurfaces);
                 }
             }
         }
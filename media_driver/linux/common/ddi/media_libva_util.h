@@ -113,6 +113,160 @@ void     DdiMediaUtil_UnlockBuffer(DDI_MEDIA_BUFFER *buf);
 //!
 void     DdiMediaUtil_FreeSurface(DDI_MEDIA_SURFACE *surface);
 
+//!
+//! \brief  Release all cached GMM layouts
+//! \details Must be called before the GMM global context is destroyed
+//!
+void     DdiMediaUtil_FlushGmmLayoutCache();
+
+//!
+//! \brief  Initialize the surface pool
+//!
+//! \param  [in] mediaCtx
+//!         Pointer to ddi media context
+//!
+void     DdiMediaUtil_InitSurfacePool(PDDI_MEDIA_CONTEXT mediaCtx);
+
+//!
+//! \brief  Release all pooled surface allocations
+//!
+//! \param  [in] mediaCtx
+//!         Pointer to ddi media context
+//!
+void     DdiMediaUtil_DestroySurfacePool(PDDI_MEDIA_CONTEXT mediaCtx);
+
+//!
+//! \brief  Take a recycled allocation for a new surface
+//! \details Looks up an idle allocation of a destroyed surface with the same
+//!          format, size and usage hint and attaches its bo and GMM info
+//!
+//! \param  [in] mediaCtx
+//!         Pointer to ddi media context
+//! \param  [in] format
+//!         Ddi media format
+//! \param  [in] width
+//!         Surface width
+//! \param  [in] height
+//!         Surface height
+//! \param  [in,out] mediaSurface
+//!         Surface to set up
+//!
+//! \return bool
+//!     true if the surface was set up from the pool
+//!
+bool     DdiMediaUtil_AcquireSurfaceFromPool(
+    PDDI_MEDIA_CONTEXT mediaCtx,
+    DDI_MEDIA_FORMAT   format,
+    int32_t            width,
+    int32_t            height,
+    PDDI_MEDIA_SURFACE mediaSurface);
+
+//!
+//! \brief  Keep the allocation of a destroyed surface for re-creation
+//! \details On success the pool owns the bo and GMM info of the surface
+//!
+//! \param  [in] mediaSurface
+//!         Surface being destroyed
+//!
+//! \return bool
+//!     true if the allocation was taken by the pool
+//!
+bool     DdiMediaUtil_ReleaseSurfaceToPool(PDDI_MEDIA_SURFACE mediaSurface);
+
+//!
+//! \brief  Start the surface reaper if deferred surface release is enabled
+//!
+//! \param  [in] mediaCtx
+//!         Pointer to ddi media context
+//!
+void     DdiMediaUtil_InitSurfaceReaper(PDDI_MEDIA_CONTEXT mediaCtx);
+
+//!
+//! \brief  Release all pending surfaces and stop the surface reaper
+//! \details Must be called before the surface pool is destroyed
+//!
+//! \param  [in] mediaCtx
+//!         Pointer to ddi media context
+//!
+void     DdiMediaUtil_DestroySurfaceReaper(PDDI_MEDIA_CONTEXT mediaCtx);
+
+//!
+//! \brief  Release the allocations of destroyed surfaces
+//! \details Frees the surfaces, their bo and GMM info on the reaper thread if
+//!          it runs, else in the calling thread
+//!
+//! \param  [in] mediaCtx
+//!         Pointer to ddi media context
+//! \param  [in] surfaces
+//!         Destroyed surfaces linked by pNextPending, no longer in the surface heap
+//!
+void     DdiMediaUtil_ReapSurfaces(PDDI_MEDIA_CONTEXT mediaCtx, PDDI_MEDIA_SURFACE surfaces);
+
+//!
+//! \brief  Create the parameter buffer slab of a context
+//!
+//! \return PDDI_MEDIA_PARAM_SLAB
+//!     Slab holding one reference for the context, nullptr if allocation failed
+//!
+PDDI_MEDIA_PARAM_SLAB DdiMediaUtil_CreateParamSlab();
+
+//!
+//! \brief  Drop a reference to the parameter buffer slab
+//! \details The last reference frees all cached blocks and the slab
+//!
+//! \param  [in] slab
+//!         Parameter buffer slab, may be nullptr
+//!
+void     DdiMediaUtil_ReleaseParamSlab(PDDI_MEDIA_PARAM_SLAB slab);
+
+//!
+//! \brief  Allocate a zeroed buffer descriptor
+//! \details Must be called with BufferMutex held
+//!
+//! \param  [in] mediaCtx
+//!         Pointer to ddi media context
+//! \param  [in] slab
+//!         Parameter buffer slab of the creating context, nullptr to allocate
+//!         the descriptor and its memory directly
+//!
+//! \return DDI_MEDIA_BUFFER*
+//!     Buffer with pMediaCtx and pParamSlab set, nullptr if allocation failed
+//!
+DDI_MEDIA_BUFFER* DdiMediaUtil_AllocMediaBuffer(PDDI_MEDIA_CONTEXT mediaCtx, PDDI_MEDIA_PARAM_SLAB slab);
+
+//!
+//! \brief  Free a buffer descriptor
+//!
+//! \param  [in] buf
+//!         Ddi media buffer, any backing memory must be freed already
+//!
+void     DdiMediaUtil_FreeMediaBuffer(DDI_MEDIA_BUFFER *buf);
+
+//!
+//! \brief  Allocate CPU memory of a parameter buffer
+//! \details Sets buf->pData from the slab class fitting size. Must be called
+//!          with BufferMutex held.
+//!
+//! \param  [in,out] buf
+//!         Ddi media buffer
+//! \param  [in] size
+//!         Size in bytes
+//! \param  [in] zero
+//!         Clear the memory, not needed if it is fully written afterwards
+//!
+//! \return VAStatus
+//!     VA_STATUS_SUCCESS if success, else fail reason
+//!
+VAStatus DdiMediaUtil_AllocParamBuffer(DDI_MEDIA_BUFFER *buf, uint32_t size, bool zero);
+
+//!
+//! \brief  Free CPU memory of a parameter buffer
+//!
+//! \param  [in,out] buf
+//!         Ddi media buffer
+//!
+void     DdiMediaUtil_FreeParamBuffer(DDI_MEDIA_BUFFER *buf);
+
 //!
 //! \brief  Free buffer
 //! 
@@ -335,6 +489,22 @@ int32_t  DdiMediaUtil_OpenGraphicsAdaptor(char *devName);
 //!
 VAStatus DdiMediaUtil_UnRegisterRTSurfaces(VADriverContextP    ctx,PDDI_MEDIA_SURFACE surface);
 
+//!
+//! \brief  Unregister a batch of RT surfaces
+//! \details Walks each decode/encode context once for the whole batch
+//!
+//! \param  [in] ctx
+//!     Pointer to VA driver context
+//! \param  [in] surfaces
+//!     Ddi media surfaces to unregister
+//! \param  [in] numSurfaces
+//!     Number of surfaces
+//!
+//! \return     VAStatus
+//!     VA_STATUS_SUCCESS if success, else fail reason
+//!
+VAStatus DdiMediaUtil_UnRegisterRTSurfaces(VADriverContextP ctx, PDDI_MEDIA_SURFACE *surfaces, uint32_t numSurfaces);
+
 //------------------------------------------------------------------------------
 // Macros for debug messages, Assert, Null check and condition check within ddi files
 //------------------------------------------------------------------------------
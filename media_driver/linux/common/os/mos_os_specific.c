@@ -1374,6 +1374,20 @@ GMM_CLIENT_CONTEXT *Mos_Specific_GetGmmClientContext(
     return pOsInterface->pOsContext->GetGmmClientContext(pOsInterface->pOsContext);
 }
 
+//!
+//! \brief    Get device handle
+//! \details  Get the buffer manager the OS context allocates resources from
+//! \param    PMOS_INTERFACE pOsInterface
+//!           [in] Pointer to OS Interface
+//! \return   void*
+//!           Return the buffer manager of the OS context
+//!
+void *Mos_Specific_GetDeviceHandle(
+    PMOS_INTERFACE pOsInterface)
+{
+    return pOsInterface->pOsContext->bufmgr;
+}
+
 //!
 //! \brief    Get Platform
 //! \details  Get platform info
@@ -3600,6 +3614,57 @@ uint64_t Mos_Specific_GetResourceGfxAddress(
     return 0;
 }
 
+//!
+//! \brief    Get resource content tag
+//! \details  Get the content the driver last formatted the resource with
+//! \param    PMOS_INTERFACE pOsInterface
+//!           [in] Pointer to OS interface structure
+//! \param    PMOS_RESOURCE pResource
+//!           [in] Pointer to resource
+//! \return   uint32_t
+//!           Return the content tag, 0 if unknown or the resource is not a media surface
+//!
+uint32_t Mos_Specific_GetResourceContentTag(
+    PMOS_INTERFACE   pOsInterface,
+    PMOS_RESOURCE    pResource)
+{
+    MOS_UNUSED(pOsInterface);
+
+    if (pResource == nullptr || pResource->pContentTag == nullptr)
+    {
+        return 0;
+    }
+
+    return *pResource->pContentTag;
+}
+
+//!
+//! \brief    Set resource content tag
+//! \details  Record the content the driver formatted the resource with,
+//!           the tag is kept with the media surface the resource was converted from
+//! \param    PMOS_INTERFACE pOsInterface
+//!           [in] Pointer to OS interface structure
+//! \param    PMOS_RESOURCE pResource
+//!           [in] Pointer to resource
+//! \param    uint32_t tag
+//!           [in] Content tag, 0 to invalidate
+//! \return   void
+//!
+void Mos_Specific_SetResourceContentTag(
+    PMOS_INTERFACE   pOsInterface,
+    PMOS_RESOURCE    pResource,
+    uint32_t         tag)
+{
+    MOS_UNUSED(pOsInterface);
+
+    if (pResource == nullptr || pResource->pContentTag == nullptr)
+    {
+        return;
+    }
+
+    *pResource->pContentTag = tag;
+}
+
 //!
 //! \brief    Resizes the buffer to be used for rendering GPU commands
 //! \details  return true if succeeded - command buffer will be large enough to hold dwMaxSize
@@ -5766,6 +5831,7 @@ MOS_STATUS Mos_Specific_InitInterface(
     pOsInterface->pfnSetEncodePakContext                    = Mos_Specific_SetEncodePakContext;
     pOsInterface->pfnSetEncodeEncContext                    = Mos_Specific_SetEncodeEncContext;
     pOsInterface->pfnGetGmmClientContext                    = Mos_Specific_GetGmmClientContext;
+    pOsInterface->pfnGetDeviceHandle                        = Mos_Specific_GetDeviceHandle;
 
     pOsInterface->pfnGetPlatform                            = Mos_Specific_GetPlatform;
     pOsInterface->pfnDestroy                                = Mos_Specific_Destroy;
@@ -5785,6 +5851,8 @@ MOS_STATUS Mos_Specific_InitInterface(
     pOsInterface->pfnResetResourceAllocationIndex           = Mos_Specific_ResetResourceAllocationIndex;
     pOsInterface->pfnGetResourceAllocationIndex             = Mos_Specific_GetResourceAllocationIndex;
     pOsInterface->pfnGetResourceGfxAddress                  = Mos_Specific_GetResourceGfxAddress;
+    pOsInterface->pfnGetResourceContentTag                  = Mos_Specific_GetResourceContentTag;
+    pOsInterface->pfnSetResourceContentTag                  = Mos_Specific_SetResourceContentTag;
     pOsInterface->pfnGetCommandBuffer                       = Mos_Specific_GetCommandBuffer;
     pOsInterface->pfnResetCommandBuffer                     = Mos_Specific_ResetCommandBuffer;
     pOsInterface->pfnReturnCommandBuffer                    = Mos_Specific_ReturnCommandBuffer;
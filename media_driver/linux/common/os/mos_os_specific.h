@@ -246,6 +246,7 @@ struct _MOS_SPECIFIC_RESOURCE
     uint32_t            name;
     GMM_RESOURCE_INFO   *pGmmResInfo;        //!< GMM resource descriptor
     MOS_MMAP_OPERATION  MmapOperation;
+    uint32_t            *pContentTag;        //!< Content tag of the media surface the resource was converted from, nullptr if none
 
     //!< to sync render target for multi-threading decoding mode
     struct
@@ -2264,18 +2264,16 @@ VAStatus DdiVp_CreateBuffer(
     }
 
     // allocate new buf and init
-    pBuf               = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+    pBuf               = DdiMediaUtil_AllocMediaBuffer(pMediaCtx, ((PDDI_VP_CONTEXT)pVpCtx)->pParamSlab);
     DDI_CHK_NULL(pBuf, "Null pBuf.", VA_STATUS_ERROR_ALLOCATION_FAILED);
-    pBuf->pMediaCtx    = pMediaCtx;
     pBuf->iSize        = uiSize * uiNumElements;
     pBuf->iNumElements = uiNumElements;
     pBuf->uiType       = vaBufType;
     pBuf->format       = Media_Format_Buffer;
     pBuf->uiOffset     = 0;
-    pBuf->pData        = (uint8_t*)MOS_AllocAndZeroMemory(uiSize * uiNumElements);
-    if (nullptr == pBuf->pData)
+    if (VA_STATUS_SUCCESS != DdiMediaUtil_AllocParamBuffer(pBuf, uiSize * uiNumElements, pDataClient == nullptr))
     {
-        MOS_FreeMemAndSetNull(pBuf);
+        DdiMediaUtil_FreeMediaBuffer(pBuf);
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
     }
     pBuf->format       = Media_Format_CPU;
@@ -2283,8 +2281,8 @@ VAStatus DdiVp_CreateBuffer(
     pBufferHeapElement  = DdiMediaUtil_AllocPMediaBufferFromHeap(pMediaCtx->pBufferHeap);
     if (nullptr == pBufferHeapElement)
     {
-        MOS_FreeMemAndSetNull(pBuf->pData);
-        MOS_FreeMemAndSetNull(pBuf);
+        DdiMediaUtil_FreeParamBuffer(pBuf);
+        DdiMediaUtil_FreeMediaBuffer(pBuf);
         VP_DDI_ASSERTMESSAGE("Invalid buffer index.");
         return VA_STATUS_ERROR_INVALID_BUFFER;
     }
@@ -2499,12 +2497,15 @@ VAStatus DdiVp_CreateContext (
     vaStatus = DdiVp_InitCtx(pVaDrvCtx, pVpCtx);
     DDI_CHK_RET(vaStatus, "VA_STATUS_ERROR_OPERATION_FAILED");
 
+    pVpCtx->pParamSlab = DdiMediaUtil_CreateParamSlab();
+
     DdiMediaUtil_LockMutex(&pMediaCtx->VpMutex);
 
     // get Free VP context index
     pVaCtxHeapElmt = DdiMediaUtil_AllocPVAContextFromHeap(pMediaCtx->pVpCtxHeap);
     if (nullptr == pVaCtxHeapElmt)
     {
+        DdiMediaUtil_ReleaseParamSlab(pVpCtx->pParamSlab);
         MOS_FreeMemAndSetNull(pVpCtx);
         DdiMediaUtil_UnLockMutex(&pMediaCtx->VpMutex);
         VP_DDI_ASSERTMESSAGE("VP Context number exceeds maximum.");
@@ -2572,7 +2573,8 @@ VAStatus DdiVp_DestroyContext (
 
     // remove from context array
     DdiMediaUtil_LockMutex(&pMediaCtx->VpMutex);
-    // destroy vp context
+    // destroy vp context, buffers still alive keep their own reference to the slab
+    DdiMediaUtil_ReleaseParamSlab(pVpCtx->pParamSlab);
     MOS_FreeMemAndSetNull(pVpCtx);
     DdiMediaUtil_ReleasePVAContextFromHeap(pMediaCtx->pVpCtxHeap, uiVpIndex);
 
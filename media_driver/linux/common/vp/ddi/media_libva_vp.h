@@ -91,6 +91,9 @@ typedef struct DDI_VP_CONTEXT
 
     DDI_VP_FRAMEID_TRACER                     FrameIDTracer;
 
+    // Recycled parameter buffer memory of this context, nullptr if not created
+    PDDI_MEDIA_PARAM_SLAB                     pParamSlab;
+
 #if (_DEBUG || _RELEASE_INTERNAL)
     DDI_VP_DUMP_PARAM                         *pCurVpDumpDDIParam;
     DDI_VP_DUMP_PARAM                         *pPreVpDumpDDIParam;
@@ -385,6 +385,16 @@ drm_export int do_exec2(struct mos_linux_bo *bo, int used, struct mos_linux_cont
 
 #endif
 drm_export void mos_gem_bo_free(struct mos_linux_bo *bo);
+
+/* Counters for the ULT benchmark mode, accumulated since the library was loaded */
+struct mos_bufmgr_mock_counters {
+    uint64_t bo_allocs;
+    uint64_t relocs;
+    uint64_t execs;
+};
+drm_export void mos_bufmgr_mock_get_counters(struct mos_bufmgr_mock_counters *counters);
+drm_export void mos_bufmgr_mock_count_exec(void);
+drm_export void mos_bufmgr_mock_set_busy(int busy);
 drm_export void mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time);
 drm_export int mos_gem_bo_map(struct mos_linux_bo *bo, int write_enable);
 drm_export int map_gtt(struct mos_linux_bo *bo);
@@ -50,10 +50,26 @@
  * Convenience functions for buffer management methods.
  */
 
+static struct mos_bufmgr_mock_counters mock_counters;
+
+void
+mos_bufmgr_mock_get_counters(struct mos_bufmgr_mock_counters *counters)
+{
+    if (counters)
+        *counters = mock_counters;
+}
+
+void
+mos_bufmgr_mock_count_exec(void)
+{
+    mock_counters.execs++;
+}
+
 struct mos_linux_bo *
 mos_bo_alloc(struct mos_bufmgr *bufmgr, const char *name,
            unsigned long size, unsigned int alignment)
 {
+    mock_counters.bo_allocs++;
     return bufmgr->bo_alloc(bufmgr, name, size, alignment);
 }
 
@@ -62,6 +78,7 @@ struct mos_linux_bo *
 mos_bo_alloc2(struct mos_bufmgr *bufmgr, const char *name,
            unsigned long size, unsigned int alignment, unsigned long flags)
 {
+    mock_counters.bo_allocs++;
     return bufmgr->bo_alloc2(bufmgr, name, size, alignment, flags);
 }
 #endif
@@ -70,6 +87,7 @@ struct mos_linux_bo *
 mos_bo_alloc_for_render(struct mos_bufmgr *bufmgr, const char *name,
                   unsigned long size, unsigned int alignment)
 {
+    mock_counters.bo_allocs++;
     return bufmgr->bo_alloc_for_render(bufmgr, name, size, alignment);
 }
 
@@ -81,6 +99,7 @@ mos_bo_alloc_userptr(struct mos_bufmgr *bufmgr,
                unsigned long size,
                unsigned long flags)
 {
+    mock_counters.bo_allocs++;
     if (bufmgr->bo_alloc_userptr)
         return bufmgr->bo_alloc_userptr(bufmgr, name, addr, tiling_mode,
                         stride, size, flags);
@@ -92,6 +111,7 @@ mos_bo_alloc_tiled(struct mos_bufmgr *bufmgr, const char *name,
                         int x, int y, int cpp, uint32_t *tiling_mode,
                         unsigned long *pitch, unsigned long flags)
 {
+    mock_counters.bo_allocs++;
     return bufmgr->bo_alloc_tiled(bufmgr, name, x, y, cpp,
                       tiling_mode, pitch, flags);
 }
@@ -286,6 +306,7 @@ mos_bo_emit_reloc2(struct mos_linux_bo *bo, uint32_t offset,
                        uint32_t read_domains, uint32_t write_domain,
                        uint64_t presumed_offset)
 {
+       mock_counters.relocs++;
        return bo->bufmgr->bo_emit_reloc2(bo, offset,
                                         target_bo, target_offset,
                                         read_domains, write_domain,
@@ -298,6 +319,7 @@ mos_bo_emit_reloc(struct mos_linux_bo *bo, uint32_t offset,
             struct mos_linux_bo *target_bo, uint32_t target_offset,
             uint32_t read_domains, uint32_t write_domain)
 {
+    mock_counters.relocs++;
     return bo->bufmgr->bo_emit_reloc(bo, offset,
                      target_bo, target_offset,
                      read_domains, write_domain);
@@ -309,6 +331,7 @@ mos_bo_emit_reloc_fence(struct mos_linux_bo *bo, uint32_t offset,
                   struct mos_linux_bo *target_bo, uint32_t target_offset,
                   uint32_t read_domains, uint32_t write_domain)
 {
+    mock_counters.relocs++;
     return bo->bufmgr->bo_emit_reloc_fence(bo, offset,
                            target_bo, target_offset,
                            read_domains, write_domain);
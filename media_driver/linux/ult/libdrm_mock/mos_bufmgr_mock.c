@@ -670,6 +670,15 @@ mos_setup_reloc_list(struct mos_linux_bo *bo)
     return 0;
 }
 
+/* Reports every bo as busy if set, the ULT uses it to keep frames running */
+static int mock_force_busy;
+
+void
+mos_bufmgr_mock_set_busy(int busy)
+{
+    mock_force_busy = busy;
+}
+
 static int
 mos_gem_bo_busy(struct mos_linux_bo *bo)
 {
@@ -678,6 +687,9 @@ mos_gem_bo_busy(struct mos_linux_bo *bo)
     struct drm_i915_gem_busy busy;
     int ret;
 
+    if (mock_force_busy)
+        return true;
+
     if (bo_gem->reusable && bo_gem->idle)
         return false;
 
@@ -3313,6 +3325,7 @@ mos_gem_bo_exec(struct mos_linux_bo *bo, int used,
               drm_clip_rect_t * cliprects, int num_cliprects, int DR4)
 #endif
 {
+    mos_bufmgr_mock_count_exec();
     if(GetDrmMode())
         return 0; //libdrm_mock
 
@@ -3459,6 +3472,7 @@ do_exec2(struct mos_linux_bo *bo, int used, struct mos_linux_context *ctx,
      drm_clip_rect_t *cliprects, int num_cliprects, int DR4,
      unsigned int flags)
 {
+    mos_bufmgr_mock_count_exec();
     if(GetDrmMode())
         return 0; //libdrm_mock
 
@@ -0,0 +1,418 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     jit_cache_test.cpp
+//! \brief    Tests of the JIT binary cache against a stub jitter.
+//! \details  Mock runtime CM devices take the jitter functions exported by
+//!           this executable, so jitting is counted instead of done.
+//!
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "cm_jit_cache.h"
+#include "kernel_test.h"
+
+static const uint32_t STUB_BINARY_SIZE = 64;
+static const uint64_t CACHE_LIMIT = 1 << 20;
+
+typedef void (*CmJitCacheSetUltConfigFunc)(uint64_t limit, const char *path);
+
+static uint32_t g_jitCompileCount = 0;
+
+extern "C" int JITCompile(const char *kernelName,
+                          const void *kernelIsa,
+                          uint32_t kernelIsaSize,
+                          void* &genBinary,
+                          uint32_t &genBinarySize,
+                          const char *platform,
+                          int majorVersion,
+                          int minorVersion,
+                          int numArgs,
+                          const char *args[],
+                          char *errorMsg,
+                          FINALIZER_INFO *jitInfo)
+{
+    ++g_jitCompileCount;
+    genBinary = malloc(STUB_BINARY_SIZE);
+    if (nullptr == genBinary)
+    {
+        return CM_OUT_OF_HOST_MEMORY;
+    }
+    memset(genBinary, 0x7f, STUB_BINARY_SIZE);
+    genBinarySize = STUB_BINARY_SIZE;
+    jitInfo->numGRFUsed = 128;
+    return CM_SUCCESS;
+}
+
+extern "C" void freeBlock(void *block)
+{
+    free(block);
+}
+
+extern "C" void getJITVersion(unsigned int &majorV, unsigned int &minorV)
+{
+    majorV = 3;
+    minorV = 6;
+}
+
+class JitCacheTest: public CmTest
+{
+public:
+    JitCacheTest(): m_setUltConfig(nullptr) {}
+
+    ~JitCacheTest() {}
+
+    //*-------------------------------------------------------------------------
+    //| Loads the same program twice on one device and once on another, only
+    //| the first load may jit.
+    //*-------------------------------------------------------------------------
+    int32_t LoadOnDevices()
+    {
+        if (!UseNewCacheDir(CACHE_LIMIT))
+        {
+            return nullptr == m_setUltConfig ? CM_SUCCESS : CM_FAILURE;
+        }
+
+        CmDevice *device = m_mockDevice.operator->();
+        CmDevice *new_device = m_mockDevice.CreateNewDevice();
+        EXPECT_NE(nullptr, new_device);
+
+        CMRT_UMD::CmProgram *programs[3] = {nullptr, nullptr, nullptr};
+        uint32_t count = g_jitCompileCount;
+        int32_t result = LoadProgram(device, programs[0], "-ult_reuse");
+        EXPECT_EQ(count + 1, g_jitCompileCount);
+
+        count = g_jitCompileCount;
+        result |= LoadProgram(device, programs[1], "-ult_reuse");
+        result |= LoadProgram(new_device, programs[2], "-ult_reuse");
+        EXPECT_EQ(count, g_jitCompileCount);
+
+        // Different jitter flags are a different binary.
+        CMRT_UMD::CmProgram *other_program = nullptr;
+        count = g_jitCompileCount;
+        result |= LoadProgram(device, other_program, "-ult_reuse -ult_other");
+        EXPECT_EQ(count + 1, g_jitCompileCount);
+
+        result |= device->DestroyProgram(other_program);
+        result |= device->DestroyProgram(programs[0]);
+        result |= device->DestroyProgram(programs[1]);
+        result |= new_device->DestroyProgram(programs[2]);
+        m_mockDevice.ReleaseNewDevice(new_device);
+
+        RemoveCacheDir();
+        return result;
+    }//===============
+
+    //*-------------------------------------------------------------------------
+    //| Loads a program and checks its binary is written to the cache path.
+    //*-------------------------------------------------------------------------
+    int32_t LoadToDisk()
+    {
+        if (!UseNewCacheDir(CACHE_LIMIT))
+        {
+            return nullptr == m_setUltConfig ? CM_SUCCESS : CM_FAILURE;
+        }
+
+        int32_t result = LoadAndDestroyProgram("-ult_disk");
+        EXPECT_TRUE(HasValidCacheFile());
+
+        RemoveCacheDir();
+        return result;
+    }//===============
+
+    //*-------------------------------------------------------------------------
+    //| Truncated, corrupted and oversized cache files, and files of another
+    //| key, are rejected, the kernel is jitted again and the file rewritten.
+    //*-------------------------------------------------------------------------
+    int32_t RejectBadFiles()
+    {
+        if (!UseNewCacheDir(CACHE_LIMIT))
+        {
+            return nullptr == m_setUltConfig ? CM_SUCCESS : CM_FAILURE;
+        }
+
+        int32_t result = LoadAndDestroyProgram("-ult_bad_file");
+        std::vector<std::string> files = GetCacheFiles();
+        EXPECT_EQ(static_cast<size_t>(1), files.size());
+        if (files.size() != 1)
+        {
+            RemoveCacheDir();
+            return CM_FAILURE;
+        }
+
+        for (int damage = 0; damage < DAMAGE_COUNT; ++damage)
+        {
+            EXPECT_TRUE(DamageCacheFile(files[0], damage));
+
+            // Drop the binary from memory, it is looked up on disk
+            m_setUltConfig(CACHE_LIMIT, m_cachePath.c_str());
+
+            uint32_t count = g_jitCompileCount;
+            result |= LoadAndDestroyProgram("-ult_bad_file");
+            EXPECT_EQ(count + 1, g_jitCompileCount) << "damage = " << damage;
+            EXPECT_TRUE(HasValidCacheFile()) << "damage = " << damage;
+        }
+
+        RemoveCacheDir();
+        return result;
+    }//===============
+
+    //*-------------------------------------------------------------------------
+    //| Limits of one binary evict the least recently used one, in memory and
+    //| on disk.
+    //*-------------------------------------------------------------------------
+    int32_t EvictBySize()
+    {
+        if (!UseNewCacheDir(STUB_BINARY_SIZE))
+        {
+            return nullptr == m_setUltConfig ? CM_SUCCESS : CM_FAILURE;
+        }
+
+        // In memory only
+        m_setUltConfig(STUB_BINARY_SIZE, "");
+
+        uint32_t count = g_jitCompileCount;
+        int32_t result = LoadAndDestroyProgram("-ult_evict_a");
+        result |= LoadAndDestroyProgram("-ult_evict_b");
+        EXPECT_EQ(count + 2, g_jitCompileCount);
+
+        count = g_jitCompileCount;
+        result |= LoadAndDestroyProgram("-ult_evict_b");
+        EXPECT_EQ(count, g_jitCompileCount);
+
+        result |= LoadAndDestroyProgram("-ult_evict_a");
+        EXPECT_EQ(count + 1, g_jitCompileCount);
+
+        // The directory holds one file, the other is removed on write. Files
+        // of both programs have the same size, the key data differs in a byte.
+        m_setUltConfig(CACHE_LIMIT, m_cachePath.c_str());
+        result |= LoadAndDestroyProgram("-ult_evict_c");
+        std::vector<std::string> files = GetCacheFiles();
+        EXPECT_EQ(static_cast<size_t>(1), files.size());
+        if (files.size() == 1)
+        {
+            m_setUltConfig(GetFileSize(files[0]), m_cachePath.c_str());
+            result |= LoadAndDestroyProgram("-ult_evict_d");
+            EXPECT_EQ(static_cast<size_t>(1), GetCacheFiles().size());
+        }
+
+        RemoveCacheDir();
+        return result;
+    }//===============
+
+private:
+    static const int DAMAGE_COUNT = 4;
+
+    int32_t LoadProgram(CmDevice *device,
+                        CMRT_UMD::CmProgram *&program,
+                        const char *options)
+    {
+        return device->LoadProgram(SKYLAKE_DONOTHING_ISA,
+                                   sizeof(SKYLAKE_DONOTHING_ISA),
+                                   program, options);
+    }
+
+    int32_t LoadAndDestroyProgram(const char *options)
+    {
+        CMRT_UMD::CmProgram *program = nullptr;
+        int32_t result = LoadProgram(m_mockDevice.operator->(), program,
+                                     options);
+        return result | m_mockDevice->DestroyProgram(program);
+    }
+
+    //! Points the cache at a new empty directory, whatever the user feature
+    //! settings and the programs loaded earlier by the process. Fails with
+    //! m_setUltConfig null if the driver does not export the test hook.
+    bool UseNewCacheDir(uint64_t limit)
+    {
+        m_setUltConfig = (CmJitCacheSetUltConfigFunc)GetUltHook(
+            "CmJitCache_SetUltConfig");
+
+        char path[] = "/tmp/cmjitcacheXXXXXX";
+        if (nullptr == m_setUltConfig || nullptr == mkdtemp(path))
+        {
+            return false;
+        }
+        m_cachePath = path;
+        m_setUltConfig(limit, path);
+        return true;
+    }
+
+    //! Restores the user feature settings and removes the directory
+    void RemoveCacheDir()
+    {
+        m_setUltConfig(0, nullptr);
+
+        DIR *dir = opendir(m_cachePath.c_str());
+        if (nullptr != dir)
+        {
+            struct dirent *ent = nullptr;
+            while (nullptr != (ent = readdir(dir)))
+            {
+                if (strcmp(ent->d_name, ".") && strcmp(ent->d_name, ".."))
+                {
+                    remove((m_cachePath + "/" + ent->d_name).c_str());
+                }
+            }
+            closedir(dir);
+        }
+        EXPECT_EQ(0, rmdir(m_cachePath.c_str()));
+        m_cachePath.clear();
+    }
+
+    std::vector<std::string> GetCacheFiles()
+    {
+        std::vector<std::string> files;
+        DIR *dir = opendir(m_cachePath.c_str());
+        if (nullptr == dir)
+        {
+            return files;
+        }
+
+        struct dirent *ent = nullptr;
+        while (nullptr != (ent = readdir(dir)))
+        {
+            std::string name = ent->d_name;
+            size_t ext_len = strlen(CM_JIT_CACHE_FILE_EXT);
+            if (name.size() > ext_len
+                && !name.compare(name.size() - ext_len, ext_len, CM_JIT_CACHE_FILE_EXT))
+            {
+                files.push_back(m_cachePath + "/" + name);
+            }
+        }
+        closedir(dir);
+        return files;
+    }
+
+    uint64_t GetFileSize(const std::string &name)
+    {
+        struct stat st;
+        return 0 == stat(name.c_str(), &st) ? st.st_size : 0;
+    }
+
+    bool HasValidCacheFile()
+    {
+        for (auto &name : GetCacheFiles())
+        {
+            FILE *file = fopen(name.c_str(), "rb");
+            if (nullptr == file)
+            {
+                continue;
+            }
+            CMRT_UMD::CM_JIT_CACHE_FILE_HEADER header;
+            bool found = (1 == fread(&header, sizeof(header), 1, file))
+                         && CM_JIT_CACHE_MAGIC == header.magic
+                         && STUB_BINARY_SIZE == header.binarySize
+                         && 128 == header.jitInfo.numGRFUsed;
+            fclose(file);
+            if (found)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! Truncates the file, flips a byte of the binary, flips a byte of the
+    //! key data as if another kernel had the same key hash, or claims a
+    //! binary larger than the file
+    bool DamageCacheFile(const std::string &name, int damage)
+    {
+        std::vector<uint8_t> data;
+        FILE *file = fopen(name.c_str(), "rb");
+        if (nullptr == file)
+        {
+            return false;
+        }
+        int c = 0;
+        while (EOF != (c = fgetc(file)))
+        {
+            data.push_back(static_cast<uint8_t>(c));
+        }
+        fclose(file);
+
+        CMRT_UMD::CM_JIT_CACHE_FILE_HEADER *header
+            = reinterpret_cast<CMRT_UMD::CM_JIT_CACHE_FILE_HEADER *>(&data[0]);
+        if (data.size() != sizeof(*header) + header->keySize + STUB_BINARY_SIZE)
+        {
+            return false;
+        }
+        switch (damage)
+        {
+            case 0:
+                data.pop_back();
+                break;
+            case 1:
+                data.back() ^= 0xff;
+                break;
+            case 2:
+                data[sizeof(*header)] ^= 0xff;
+                break;
+            default:
+                header->binarySize = 0xfffffff0;
+                break;
+        }
+
+        file = fopen(name.c_str(), "wb");
+        if (nullptr == file)
+        {
+            return false;
+        }
+        bool written = (data.size() == fwrite(&data[0], 1, data.size(), file));
+        return (0 == fclose(file)) && written;
+    }
+
+    CmJitCacheSetUltConfigFunc m_setUltConfig;
+    std::string m_cachePath;
+};//=============================
+
+TEST_F(JitCacheTest, ReuseAcrossLoadsAndDevices)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return LoadOnDevices(); });
+    return;
+}//========
+
+TEST_F(JitCacheTest, WriteToDisk)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return LoadToDisk(); });
+    return;
+}//========
+
+TEST_F(JitCacheTest, RejectBadFiles)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return RejectBadFiles(); });
+    return;
+}//========
+
+TEST_F(JitCacheTest, EvictBySize)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return EvictBySize(); });
+    return;
+}//========
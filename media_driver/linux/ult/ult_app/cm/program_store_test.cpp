@@ -0,0 +1,205 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     program_store_test.cpp
+//! \brief    Tests of program sharing between CM devices of a process.
+//! \details  Loads the same program on several devices and checks that only
+//!           the first load copies and parses it, and that the shared copy is
+//!           freed with the last program. Reports the cost of loading on all
+//!           devices in benchmark mode.
+//!
+
+#include "kernel_test.h"
+#include "../perf_benchmark.h"
+
+static const uint32_t DEVICE_COUNT = 8;
+
+typedef void *(*CmProgramGetUltIsaFileFunc)(CMRT_UMD::CmProgram *program);
+typedef uint32_t (*CmProgramStoreGetUltProgramCountFunc)();
+
+class ProgramStoreTest: public KernelTest
+{
+public:
+    ProgramStoreTest() {}
+
+    ~ProgramStoreTest() {}
+
+    //*-------------------------------------------------------------------------
+    //| Loads the default ISA on DEVICE_COUNT devices. All programs must use
+    //| the same code and ISA file, later loads must allocate less than the
+    //| first one, and the shared entry must go with the last program.
+    //*-------------------------------------------------------------------------
+    int32_t LoadOnDevices()
+    {
+        CmProgramGetUltIsaFileFunc get_isa_file
+            = (CmProgramGetUltIsaFileFunc)GetUltHook(
+                "CmProgram_GetUltIsaFile");
+        CmProgramStoreGetUltProgramCountFunc get_program_count
+            = (CmProgramStoreGetUltProgramCountFunc)GetUltHook(
+                "CmProgramStore_GetUltProgramCount");
+        if (nullptr == get_isa_file || nullptr == get_program_count)
+        {
+            return CM_SUCCESS;
+        }
+
+        int32_t result = CreateDevices();
+
+        IsaData *isa_data = GetIsaData();
+        const DriverSymbols &symbols = m_driverLoader.GetDriverSymbols();
+        CMRT_UMD::CmProgram *programs[DEVICE_COUNT] = {};
+        uint32_t program_count = get_program_count();
+
+        int32_t count = symbols.MOS_GetMemNinjaCounter();
+        result |= m_devices[0]->LoadProgram(
+            isa_data->binary, static_cast<uint32_t>(isa_data->size),
+            programs[0], "nojitter");
+        int32_t first_allocs = symbols.MOS_GetMemNinjaCounter() - count;
+
+        for (uint32_t i = 1; i < DEVICE_COUNT; ++i)
+        {
+            count = symbols.MOS_GetMemNinjaCounter();
+            result |= m_devices[i]->LoadProgram(
+                isa_data->binary, static_cast<uint32_t>(isa_data->size),
+                programs[i], "nojitter");
+            EXPECT_LT(symbols.MOS_GetMemNinjaCounter() - count, first_allocs);
+        }
+        EXPECT_EQ(program_count + 1, get_program_count());
+
+        // The ISA file is not allocated through MOS, compare it directly
+        void *code = nullptr;
+        uint32_t code_size = 0;
+        result |= programs[0]->GetCommonISACode(code, code_size);
+        EXPECT_NE(nullptr, code);
+        void *isa_file = get_isa_file(programs[0]);
+        for (uint32_t i = 1; i < DEVICE_COUNT; ++i)
+        {
+            void *other_code = nullptr;
+            uint32_t other_size = 0;
+            result |= programs[i]->GetCommonISACode(other_code, other_size);
+            EXPECT_EQ(code, other_code);
+            EXPECT_EQ(code_size, other_size);
+            EXPECT_EQ(isa_file, get_isa_file(programs[i]));
+        }
+
+        for (uint32_t i = 0; i < DEVICE_COUNT; ++i)
+        {
+            result |= m_devices[i]->DestroyProgram(programs[i]);
+            uint32_t expected_count = program_count
+                                      + (i + 1 < DEVICE_COUNT ? 1 : 0);
+            EXPECT_EQ(expected_count, get_program_count());
+        }
+
+        result |= ReleaseDevices();
+        return result;
+    }//===============
+
+    //*-------------------------------------------------------------------------
+    //| Benchmark: loads and destroys the default ISA on DEVICE_COUNT devices
+    //| per iteration.
+    //*-------------------------------------------------------------------------
+    int32_t BenchmarkLoadOnDevices()
+    {
+        PerfBenchmark *benchmark = PerfBenchmark::GetInstance();
+        if (!benchmark->IsEnabled())
+        {
+            return CM_SUCCESS;
+        }
+
+        int32_t result = CreateDevices();
+
+        IsaData *isa_data = GetIsaData();
+        CMRT_UMD::CmProgram *programs[DEVICE_COUNT] = {};
+
+        benchmark->Begin("CmLoadProgram8Dev", m_currentPlatform);
+        for (uint32_t frame = 0; frame < benchmark->GetFrameNum(); ++frame)
+        {
+            for (uint32_t i = 0; i < DEVICE_COUNT; ++i)
+            {
+                result |= m_devices[i]->LoadProgram(
+                    isa_data->binary, static_cast<uint32_t>(isa_data->size),
+                    programs[i], "nojitter");
+            }
+            for (uint32_t i = 0; i < DEVICE_COUNT; ++i)
+            {
+                result |= m_devices[i]->DestroyProgram(programs[i]);
+            }
+        }
+        benchmark->End();
+
+        result |= ReleaseDevices();
+        return result;
+    }//===============
+
+private:
+    IsaData* GetIsaData()
+    {
+        ResetDefaultIsaArray();
+        SetDefaultIsaArrayBinaries();
+        SetDefaultIsaArraySizes();
+        return &m_isaArray[static_cast<uint32_t>(m_currentPlatform)];
+    }
+
+    int32_t CreateDevices()
+    {
+        m_devices[0] = m_mockDevice.operator->();
+        for (uint32_t i = 1; i < DEVICE_COUNT; ++i)
+        {
+            m_devices[i] = m_mockDevice.CreateNewDevice();
+            EXPECT_NE(nullptr, m_devices[i]);
+            if (nullptr == m_devices[i])
+            {
+                return CM_FAILURE;
+            }
+        }
+        return CM_SUCCESS;
+    }
+
+    int32_t ReleaseDevices()
+    {
+        int32_t result = CM_SUCCESS;
+        for (uint32_t i = 1; i < DEVICE_COUNT; ++i)
+        {
+            if (nullptr != m_devices[i])
+            {
+                result |= m_mockDevice.ReleaseNewDevice(m_devices[i]);
+                m_devices[i] = nullptr;
+            }
+        }
+        return result;
+    }
+
+    CmDevice *m_devices[DEVICE_COUNT] = {};
+};//=============================
+
+TEST_F(ProgramStoreTest, ShareAcrossDevices)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return LoadOnDevices(); });
+    return;
+}//========
+
+TEST_F(ProgramStoreTest, BenchmarkLoadOnDevices)
+{
+    RunEach<int32_t>(CM_SUCCESS,
+                     [this]() { return BenchmarkLoadOnDevices(); });
+    return;
+}//========
@@ -20,11 +20,20 @@
 * OTHER DEALINGS IN THE SOFTWARE.
 */
 #include "cmd_validator.h"
+#include "perf_benchmark.h"
 
 using namespace std;
 
 void UltGetCmdBuf(PMOS_COMMAND_BUFFER pCmdBuffer)
 {
+    // Command validation is skipped while benchmarking, it is not part of the driver cost
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    if (perfBenchmark->IsRunning())
+    {
+        perfBenchmark->RecordCmdBuf(pCmdBuffer);
+        return;
+    }
+
     auto cmdValidator = CmdValidator::GetInstance();
     cmdValidator->Validate(pCmdBuffer);
 }
@@ -0,0 +1,178 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+#include "perf_benchmark.h"
+
+using namespace std;
+
+typedef MOS_STATUS (*CheckDumpAttribsFunc)(const char *, uint32_t, bool, uint32_t, uint8_t *, uint32_t *);
+
+// Checks the dump attributes compiled into bitmasks against the string keyed
+// lookup they replaced. The hook is only exported by drivers built with the
+// codechal debug tool.
+class CodechalDebugConfigTest : public testing::Test
+{
+protected:
+
+    // Order of the dump attributes checked by CodechalDebug_UltCheckDumpAttribs
+    enum
+    {
+        ATTR_PIC_PARAMS     = 0,
+        ATTR_SLC_PARAMS     = 1,
+        ATTR_MB_PARAMS      = 2,
+        ATTR_BITSTREAM      = 5,
+        ATTR_STATUS_REPORT  = 19
+    };
+
+    static const uint32_t m_maxResults = 1024;
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnCheck = (CheckDumpAttribsFunc)GetUltHook("CodechalDebug_UltCheckDumpAttribs");
+        if (m_pfnCheck == nullptr)
+        {
+            return;
+        }
+
+        char folder[] = "/tmp/codechal_dbg_cfg_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(folder));
+        m_folder = string(folder) + "/";
+
+        FILE *cfg = fopen((m_folder + "CodecDbgSetting.cfg").c_str(), "w");
+        ASSERT_NE(nullptr, cfg);
+        fputs("@mode ALL\n"
+              "@Frame ALL\n"
+              "PicParams:1\n"
+              "SlcParams:0\n"
+              "Bitstream:1\n"
+              "@4xScaling Curbe DSH\n"
+              "@Frame 3-5\n"
+              "MbParams:1\n"
+              "StatusReport:1\n"
+              "@BrcUpdate ALL\n", cfg);
+        fclose(cfg);
+    }
+
+    void TearDown() override
+    {
+        if (!m_folder.empty())
+        {
+            unlink((m_folder + "CodecDbgSetting.cfg").c_str());
+            rmdir(m_folder.c_str());
+        }
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    vector<uint8_t> Check(uint32_t frameIdx, bool byName, uint32_t loops = 1)
+    {
+        vector<uint8_t> results(m_maxResults, 0xff);
+        uint32_t        resultNum = m_maxResults;
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_pfnCheck(m_folder.c_str(), frameIdx, byName, loops, results.data(), &resultNum));
+        results.resize(resultNum);
+        return results;
+    }
+
+    DriverDllLoader         m_driverLoader;
+    Platform_t              m_platform          = igfx_MAX;
+    bool                    m_driverInitialized = false;
+    CheckDumpAttribsFunc    m_pfnCheck          = nullptr;
+    string                  m_folder;
+};
+
+TEST_F(CodechalDebugConfigTest, BitmaskMatchesByName)
+{
+    if (m_pfnCheck == nullptr)
+    {
+        return;
+    }
+
+    for (uint32_t frameIdx : { 0, 3, 4, 5, 6 })
+    {
+        vector<uint8_t> bitmask = Check(frameIdx, false);
+        vector<uint8_t> byName  = Check(frameIdx, true);
+        ASSERT_LT(ATTR_STATUS_REPORT, bitmask.size());
+        EXPECT_EQ(byName, bitmask) << "frame " << frameIdx;
+
+        bool frameConfig = frameIdx >= 3 && frameIdx <= 5;
+        EXPECT_EQ(1, bitmask[ATTR_PIC_PARAMS]) << "frame " << frameIdx;
+        EXPECT_EQ(0, bitmask[ATTR_SLC_PARAMS]) << "frame " << frameIdx;
+        EXPECT_EQ(1, bitmask[ATTR_BITSTREAM]) << "frame " << frameIdx;
+        EXPECT_EQ((uint8_t)frameConfig, bitmask[ATTR_MB_PARAMS]) << "frame " << frameIdx;
+        EXPECT_EQ((uint8_t)frameConfig, bitmask[ATTR_STATUS_REPORT]) << "frame " << frameIdx;
+
+        // 4xScaling dumps Curbe and DSH on every frame, BrcUpdate everything on frames 3-5
+        uint32_t kernelEnabled = 0;
+        for (uint32_t i = ATTR_STATUS_REPORT + 1; i < bitmask.size(); i++)
+        {
+            kernelEnabled += bitmask[i];
+        }
+        EXPECT_EQ(frameConfig ? 10u : 2u, kernelEnabled) << "frame " << frameIdx;
+    }
+}
+
+TEST_F(CodechalDebugConfigTest, ResultBufferTooSmall)
+{
+    if (m_pfnCheck == nullptr)
+    {
+        return;
+    }
+
+    uint8_t  result;
+    uint32_t resultNum = 1;
+    EXPECT_EQ(MOS_STATUS_NOT_ENOUGH_BUFFER, m_pfnCheck(m_folder.c_str(), 0, false, 1, &result, &resultNum));
+    EXPECT_LT(1u, resultNum);
+}
+
+// Each iteration checks every dump attribute and every kernel attribute of
+// every media state once, as a frame with all dump points would
+TEST_F(CodechalDebugConfigTest, Benchmark)
+{
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    if (m_pfnCheck == nullptr || !perfBenchmark->IsEnabled())
+    {
+        return;
+    }
+
+    perfBenchmark->Begin("DebugAttribsBitmask", igfx_MAX);
+    Check(4, false, perfBenchmark->GetFrameNum());
+    perfBenchmark->End();
+
+    perfBenchmark->Begin("DebugAttribsByName", igfx_MAX);
+    Check(4, true, perfBenchmark->GetFrameNum());
+    perfBenchmark->End();
+}
@@ -19,10 +19,19 @@
 * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
 * OTHER DEALINGS IN THE SOFTWARE.
 */
+#include <dlfcn.h>
+#include <atomic>
+#include <thread>
 #include "ddi_test_decode.h"
 
 using namespace std;
 
+typedef uint8_t (*SelectPipeNumByLoadFunc)(uint8_t candidatePipeNum, uint8_t curPipeNum, uint8_t numVdbox);
+typedef VAStatus (*GetParamSlabStatsFunc)(VADriverContextP ctx, VAContextID context, uint64_t stats[4]);
+typedef bool (*SetSurfacePoolMaxEntriesFunc)(VADriverContextP ctx, uint32_t maxEntries);
+typedef bool (*GetSurfacePoolStatsFunc)(VADriverContextP ctx, uint32_t stats[3]);
+typedef bool (*GetSurfacePlaneOffsetsFunc)(VADriverContextP ctx, VASurfaceID surfaceId, bool fresh, uint32_t planeOffset[3]);
+
 TEST_F(MediaDecodeDdiTest, DecodeHEVCLong)
 {
     m_GpuCmdFactory = g_gpuCmdFactoryDecodeHEVCLong;
@@ -39,6 +48,290 @@ TEST_F(MediaDecodeDdiTest, DecodeAVCLong)
     delete pDecData;
 }
 
+TEST_F(MediaDecodeDdiTest, DestroySurfacesAVC)
+{
+    DecTestData *pDecData = m_decDataFactory.GetDecTestData("AVC-Long");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_decTestCfg.IsDecTestEnabled(DeviceConfigTable[platforms[i]],
+            pDecData->GetFeatureID()))
+        {
+            DestroySurfacesExecute(pDecData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pDecData;
+}
+
+TEST_F(MediaDecodeDdiTest, DestroyDuplicateSurfacesAVC)
+{
+    DecTestData *pDecData = m_decDataFactory.GetDecTestData("AVC-Long");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_decTestCfg.IsDecTestEnabled(DeviceConfigTable[platforms[i]],
+            pDecData->GetFeatureID()))
+        {
+            DestroyDuplicateSurfacesExecute(pDecData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pDecData;
+}
+
+TEST_F(MediaDecodeDdiTest, DeferredDestroySurfacesAVC)
+{
+    DecTestData *pDecData = m_decDataFactory.GetDecTestData("AVC-Long");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_decTestCfg.IsDecTestEnabled(DeviceConfigTable[platforms[i]],
+            pDecData->GetFeatureID()))
+        {
+            DeferredDestroySurfacesExecute(pDecData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pDecData;
+}
+
+TEST_F(MediaDecodeDdiTest, SyncSurfacesAVC)
+{
+    DecTestData *pDecData = m_decDataFactory.GetDecTestData("AVC-Long");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_decTestCfg.IsDecTestEnabled(DeviceConfigTable[platforms[i]],
+            pDecData->GetFeatureID()))
+        {
+            SyncSurfacesExecute(pDecData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pDecData;
+}
+
+TEST_F(MediaDecodeDdiTest, MonoPicturesAVC)
+{
+    DecTestData *pDecData = m_decDataFactory.GetDecTestData("AVC-Mono");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_decTestCfg.IsDecTestEnabled(DeviceConfigTable[platforms[i]],
+            pDecData->GetFeatureID()))
+        {
+            MonoPicturesExecute(pDecData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pDecData;
+}
+
+TEST_F(MediaDecodeDdiTest, ParamSlabAVC)
+{
+    DecTestData *pDecData = m_decDataFactory.GetDecTestData("AVC-Long");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_decTestCfg.IsDecTestEnabled(DeviceConfigTable[platforms[i]],
+            pDecData->GetFeatureID()))
+        {
+            ParamSlabExecute(pDecData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pDecData;
+}
+
+TEST_F(MediaDecodeDdiTest, SurfacePoolAVC)
+{
+    DecTestData *pDecData = m_decDataFactory.GetDecTestData("AVC-Long");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_decTestCfg.IsDecTestEnabled(DeviceConfigTable[platforms[i]],
+            pDecData->GetFeatureID()))
+        {
+            SurfacePoolExecute(pDecData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pDecData;
+}
+
+// Creates NV12 and P010 surfaces of a few sizes, two at a time so the second
+// one takes its layout from the GMM layout cache. The plane offsets kept on
+// each surface must match the ones GMM reports for its resource, and the
+// derived image must place its UV plane there.
+TEST_F(MediaDecodeDdiTest, PlaneOffsetsNV12P010)
+{
+    const uint32_t sizes[][2]  = { { 176, 144 }, { 720, 480 }, { 1920, 1080 }, { 4096, 2160 } };
+    const uint32_t fourccs[]   = { VA_FOURCC_NV12, VA_FOURCC_P010 };
+    const uint32_t rtFormats[] = { VA_RT_FORMAT_YUV420, VA_RT_FORMAT_YUV420_10BPP };
+    Platform_t     platform    = m_driverLoader.GetPlatforms()[0];
+
+    ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(platform));
+    auto pfnGetPlaneOffsets = (GetSurfacePlaneOffsetsFunc)GetUltHook("DdiMediaUtil_GetUltSurfacePlaneOffsets");
+
+    for (int f = 0; pfnGetPlaneOffsets != nullptr && f < 2; f++)
+    {
+        for (auto &size : sizes)
+        {
+            VASurfaceAttrib attrib     = {};
+            attrib.type                = VASurfaceAttribPixelFormat;
+            attrib.flags               = VA_SURFACE_ATTRIB_SETTABLE;
+            attrib.value.type          = VAGenericValueTypeInteger;
+            attrib.value.value.i       = fourccs[f];
+            VASurfaceID surfaces[2];
+
+            int ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, rtFormats[f],
+                size[0], size[1], surfaces, 2, &attrib, 1);
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2"
+                << ", fourcc = " << fourccs[f] << ", size = " << size[0] << "x" << size[1] << endl;
+            if (ret != VA_STATUS_SUCCESS)
+            {
+                continue;
+            }
+
+            for (int s = 0; s < 2; s++)
+            {
+                uint32_t cached[3] = {};
+                uint32_t fresh[3]  = {};
+                EXPECT_TRUE(pfnGetPlaneOffsets(&m_driverLoader.m_ctx, surfaces[s], false, cached));
+                EXPECT_TRUE(pfnGetPlaneOffsets(&m_driverLoader.m_ctx, surfaces[s], true, fresh));
+                EXPECT_NE(0u, cached[1]) << "fourcc = " << fourccs[f] << ", size = " << size[0] << "x" << size[1];
+                for (int p = 0; p < 3; p++)
+                {
+                    EXPECT_EQ(fresh[p], cached[p]) << "fourcc = " << fourccs[f]
+                        << ", size = " << size[0] << "x" << size[1] << ", plane = " << p;
+                }
+
+                VAImage image = {};
+                ret = m_driverLoader.m_ctx.vtable->vaDeriveImage(&m_driverLoader.m_ctx, surfaces[s], &image);
+                EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Failed function = m_driverLoader.m_ctx.vtable->vaDeriveImage";
+                EXPECT_EQ(fresh[1], image.offsets[1]) << "fourcc = " << fourccs[f]
+                    << ", size = " << size[0] << "x" << size[1];
+                ret = m_driverLoader.m_ctx.vtable->vaDestroyImage(&m_driverLoader.m_ctx, image.image_id);
+                EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Failed function = m_driverLoader.m_ctx.vtable->vaDestroyImage";
+            }
+
+            ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, surfaces, 2);
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces";
+        }
+    }
+
+    EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+    MemoryLeakDetector::Detect(m_driverLoader, platform);
+}
+
+// Simulates 4K streams starting and stopping on a node with 2 Vdboxes, each
+// stream asks for 2 pipes and decides again with the pipe num it runs with.
+TEST_F(MediaDecodeDdiTest, ScalabilityPipeNumByLoad)
+{
+    const uint8_t numVdbox = 2;
+    Platform_t    platform = m_driverLoader.GetPlatforms()[0];
+
+    ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(platform));
+    auto pfnSelectPipeNum = (SelectPipeNumByLoadFunc)GetUltHook(
+        "CodecHalDecodeScalability_UltSelectPipeNumByLoad");
+
+    if (pfnSelectPipeNum != nullptr)
+    {
+        // The first stream takes both pipes, the next ones find them busy
+        uint8_t a = pfnSelectPipeNum(2, 0, numVdbox);
+        EXPECT_EQ(2, a);
+        uint8_t b = pfnSelectPipeNum(2, 0, numVdbox);
+        EXPECT_EQ(1, b);
+
+        // A stays scalable while a Vdbox is still free of other streams
+        a = pfnSelectPipeNum(2, a, numVdbox);
+        EXPECT_EQ(2, a);
+        uint8_t c = pfnSelectPipeNum(2, 0, numVdbox);
+        EXPECT_EQ(1, c);
+
+        // Every Vdbox runs another stream, A leaves scalable mode
+        a = pfnSelectPipeNum(2, a, numVdbox);
+        EXPECT_EQ(1, a);
+        b = pfnSelectPipeNum(2, b, numVdbox);
+        EXPECT_EQ(1, b);
+
+        // B goes scalable once it is the only stream left
+        c = pfnSelectPipeNum(0, c, numVdbox);
+        EXPECT_EQ(0, c);
+        b = pfnSelectPipeNum(2, b, numVdbox);
+        EXPECT_EQ(1, b);
+        a = pfnSelectPipeNum(0, a, numVdbox);
+        EXPECT_EQ(0, a);
+        b = pfnSelectPipeNum(2, b, numVdbox);
+        EXPECT_EQ(2, b);
+
+        // Single pipe candidates are kept whatever the load
+        c = pfnSelectPipeNum(1, 0, numVdbox);
+        EXPECT_EQ(1, c);
+
+        pfnSelectPipeNum(0, b, numVdbox);
+        pfnSelectPipeNum(0, c, numVdbox);
+        EXPECT_EQ(2, pfnSelectPipeNum(2, 0, numVdbox)) << "Vdbox load not released";
+        pfnSelectPipeNum(0, 2, numVdbox);
+    }
+
+    EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+    MemoryLeakDetector::Detect(m_driverLoader, platform);
+}
+
+// Streams deciding their pipe num concurrently must not take the same free
+// pipes, at most one of two streams on 2 Vdboxes may run scalable.
+TEST_F(MediaDecodeDdiTest, ScalabilityPipeNumConcurrent)
+{
+    const uint8_t numVdbox  = 2;
+    const int     threadNum = 4;
+    const int     iterNum   = 10000;
+    Platform_t    platform  = m_driverLoader.GetPlatforms()[0];
+
+    ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(platform));
+    auto pfnSelectPipeNum = (SelectPipeNumByLoadFunc)GetUltHook(
+        "CodecHalDecodeScalability_UltSelectPipeNumByLoad");
+
+    if (pfnSelectPipeNum != nullptr)
+    {
+        atomic<int> scalableNum(0);
+        atomic<int> maxScalableNum(0);
+
+        vector<thread> threads;
+        for (int t = 0; t < threadNum; t++)
+        {
+            threads.push_back(thread([&]() {
+                for (int n = 0; n < iterNum; n++)
+                {
+                    uint8_t pipeNum = pfnSelectPipeNum(2, 0, numVdbox);
+                    if (pipeNum == 2)
+                    {
+                        int num = ++scalableNum;
+                        int max = maxScalableNum.load();
+                        while (num > max && !maxScalableNum.compare_exchange_weak(max, num))
+                        {
+                        }
+                        --scalableNum;
+                    }
+                    pfnSelectPipeNum(0, pipeNum, numVdbox);
+                }
+            }));
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+
+        EXPECT_EQ(1, maxScalableNum.load()) << "Streams took the same free pipes";
+        EXPECT_EQ(2, pfnSelectPipeNum(2, 0, numVdbox)) << "Vdbox load not released";
+        pfnSelectPipeNum(0, 2, numVdbox);
+    }
+
+    EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+    MemoryLeakDetector::Detect(m_driverLoader, platform);
+}
+
 void MediaDecodeDdiTest::ExectueDecodeTest(DecTestData *pDecData)
 {
     vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
@@ -58,10 +351,32 @@ void MediaDecodeDdiTest::DecodeExecute(DecTestData *pDecData, Platform_t platfor
 {
     VAConfigID      config_id;
     VAContextID     context_id;
-    VASurfaceStatus surface_status;
 
-    // So far we still use DeviceConfigTable to find the platform, as the libdrm mock use this.
-    // If we want to use vector Platforms, we would use vector in libdrm too.
+    InitDecode(pDecData, platform, config_id, context_id);
+
+    // In benchmark mode the frame sequence of the test data is repeated
+    int frameNum = BeginBenchmark(platform, pDecData->m_num_frames);
+
+    vector<VASurfaceID> &resources = pDecData->GetResources();
+    for (int n = 0; n < frameNum; n++)
+    {
+        int i = n % pDecData->m_num_frames;
+
+        DecodeFrame(pDecData, platform, context_id, resources[0], i);
+        WaitSurfaceReady(platform, resources[0]);
+        DestroyFrameBuffers(pDecData, platform, i);
+    }
+
+    EndBenchmark();
+
+    DeinitDecode(pDecData, platform, config_id, context_id);
+}
+
+// So far we still use DeviceConfigTable to find the platform, as the libdrm mock use this.
+// If we want to use vector Platforms, we would use vector in libdrm too.
+void MediaDecodeDdiTest::InitDecode(DecTestData *pDecData, Platform_t platform,
+    VAConfigID &config_id, VAContextID &context_id)
+{
     int ret = m_driverLoader.InitDriver(platform);
     EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
         << ", Failed function = m_driverLoader.InitDriver" << endl;
@@ -83,50 +398,381 @@ void MediaDecodeDdiTest::DecodeExecute(DecTestData *pDecData, Platform_t platfor
         pDecData->GetHeight(),VA_PROGRESSIVE, &resources[0], resources.size(), &context_id);
     EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
         << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
+}
 
-    for (int i = 0; i < pDecData->m_num_frames; i++)
+void MediaDecodeDdiTest::DeinitDecode(DecTestData *pDecData, Platform_t platform,
+    VAConfigID config_id, VAContextID context_id)
+{
+    vector<VASurfaceID> &resources = pDecData->GetResources();
+    int ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &resources[0], resources.size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyContext(&m_driverLoader.m_ctx, context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyContext" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyConfig(&m_driverLoader.m_ctx, config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyConfig" << endl;
+
+    ret = m_driverLoader.CloseDriver();
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.CloseDriver" << endl;
+}
+
+// Submits frame i of the test data to render target, the buffers of the frame
+// are kept until DestroyFrameBuffers.
+void MediaDecodeDdiTest::DecodeFrame(DecTestData *pDecData, Platform_t platform,
+    VAContextID context_id, VASurfaceID surface, int i)
+{
+    // As BeginPicture would reset some parameters, so it should be called before RenderPicture.
+    int ret = m_driverLoader.m_ctx.vtable->vaBeginPicture(&m_driverLoader.m_ctx, context_id, surface);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaBeginPicture" << endl;
+
+    vector<vector<CompBufConif>> &compBufs = pDecData->GetCompBuffers();
+    for (int j = 0; j < compBufs[i].size(); j++)
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaCreateBuffer(&m_driverLoader.m_ctx, context_id,
+            compBufs[i][j].bufType, compBufs[i][j].bufSize, 1, compBufs[i][j].pData, &compBufs[i][j].bufID);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateBuffer" << endl;
+    }
+
+    pDecData->UpdateCompBuffers(i);
+    for (int j = 0; j < compBufs[i].size(); j++)
+    {
+        // In RenderPicture, it suppose all needed buffer has been created already.
+        ret = m_driverLoader.m_ctx.vtable->vaRenderPicture(&m_driverLoader.m_ctx,
+            context_id, &compBufs[i][j].bufID, 1);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaRenderPicture" << endl;
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaEndPicture(&m_driverLoader.m_ctx, context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaEndPicture" << endl;
+}
+
+void MediaDecodeDdiTest::WaitSurfaceReady(Platform_t platform, VASurfaceID surface)
+{
+    VASurfaceStatus surface_status;
+    int             ret;
+
+    do
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus(
+            &m_driverLoader.m_ctx, surface, &surface_status);
+        ASSERT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus" << endl;
+    } while (surface_status != VASurfaceReady);
+}
+
+// Starts the benchmark of the running test if enabled. Returns the number of
+// iterations to run, the frame number of the benchmark or iterNum otherwise.
+int MediaDecodeDdiTest::BeginBenchmark(Platform_t platform, int iterNum)
+{
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    if (!perfBenchmark->IsEnabled())
+    {
+        return iterNum;
+    }
+
+    perfBenchmark->Begin(testing::UnitTest::GetInstance()->current_test_info()->name(), platform);
+    return perfBenchmark->GetFrameNum();
+}
+
+void MediaDecodeDdiTest::EndBenchmark()
+{
+    PerfBenchmark::GetInstance()->End();
+}
+
+void MediaDecodeDdiTest::DestroyFrameBuffers(DecTestData *pDecData, Platform_t platform, int i)
+{
+    vector<vector<CompBufConif>> &compBufs = pDecData->GetCompBuffers();
+    for (int j = 0; j < compBufs[i].size(); j++)
     {
-        // As BeginPicture would reset some parameters, so it should be called before RenderPicture.
-        ret = m_driverLoader.m_ctx.vtable->vaBeginPicture(&m_driverLoader.m_ctx, context_id, resources[0]);
+        int ret = m_driverLoader.m_ctx.vtable->vaDestroyBuffer(&m_driverLoader.m_ctx, compBufs[i][j].bufID);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyBuffer" << endl;
+    }
+}
+
+// Makes each surface a render target of the context, BeginPicture adds it to
+// the render target table without submitting anything.
+void MediaDecodeDdiTest::RegisterRenderTargets(Platform_t platform, VAContextID context_id,
+    vector<VASurfaceID> &surfaces)
+{
+    for (int s = 0; s < surfaces.size(); s++)
+    {
+        int ret = m_driverLoader.m_ctx.vtable->vaBeginPicture(&m_driverLoader.m_ctx, context_id, surfaces[s]);
         EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
             << ", Failed function = m_driverLoader.m_ctx.vtable->vaBeginPicture" << endl;
+    }
+}
+
+// Creates and destroys a pool of surfaces registered as render targets of
+// several decode contexts, vaDestroySurfaces has to clean up the render target
+// table of each. The tables have room for one pool only, so the next iteration
+// fails to register its surfaces if the previous ones were left behind.
+void MediaDecodeDdiTest::DestroySurfacesExecute(DecTestData *pDecData, Platform_t platform)
+{
+    const int           contextNum = 8;
+    const int           surfaceNum = 64;
+    VAConfigID          config_id;
+    VAContextID         context_id[contextNum];
+    vector<VASurfaceID> surfaces(surfaceNum);
+
+    int ret = m_driverLoader.InitDriver(platform);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateConfig(&m_driverLoader.m_ctx,
+        pDecData->GetFeatureID().profile, pDecData->GetFeatureID().entrypoint,
+        (VAConfigAttrib *)&(pDecData->GetConfAttrib()[0]), pDecData->GetConfAttrib().size(), &config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateConfig" << endl;
 
-        vector<vector<CompBufConif>> &compBufs = pDecData->GetCompBuffers();
-        for (int j = 0; j < compBufs[i].size(); j++)
+    vector<VASurfaceID> &resources = pDecData->GetResources();
+    ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+        pDecData->GetWidth(), pDecData->GetHeight(), &resources[0], resources.size(), nullptr, 0);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+    for (int c = 0; c < contextNum; c++)
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaCreateContext(&m_driverLoader.m_ctx, config_id, pDecData->GetWidth(),
+            pDecData->GetHeight(), VA_PROGRESSIVE, &resources[0], resources.size(), &context_id[c]);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
+    }
+
+    // In benchmark mode each iteration counts as one frame
+    int iterNum = BeginBenchmark(platform, 2);
+
+    for (int n = 0; n < iterNum; n++)
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+            pDecData->GetWidth(), pDecData->GetHeight(), &surfaces[0], surfaceNum, nullptr, 0);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+        for (int c = 0; c < contextNum; c++)
         {
-            ret = m_driverLoader.m_ctx.vtable->vaCreateBuffer(&m_driverLoader.m_ctx, context_id,
-                compBufs[i][j].bufType, compBufs[i][j].bufSize, 1, compBufs[i][j].pData, &compBufs[i][j].bufID);
-            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-                << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateBuffer" << endl;
+            RegisterRenderTargets(platform, context_id[c], surfaces);
         }
 
-        pDecData->UpdateCompBuffers(i);
-        for (int j = 0; j < compBufs[i].size(); j++)
+        ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &surfaces[0], surfaceNum);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+    }
+
+    EndBenchmark();
+
+    for (int c = 0; c < contextNum; c++)
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaDestroyContext(&m_driverLoader.m_ctx, context_id[c]);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyContext" << endl;
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &resources[0], resources.size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyConfig(&m_driverLoader.m_ctx, config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyConfig" << endl;
+
+    ret = m_driverLoader.CloseDriver();
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.CloseDriver" << endl;
+}
+
+// A surface listed twice in one vaDestroySurfaces call is rejected before
+// anything is released, the surfaces stay usable and are destroyed afterwards.
+void MediaDecodeDdiTest::DestroyDuplicateSurfacesExecute(DecTestData *pDecData, Platform_t platform)
+{
+    VAConfigID          config_id;
+    VAContextID         context_id;
+    vector<VASurfaceID> surfaces(2);
+
+    InitDecode(pDecData, platform, config_id, context_id);
+
+    int ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+        pDecData->GetWidth(), pDecData->GetHeight(), &surfaces[0], surfaces.size(), nullptr, 0);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+    RegisterRenderTargets(platform, context_id, surfaces);
+
+    VASurfaceID duplicates[3] = {surfaces[0], surfaces[1], surfaces[0]};
+    ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, duplicates, 3);
+    EXPECT_EQ(VA_STATUS_ERROR_INVALID_SURFACE, ret) << "Platform = " << g_platformName[platform]
+        << ", Duplicate surfaces destroyed" << endl;
+
+    for (int s = 0; s < surfaces.size(); s++)
+    {
+        VASurfaceStatus surface_status;
+        ret = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus(&m_driverLoader.m_ctx, surfaces[s], &surface_status);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Surface released by a rejected vaDestroySurfaces" << endl;
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &surfaces[0], surfaces.size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+    DeinitDecode(pDecData, platform, config_id, context_id);
+}
+
+// With deferred surface release enabled, destroyed render targets are queued
+// to the surface reaper one batch per call. The last batch is still pending
+// when the driver terminates, the leak check after CloseDriver makes sure it
+// is drained.
+void MediaDecodeDdiTest::DeferredDestroySurfacesExecute(DecTestData *pDecData, Platform_t platform)
+{
+    const int           batchNum   = 3;
+    const int           surfaceNum = 64;
+    VAConfigID          config_id;
+    VAContextID         context_id;
+    vector<VASurfaceID> surfaces(surfaceNum);
+
+    // The user feature is read when the driver is initialized, the driver
+    // stays loaded so the override applies to the next initialization.
+    int ret = m_driverLoader.InitDriver(platform);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+    auto pfnSetDeferredRelease = (void (*)(int32_t))GetUltHook("DdiMediaUtil_SetUltDeferredSurfaceRelease");
+    auto pfnGetReaperBatches   = (bool (*)(VADriverContextP, uint32_t *))GetUltHook(
+        "DdiMediaUtil_GetUltSurfaceReaperBatches");
+
+    ret = m_driverLoader.CloseDriver();
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.CloseDriver" << endl;
+
+    if (pfnSetDeferredRelease == nullptr || pfnGetReaperBatches == nullptr)
+    {
+        return;
+    }
+    pfnSetDeferredRelease(1);
+
+    InitDecode(pDecData, platform, config_id, context_id);
+
+    uint32_t batches = 0;
+    EXPECT_TRUE(pfnGetReaperBatches(&m_driverLoader.m_ctx, &batches)) << "Platform = " << g_platformName[platform]
+        << ", Surface reaper not started" << endl;
+
+    for (int n = 0; n < batchNum; n++)
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+            pDecData->GetWidth(), pDecData->GetHeight(), &surfaces[0], surfaceNum, nullptr, 0);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+        RegisterRenderTargets(platform, context_id, surfaces);
+
+        ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &surfaces[0], surfaceNum);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+        // The IDs are invalid as soon as the call returns, whether or not the reaper ran
+        VASurfaceStatus surface_status;
+        ret = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus(&m_driverLoader.m_ctx, surfaces[0], &surface_status);
+        EXPECT_EQ(VA_STATUS_ERROR_INVALID_SURFACE, ret) << "Platform = " << g_platformName[platform]
+            << ", Destroyed surface still valid" << endl;
+    }
+
+    uint32_t queued = 0;
+    EXPECT_TRUE(pfnGetReaperBatches(&m_driverLoader.m_ctx, &queued));
+    EXPECT_EQ((uint32_t)batchNum, queued - batches) << "Platform = " << g_platformName[platform]
+        << ", Destroyed surfaces not queued to the surface reaper" << endl;
+
+    DeinitDecode(pDecData, platform, config_id, context_id);
+    pfnSetDeferredRelease(-1);
+}
+
+// Queues a whole frame sequence before syncing each render target, while a
+// display sized set of idle surfaces sits in the surface heap. The frames are
+// completed as the GPU would and synced last to first, so the first
+// vaSyncSurface retires the status report of every queued frame.
+void MediaDecodeDdiTest::SyncSurfacesExecute(DecTestData *pDecData, Platform_t platform)
+{
+    const int           idleSurfaceNum = 128;
+    VAConfigID          config_id;
+    VAContextID         context_id;
+    vector<VASurfaceID> idleSurfaces(idleSurfaceNum);
+
+    int ret = m_driverLoader.InitDriver(platform);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+    // libdrm_mock never executes the batch buffers, the status reports are completed by the driver
+    auto pfnSetFramesCompleted = (VAStatus (*)(VADriverContextP, VAContextID))GetUltHook(
+        "DdiDecode_SetUltFramesCompleted");
+    if (pfnSetFramesCompleted == nullptr)
+    {
+        m_driverLoader.CloseDriver();
+        return;
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateConfig(&m_driverLoader.m_ctx,
+        pDecData->GetFeatureID().profile, pDecData->GetFeatureID().entrypoint,
+        (VAConfigAttrib *)&(pDecData->GetConfAttrib()[0]), pDecData->GetConfAttrib().size(), &config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateConfig" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+        pDecData->GetWidth(), pDecData->GetHeight(), &idleSurfaces[0], idleSurfaceNum, nullptr, 0);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+    vector<VASurfaceID> &resources = pDecData->GetResources();
+    ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+        pDecData->GetWidth(), pDecData->GetHeight(), &resources[0], resources.size(), nullptr, 0);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateContext(&m_driverLoader.m_ctx, config_id, pDecData->GetWidth(),
+        pDecData->GetHeight(), VA_PROGRESSIVE, &resources[0], resources.size(), &context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
+
+    // In benchmark mode each queued sequence counts as one frame
+    int iterNum = BeginBenchmark(platform, 1);
+
+    for (int n = 0; n < iterNum; n++)
+    {
+        for (int i = 0; i < pDecData->m_num_frames; i++)
         {
-            // In RenderPicture, it suppose all needed buffer has been created already.
-            ret = m_driverLoader.m_ctx.vtable->vaRenderPicture(&m_driverLoader.m_ctx,
-                context_id, &compBufs[i][j].bufID, 1);
-            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-                << ", Failed function = m_driverLoader.m_ctx.vtable->vaRenderPicture" << endl;
+            DecodeFrame(pDecData, platform, context_id, resources[i], i);
         }
 
-        ret = m_driverLoader.m_ctx.vtable->vaEndPicture(&m_driverLoader.m_ctx, context_id);
+        ret = pfnSetFramesCompleted(&m_driverLoader.m_ctx, context_id);
         EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-            << ", Failed function = m_driverLoader.m_ctx.vtable->vaEndPicture" << endl;
+            << ", Failed function = DdiDecode_SetUltFramesCompleted" << endl;
 
-        do
+        for (int i = pDecData->m_num_frames - 1; i >= 0; i--)
         {
-            ret = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus(
-                &m_driverLoader.m_ctx, resources[0], &surface_status);
-        } while (surface_status != VASurfaceReady);
+            ret = m_driverLoader.m_ctx.vtable->vaSyncSurface(&m_driverLoader.m_ctx, resources[i]);
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+                << ", Failed function = m_driverLoader.m_ctx.vtable->vaSyncSurface, frame = " << i << endl;
 
-        for (int j = 0; j < compBufs[i].size(); j++)
-        {
-            ret = m_driverLoader.m_ctx.vtable->vaDestroyBuffer(&m_driverLoader.m_ctx, compBufs[i][j].bufID);
+            VASurfaceStatus surface_status = VASurfaceRendering;
+            ret = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus(&m_driverLoader.m_ctx, resources[i], &surface_status);
             EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-                << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyBuffer" << endl;
+                << ", Failed function = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus, frame = " << i << endl;
+            EXPECT_EQ(VASurfaceReady, surface_status) << "Platform = " << g_platformName[platform]
+                << ", Synced surface not ready, frame = " << i << endl;
         }
-      }
+
+        for (int i = 0; i < pDecData->m_num_frames; i++)
+        {
+            DestroyFrameBuffers(pDecData, platform, i);
+        }
+    }
+
+    EndBenchmark();
 
     ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &resources[0], resources.size());
     EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
@@ -136,6 +782,10 @@ void MediaDecodeDdiTest::DecodeExecute(DecTestData *pDecData, Platform_t platfor
     EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
         << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyContext" << endl;
 
+    ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &idleSurfaces[0], idleSurfaceNum);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
     ret = m_driverLoader.m_ctx.vtable->vaDestroyConfig(&m_driverLoader.m_ctx, config_id);
     EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
         << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyConfig" << endl;
@@ -145,6 +795,90 @@ void MediaDecodeDdiTest::DecodeExecute(DecTestData *pDecData, Platform_t platfor
         << ", Failed function = m_driverLoader.CloseDriver" << endl;
 }
 
+// Decodes a monochrome sequence into one render target. The default chroma is
+// filled within the decode submission of the first frame and kept for the
+// following frames, so libdrm_mock sees a single submission per frame.
+void MediaDecodeDdiTest::MonoPicturesExecute(DecTestData *pDecData, Platform_t platform)
+{
+    auto pfnGetMockCounters = (MockGetCountersFunc)dlsym(RTLD_DEFAULT, "mos_bufmgr_mock_get_counters");
+    if (pfnGetMockCounters == nullptr)
+    {
+        return;
+    }
+
+    // Commands of the mono picture differ from the ones of the validated sequences
+    CmdValidator::GpuCmdsValidationInit(nullptr, platform);
+
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    int  frameNum      = perfBenchmark->IsEnabled() ? perfBenchmark->GetFrameNum() : pDecData->m_num_frames;
+
+    MockBufMgrCounters start = {};
+    MockBufMgrCounters end   = {};
+    pfnGetMockCounters(&start);
+    DecodeExecute(pDecData, platform);
+    pfnGetMockCounters(&end);
+
+    EXPECT_EQ((uint64_t)frameNum, end.execs - start.execs) << "Platform = " << g_platformName[platform]
+        << ", Unexpected number of submissions" << endl;
+
+    if (perfBenchmark->IsEnabled())
+    {
+        return;
+    }
+
+    // Decodes the first picture three times into the same render target, the
+    // chroma fill adds the relocations of the HuC copies to the submission. It
+    // is skipped when the render target is reused untouched, and done again
+    // once the application wrote the render target.
+    VAConfigID  config_id;
+    VAContextID context_id;
+    VASurfaceID surface = pDecData->GetResources()[0];
+    uint64_t    relocs[3];
+
+    InitDecode(pDecData, platform, config_id, context_id);
+
+    for (int n = 0; n < 3; n++)
+    {
+        if (n == 2)
+        {
+            VAImageFormat format  = {};
+            VAImage       image   = {};
+            format.fourcc         = VA_FOURCC_NV12;
+            format.byte_order     = VA_LSB_FIRST;
+            format.bits_per_pixel = 12;
+
+            int ret = m_driverLoader.m_ctx.vtable->vaCreateImage(&m_driverLoader.m_ctx, &format,
+                pDecData->GetWidth(), pDecData->GetHeight(), &image);
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+                << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateImage" << endl;
+
+            ret = m_driverLoader.m_ctx.vtable->vaPutImage(&m_driverLoader.m_ctx, surface, image.image_id,
+                0, 0, pDecData->GetWidth(), pDecData->GetHeight(), 0, 0, pDecData->GetWidth(), pDecData->GetHeight());
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+                << ", Failed function = m_driverLoader.m_ctx.vtable->vaPutImage" << endl;
+
+            ret = m_driverLoader.m_ctx.vtable->vaDestroyImage(&m_driverLoader.m_ctx, image.image_id);
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+                << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyImage" << endl;
+        }
+
+        pfnGetMockCounters(&start);
+        DecodeFrame(pDecData, platform, context_id, surface, 0);
+        pfnGetMockCounters(&end);
+        relocs[n] = end.relocs - start.relocs;
+
+        WaitSurfaceReady(platform, surface);
+        DestroyFrameBuffers(pDecData, platform, 0);
+    }
+
+    EXPECT_LT(relocs[1], relocs[0]) << "Platform = " << g_platformName[platform]
+        << ", Chroma of an untouched render target filled again" << endl;
+    EXPECT_GT(relocs[2], relocs[1]) << "Platform = " << g_platformName[platform]
+        << ", Chroma of a written render target not filled again" << endl;
+
+    DeinitDecode(pDecData, platform, config_id, context_id);
+}
+
 DecodeTestConfig::DecodeTestConfig()
 {
     m_mapPlatformFeatureID[DeviceConfigTable[igfxCANNONLAKE]] = {
@@ -180,3 +914,200 @@ bool DecodeTestConfig::IsDecTestEnabled(DeviceConfig platform, FeatureID feature
 
     return false;
 }
+
+// Creates and destroys IQ matrix buffers on two decode contexts. A destroyed
+// buffer hands its descriptor and memory back to the slab of its context, so
+// the next buffer of that context reuses both, and the other context does not.
+// A slab class keeps 32 free blocks and frees the rest, and a buffer larger
+// than the biggest class (64KB) only takes its descriptor from the slab.
+void MediaDecodeDdiTest::ParamSlabExecute(DecTestData *pDecData, Platform_t platform)
+{
+    enum { allocs, hits, frees, released };
+    const int           maxCached = 32;
+    const int           bufNum    = maxCached + 8;
+    const uint32_t      bufSize   = sizeof(VAIQMatrixBufferH264);
+    const uint32_t      largeSize = 128 * 1024;
+    VAConfigID          config_id;
+    VAContextID         context_id;
+    VAContextID         other_context_id;
+    vector<VABufferID>  bufIds(bufNum);
+    vector<uint8_t>     data(largeSize);
+
+    InitDecode(pDecData, platform, config_id, context_id);
+
+    auto pfnGetStats = (GetParamSlabStatsFunc)GetUltHook("DdiMedia_GetUltParamSlabStats");
+    if (pfnGetStats == nullptr)
+    {
+        DeinitDecode(pDecData, platform, config_id, context_id);
+        return;
+    }
+
+    vector<VASurfaceID> &resources = pDecData->GetResources();
+    int ret = m_driverLoader.m_ctx.vtable->vaCreateContext(&m_driverLoader.m_ctx, config_id, pDecData->GetWidth(),
+        pDecData->GetHeight(), VA_PROGRESSIVE, &resources[0], resources.size(), &other_context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
+
+    auto createBuffers = [&](VAContextID context, int num, uint32_t size) {
+        for (int i = 0; i < num; i++)
+        {
+            ret = m_driverLoader.m_ctx.vtable->vaCreateBuffer(&m_driverLoader.m_ctx, context,
+                VAIQMatrixBufferType, size, 1, &data[0], &bufIds[i]);
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+                << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateBuffer" << endl;
+        }
+    };
+    auto destroyBuffers = [&](int num) {
+        for (int i = 0; i < num; i++)
+        {
+            ret = m_driverLoader.m_ctx.vtable->vaDestroyBuffer(&m_driverLoader.m_ctx, bufIds[i]);
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+                << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyBuffer" << endl;
+        }
+    };
+    auto getStats = [&](VAContextID context, uint64_t stats[4]) {
+        ret = pfnGetStats(&m_driverLoader.m_ctx, context, stats);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = DdiMedia_GetUltParamSlabStats" << endl;
+    };
+
+    uint64_t start[4] = {};
+    uint64_t end[4]   = {};
+    uint64_t other[4] = {};
+
+    // The first buffer misses for its descriptor and memory, the second one
+    // created after it was destroyed hits for both
+    getStats(context_id, start);
+    createBuffers(context_id, 1, bufSize);
+    destroyBuffers(1);
+    createBuffers(context_id, 1, bufSize);
+    getStats(context_id, end);
+    EXPECT_EQ(4u, end[allocs] - start[allocs]);
+    EXPECT_EQ(2u, end[hits] - start[hits]);
+    EXPECT_EQ(2u, end[frees] - start[frees]);
+    destroyBuffers(1);
+
+    // Blocks freed on one context are not handed to the other
+    createBuffers(other_context_id, 1, bufSize);
+    getStats(other_context_id, other);
+    EXPECT_EQ(2u, other[allocs]);
+    EXPECT_EQ(0u, other[hits]);
+    destroyBuffers(1);
+
+    // Destroying more buffers than a class caches frees the blocks beyond the
+    // limit, the buffers created after it reuse the cached ones only
+    getStats(context_id, start);
+    createBuffers(context_id, bufNum, bufSize);
+    destroyBuffers(bufNum);
+    getStats(context_id, end);
+    EXPECT_EQ(2u, end[hits] - start[hits]);
+    EXPECT_EQ(2u * bufNum, end[frees] - start[frees]);
+    EXPECT_EQ(2u * (bufNum - maxCached), end[released] - start[released]);
+
+    getStats(context_id, start);
+    createBuffers(context_id, bufNum, bufSize);
+    getStats(context_id, end);
+    EXPECT_EQ(2u * maxCached, end[hits] - start[hits]);
+    destroyBuffers(bufNum);
+
+    // Memory of a buffer above the biggest class is allocated directly
+    getStats(context_id, start);
+    createBuffers(context_id, 1, largeSize);
+    destroyBuffers(1);
+    getStats(context_id, end);
+    EXPECT_EQ(1u, end[allocs] - start[allocs]);
+    EXPECT_EQ(1u, end[hits] - start[hits]);
+    EXPECT_EQ(1u, end[frees] - start[frees]);
+
+    // A buffer destroyed after its context still returns its blocks
+    createBuffers(other_context_id, 1, bufSize);
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyContext(&m_driverLoader.m_ctx, other_context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyContext" << endl;
+    destroyBuffers(1);
+
+    DeinitDecode(pDecData, platform, config_id, context_id);
+}
+
+// Destroys and re-creates surfaces with the surface pool limited to a few
+// entries. Surfaces destroyed beyond the limit evict the oldest pooled
+// allocations, re-created surfaces take the pooled ones and only the rest
+// allocate a bo from libdrm_mock. A surface of another size never matches.
+void MediaDecodeDdiTest::SurfacePoolExecute(DecTestData *pDecData, Platform_t platform)
+{
+    enum { hits, misses, evictions };
+    const int           maxEntries = 4;
+    const int           surfaceNum = 8;
+    VAConfigID          config_id;
+    VAContextID         context_id;
+    vector<VASurfaceID> surfaces(surfaceNum);
+
+    InitDecode(pDecData, platform, config_id, context_id);
+
+    auto pfnSetMaxEntries   = (SetSurfacePoolMaxEntriesFunc)GetUltHook("DdiMediaUtil_SetUltSurfacePoolMaxEntries");
+    auto pfnGetStats        = (GetSurfacePoolStatsFunc)GetUltHook("DdiMediaUtil_GetUltSurfacePoolStats");
+    auto pfnGetMockCounters = (MockGetCountersFunc)dlsym(RTLD_DEFAULT, "mos_bufmgr_mock_get_counters");
+    if (pfnSetMaxEntries == nullptr || pfnGetStats == nullptr || pfnGetMockCounters == nullptr)
+    {
+        DeinitDecode(pDecData, platform, config_id, context_id);
+        return;
+    }
+    EXPECT_TRUE(pfnSetMaxEntries(&m_driverLoader.m_ctx, maxEntries));
+
+    int ret = VA_STATUS_SUCCESS;
+    auto createSurfaces = [&](int num, uint32_t width) {
+        ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+            width, pDecData->GetHeight(), &surfaces[0], num, nullptr, 0);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+    };
+    auto destroySurfaces = [&](int num) {
+        ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, &surfaces[0], num);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+    };
+
+    uint32_t           start[3] = {};
+    uint32_t           end[3]   = {};
+    MockBufMgrCounters mockStart = {};
+    MockBufMgrCounters mockEnd   = {};
+
+    // Nothing of this size is pooled yet, destroying the surfaces keeps the
+    // last maxEntries allocations
+    EXPECT_TRUE(pfnGetStats(&m_driverLoader.m_ctx, start));
+    pfnGetMockCounters(&mockStart);
+    createSurfaces(surfaceNum, pDecData->GetWidth());
+    pfnGetMockCounters(&mockEnd);
+    destroySurfaces(surfaceNum);
+    EXPECT_TRUE(pfnGetStats(&m_driverLoader.m_ctx, end));
+    EXPECT_EQ(0u, end[hits] - start[hits]);
+    EXPECT_EQ((uint32_t)surfaceNum, end[misses] - start[misses]);
+    EXPECT_EQ((uint32_t)(surfaceNum - maxEntries), end[evictions] - start[evictions]);
+    EXPECT_LE((uint64_t)surfaceNum, mockEnd.boAllocs - mockStart.boAllocs);
+    uint64_t missAllocs = (mockEnd.boAllocs - mockStart.boAllocs) / surfaceNum;
+
+    // The pooled allocations are taken over without allocating a bo
+    EXPECT_TRUE(pfnGetStats(&m_driverLoader.m_ctx, start));
+    pfnGetMockCounters(&mockStart);
+    createSurfaces(surfaceNum, pDecData->GetWidth());
+    pfnGetMockCounters(&mockEnd);
+    EXPECT_TRUE(pfnGetStats(&m_driverLoader.m_ctx, end));
+    EXPECT_EQ((uint32_t)maxEntries, end[hits] - start[hits]);
+    EXPECT_EQ((uint32_t)(surfaceNum - maxEntries), end[misses] - start[misses]);
+    EXPECT_EQ(missAllocs * (surfaceNum - maxEntries), mockEnd.boAllocs - mockStart.boAllocs)
+        << "Platform = " << g_platformName[platform] << ", Pool hits allocated a bo" << endl;
+    destroySurfaces(surfaceNum);
+
+    // A surface of another size misses, and destroying it evicts one more
+    EXPECT_TRUE(pfnGetStats(&m_driverLoader.m_ctx, start));
+    createSurfaces(1, pDecData->GetWidth() / 2);
+    destroySurfaces(1);
+    EXPECT_TRUE(pfnGetStats(&m_driverLoader.m_ctx, end));
+    EXPECT_EQ(0u, end[hits] - start[hits]);
+    EXPECT_EQ(1u, end[misses] - start[misses]);
+    EXPECT_EQ(1u, end[evictions] - start[evictions]);
+
+    // Pooled allocations are released when the driver terminates, the leak
+    // check after CloseDriver makes sure of it
+    DeinitDecode(pDecData, platform, config_id, context_id);
+}
@@ -26,6 +26,7 @@
 #include "driver_loader.h"
 #include "gtest/gtest.h"
 #include "memory_leak_detector.h"
+#include "perf_benchmark.h"
 #include "test_data_caps.h"
 #include "test_data_decode.h"
 
@@ -54,6 +55,36 @@ protected:
 
     void ExectueDecodeTest(DecTestData *pDecData);
 
+    void DestroySurfacesExecute(DecTestData *pDecData, Platform_t platform);
+
+    void DestroyDuplicateSurfacesExecute(DecTestData *pDecData, Platform_t platform);
+
+    void DeferredDestroySurfacesExecute(DecTestData *pDecData, Platform_t platform);
+
+    void SyncSurfacesExecute(DecTestData *pDecData, Platform_t platform);
+
+    void MonoPicturesExecute(DecTestData *pDecData, Platform_t platform);
+
+    void ParamSlabExecute(DecTestData *pDecData, Platform_t platform);
+
+    void SurfacePoolExecute(DecTestData *pDecData, Platform_t platform);
+
+    void InitDecode(DecTestData *pDecData, Platform_t platform, VAConfigID &config_id, VAContextID &context_id);
+
+    void DeinitDecode(DecTestData *pDecData, Platform_t platform, VAConfigID config_id, VAContextID context_id);
+
+    void DecodeFrame(DecTestData *pDecData, Platform_t platform, VAContextID context_id, VASurfaceID surface, int i);
+
+    void WaitSurfaceReady(Platform_t platform, VASurfaceID surface);
+
+    void DestroyFrameBuffers(DecTestData *pDecData, Platform_t platform, int i);
+
+    int BeginBenchmark(Platform_t platform, int iterNum);
+
+    void EndBenchmark();
+
+    void RegisterRenderTargets(Platform_t platform, VAContextID context_id, std::vector<VASurfaceID> &surfaces);
+
 protected:
 
     DriverDllLoader     m_driverLoader;
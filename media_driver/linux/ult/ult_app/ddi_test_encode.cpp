@@ -19,6 +19,7 @@
 * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
 * OTHER DEALINGS IN THE SOFTWARE.
 */
+#include <dlfcn.h>
 #include "ddi_test_encode.h"
 
 using namespace std;
@@ -39,6 +40,54 @@ TEST_F(MediaEncodeDdiTest, EncodeAVC_DualPipe)
     delete pEncData;
 }
 
+TEST_F(MediaEncodeDdiTest, RecreateEncoderAVC)
+{
+    EncTestData *pEncData = m_encTestFactory.GetEncTestData("AVC-DualPipe");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_encTestCfg.IsEncTestEnabled(DeviceConfigTable[platforms[i]],
+            pEncData->GetFeatureID()))
+        {
+            RecreateEncoderExecute(pEncData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pEncData;
+}
+
+TEST_F(MediaEncodeDdiTest, SliceSegmentsAVC)
+{
+    EncTestData *pEncData = m_encTestFactory.GetEncTestData("AVC-DualPipe");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_encTestCfg.IsEncTestEnabled(DeviceConfigTable[platforms[i]],
+            pEncData->GetFeatureID()))
+        {
+            SliceSegmentsExecute(pEncData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pEncData;
+}
+
+TEST_F(MediaEncodeDdiTest, StatusReportTimeoutAVC)
+{
+    EncTestData *pEncData = m_encTestFactory.GetEncTestData("AVC-DualPipe");
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        if (m_encTestCfg.IsEncTestEnabled(DeviceConfigTable[platforms[i]],
+            pEncData->GetFeatureID()))
+        {
+            StatusReportTimeoutExecute(pEncData, platforms[i]);
+            MemoryLeakDetector::Detect(m_driverLoader, platforms[i]);
+        }
+    }
+    delete pEncData;
+}
+
 void MediaEncodeDdiTest::ExectueEncodeTest(EncTestData *pEncData)
 {
     vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
@@ -58,7 +107,6 @@ void MediaEncodeDdiTest::EncodeExecute(EncTestData *pEncData, Platform_t platfor
 {
     VAConfigID      config_id;
     VAContextID     context_id;
-    VASurfaceStatus surface_status;
 
     // So far we still use DeviceConfigTable to find the platform, as the libdrm mock use this.
     // If we want to use vector Platforms, we would use vector in libdrm too.
@@ -85,55 +133,435 @@ void MediaEncodeDdiTest::EncodeExecute(EncTestData *pEncData, Platform_t platfor
     EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
         << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
 
-    for (int i = 0; i < pEncData->m_num_frames; i++)
+    // In benchmark mode the frame sequence of the test data is repeated
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    int  frameNum      = pEncData->m_num_frames;
+    if (perfBenchmark->IsEnabled())
     {
-        ret = m_driverLoader.m_ctx.vtable->vaBeginPicture(&m_driverLoader.m_ctx, context_id,resources[0]);
+        frameNum = perfBenchmark->GetFrameNum();
+        perfBenchmark->Begin(testing::UnitTest::GetInstance()->current_test_info()->name(), platform);
+    }
+
+    for (int n = 0; n < frameNum; n++)
+    {
+        EncodeFrame(pEncData, platform, context_id, n % pEncData->m_num_frames);
+    }
+
+    perfBenchmark->End();
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx,
+        &resources[0], resources.size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyContext(&m_driverLoader.m_ctx, context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyContext" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyConfig(&m_driverLoader.m_ctx, config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyConfig" << endl;
+
+    ret = m_driverLoader.CloseDriver();
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.CloseDriver" << endl;
+}
+
+// Encodes frame i of the test data into the first surface and waits for it
+void MediaEncodeDdiTest::EncodeFrame(EncTestData *pEncData, Platform_t platform, VAContextID context_id, int i)
+{
+    SubmitFrame(pEncData, platform, context_id, i);
+    DestroyFrameBuffers(pEncData, platform, i);
+}
+
+// Submits frame i of the test data and waits for the surface, the buffers of the
+// frame are kept so the coded buffer can still be mapped
+void MediaEncodeDdiTest::SubmitFrame(EncTestData *pEncData, Platform_t platform, VAContextID context_id, int i)
+{
+    VASurfaceStatus surface_status;
+
+    vector<VASurfaceID> &resources = pEncData->GetResources();
+    int ret = m_driverLoader.m_ctx.vtable->vaBeginPicture(&m_driverLoader.m_ctx, context_id,resources[0]);
 
-        vector<vector<CompBufConif>> &compBufs = pEncData->GetCompBuffers();
-        ret = m_driverLoader.m_ctx.vtable->vaCreateBuffer(&m_driverLoader.m_ctx, context_id, compBufs[i][0].bufType,
-            compBufs[i][0].bufSize, 1, compBufs[i][0].pData, &compBufs[i][0].bufID);
+    vector<vector<CompBufConif>> &compBufs = pEncData->GetCompBuffers();
+    ret = m_driverLoader.m_ctx.vtable->vaCreateBuffer(&m_driverLoader.m_ctx, context_id, compBufs[i][0].bufType,
+        compBufs[i][0].bufSize, 1, compBufs[i][0].pData, &compBufs[i][0].bufID);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateBuffer" << endl;
+
+    pEncData->UpdateCompBuffers(i);
+    for (int j = 1; j < compBufs[i].size(); j++)
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaCreateBuffer(&m_driverLoader.m_ctx, context_id,
+            compBufs[i][j].bufType, compBufs[i][j].bufSize, 1, compBufs[i][j].pData, &compBufs[i][j].bufID);
         EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
             << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateBuffer" << endl;
 
-        pEncData->UpdateCompBuffers(i);
-        for (int j = 1; j < compBufs[i].size(); j++)
+        // In RenderPicture, it suppose all needed buffer has been created already.
+        // Suppose the compBufs[0] is always EncCodedBuffer, so we won't render it.
+        // If we render it, the ret is still Success, but would with log"not supported
+        // buffer type in vpgEncodeRenderPicture."
+        ret = m_driverLoader.m_ctx.vtable->vaRenderPicture(&m_driverLoader.m_ctx,
+            context_id, &compBufs[i][j].bufID, 1);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaRenderPicture" << endl;
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaEndPicture(&m_driverLoader.m_ctx, context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaEndPicture" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaSyncSurface(&m_driverLoader.m_ctx, resources[0]);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaSyncSurface" << endl;
+
+    do
+    {
+        ret = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus(&m_driverLoader.m_ctx,
+            resources[0], &surface_status);
+    } while (surface_status != VASurfaceReady);
+}
+
+void MediaEncodeDdiTest::DestroyFrameBuffers(EncTestData *pEncData, Platform_t platform, int i)
+{
+    vector<vector<CompBufConif>> &compBufs = pEncData->GetCompBuffers();
+    for (int j = 0; j < compBufs[i].size(); j++)
+    {
+        int ret = m_driverLoader.m_ctx.vtable->vaDestroyBuffer(&m_driverLoader.m_ctx, compBufs[i][j].bufID);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyBuffer" << endl;
+    }
+}
+
+// Destroys the encoder after a sequence and creates it again with the resource
+// pool enabled. The tracked buffers of the first encoder wait in the pool until
+// the driver is closed, so the second encoder allocates fewer buffer objects.
+void MediaEncodeDdiTest::RecreateEncoderExecute(EncTestData *pEncData, Platform_t platform)
+{
+    const int  encoderNum = 2;
+    VAConfigID config_id;
+    VAContextID context_id;
+    uint64_t   boAllocs[encoderNum];
+
+    auto pfnGetMockCounters = (MockGetCountersFunc)dlsym(RTLD_DEFAULT, "mos_bufmgr_mock_get_counters");
+    if (pfnGetMockCounters == nullptr)
+    {
+        return;
+    }
+
+    int ret = m_driverLoader.InitDriver(platform);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+    auto pfnSetPoolSize = (void (*)(uint32_t))GetUltHook("CodecHal_SetUltResourcePoolSize");
+    if (pfnSetPoolSize == nullptr)
+    {
+        m_driverLoader.CloseDriver();
+        return;
+    }
+    pfnSetPoolSize(256);
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateConfig(&m_driverLoader.m_ctx,
+        pEncData->GetFeatureID().profile, pEncData->GetFeatureID().entrypoint,
+        (VAConfigAttrib *)&(pEncData->GetConfAttrib()[0]), pEncData->GetConfAttrib().size(), &config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateConfig" << endl;
+
+    vector<VASurfaceID> &resources = pEncData->GetResources();
+    ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+        pEncData->GetWidth(), pEncData->GetHeight(), &resources[0], resources.size(),
+        (VASurfaceAttrib *)&(pEncData->GetSurfAttrib()[0]), pEncData->GetSurfAttrib().size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+    for (int e = 0; e < encoderNum; e++)
+    {
+        MockBufMgrCounters start = {};
+        MockBufMgrCounters end   = {};
+        pfnGetMockCounters(&start);
+
+        ret = m_driverLoader.m_ctx.vtable->vaCreateContext(&m_driverLoader.m_ctx, config_id, pEncData->GetWidth(),
+            pEncData->GetHeight(), VA_PROGRESSIVE, &resources[0], resources.size(), &context_id);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
+
+        for (int i = 0; i < pEncData->m_num_frames; i++)
         {
-            ret = m_driverLoader.m_ctx.vtable->vaCreateBuffer(&m_driverLoader.m_ctx, context_id,
-                compBufs[i][j].bufType, compBufs[i][j].bufSize, 1, compBufs[i][j].pData, &compBufs[i][j].bufID);
-            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-                << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateBuffer" << endl;
-
-            // In RenderPicture, it suppose all needed buffer has been created already.
-            // Suppose the compBufs[0] is always EncCodedBuffer, so we won't render it.
-            // If we render it, the ret is still Success, but would with log"not supported
-            // buffer type in vpgEncodeRenderPicture."
-            ret = m_driverLoader.m_ctx.vtable->vaRenderPicture(&m_driverLoader.m_ctx,
-                context_id, &compBufs[i][j].bufID, 1);
-            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-                << ", Failed function = m_driverLoader.m_ctx.vtable->vaRenderPicture" << endl;
+            EncodeFrame(pEncData, platform, context_id, i);
         }
 
-        ret = m_driverLoader.m_ctx.vtable->vaEndPicture(&m_driverLoader.m_ctx, context_id);
+        ret = m_driverLoader.m_ctx.vtable->vaDestroyContext(&m_driverLoader.m_ctx, context_id);
         EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-            << ", Failed function = m_driverLoader.m_ctx.vtable->vaEndPicture" << endl;
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyContext" << endl;
+
+        pfnGetMockCounters(&end);
+        boAllocs[e] = end.boAllocs - start.boAllocs;
+    }
 
-        ret = m_driverLoader.m_ctx.vtable->vaSyncSurface(&m_driverLoader.m_ctx, resources[0]);
+    EXPECT_LT(boAllocs[1], boAllocs[0]) << "Platform = " << g_platformName[platform]
+        << ", Tracked buffers of the destroyed encoder not reused" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx,
+        &resources[0], resources.size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyConfig(&m_driverLoader.m_ctx, config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyConfig" << endl;
+
+    // Pooled buffers are freed with the device
+    ret = m_driverLoader.CloseDriver();
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.CloseDriver" << endl;
+
+    // The driver stays loaded, restore the pool size of the user feature for other tests
+    pfnSetPoolSize(0);
+}
+
+// Completes coded frames with given slice sizes, the mock never runs PAK, and
+// checks the segment list vaMapBuffer returns for them. Only HEVC VDEnc PAK
+// reports slice sizes, the AVC context stands in for it as there is no HEVC
+// VDEnc test data; the slice segment handling of the DDI is codec agnostic.
+void MediaEncodeDdiTest::SliceSegmentsExecute(EncTestData *pEncData, Platform_t platform)
+{
+    VAConfigID  config_id;
+    VAContextID context_id;
+
+    int ret = m_driverLoader.InitDriver(platform);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+    typedef VAStatus (*CompleteCodedBufferFunc)(VADriverContextP, VAContextID, VABufferID, uint32_t, uint16_t *, uint32_t);
+    typedef void (*SetSliceSegmentOutputFunc)(int32_t);
+    auto pfnCompleteCodedBuffer    = (CompleteCodedBufferFunc)GetUltHook("DdiEncode_UltCompleteCodedBuffer");
+    auto pfnSetSliceSegmentOutput  = (SetSliceSegmentOutputFunc)GetUltHook("DdiEncode_SetUltSliceSegmentOutput");
+    if (pfnCompleteCodedBuffer == nullptr || pfnSetSliceSegmentOutput == nullptr)
+    {
+        m_driverLoader.CloseDriver();
+        return;
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateConfig(&m_driverLoader.m_ctx,
+        pEncData->GetFeatureID().profile, pEncData->GetFeatureID().entrypoint,
+        (VAConfigAttrib *)&(pEncData->GetConfAttrib()[0]), pEncData->GetConfAttrib().size(), &config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateConfig" << endl;
+
+    vector<VASurfaceID> &resources = pEncData->GetResources();
+    ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+        pEncData->GetWidth(), pEncData->GetHeight(), &resources[0], resources.size(),
+        (VASurfaceAttrib *)&(pEncData->GetSurfAttrib()[0]), pEncData->GetSurfAttrib().size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+    // Stands in for the user feature, which is read when the context is created
+    pfnSetSliceSegmentOutput(1);
+    ret = m_driverLoader.m_ctx.vtable->vaCreateContext(&m_driverLoader.m_ctx, config_id, pEncData->GetWidth(),
+        pEncData->GetHeight(), VA_PROGRESSIVE, &resources[0], resources.size(), &context_id);
+    pfnSetSliceSegmentOutput(-1);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
+
+    // Frame 0 has 4 slices and 7 bytes behind the last one, which stay with the
+    // last segment. The slices of frame 1 exceed the frame, which is kept whole.
+    const uint32_t   frameNum             = 2;
+    vector<uint16_t> sliceSizes[frameNum] = { { 100, 250, 40, 333 }, { 400, 400 } };
+    uint32_t         frameSizes[frameNum] = { 100 + 250 + 40 + 333 + 7, 600 };
+
+    vector<vector<CompBufConif>> &compBufs = pEncData->GetCompBuffers();
+    for (uint32_t n = 0; n < frameNum; n++)
+    {
+        int i = n % pEncData->m_num_frames;
+        SubmitFrame(pEncData, platform, context_id, i);
+
+        // compBufs[i][0] is the coded buffer of the frame
+        VABufferID codedBuf = compBufs[i][0].bufID;
+        ret = pfnCompleteCodedBuffer(&m_driverLoader.m_ctx, context_id, codedBuf, frameSizes[n],
+            &sliceSizes[n][0], sliceSizes[n].size());
         EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-            << ", Failed function = m_driverLoader.m_ctx.vtable->vaSyncSurface" << endl;
+            << ", Failed function = DdiEncode_UltCompleteCodedBuffer" << endl;
 
-        do
+        VACodedBufferSegment *segment = nullptr;
+        ret = m_driverLoader.m_ctx.vtable->vaMapBuffer(&m_driverLoader.m_ctx, codedBuf, (void **)&segment);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaMapBuffer" << endl;
+        ASSERT_NE(nullptr, segment) << "Platform = " << g_platformName[platform]
+            << ", Null coded buffer segment" << endl;
+
+        vector<VACodedBufferSegment *> segments;
+        for (VACodedBufferSegment *s = segment; s != nullptr && segments.size() <= sliceSizes[n].size(); s = (VACodedBufferSegment *)s->next)
+        {
+            segments.push_back(s);
+        }
+
+        if (n == 0)
         {
-            ret = m_driverLoader.m_ctx.vtable->vaQuerySurfaceStatus(&m_driverLoader.m_ctx,
-                resources[0], &surface_status);
-        } while (surface_status != VASurfaceReady);
+            ASSERT_EQ(sliceSizes[n].size(), segments.size()) << "Platform = " << g_platformName[platform]
+                << ", Not one segment per slice" << endl;
 
-        for (int j = 0; j < compBufs[i].size(); j++)
+            uint8_t *base   = (uint8_t *)segments[0]->buf;
+            uint32_t offset = 0;
+            for (uint32_t k = 0; k < segments.size(); k++)
+            {
+                uint32_t size = sliceSizes[n][k] + (k == segments.size() - 1 ? 7 : 0);
+                EXPECT_EQ(base + offset, (uint8_t *)segments[k]->buf) << "Platform = " << g_platformName[platform]
+                    << ", Wrong offset of segment " << k << endl;
+                EXPECT_EQ(size, segments[k]->size) << "Platform = " << g_platformName[platform]
+                    << ", Wrong size of segment " << k << endl;
+                EXPECT_EQ(0u, segments[k]->bit_offset) << "Platform = " << g_platformName[platform]
+                    << ", Wrong bit offset of segment " << k << endl;
+                EXPECT_EQ(segments[0]->status, segments[k]->status) << "Platform = " << g_platformName[platform]
+                    << ", Wrong status of segment " << k << endl;
+                offset += sliceSizes[n][k];
+            }
+        }
+        else
         {
-            ret = m_driverLoader.m_ctx.vtable->vaDestroyBuffer(&m_driverLoader.m_ctx, compBufs[i][j].bufID);
-            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
-                << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyBuffer" << endl;
+            ASSERT_EQ(1u, segments.size()) << "Platform = " << g_platformName[platform]
+                << ", Oversized slices split the frame" << endl;
+            EXPECT_EQ(frameSizes[n], segments[0]->size) << "Platform = " << g_platformName[platform]
+                << ", Wrong size of the frame segment" << endl;
         }
-      }
+
+        ret = m_driverLoader.m_ctx.vtable->vaUnmapBuffer(&m_driverLoader.m_ctx, codedBuf);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaUnmapBuffer" << endl;
+
+        DestroyFrameBuffers(pEncData, platform, i);
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx,
+        &resources[0], resources.size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyContext(&m_driverLoader.m_ctx, context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyContext" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaDestroyConfig(&m_driverLoader.m_ctx, config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroyConfig" << endl;
+
+    ret = m_driverLoader.CloseDriver();
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.CloseDriver" << endl;
+}
+
+// Maps the coded buffers of frames whose status never arrives, the mock never
+// runs PAK and its fence waits return at once. A frame still running when a
+// later one times out keeps its queue entry and can still complete, a frame
+// whose coded buffer is idle without status is reported as a bad bitstream.
+void MediaEncodeDdiTest::StatusReportTimeoutExecute(EncTestData *pEncData, Platform_t platform)
+{
+    VAConfigID  config_id;
+    VAContextID context_id;
+    const int   frameNum = 3;
+
+    ASSERT_LE(frameNum, pEncData->m_num_frames);
+
+    int ret = m_driverLoader.InitDriver(platform);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+    typedef VAStatus (*CompleteCodedBufferFunc)(VADriverContextP, VAContextID, VABufferID, uint32_t, uint16_t *, uint32_t);
+    typedef void (*MockSetBusyFunc)(int);
+    auto pfnCompleteCodedBuffer = (CompleteCodedBufferFunc)GetUltHook("DdiEncode_UltCompleteCodedBuffer");
+    auto pfnSetBusy             = (MockSetBusyFunc)dlsym(RTLD_DEFAULT, "mos_bufmgr_mock_set_busy");
+    if (pfnCompleteCodedBuffer == nullptr || pfnSetBusy == nullptr)
+    {
+        m_driverLoader.CloseDriver();
+        return;
+    }
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateConfig(&m_driverLoader.m_ctx,
+        pEncData->GetFeatureID().profile, pEncData->GetFeatureID().entrypoint,
+        (VAConfigAttrib *)&(pEncData->GetConfAttrib()[0]), pEncData->GetConfAttrib().size(), &config_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateConfig" << endl;
+
+    vector<VASurfaceID> &resources = pEncData->GetResources();
+    ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+        pEncData->GetWidth(), pEncData->GetHeight(), &resources[0], resources.size(),
+        (VASurfaceAttrib *)&(pEncData->GetSurfAttrib()[0]), pEncData->GetSurfAttrib().size());
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+    ret = m_driverLoader.m_ctx.vtable->vaCreateContext(&m_driverLoader.m_ctx, config_id, pEncData->GetWidth(),
+        pEncData->GetHeight(), VA_PROGRESSIVE, &resources[0], resources.size(), &context_id);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateContext" << endl;
+
+    // Frames 0, 1 and 2 are pending, compBufs[i][0] is the coded buffer of frame i
+    vector<vector<CompBufConif>> &compBufs = pEncData->GetCompBuffers();
+    for (int i = 0; i < frameNum; i++)
+    {
+        SubmitFrame(pEncData, platform, context_id, i);
+    }
+
+    auto mapCodedBuffer = [&](int i, uint32_t &size, uint32_t &status)
+    {
+        VACodedBufferSegment *segment = nullptr;
+        ret = m_driverLoader.m_ctx.vtable->vaMapBuffer(&m_driverLoader.m_ctx, compBufs[i][0].bufID, (void **)&segment);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaMapBuffer, frame " << i << endl;
+        size   = segment ? segment->size : 0xffffffff;
+        status = segment ? segment->status : 0;
+        ret = m_driverLoader.m_ctx.vtable->vaUnmapBuffer(&m_driverLoader.m_ctx, compBufs[i][0].bufID);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaUnmapBuffer, frame " << i << endl;
+    };
+
+    uint32_t size   = 0;
+    uint32_t status = 0;
+
+    ret = pfnCompleteCodedBuffer(&m_driverLoader.m_ctx, context_id, compBufs[0][0].bufID, 500, nullptr, 0);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Failed function = DdiEncode_UltCompleteCodedBuffer, frame 0" << endl;
+
+    // Frames 1 and 2 are still running, frame 2 times out on its own
+    pfnSetBusy(1);
+    mapCodedBuffer(2, size, status);
+    pfnSetBusy(0);
+    EXPECT_EQ(0u, size) << "Platform = " << g_platformName[platform]
+        << ", Timed out frame has a size" << endl;
+    EXPECT_NE(0u, status & VA_CODED_BUF_STATUS_BAD_BITSTREAM) << "Platform = " << g_platformName[platform]
+        << ", Timed out frame is not a bad bitstream" << endl;
+
+    // Frame 1 is still the oldest pending one and completes late
+    ret = pfnCompleteCodedBuffer(&m_driverLoader.m_ctx, context_id, compBufs[1][0].bufID, 600, nullptr, 0);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform]
+        << ", Frame 1 was charged with the timeout of frame 2" << endl;
+
+    mapCodedBuffer(1, size, status);
+    EXPECT_EQ(600u, size) << "Platform = " << g_platformName[platform]
+        << ", Wrong size of frame 1" << endl;
+    EXPECT_EQ(0u, status & VA_CODED_BUF_STATUS_BAD_BITSTREAM) << "Platform = " << g_platformName[platform]
+        << ", Frame 1 is a bad bitstream" << endl;
+
+    mapCodedBuffer(0, size, status);
+    EXPECT_EQ(500u, size) << "Platform = " << g_platformName[platform]
+        << ", Wrong size of frame 0" << endl;
+
+    // A new frame finds frame 2 idle without status and reports it failed,
+    // then itself, each on its own entry
+    DestroyFrameBuffers(pEncData, platform, 0);
+    SubmitFrame(pEncData, platform, context_id, 0);
+    mapCodedBuffer(0, size, status);
+    EXPECT_EQ(0u, size) << "Platform = " << g_platformName[platform]
+        << ", Frame without status has a size" << endl;
+    EXPECT_NE(0u, status & VA_CODED_BUF_STATUS_BAD_BITSTREAM) << "Platform = " << g_platformName[platform]
+        << ", Frame without status is not a bad bitstream" << endl;
+
+    mapCodedBuffer(1, size, status);
+    EXPECT_EQ(600u, size) << "Platform = " << g_platformName[platform]
+        << ", Frame 1 was overwritten" << endl;
+
+    for (int i = 0; i < frameNum; i++)
+    {
+        DestroyFrameBuffers(pEncData, platform, i);
+    }
 
     ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx,
         &resources[0], resources.size());
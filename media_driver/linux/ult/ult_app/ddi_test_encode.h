@@ -26,6 +26,7 @@
 #include "driver_loader.h"
 #include "gtest/gtest.h"
 #include "memory_leak_detector.h"
+#include "perf_benchmark.h"
 #include "test_data_caps.h"
 #include "test_data_encode.h"
 
@@ -54,6 +55,18 @@ protected:
 
     void ExectueEncodeTest(EncTestData *pDecData);
 
+    void EncodeFrame(EncTestData *pEncData, Platform_t platform, VAContextID context_id, int i);
+
+    void SubmitFrame(EncTestData *pEncData, Platform_t platform, VAContextID context_id, int i);
+
+    void DestroyFrameBuffers(EncTestData *pEncData, Platform_t platform, int i);
+
+    void SliceSegmentsExecute(EncTestData *pEncData, Platform_t platform);
+
+    void RecreateEncoderExecute(EncTestData *pEncData, Platform_t platform);
+
+    void StatusReportTimeoutExecute(EncTestData *pEncData, Platform_t platform);
+
 protected:
 
     DriverDllLoader     m_driverLoader;
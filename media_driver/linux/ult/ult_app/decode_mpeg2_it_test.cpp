@@ -0,0 +1,131 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <vector>
+#include "gtest/gtest.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+#include "perf_benchmark.h"
+
+using namespace std;
+
+typedef MOS_STATUS (*AddMpeg2SkippedITObjectsFunc)(uint16_t, uint16_t, uint16_t, uint16_t, bool, uint32_t, uint8_t *, uint32_t *);
+
+// Skipped MBs of MPEG-2 IT mode decode are added as one run, only the MB
+// position changes along it. Checks the run against one IT object per MB.
+class DecodeMpeg2ITTest : public testing::Test
+{
+protected:
+
+    static const uint16_t m_widthInMb    = 120;   // 1920x1088
+    static const uint16_t m_heightInMb   = 68;
+    static const uint32_t m_maxCmdSize   = 128;   // Per MB, MFD_IT_OBJECT with MPEG-2 inline data is less
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnAdd = (AddMpeg2SkippedITObjectsFunc)GetUltHook("MhwVdboxMfx_UltAddMpeg2SkippedITObjects");
+    }
+
+    void TearDown() override
+    {
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    vector<uint8_t> Add(uint16_t startMbAddr, uint16_t numMbs, bool perMb, uint32_t loops = 1)
+    {
+        vector<uint8_t> data(numMbs * m_maxCmdSize, 0x5a);
+        uint32_t        size = data.size();
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_pfnAdd(m_widthInMb, m_heightInMb, startMbAddr, numMbs, perMb, loops, data.data(), &size));
+        EXPECT_EQ(0u, size % numMbs);
+        data.resize(size);
+        return data;
+    }
+
+    void ExecuteRunMatchesPerMb(uint16_t startMbAddr, uint16_t numMbs)
+    {
+        vector<uint8_t> run   = Add(startMbAddr, numMbs, false);
+        vector<uint8_t> perMb = Add(startMbAddr, numMbs, true);
+        EXPECT_FALSE(run.empty());
+        EXPECT_EQ(perMb, run) << "start " << startMbAddr << ", MBs " << numMbs;
+    }
+
+    DriverDllLoader                 m_driverLoader;
+    Platform_t                      m_platform          = igfx_MAX;
+    bool                            m_driverInitialized = false;
+    AddMpeg2SkippedITObjectsFunc    m_pfnAdd            = nullptr;
+};
+
+TEST_F(DecodeMpeg2ITTest, RunMatchesPerMb)
+{
+    if (m_pfnAdd == nullptr)
+    {
+        return;
+    }
+
+    ExecuteRunMatchesPerMb(0, 1);
+    ExecuteRunMatchesPerMb(m_widthInMb - 1, 1);
+    ExecuteRunMatchesPerMb(m_widthInMb - 3, 7);
+    ExecuteRunMatchesPerMb(5 * m_widthInMb + 17, 3 * m_widthInMb);
+    ExecuteRunMatchesPerMb(0, m_widthInMb * m_heightInMb);
+}
+
+TEST_F(DecodeMpeg2ITTest, RunWithoutSpaceFails)
+{
+    if (m_pfnAdd == nullptr)
+    {
+        return;
+    }
+
+    uint16_t        numMbs = 16;
+    vector<uint8_t> data   = Add(0, numMbs, false);
+    uint32_t        size   = data.size() - 1;
+    EXPECT_NE(MOS_STATUS_SUCCESS, m_pfnAdd(m_widthInMb, m_heightInMb, 0, numMbs, false, 1, data.data(), &size));
+}
+
+// Reports skipped MBs per CPU second for a picture that is skipped entirely
+TEST_F(DecodeMpeg2ITTest, Benchmark)
+{
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    if (m_pfnAdd == nullptr || !perfBenchmark->IsEnabled())
+    {
+        return;
+    }
+
+    uint16_t numMbs = m_widthInMb * m_heightInMb;
+    uint32_t loops  = perfBenchmark->GetFrameNum();
+
+    perfBenchmark->Begin("Mpeg2SkippedMbRun", igfx_MAX);
+    Add(0, numMbs, false, loops);
+    perfBenchmark->End((uint64_t)numMbs * loops);
+
+    perfBenchmark->Begin("Mpeg2SkippedMbPerMb", igfx_MAX);
+    Add(0, numMbs, true, loops);
+    perfBenchmark->End((uint64_t)numMbs * loops);
+}
@@ -0,0 +1,911 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <vector>
+#include "gtest/gtest.h"
+#include "codechal_decode_vc1.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+#include "perf_benchmark.h"
+
+using namespace std;
+
+#define VC1_TEST_EOS ((uint32_t)(-1))
+
+// NORM-6 tile code table of the VC-1 spec, in the layout of the driver VLC tables
+static const uint32_t Vc1Norm6TileTable[] =
+{
+    13, /* max bits */
+    1,  /* 1-bit codes */
+    1, 0,
+    0,  /* 2-bit codes */
+    0,  /* 3-bit codes */
+    6,  /* 4-bit codes */
+    2, 1,
+    3, 2,
+    4, 4,
+    5, 8,
+
+    6, 16,
+    7, 32,
+    0,  /* 5-bit codes */
+    1,  /* 6-bit codes */
+    (3 << 1) | 1, 63,
+    0,  /* 7-bit codes */
+    15, /* 8-bit codes */
+    0, 3,
+    1, 5,
+    2, 6,
+    3, 9,
+
+    4, 10,
+    5, 12,
+    6, 17,
+    7, 18,
+
+    8, 20,
+    9, 24,
+    10, 33,
+    11, 34,
+
+    12, 36,
+    13, 40,
+    14, 48,
+    6, /* 9-bit codes */
+    (3 << 4) | 7, 31,
+    (3 << 4) | 6, 47,
+    (3 << 4) | 5, 55,
+    (3 << 4) | 4, 59,
+
+    (3 << 4) | 3, 61,
+    (3 << 4) | 2, 62,
+    20, /* 10-bit codes */
+    (1 << 6) | 11, 11,
+    (1 << 6) | 7, 7,
+    (1 << 6) | 13, 13,
+    (1 << 6) | 14, 14,
+
+    (1 << 6) | 19, 19,
+    (1 << 6) | 21, 21,
+    (1 << 6) | 22, 22,
+    (1 << 6) | 25, 25,
+
+    (1 << 6) | 26, 26,
+    (1 << 6) | 28, 28,
+    (1 << 6) | 3, 35,
+    (1 << 6) | 5, 37,
+
+    (1 << 6) | 6, 38,
+    (1 << 6) | 9, 41,
+    (1 << 6) | 10, 42,
+    (1 << 6) | 12, 44,
+
+    (1 << 6) | 17, 49,
+    (1 << 6) | 18, 50,
+    (1 << 6) | 20, 52,
+    (1 << 6) | 24, 56,
+    0,  /* 11-bit codes */
+    0,  /* 12-bit codes */
+    15, /* 13-bit codes */
+    (3 << 8) | 14, 15,
+    (3 << 8) | 13, 23,
+    (3 << 8) | 12, 27,
+    (3 << 8) | 11, 29,
+
+    (3 << 8) | 10, 30,
+    (3 << 8) | 9, 39,
+    (3 << 8) | 8, 43,
+    (3 << 8) | 7, 45,
+
+    (3 << 8) | 6, 46,
+    (3 << 8) | 5, 51,
+    (3 << 8) | 4, 53,
+    (3 << 8) | 3, 54,
+
+    (3 << 8) | 2, 57,
+    (3 << 8) | 1, 58,
+    (3 << 8) | 0, 60,
+    (uint32_t)-1
+};
+
+// Walks the VLC table a bit at a time, the same way GetVLC matches codes
+class RefVlcDecoder
+{
+public:
+
+    RefVlcDecoder(const uint32_t *table) : m_table(table) {}
+
+    // Returns the code length and value of the code at the start of bits,
+    // 0 if it is not in the VLC table
+    uint32_t Decode(const vector<uint8_t> &bits, size_t position, uint32_t &value) const
+    {
+        uint32_t code  = 0;
+        uint32_t index = 1;
+        for (uint32_t codeLength = 1; codeLength <= m_table[0]; codeLength++)
+        {
+            uint8_t bit = (position + codeLength - 1 < bits.size()) ? bits[position + codeLength - 1] : 0;
+            code        = (code << 1) | bit;
+
+            uint32_t subtableSize = m_table[index++];
+            while (subtableSize--)
+            {
+                if (m_table[index] == code)
+                {
+                    value = m_table[index + 1];
+                    return codeLength;
+                }
+                index += 2;
+            }
+        }
+        return 0;
+    }
+
+private:
+
+    const uint32_t *m_table;
+};
+
+// Reads the unescaped bitstream a bit at a time, with the results of the
+// driver reader: a read beyond the end returns EOS and consumes nothing, the
+// processed bit count includes it.
+class RefVc1BitReader
+{
+public:
+
+    RefVc1BitReader(const vector<uint8_t> &bytes) : m_bytes(bytes) {}
+
+    uint32_t GetBits(uint32_t bits)
+    {
+        m_processedBitNum += bits;
+        if (m_position + bits > m_bytes.size() * 8)
+        {
+            return VC1_TEST_EOS;
+        }
+
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bits; i++, m_position++)
+        {
+            value = (value << 1) | ((m_bytes[m_position >> 3] >> (7 - (m_position & 7))) & 1);
+        }
+        return value;
+    }
+
+    bool SkipBits(uint32_t bits)
+    {
+        m_processedBitNum += bits;
+        if (m_position + bits > m_bytes.size() * 8)
+        {
+            return false;
+        }
+        m_position += bits;
+        return true;
+    }
+
+    uint32_t m_processedBitNum = 0;
+
+private:
+
+    const vector<uint8_t> &m_bytes;
+    size_t                m_position = 0;
+};
+
+class RefVc1BitWriter
+{
+public:
+
+    void PutBits(uint32_t value, uint32_t bits)
+    {
+        for (uint32_t i = bits; i > 0; i--)
+        {
+            if ((m_bitNum & 7) == 0)
+            {
+                m_bytes.push_back(0);
+            }
+            m_bytes.back() |= ((value >> (i - 1)) & 1) << (7 - (m_bitNum & 7));
+            m_bitNum++;
+        }
+    }
+
+    vector<uint8_t> m_bytes;
+    uint32_t        m_bitNum = 0;
+};
+
+struct Vc1VlcCode
+{
+    uint32_t code;
+    uint32_t length;
+    uint32_t value;
+};
+
+static vector<Vc1VlcCode> GetTileCodes()
+{
+    vector<Vc1VlcCode> codes;
+    const uint32_t     *table = Vc1Norm6TileTable;
+    uint32_t           index  = 1;
+    for (uint32_t codeLength = 1; codeLength <= table[0]; codeLength++)
+    {
+        uint32_t subtableSize = table[index++];
+        while (subtableSize--)
+        {
+            codes.push_back({table[index], codeLength, table[index + 1]});
+            index += 2;
+        }
+    }
+    EXPECT_EQ((uint32_t)-1, table[index]);
+    return codes;
+}
+
+// Inserts emulation prevention bytes, 0x03 after two zeros followed by 0x00 to 0x03
+static vector<uint8_t> Escape(const vector<uint8_t> &raw)
+{
+    vector<uint8_t> escaped;
+    uint32_t        zeroNum = 0;
+    for (auto data : raw)
+    {
+        if (zeroNum == 2 && data <= 0x03)
+        {
+            escaped.push_back(0x03);
+            zeroNum = 0;
+        }
+        escaped.push_back(data);
+        zeroNum = data ? 0 : zeroNum + 1;
+    }
+    return escaped;
+}
+
+// Removes emulation prevention bytes the way the VC-1 spec defines them, up to
+// the first invalid sequence. 0x000002, 0x000003 not followed by 0x00 to 0x03
+// and three zeros followed by more than 0x01 are invalid.
+static vector<uint8_t> Unescape(const vector<uint8_t> &escaped)
+{
+    vector<uint8_t> raw;
+    uint32_t        zeroNum = 0;
+    for (size_t i = 0; i < escaped.size(); i++)
+    {
+        uint8_t data = escaped[i];
+        if (zeroNum == 2 && data == 0x03)
+        {
+            if (i + 1 == escaped.size() || escaped[i + 1] > 0x03)
+            {
+                break;
+            }
+            data    = escaped[++i];
+            zeroNum = (data == 0);
+        }
+        else if ((zeroNum == 2 && data == 0x02) || (zeroNum > 2 && data > 0x01))
+        {
+            break;
+        }
+        else if (zeroNum > 2 && data == 0x01)
+        {
+            zeroNum = 0;
+        }
+        else
+        {
+            zeroNum = data ? 0 : zeroNum + 1;
+        }
+        raw.push_back(data);
+    }
+    return raw;
+}
+
+class MediaDecodeVc1VlcTest : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        m_codes = GetTileCodes();
+    }
+
+    // Tile codes of random symbols, one bit per byte
+    void PackRandomCodes(uint32_t symbolNum, vector<Vc1VlcCode> &symbols, vector<uint8_t> &bits)
+    {
+        for (uint32_t n = 0; n < symbolNum; n++)
+        {
+            const Vc1VlcCode &symbol = m_codes[rand() % m_codes.size()];
+            symbols.push_back(symbol);
+            for (uint32_t i = symbol.length; i > 0; i--)
+            {
+                bits.push_back((symbol.code >> (i - 1)) & 1);
+            }
+        }
+    }
+
+    // Next max bits of the bitstream, bits beyond the end are read as 0 like PeekBits
+    static uint32_t PeekBits(const vector<uint8_t> &bits, size_t position)
+    {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < CodechalDecodeVc1VlcLengthTable::m_maxBits; i++)
+        {
+            value = (value << 1) | ((position + i < bits.size()) ? bits[position + i] : 0);
+        }
+        return value;
+    }
+
+    vector<Vc1VlcCode> m_codes;
+};
+
+TEST_F(MediaDecodeVc1VlcTest, LengthTableAllWindows)
+{
+    const CodechalDecodeVc1VlcLengthTable lengthTable(Vc1Norm6TileTable);
+    RefVlcDecoder refDecoder(Vc1Norm6TileTable);
+    const uint32_t maxBits = CodechalDecodeVc1VlcLengthTable::m_maxBits;
+
+    uint32_t validNum = 0;
+    vector<uint8_t> bits(maxBits);
+    for (uint32_t window = 0; window < (1u << maxBits); window++)
+    {
+        for (uint32_t i = 0; i < maxBits; i++)
+        {
+            bits[i] = (window >> (maxBits - 1 - i)) & 1;
+        }
+
+        uint32_t value;
+        uint32_t length = refDecoder.Decode(bits, 0, value);
+        ASSERT_EQ(length, lengthTable.m_length[window]) << "window " << window;
+        validNum += (length != 0);
+    }
+
+    // 64 tile patterns are coded, the rest of the 13 bit windows are invalid codes
+    EXPECT_EQ(64u, m_codes.size());
+    EXPECT_LT(validNum, 1u << maxBits);
+}
+
+TEST_F(MediaDecodeVc1VlcTest, SkipRandomTileCodes)
+{
+    const CodechalDecodeVc1VlcLengthTable lengthTable(Vc1Norm6TileTable);
+    RefVlcDecoder refDecoder(Vc1Norm6TileTable);
+
+    vector<Vc1VlcCode> symbols;
+    vector<uint8_t>    bits;
+    srand(1);
+    PackRandomCodes(8192, symbols, bits);
+
+    size_t position = 0;
+    for (size_t n = 0; n < symbols.size(); n++)
+    {
+        uint32_t value;
+        uint32_t refLength = refDecoder.Decode(bits, position, value);
+        ASSERT_EQ(symbols[n].length, refLength) << "symbol " << n;
+        ASSERT_EQ(symbols[n].value, value) << "symbol " << n;
+
+        ASSERT_EQ(refLength, lengthTable.m_length[PeekBits(bits, position)]) << "symbol " << n;
+        position += refLength;
+    }
+    EXPECT_EQ(bits.size(), position);
+}
+
+TEST_F(MediaDecodeVc1VlcTest, BenchmarkSkipTileCodes)
+{
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    if (!perfBenchmark->IsEnabled())
+    {
+        return;
+    }
+
+    // A 1080p NORM-6 bitplane is 40x34 tiles
+    vector<Vc1VlcCode> symbols;
+    vector<uint8_t>    bits;
+    srand(2);
+    PackRandomCodes(40 * 34, symbols, bits);
+
+    vector<uint32_t> windows;
+    size_t position = 0;
+    for (auto &symbol : symbols)
+    {
+        windows.push_back(PeekBits(bits, position));
+        position += symbol.length;
+    }
+
+    // The driver builds the length table once per process
+    const CodechalDecodeVc1VlcLengthTable lengthTable(Vc1Norm6TileTable);
+
+    size_t skipped = 0;
+    perfBenchmark->Begin("SkipVc1TileCodesLookup", igfx_MAX);
+    for (uint32_t n = 0; n < perfBenchmark->GetFrameNum(); n++)
+    {
+        for (auto window : windows)
+        {
+            skipped += lengthTable.m_length[window];
+        }
+    }
+    perfBenchmark->End();
+
+    // The table walk the lookup replaced, for comparison
+    RefVlcDecoder refDecoder(Vc1Norm6TileTable);
+    size_t        walked = 0;
+    perfBenchmark->Begin("SkipVc1TileCodesWalk", igfx_MAX);
+    for (uint32_t n = 0; n < perfBenchmark->GetFrameNum(); n++)
+    {
+        position = 0;
+        for (size_t i = 0; i < symbols.size(); i++)
+        {
+            uint32_t value;
+            position += refDecoder.Decode(bits, position, value);
+        }
+        walked += position;
+    }
+    perfBenchmark->End();
+
+    EXPECT_EQ(walked, skipped);
+    EXPECT_EQ(bits.size() * perfBenchmark->GetFrameNum(), skipped);
+}
+
+// Runs the bitstream reader of a VC1 decode context on host memory through the
+// driver test hook and checks it against the reference reader.
+class MediaDecodeVc1BitstreamTest : public testing::Test
+{
+protected:
+
+    typedef VAStatus (*RunBitstreamOpsFunc)(VADriverContextP ctx, VAContextID context, uint8_t *buffer,
+        uint32_t length, bool isEBDU, PCODECHAL_DECODE_VC1_ULT_OP ops, uint32_t opNum);
+
+    static const uint32_t m_surfaceNum = 8;
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnRunBitstreamOps = (RunBitstreamOpsFunc)GetUltHook("DdiDecodeVc1_UltRunBitstreamOps");
+        if (m_pfnRunBitstreamOps == nullptr)
+        {
+            return;
+        }
+
+        VADriverContextP ctx    = &m_driverLoader.m_ctx;
+        VAConfigAttrib   attrib = {VAConfigAttribDecSliceMode, VA_DEC_SLICE_MODE_NORMAL};
+        ASSERT_EQ(VA_STATUS_SUCCESS, ctx->vtable->vaCreateConfig(ctx, VAProfileVC1Advanced, VAEntrypointVLD,
+            &attrib, 1, &m_configId));
+        ASSERT_EQ(VA_STATUS_SUCCESS, ctx->vtable->vaCreateSurfaces2(ctx, VA_RT_FORMAT_YUV420, 64, 64,
+            m_surfaces, m_surfaceNum, nullptr, 0));
+        m_surfacesCreated = true;
+        ASSERT_EQ(VA_STATUS_SUCCESS, ctx->vtable->vaCreateContext(ctx, m_configId, 64, 64, VA_PROGRESSIVE,
+            m_surfaces, m_surfaceNum, &m_contextId));
+    }
+
+    void TearDown() override
+    {
+        VADriverContextP ctx = &m_driverLoader.m_ctx;
+        if (m_contextId != VA_INVALID_ID)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, ctx->vtable->vaDestroyContext(ctx, m_contextId));
+        }
+        if (m_surfacesCreated)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, ctx->vtable->vaDestroySurfaces(ctx, m_surfaces, m_surfaceNum));
+        }
+        if (m_configId != VA_INVALID_ID)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, ctx->vtable->vaDestroyConfig(ctx, m_configId));
+        }
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    static CODECHAL_DECODE_VC1_ULT_OP Op(CODECHAL_DECODE_VC1_ULT_OP_TYPE type, uint32_t bits,
+        uint16_t widthInMb = 0, uint16_t heightInMb = 0)
+    {
+        CODECHAL_DECODE_VC1_ULT_OP op = {};
+        op.type       = type;
+        op.bits       = bits;
+        op.widthInMb  = widthInMb;
+        op.heightInMb = heightInMb;
+        return op;
+    }
+
+    void RunOps(const vector<uint8_t> &stream, bool isEBDU, vector<CODECHAL_DECODE_VC1_ULT_OP> &ops)
+    {
+        vector<uint8_t> buffer(stream);
+        EXPECT_EQ(VA_STATUS_SUCCESS, m_pfnRunBitstreamOps(&m_driverLoader.m_ctx, m_contextId,
+            buffer.data(), (uint32_t)buffer.size(), isEBDU, ops.data(), (uint32_t)ops.size()));
+    }
+
+    // Reads and skips bits of the stream, the reference reads raw, the stream unescaped.
+    // A failed skip leaves the reader in an unspecified state, the ops after it are not checked.
+    void RunAndCompare(const vector<uint8_t> &stream, bool isEBDU, const vector<uint8_t> &raw,
+        vector<CODECHAL_DECODE_VC1_ULT_OP> &ops, const char *name)
+    {
+        RunOps(stream, isEBDU, ops);
+
+        RefVc1BitReader refReader(raw);
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            if (ops[i].type == CODECHAL_DECODE_VC1_ULT_GET_BITS)
+            {
+                uint32_t value = refReader.GetBits(ops[i].bits);
+                ASSERT_EQ(value, ops[i].value) << name << ", op " << i << " reads " << ops[i].bits;
+                ASSERT_EQ((value == VC1_TEST_EOS) ? MOS_STATUS_UNKNOWN : MOS_STATUS_SUCCESS, ops[i].status)
+                    << name << ", op " << i;
+            }
+            else
+            {
+                bool skipped = refReader.SkipBits(ops[i].bits);
+                ASSERT_EQ(skipped ? MOS_STATUS_SUCCESS : MOS_STATUS_UNKNOWN, ops[i].status)
+                    << name << ", op " << i << " skips " << ops[i].bits;
+                if (!skipped)
+                {
+                    return;
+                }
+            }
+            ASSERT_EQ(refReader.m_processedBitNum, ops[i].processedBitNum) << name << ", op " << i;
+        }
+    }
+
+    // Random reads of 1 to 32 bits up to past the end of the stream
+    static void AddRandomReads(size_t bytes, vector<CODECHAL_DECODE_VC1_ULT_OP> &ops)
+    {
+        size_t bits = 0;
+        while (bits < bytes * 8 + 64)
+        {
+            uint32_t bitsRead = rand() % 32 + 1;
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, bitsRead));
+            bits += bitsRead;
+        }
+    }
+
+    // An EBDU with non-zero runs, zero runs of any length that need emulation
+    // prevention bytes and start codes, raw is the EBDU without the prevention bytes
+    static void BuildEbdu(size_t size, vector<uint8_t> &escaped, vector<uint8_t> &raw)
+    {
+        while (escaped.size() < size)
+        {
+            vector<uint8_t> chunk;
+            uint32_t        runNum = rand() % 8 + 1;
+            for (uint32_t r = 0; r < runNum; r++)
+            {
+                uint32_t runLength = rand() % 64 + 1;
+                bool     zeroRun   = (rand() % 2) == 0;
+                for (uint32_t i = 0; i < runLength; i++)
+                {
+                    chunk.push_back(zeroRun ? 0 : (uint8_t)(rand() % 255 + 1));
+                }
+                // Small values after zeros need an emulation prevention byte
+                chunk.push_back((uint8_t)(rand() % 4));
+            }
+            // End the chunk on a non-zero byte, so it is escaped on its own
+            chunk.push_back(0x80);
+
+            vector<uint8_t> escapedChunk = Escape(chunk);
+            escaped.insert(escaped.end(), escapedChunk.begin(), escapedChunk.end());
+            raw.insert(raw.end(), chunk.begin(), chunk.end());
+
+            if (rand() % 2)
+            {
+                const uint8_t startCode[] = {0x00, 0x00, 0x00, 0x01, 0x0d};
+                const uint8_t *begin      = startCode + (rand() % 2);
+                escaped.insert(escaped.end(), begin, startCode + sizeof(startCode));
+                raw.insert(raw.end(), begin, startCode + sizeof(startCode));
+            }
+        }
+    }
+
+    // NORM-2 coded bitplane, each pair coded as 0, 100, 101 or 11
+    static void CodeNorm2(uint16_t widthInMb, uint16_t heightInMb, RefVc1BitWriter &writer)
+    {
+        static const uint32_t codes[4][2] = {{0, 1}, {4, 3}, {5, 3}, {3, 2}};
+
+        uint32_t count = widthInMb * heightInMb;
+        if (count & 1)
+        {
+            writer.PutBits(rand() & 1, 1);
+            count--;
+        }
+        for (uint32_t i = 0; i < count / 2; i++)
+        {
+            const uint32_t *code = codes[rand() % 4];
+            writer.PutBits(code[0], code[1]);
+        }
+    }
+
+    // NORM-6 coded bitplane with random tiles and residual rows and columns
+    static void CodeNorm6(uint16_t widthInMb, uint16_t heightInMb, const vector<Vc1VlcCode> &codes,
+        RefVc1BitWriter &writer)
+    {
+        bool     is2x3Tiled = (0 != widthInMb % 3) && (0 == heightInMb % 3);
+        uint32_t tileNum    = is2x3Tiled ? (widthInMb / 2) * (heightInMb / 3) : (widthInMb / 3) * (heightInMb / 2);
+        uint32_t residualX  = is2x3Tiled ? (widthInMb & 1) : (widthInMb % 3);
+        uint32_t residualY  = is2x3Tiled ? 0 : (heightInMb & 1);
+
+        for (uint32_t i = 0; i < tileNum; i++)
+        {
+            const Vc1VlcCode &code = codes[rand() % codes.size()];
+            writer.PutBits(code.code, code.length);
+        }
+        for (uint32_t i = 0; i < residualX; i++)
+        {
+            PutSkipBits(heightInMb, writer);
+        }
+        for (uint32_t j = 0; j < residualY; j++)
+        {
+            PutSkipBits(widthInMb - residualX, writer);
+        }
+    }
+
+    // Colskip or rowskip flag, followed by the bits of the line if it is set
+    static void PutSkipBits(uint32_t bits, RefVc1BitWriter &writer)
+    {
+        uint32_t skip = rand() & 1;
+        writer.PutBits(skip, 1);
+        for (uint32_t i = 0; skip && i < bits; i++)
+        {
+            writer.PutBits(rand() & 1, 1);
+        }
+    }
+
+    DriverDllLoader     m_driverLoader;
+    Platform_t          m_platform             = igfx_MAX;
+    bool                m_driverInitialized    = false;
+    RunBitstreamOpsFunc m_pfnRunBitstreamOps   = nullptr;
+    VAConfigID          m_configId             = VA_INVALID_ID;
+    VAContextID         m_contextId            = VA_INVALID_ID;
+    VASurfaceID         m_surfaces[m_surfaceNum];
+    bool                m_surfacesCreated      = false;
+};
+
+// 32 bit reads straddle the end of the 256 byte cache at every bit offset, the
+// 64 bit window is refilled across it
+TEST_F(MediaDecodeVc1BitstreamTest, RefillAcrossCacheBoundary)
+{
+    if (m_pfnRunBitstreamOps == nullptr)
+    {
+        return;
+    }
+
+    vector<uint8_t> stream(1024);
+    srand(1);
+    for (auto &data : stream)
+    {
+        data = (uint8_t)rand();
+    }
+
+    for (uint32_t lead = 1; lead <= 32; lead++)
+    {
+        vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+        ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, lead));
+        for (uint32_t i = 0; i < stream.size() * 8 / 32 + 1; i++)
+        {
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, 32));
+        }
+        RunAndCompare(stream, false, stream, ops, "32 bit reads");
+    }
+
+    for (uint32_t n = 0; n < 16; n++)
+    {
+        vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+        AddRandomReads(stream.size(), ops);
+        RunAndCompare(stream, false, stream, ops, "random reads");
+    }
+}
+
+TEST_F(MediaDecodeVc1BitstreamTest, EbduZeroRuns)
+{
+    if (m_pfnRunBitstreamOps == nullptr)
+    {
+        return;
+    }
+
+    srand(2);
+    for (uint32_t n = 0; n < 32; n++)
+    {
+        vector<uint8_t> escaped, raw;
+        BuildEbdu(2048, escaped, raw);
+
+        // The stream is valid, nothing is truncated
+        ASSERT_EQ(raw, Unescape(escaped));
+        ASSERT_LT(raw.size(), escaped.size());
+
+        vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+        AddRandomReads(raw.size(), ops);
+        RunAndCompare(escaped, true, raw, ops, "EBDU");
+    }
+}
+
+// Bytes before an invalid emulation prevention sequence are read, reads beyond it return EOS
+TEST_F(MediaDecodeVc1BitstreamTest, TruncateAtInvalidEpb)
+{
+    if (m_pfnRunBitstreamOps == nullptr)
+    {
+        return;
+    }
+
+    struct InvalidSequence
+    {
+        vector<uint8_t> bytes;
+        uint32_t        zerosRead;
+    };
+    const InvalidSequence sequences[] =
+    {
+        {{0x00, 0x00, 0x02}, 2},
+        {{0x00, 0x00, 0x03, 0x04}, 2},
+        {{0x00, 0x00, 0x00, 0x05}, 3},
+    };
+    const uint32_t prefixSizes[] = {0, 1, 200, 253, 254, 255, 256, 300};
+
+    srand(3);
+    for (auto &sequence : sequences)
+    {
+        for (auto prefixSize : prefixSizes)
+        {
+            vector<uint8_t> escaped;
+            for (uint32_t i = 0; i < prefixSize; i++)
+            {
+                escaped.push_back((uint8_t)(rand() % 255 + 1));
+            }
+            escaped.insert(escaped.end(), sequence.bytes.begin(), sequence.bytes.end());
+            for (uint32_t i = 0; i < 64; i++)
+            {
+                escaped.push_back((uint8_t)rand());
+            }
+
+            vector<uint8_t> raw = Unescape(escaped);
+            ASSERT_EQ(prefixSize + sequence.zerosRead, raw.size());
+
+            vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+            for (size_t i = 0; i < raw.size() + 2; i++)
+            {
+                ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, 8));
+            }
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, 1));
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_SKIP_BITS, 1));
+            RunAndCompare(escaped, true, raw, ops, "invalid EPB");
+        }
+    }
+
+    // Also at the end of the bitstream, without the byte after 0x03
+    vector<uint8_t> escaped = {0x55, 0x00, 0x00, 0x03};
+    vector<CODECHAL_DECODE_VC1_ULT_OP> ops(4, Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, 8));
+    RunAndCompare(escaped, true, Unescape(escaped), ops, "EPB at the end");
+    EXPECT_EQ(VC1_TEST_EOS, ops[3].value);
+}
+
+TEST_F(MediaDecodeVc1BitstreamTest, SkipBitsAbove32)
+{
+    if (m_pfnRunBitstreamOps == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t skips[] = {33, 40, 56, 63, 64, 65, 100, 255, 256, 2047, 2048, 2049, 4000};
+
+    srand(4);
+    vector<uint8_t> stream(4096);
+    for (auto &data : stream)
+    {
+        data = (uint8_t)rand();
+    }
+    vector<uint8_t> escaped, raw;
+    BuildEbdu(4096, escaped, raw);
+
+    for (uint32_t n = 0; n < 16; n++)
+    {
+        vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+        for (uint32_t i = 0; i < 64; i++)
+        {
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, rand() % 32 + 1));
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_SKIP_BITS, skips[rand() % (sizeof(skips) / sizeof(skips[0]))]));
+        }
+        RunAndCompare(stream, false, stream, ops, "skips");
+        RunAndCompare(escaped, true, raw, ops, "EBDU skips");
+    }
+
+    // Skipping past the end fails
+    vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+    ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, 3));
+    ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_SKIP_BITS, (uint32_t)stream.size() * 8));
+    RunAndCompare(stream, false, stream, ops, "skip past the end");
+    EXPECT_EQ(MOS_STATUS_UNKNOWN, ops[1].status);
+}
+
+// Pairs are consumed in batches from the bit window, the next syntax element
+// must start right after the bitplane
+TEST_F(MediaDecodeVc1BitstreamTest, Norm2Batched)
+{
+    if (m_pfnRunBitstreamOps == nullptr)
+    {
+        return;
+    }
+
+    const uint16_t sizes[][2] = {{1, 1}, {3, 1}, {5, 3}, {8, 8}, {45, 30}, {120, 68}, {121, 67}};
+    const uint32_t marker     = 0x5a5aa5a5;
+
+    srand(5);
+    for (auto &size : sizes)
+    {
+        for (uint32_t n = 0; n < 8; n++)
+        {
+            RefVc1BitWriter writer;
+            CodeNorm2(size[0], size[1], writer);
+            uint32_t bitplaneBits = writer.m_bitNum;
+            writer.PutBits(marker, 32);
+
+            vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_NORM2, 0, size[0], size[1]));
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, 32));
+            RunOps(writer.m_bytes, false, ops);
+
+            ASSERT_EQ(MOS_STATUS_SUCCESS, ops[0].status) << size[0] << "x" << size[1];
+            ASSERT_EQ(bitplaneBits, ops[0].processedBitNum) << size[0] << "x" << size[1];
+            ASSERT_EQ(marker, ops[1].value) << size[0] << "x" << size[1];
+        }
+    }
+
+    // Bitplanes at the end of the bitstream, the last pairs are read a bit at a time
+    for (uint32_t n = 0; n < 64; n++)
+    {
+        RefVc1BitWriter writer;
+        CodeNorm2(7, 5, writer);
+
+        vector<CODECHAL_DECODE_VC1_ULT_OP> ops(1, Op(CODECHAL_DECODE_VC1_ULT_NORM2, 0, 7, 5));
+        RunOps(writer.m_bytes, false, ops);
+        ASSERT_EQ(MOS_STATUS_SUCCESS, ops[0].status) << "bitplane " << n;
+        ASSERT_EQ(writer.m_bitNum, ops[0].processedBitNum) << "bitplane " << n;
+    }
+
+    // A truncated bitplane fails
+    RefVc1BitWriter writer;
+    CodeNorm2(120, 68, writer);
+    writer.m_bytes.resize(writer.m_bytes.size() / 2);
+    vector<CODECHAL_DECODE_VC1_ULT_OP> ops(1, Op(CODECHAL_DECODE_VC1_ULT_NORM2, 0, 120, 68));
+    RunOps(writer.m_bytes, false, ops);
+    EXPECT_NE(MOS_STATUS_SUCCESS, ops[0].status);
+}
+
+// Tile codes are skipped through the length table built from the driver VLC
+// table, which must match the spec table
+TEST_F(MediaDecodeVc1BitstreamTest, Norm6SkipsTileCodes)
+{
+    if (m_pfnRunBitstreamOps == nullptr)
+    {
+        return;
+    }
+
+    const uint16_t           sizes[][2] = {{3, 2}, {8, 9}, {7, 9}, {9, 6}, {121, 67}, {120, 68}};
+    const uint32_t           marker     = 0x5a5aa5a5;
+    const vector<Vc1VlcCode> codes      = GetTileCodes();
+
+    srand(6);
+    for (auto &size : sizes)
+    {
+        for (uint32_t n = 0; n < 8; n++)
+        {
+            RefVc1BitWriter writer;
+            CodeNorm6(size[0], size[1], codes, writer);
+            uint32_t bitplaneBits = writer.m_bitNum;
+            writer.PutBits(marker, 32);
+
+            vector<CODECHAL_DECODE_VC1_ULT_OP> ops;
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_NORM6, 0, size[0], size[1]));
+            ops.push_back(Op(CODECHAL_DECODE_VC1_ULT_GET_BITS, 32));
+            RunOps(writer.m_bytes, false, ops);
+
+            ASSERT_EQ(MOS_STATUS_SUCCESS, ops[0].status) << size[0] << "x" << size[1];
+            ASSERT_EQ(bitplaneBits, ops[0].processedBitNum) << size[0] << "x" << size[1];
+            ASSERT_EQ(marker, ops[1].value) << size[0] << "x" << size[1];
+        }
+    }
+}
@@ -0,0 +1,627 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "codechal_decode_vp8.h"
+#include "codec_def_vp8_probs.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+#include "perf_benchmark.h"
+
+using namespace std;
+
+// Bool encoder of the VP8 spec, writes the frame heads of the test corpus
+class RefVp8BoolEncoder
+{
+public:
+
+    RefVp8BoolEncoder(vector<uint8_t> &buffer) : m_buffer(buffer), m_start(buffer.size()) {}
+
+    void Encode(uint32_t bit, int32_t probability)
+    {
+        uint32_t split = 1 + (((m_range - 1) * probability) >> 8);
+        if (bit)
+        {
+            m_lowValue += split;
+            m_range    -= split;
+        }
+        else
+        {
+            m_range = split;
+        }
+
+        int32_t shift = Norm[m_range];
+        m_range <<= shift;
+        m_count  += shift;
+
+        if (m_count >= 0)
+        {
+            int32_t offset = shift - m_count;
+            if ((m_lowValue << (offset - 1)) & 0x80000000)
+            {
+                // Propagate the carry into the bytes already written
+                size_t x = m_buffer.size();
+                while (x > m_start + 1 && m_buffer[x - 1] == 0xff)
+                {
+                    m_buffer[--x] = 0;
+                }
+                m_buffer[x - 1]++;
+            }
+
+            m_buffer.push_back((uint8_t)(m_lowValue >> (24 - offset)));
+            m_lowValue <<= offset;
+            shift       = m_count;
+            m_lowValue &= 0xffffff;
+            m_count    -= 8;
+        }
+
+        m_lowValue <<= shift;
+    }
+
+    void Flush()
+    {
+        for (int32_t i = 0; i < 32; i++)
+        {
+            Encode(0, 128);
+        }
+    }
+
+private:
+
+    vector<uint8_t> &m_buffer;
+    size_t          m_start;
+    uint32_t        m_lowValue = 0;
+    uint32_t        m_range    = 255;
+    int32_t         m_count    = -24;
+};
+
+// The 32 bit bool decoder the frame head was parsed with before the 64 bit
+// window, refilled after every bool
+class RefVp8BoolDecoder
+{
+public:
+
+    static const uint32_t m_valueSize  = 32;
+    static const int32_t  m_lotsOfBits = 0x40000000;
+
+    RefVp8BoolDecoder(const uint8_t *buffer, const uint8_t *bufferEnd) : m_buffer(buffer), m_bufferEnd(bufferEnd)
+    {
+        Fill();
+    }
+
+    uint32_t Decode(int32_t probability)
+    {
+        uint32_t split    = 1 + (((m_range - 1) * probability) >> 8);
+        uint32_t bigSplit = split << (m_valueSize - 8);
+        uint32_t bit      = 0;
+
+        if (m_value >= bigSplit)
+        {
+            m_range -= split;
+            m_value -= bigSplit;
+            bit      = 1;
+        }
+        else
+        {
+            m_range = split;
+        }
+
+        int32_t shift = Norm[m_range];
+        m_range <<= shift;
+        m_value <<= shift;
+        m_count  -= shift;
+
+        if (m_count < 0)
+        {
+            Fill();
+        }
+
+        return bit;
+    }
+
+    const uint8_t *m_buffer;
+    const uint8_t *m_bufferEnd;
+    int32_t        m_count = -8;
+    uint32_t       m_value = 0;
+    uint32_t       m_range = 255;
+
+private:
+
+    void Fill()
+    {
+        int32_t  shift    = m_valueSize - 8 - (m_count + 8);
+        uint32_t bitsLeft = (uint32_t)(m_bufferEnd - m_buffer) * CHAR_BIT;
+        int32_t  num      = (int32_t)(shift + CHAR_BIT - bitsLeft);
+        int32_t  loopEnd  = 0;
+
+        if (num >= 0)
+        {
+            m_count += m_lotsOfBits;
+            loopEnd  = num;
+        }
+
+        if (num < 0 || bitsLeft)
+        {
+            while (shift >= loopEnd)
+            {
+                m_count += CHAR_BIT;
+                m_value |= (uint32_t)*m_buffer << shift;
+                ++m_buffer;
+                shift -= CHAR_BIT;
+            }
+        }
+    }
+};
+
+// Picks the symbols of a frame head and encodes them. Half probability bools
+// are random, the others (prob and mv updates) are 1 at the update rate.
+class Vp8SymbolWriter
+{
+public:
+
+    Vp8SymbolWriter(RefVp8BoolEncoder &encoder, uint32_t updateRate) : m_encoder(encoder), m_updateRate(updateRate) {}
+
+    uint32_t Bool(int32_t probability)
+    {
+        uint32_t bit = (probability == 128) ? (rand() & 1) : ((uint32_t)(rand() % 100) < m_updateRate);
+        m_encoder.Encode(bit, probability);
+        return bit;
+    }
+
+private:
+
+    RefVp8BoolEncoder &m_encoder;
+    uint32_t          m_updateRate;
+};
+
+class Vp8SymbolReader
+{
+public:
+
+    Vp8SymbolReader(RefVp8BoolDecoder &decoder) : m_decoder(decoder) {}
+
+    uint32_t Bool(int32_t probability)
+    {
+        return m_decoder.Decode(probability);
+    }
+
+private:
+
+    RefVp8BoolDecoder &m_decoder;
+};
+
+template <class Coder>
+int32_t CodeValue(Coder &coder, int32_t bits)
+{
+    int32_t value = 0;
+    for (int32_t i = bits - 1; i >= 0; i--)
+    {
+        value |= coder.Bool(128) << i;
+    }
+    return value;
+}
+
+template <class Coder>
+int32_t CodeSignedValue(Coder &coder, int32_t bits)
+{
+    int32_t value = 0;
+    if (coder.Bool(128))
+    {
+        value = CodeValue(coder, bits);
+        if (coder.Bool(128))
+        {
+            value = -value;
+        }
+    }
+    return value;
+}
+
+// Frame head syntax in the order ParseFrameHead reads it, the writer picks the
+// symbols of the corpus through it and the reference decoder reads them back.
+// The head starts zeroed, as the driver's frame head of a first call.
+template <class Coder>
+void CodeFrameHead(Coder &coder, bool keyFrame, CODECHAL_DECODE_VP8_FRAME_HEAD &head)
+{
+    if (keyFrame)
+    {
+        memcpy(head.FrameContext.CoefProbs, DefaultCoefProbs, sizeof(DefaultCoefProbs));
+        coder.Bool(128);  // Color Space
+        coder.Bool(128);  // Clamp Type
+    }
+
+    head.u8SegmentationEnabled = (uint8_t)coder.Bool(128);
+    if (head.u8SegmentationEnabled)
+    {
+        head.u8UpdateMbSegmentationMap  = (uint8_t)coder.Bool(128);
+        head.u8UpdateMbSegmentationData = (uint8_t)coder.Bool(128);
+
+        if (head.u8UpdateMbSegmentationData)
+        {
+            head.u8MbSegementAbsDelta = (uint8_t)coder.Bool(128);
+            for (int32_t i = 0; i < VP8_MB_LVL_MAX; i++)
+            {
+                for (int32_t j = 0; j < VP8_MAX_MB_SEGMENTS; j++)
+                {
+                    head.SegmentFeatureData[i][j] = (int8_t)CodeSignedValue(coder, MbFeatureDataBits[i]);
+                }
+            }
+        }
+
+        if (head.u8UpdateMbSegmentationMap)
+        {
+            for (int32_t i = 0; i < VP8_MB_SEGMENT_TREE_PROBS; i++)
+            {
+                head.MbSegmentTreeProbs[i] = coder.Bool(128) ? (uint8_t)CodeValue(coder, 8) : 255;
+            }
+        }
+    }
+
+    head.FilterType      = (VP8_LF_TYPE)coder.Bool(128);
+    head.iFilterLevel    = CodeValue(coder, 6);
+    head.iSharpnessLevel = CodeValue(coder, 3);
+
+    head.u8ModeRefLfDeltaEnabled = (uint8_t)coder.Bool(128);
+    if (head.u8ModeRefLfDeltaEnabled)
+    {
+        head.u8ModeRefLfDeltaUpdate = (uint8_t)coder.Bool(128);
+        if (head.u8ModeRefLfDeltaUpdate)
+        {
+            for (int32_t i = 0; i < VP8_MAX_REF_LF_DELTAS; i++)
+            {
+                head.RefLFDeltas[i] = (int8_t)CodeSignedValue(coder, 6);
+            }
+            for (int32_t i = 0; i < VP8_MAX_MODE_LF_DELTAS; i++)
+            {
+                head.ModeLFDeltas[i] = (int8_t)CodeSignedValue(coder, 6);
+            }
+        }
+    }
+
+    head.MultiTokenPartition = (VP8_TOKEN_PARTITION)CodeValue(coder, 2);
+
+    head.iBaseQIndex = CodeValue(coder, 7);
+    head.iY1DcDeltaQ = CodeSignedValue(coder, 4);
+    head.iY2DcDeltaQ = CodeSignedValue(coder, 4);
+    head.iY2AcDeltaQ = CodeSignedValue(coder, 4);
+    head.iUVDcDeltaQ = CodeSignedValue(coder, 4);
+    head.iUVAcDeltaQ = CodeSignedValue(coder, 4);
+
+    if (!keyFrame)
+    {
+        head.iRefreshGoldenFrame = coder.Bool(128);
+        head.iRefreshAltFrame    = coder.Bool(128);
+        if (!head.iRefreshGoldenFrame)
+        {
+            head.iCopyBufferToGolden = CodeValue(coder, 2);
+        }
+        if (!head.iRefreshAltFrame)
+        {
+            head.iCopyBufferToAlt = CodeValue(coder, 2);
+        }
+        head.RefFrameSignBias[VP8_GOLDEN_FRAME] = coder.Bool(128);
+        head.RefFrameSignBias[VP8_ALTREF_FRAME] = coder.Bool(128);
+    }
+
+    head.iRefreshEntropyProbs = coder.Bool(128);
+    head.iRefreshLastFrame    = keyFrame || coder.Bool(128);
+
+    const uint8_t *upProb = &CoefUpdateProbs[0][0][0][0];
+    uint8_t       *prob   = &head.FrameContext.CoefProbs[0][0][0][0];
+    for (uint32_t i = 0; i < sizeof(CoefUpdateProbs); i++)
+    {
+        if (coder.Bool(upProb[i]))
+        {
+            prob[i] = (uint8_t)CodeValue(coder, 8);
+        }
+    }
+
+    head.iMbNoCoeffSkip = coder.Bool(128);
+    if (head.iMbNoCoeffSkip)
+    {
+        head.iProbSkipFalse = CodeValue(coder, 8);
+    }
+
+    if (!keyFrame)
+    {
+        head.ProbIntra = (uint8_t)CodeValue(coder, 8);
+        head.ProbLast  = (uint8_t)CodeValue(coder, 8);
+        head.ProbGf    = (uint8_t)CodeValue(coder, 8);
+
+        if (coder.Bool(128))
+        {
+            for (int32_t i = 0; i < 4; i++)
+            {
+                head.YModeProbs[i] = (uint8_t)CodeValue(coder, 8);
+            }
+        }
+        if (coder.Bool(128))
+        {
+            for (int32_t i = 0; i < 3; i++)
+            {
+                head.UVModeProbs[i] = (uint8_t)CodeValue(coder, 8);
+            }
+        }
+
+        for (int32_t i = 0; i < 2; i++)
+        {
+            for (int32_t j = 0; j < 19; j++)
+            {
+                if (coder.Bool(MvUpdateProbs[i].MvProb[j]))
+                {
+                    CodeValue(coder, 7);
+                }
+            }
+        }
+    }
+}
+
+typedef MOS_STATUS (*ParseFrameHeadFunc)(uint8_t *, uint32_t, PCODECHAL_DECODE_VP8_FRAME_HEAD, PCODEC_VP8_PIC_PARAMS);
+
+class MediaDecodeVp8BoolTest : public testing::Test
+{
+protected:
+
+    struct Vp8Frame
+    {
+        vector<uint8_t> bitstream;
+        bool            keyFrame;
+        uint32_t        firstPartitionSize;
+    };
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnParseFrameHead = (ParseFrameHeadFunc)GetUltHook("CodecHalDecodeVp8_UltParseFrameHead");
+    }
+
+    void TearDown() override
+    {
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    // A frame with a random frame head, random macroblock data behind it in the
+    // first partition and random token partitions
+    static void BuildFrame(bool keyFrame, uint32_t updateRate, Vp8Frame &frame)
+    {
+        vector<uint8_t> &bitstream = frame.bitstream;
+        uint32_t        uncompSize = keyFrame ? 10 : 3;
+        bitstream.assign(uncompSize, 0);
+
+        CODECHAL_DECODE_VP8_FRAME_HEAD head;
+        memset(&head, 0, sizeof(head));
+        RefVp8BoolEncoder encoder(bitstream);
+        Vp8SymbolWriter   writer(encoder, updateRate);
+        CodeFrameHead(writer, keyFrame, head);
+        for (int32_t i = 0; i < 64; i++)
+        {
+            encoder.Encode(rand() & 1, rand() % 255 + 1);
+        }
+        encoder.Flush();
+
+        frame.keyFrame           = keyFrame;
+        frame.firstPartitionSize = (uint32_t)bitstream.size() - uncompSize;
+
+        // Frame tag with the show frame flag
+        uint32_t tag = (keyFrame ? 0 : 1) | (1 << 4) | (frame.firstPartitionSize << 5);
+        bitstream[0] = (uint8_t)tag;
+        bitstream[1] = (uint8_t)(tag >> 8);
+        bitstream[2] = (uint8_t)(tag >> 16);
+        if (keyFrame)
+        {
+            const uint8_t startCodeAndSize[] = { 0x9d, 0x01, 0x2a, 0x80, 0x07, 0x38, 0x04 };
+            memcpy(&bitstream[3], startCodeAndSize, sizeof(startCodeAndSize));
+        }
+
+        // Sizes of all token partitions but the last follow the first partition
+        uint32_t partitionNum = 1 << head.MultiTokenPartition;
+        vector<uint32_t> partitionSizes;
+        for (uint32_t i = 0; i < partitionNum; i++)
+        {
+            partitionSizes.push_back(16 + rand() % 64);
+        }
+        for (uint32_t i = 0; i < partitionNum - 1; i++)
+        {
+            bitstream.push_back((uint8_t)partitionSizes[i]);
+            bitstream.push_back((uint8_t)(partitionSizes[i] >> 8));
+            bitstream.push_back((uint8_t)(partitionSizes[i] >> 16));
+        }
+        for (uint32_t i = 0; i < partitionNum; i++)
+        {
+            for (uint32_t j = 0; j < partitionSizes[i]; j++)
+            {
+                bitstream.push_back((uint8_t)rand());
+            }
+        }
+    }
+
+    // Parses the frame head with the 32 bit decoder and computes the pic params
+    // the driver exported with it
+    static void RefParseFrameHead(const Vp8Frame &frame, CODECHAL_DECODE_VP8_FRAME_HEAD &head, CODEC_VP8_PIC_PARAMS &picParams)
+    {
+        const uint8_t *bitstream  = frame.bitstream.data();
+        uint32_t       uncompSize = frame.keyFrame ? 10 : 3;
+
+        memset(&head, 0, sizeof(head));
+        RefVp8BoolDecoder decoder(bitstream + uncompSize, bitstream + frame.bitstream.size());
+        Vp8SymbolReader   reader(decoder);
+        CodeFrameHead(reader, frame.keyFrame, head);
+
+        picParams.ucP0EntropyCount = 8 - (decoder.m_count & 0x07);
+        picParams.ucP0EntropyValue = (uint8_t)(decoder.m_value >> 24);
+        picParams.uiP0EntropyRange = decoder.m_range;
+
+        uint32_t firstPartitionAndUncompSize = frame.firstPartitionSize + uncompSize;
+        uint32_t partitionNum                = 1 << head.MultiTokenPartition;
+        uint32_t partitionSizeSum            = 0;
+        const uint8_t *sizes                 = bitstream + firstPartitionAndUncompSize;
+        for (uint32_t i = 1; i < partitionNum; i++)
+        {
+            picParams.uiPartitionSize[i] = sizes[0] + (sizes[1] << 8) + (sizes[2] << 16);
+            sizes += 3;
+            partitionSizeSum += picParams.uiPartitionSize[i];
+        }
+
+        uint32_t consumed      = (uint32_t)(decoder.m_buffer - bitstream);
+        uint32_t offsetCounter = ((decoder.m_count & 0x18) >> 3) + (((decoder.m_count & 0x07) != 0) ? 1 : 0);
+        picParams.uiFirstMbByteOffset           = consumed - offsetCounter;
+        picParams.uiPartitionSize[0]            = firstPartitionAndUncompSize - consumed + offsetCounter;
+        picParams.uiPartitionSize[partitionNum] = (uint32_t)frame.bitstream.size() - firstPartitionAndUncompSize -
+            (partitionNum - 1) * 3 - partitionSizeSum;
+    }
+
+    MOS_STATUS ParseFrameHead(Vp8Frame &frame, CODECHAL_DECODE_VP8_FRAME_HEAD &head, CODEC_VP8_PIC_PARAMS &picParams)
+    {
+        memset(&head, 0, sizeof(head));
+        memset(&picParams, 0, sizeof(picParams));
+        picParams.uiFirstPartitionSize = frame.firstPartitionSize;
+        return m_pfnParseFrameHead(frame.bitstream.data(), (uint32_t)frame.bitstream.size(), &head, &picParams);
+    }
+
+    DriverDllLoader    m_driverLoader;
+    Platform_t         m_platform          = igfx_MAX;
+    bool               m_driverInitialized = false;
+    ParseFrameHeadFunc m_pfnParseFrameHead = nullptr;
+};
+
+// Frame heads with few to all coefficient probs updated are parsed by the
+// driver and by the previous 32 bit decoder, decoded symbols and the entropy
+// state exported to the HW must match bit for bit.
+TEST_F(MediaDecodeVp8BoolTest, ParseFrameHeadMatches32BitDecoder)
+{
+    if (m_pfnParseFrameHead == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t updateRates[] = { 0, 5, 50, 100 };
+    const uint32_t frameNum      = 256;
+
+    srand(1);
+    for (auto updateRate : updateRates)
+    {
+        for (uint32_t n = 0; n < frameNum; n++)
+        {
+            Vp8Frame frame;
+            BuildFrame((n & 1) == 0, updateRate, frame);
+
+            CODECHAL_DECODE_VP8_FRAME_HEAD refHead;
+            CODEC_VP8_PIC_PARAMS           refPicParams;
+            memset(&refPicParams, 0, sizeof(refPicParams));
+            RefParseFrameHead(frame, refHead, refPicParams);
+
+            CODECHAL_DECODE_VP8_FRAME_HEAD head;
+            CODEC_VP8_PIC_PARAMS           picParams;
+            ASSERT_EQ(MOS_STATUS_SUCCESS, ParseFrameHead(frame, head, picParams));
+
+            uint32_t partitionNum = 1 << refHead.MultiTokenPartition;
+            ASSERT_EQ(refHead.MultiTokenPartition, head.MultiTokenPartition) << "update rate " << updateRate << ", frame " << n;
+            ASSERT_EQ(0, memcmp(refHead.FrameContext.CoefProbs, head.FrameContext.CoefProbs, sizeof(head.FrameContext.CoefProbs)))
+                << "update rate " << updateRate << ", frame " << n;
+            ASSERT_EQ(0, memcmp(refHead.SegmentFeatureData, head.SegmentFeatureData, sizeof(head.SegmentFeatureData)))
+                << "update rate " << updateRate << ", frame " << n;
+            ASSERT_EQ(0, memcmp(refHead.RefLFDeltas, head.RefLFDeltas, sizeof(head.RefLFDeltas)))
+                << "update rate " << updateRate << ", frame " << n;
+            ASSERT_EQ(0, memcmp(refHead.ModeLFDeltas, head.ModeLFDeltas, sizeof(head.ModeLFDeltas)))
+                << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iFilterLevel, head.iFilterLevel) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iSharpnessLevel, head.iSharpnessLevel) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iBaseQIndex, head.iBaseQIndex) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iUVAcDeltaQ, head.iUVAcDeltaQ) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iRefreshEntropyProbs, head.iRefreshEntropyProbs) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iRefreshLastFrame, head.iRefreshLastFrame) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iMbNoCoeffSkip, head.iMbNoCoeffSkip) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refHead.iProbSkipFalse, head.iProbSkipFalse) << "update rate " << updateRate << ", frame " << n;
+            if (!frame.keyFrame)
+            {
+                EXPECT_EQ(refHead.ProbGf, head.ProbGf) << "update rate " << updateRate << ", frame " << n;
+                EXPECT_EQ(0, memcmp(refHead.UVModeProbs, head.UVModeProbs, sizeof(head.UVModeProbs)))
+                    << "update rate " << updateRate << ", frame " << n;
+            }
+
+            EXPECT_EQ(refPicParams.ucP0EntropyCount, picParams.ucP0EntropyCount) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refPicParams.ucP0EntropyValue, picParams.ucP0EntropyValue) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refPicParams.uiP0EntropyRange, picParams.uiP0EntropyRange) << "update rate " << updateRate << ", frame " << n;
+            EXPECT_EQ(refPicParams.uiFirstMbByteOffset, picParams.uiFirstMbByteOffset) << "update rate " << updateRate << ", frame " << n;
+            for (uint32_t i = 0; i <= partitionNum; i++)
+            {
+                EXPECT_EQ(refPicParams.uiPartitionSize[i], picParams.uiPartitionSize[i])
+                    << "update rate " << updateRate << ", frame " << n << ", partition " << i;
+            }
+        }
+    }
+}
+
+TEST_F(MediaDecodeVp8BoolTest, BenchmarkParseFrameHead)
+{
+    if (m_pfnParseFrameHead == nullptr)
+    {
+        return;
+    }
+
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    if (!perfBenchmark->IsEnabled())
+    {
+        return;
+    }
+
+    // Key and inter frames with half of the coefficient probs updated
+    const uint32_t   corpusNum = 64;
+    vector<Vp8Frame> frames(corpusNum);
+    srand(2);
+    for (uint32_t n = 0; n < corpusNum; n++)
+    {
+        BuildFrame((n & 1) == 0, 50, frames[n]);
+    }
+
+    CODECHAL_DECODE_VP8_FRAME_HEAD head;
+    CODEC_VP8_PIC_PARAMS           picParams;
+    uint32_t                       entropyRangeSum = 0;
+    perfBenchmark->Begin("ParseVp8FrameHead", igfx_MAX);
+    for (uint32_t n = 0; n < perfBenchmark->GetFrameNum(); n++)
+    {
+        ParseFrameHead(frames[n % corpusNum], head, picParams);
+        entropyRangeSum += picParams.uiP0EntropyRange;
+    }
+    perfBenchmark->End();
+
+    // The previous 32 bit decoder on the same frames, for comparison
+    CODEC_VP8_PIC_PARAMS refPicParams;
+    uint32_t             refEntropyRangeSum = 0;
+    perfBenchmark->Begin("ParseVp8FrameHead32BitRef", igfx_MAX);
+    for (uint32_t n = 0; n < perfBenchmark->GetFrameNum(); n++)
+    {
+        RefParseFrameHead(frames[n % corpusNum], head, refPicParams);
+        refEntropyRangeSum += refPicParams.uiP0EntropyRange;
+    }
+    perfBenchmark->End();
+
+    EXPECT_EQ(refEntropyRangeSum, entropyRangeSum);
+}
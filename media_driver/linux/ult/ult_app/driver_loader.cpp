@@ -40,6 +40,17 @@ const char *g_platformName[] = {
     "CNL",
 };
 
+void *GetUltHook(const char *name)
+{
+    void *hook = dlsym(RTLD_DEFAULT, name);
+    if (hook == nullptr)
+    {
+        // Release drivers only export the hooks if built with MEDIA_ULT_HOOKS
+        printf("[  SKIPPED ] %s is not exported by the driver.\n", name);
+    }
+    return hook;
+}
+
 DriverDllLoader::DriverDllLoader()
 {
     if (g_dirverPath)
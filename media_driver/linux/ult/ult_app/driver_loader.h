@@ -77,6 +77,12 @@ typedef int32_t (*MOS_GetMemNinjaCounterFunc)();
 
 typedef void (*UltGetCmdBufFunc)(PMOS_COMMAND_BUFFER pCmdBuffer);
 
+//!
+//! \brief    Looks up a test hook of the loaded driver, returns nullptr and
+//!           notes the test as skipped if the driver does not export it
+//!
+void *GetUltHook(const char *name);
+
 struct DriverSymbols
 {
     DriverSymbols()
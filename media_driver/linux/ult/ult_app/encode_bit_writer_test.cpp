@@ -0,0 +1,447 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <vector>
+#include "gtest/gtest.h"
+#include "codechal_encode_avc_base.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+#include "perf_benchmark.h"
+
+using namespace std;
+
+// The header bit writer is header only, so it is checked on host memory
+// against a bit at a time reference writer.
+class RefBitWriter
+{
+public:
+
+    void PutBits(uint32_t code, uint32_t length)
+    {
+        for (uint32_t i = length; i > 0; i--)
+        {
+            m_bits.push_back((code >> (i - 1)) & 1);
+        }
+    }
+
+    void PutVLCCode(uint32_t code)
+    {
+        uint64_t codeNum         = (uint64_t)code + 1;
+        uint32_t leadingZeroBits = 0;
+        while ((codeNum >> (leadingZeroBits + 1)) != 0)
+        {
+            leadingZeroBits++;
+        }
+        PutBits(0, leadingZeroBits);
+        for (uint32_t i = leadingZeroBits + 1; i > 0; i--)
+        {
+            m_bits.push_back((codeNum >> (i - 1)) & 1);
+        }
+    }
+
+    vector<uint8_t> GetBytes() const
+    {
+        vector<uint8_t> bytes((m_bits.size() + 7) / 8, 0);
+        for (size_t i = 0; i < m_bits.size(); i++)
+        {
+            bytes[i / 8] |= m_bits[i] << (7 - (i % 8));
+        }
+        return bytes;
+    }
+
+    size_t GetBitSize() const { return m_bits.size(); }
+
+private:
+
+    vector<uint8_t> m_bits;
+};
+
+class MediaEncodeBitWriterTest : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        m_buffer.assign(1 << 16, 0xa5);
+        MOS_ZeroMemory(&m_bsBuffer, sizeof(m_bsBuffer));
+        m_bsBuffer.pBase      = m_buffer.data();
+        m_bsBuffer.pCurrent   = m_buffer.data();
+        m_bsBuffer.BufferSize = (uint32_t)m_buffer.size();
+        *m_bsBuffer.pCurrent  = 0;
+    }
+
+    void CompareWithReference(const char *name)
+    {
+        size_t bitSize = (m_bsBuffer.pCurrent - m_bsBuffer.pBase) * 8 + m_bsBuffer.BitOffset;
+        ASSERT_EQ(m_ref.GetBitSize(), bitSize) << name;
+
+        vector<uint8_t> expected = m_ref.GetBytes();
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            ASSERT_EQ(expected[i], m_buffer[i]) << name << ", byte " << i;
+        }
+
+        // the current byte is kept clear past the written bits
+        if (m_bsBuffer.BitOffset == 0)
+        {
+            ASSERT_EQ(0, *m_bsBuffer.pCurrent) << name;
+        }
+    }
+
+    vector<uint8_t> m_buffer;
+    BSBuffer        m_bsBuffer;
+    RefBitWriter    m_ref;
+};
+
+TEST_F(MediaEncodeBitWriterTest, PutBitsAllLengths)
+{
+    srand(1);
+    for (uint32_t n = 0; n < 4096; n++)
+    {
+        uint32_t code   = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        uint32_t length = n % 33;
+
+        PutBits(&m_bsBuffer, code, length);
+        m_ref.PutBits(code, length);
+        if (n % 7 == 0)
+        {
+            PutBit(&m_bsBuffer, code);
+            m_ref.PutBits(code, 1);
+        }
+    }
+
+    CompareWithReference("PutBitsAllLengths");
+}
+
+TEST_F(MediaEncodeBitWriterTest, PutVLCCodeBoundaries)
+{
+    const uint32_t codes[] = {0, 1, 2, 3, 6, 7, 14, 254, 255, 0x7fff, 0xfffe, 0xffff, 0x10000,
+        0x1fffe, 0x1ffff, 0x7fffffff, 0xfffffffe};
+
+    // odd bit offsets so codes straddle bytes
+    for (uint32_t offset = 0; offset < 8; offset++)
+    {
+        PutBits(&m_bsBuffer, 0x55, offset);
+        m_ref.PutBits(0x55, offset);
+        for (auto code : codes)
+        {
+            PutVLCCode(&m_bsBuffer, code);
+            m_ref.PutVLCCode(code);
+        }
+    }
+
+    CompareWithReference("PutVLCCodeBoundaries");
+}
+
+TEST_F(MediaEncodeBitWriterTest, PutVLCCodeRandom)
+{
+    srand(2);
+    for (uint32_t n = 0; n < 4096; n++)
+    {
+        uint32_t code = (((uint32_t)rand() << 16) ^ (uint32_t)rand()) >> (rand() % 32);
+        code = MOS_MIN(code, 0xfffffffe);
+
+        PutVLCCode(&m_bsBuffer, code);
+        m_ref.PutVLCCode(code);
+    }
+
+    CompareWithReference("PutVLCCodeRandom");
+}
+
+TEST_F(MediaEncodeBitWriterTest, PutBitString)
+{
+    vector<uint8_t> source(512);
+    srand(3);
+    for (auto &byte : source)
+    {
+        byte = (uint8_t)rand();
+    }
+
+    for (uint32_t n = 0; n < 64; n++)
+    {
+        uint32_t bitOffset = rand() % 64;
+        uint32_t bitSize   = rand() % 1024;
+
+        PutBitString(&m_bsBuffer, source.data(), bitOffset, bitSize);
+        for (uint32_t i = bitOffset; i < bitOffset + bitSize; i++)
+        {
+            m_ref.PutBits(source[i / 8] >> (7 - (i % 8)), 1);
+        }
+    }
+
+    CompareWithReference("PutBitString");
+}
+
+// Fields of a typical P slice header after first_mb_in_slice
+static void PackSliceHeaderFields(BSBuffer *bsBuffer, uint32_t slice)
+{
+    PutVLCCode(bsBuffer, slice * 120);
+    PutVLCCode(bsBuffer, 5);
+    PutVLCCode(bsBuffer, 0);
+    PutBits(bsBuffer, slice & 0xff, 8);
+    PutBits(bsBuffer, 0x1234, 16);
+    PutBit(bsBuffer, 1);
+    PutVLCCode(bsBuffer, 2);
+    PutBit(bsBuffer, 0);
+    PutBit(bsBuffer, 0);
+    PutVLCCode(bsBuffer, 0);
+    PutVLCCode(bsBuffer, 4);
+    PutVLCCode(bsBuffer, 0);
+}
+
+TEST_F(MediaEncodeBitWriterTest, PutSliceHeaderFieldSequence)
+{
+    const uint32_t numSlices = 68;
+
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    uint32_t frames = perfBenchmark->IsEnabled() ? perfBenchmark->GetFrameNum() : 1;
+
+    if (perfBenchmark->IsEnabled())
+    {
+        perfBenchmark->Begin("PutAvcSliceHeaderFields", igfx_MAX);
+    }
+    for (uint32_t n = 0; n < frames; n++)
+    {
+        m_bsBuffer.pCurrent  = m_bsBuffer.pBase;
+        m_bsBuffer.BitOffset = 0;
+        *m_bsBuffer.pCurrent = 0;
+        for (uint32_t slice = 0; slice < numSlices; slice++)
+        {
+            PackSliceHeaderFields(&m_bsBuffer, slice);
+        }
+    }
+    perfBenchmark->End();
+
+    for (uint32_t slice = 0; slice < numSlices; slice++)
+    {
+        m_ref.PutVLCCode(slice * 120);
+        m_ref.PutVLCCode(5);
+        m_ref.PutVLCCode(0);
+        m_ref.PutBits(slice & 0xff, 8);
+        m_ref.PutBits(0x1234, 16);
+        m_ref.PutBits(1, 1);
+        m_ref.PutVLCCode(2);
+        m_ref.PutBits(0, 2);
+        m_ref.PutVLCCode(0);
+        m_ref.PutVLCCode(4);
+        m_ref.PutVLCCode(0);
+    }
+
+    CompareWithReference("PutSliceHeaderFieldSequence");
+}
+
+typedef MOS_STATUS (*PackSliceHeaderFunc)(PCODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS params);
+
+// Slice headers are packed by the driver, it is loaded to reach the exported
+// packing function. Headers packed with the slice header template must match
+// the ones packed field by field.
+class MediaEncodeSliceHeaderTest : public testing::Test
+{
+protected:
+
+    static const uint32_t m_numSlices = 8;
+    static const uint32_t m_numFrameStores = 3;
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnPackSliceHeader = (PackSliceHeaderFunc)GetUltHook("CodecHalAvcEncode_UltPackSliceHeader");
+
+        MOS_ZeroMemory(&m_seqParams, sizeof(m_seqParams));
+        m_seqParams.log2_max_frame_num_minus4         = 0;
+        m_seqParams.pic_order_cnt_type                = 0;
+        m_seqParams.log2_max_pic_order_cnt_lsb_minus4 = 2;
+        m_seqParams.frame_mbs_only_flag               = 1;
+
+        MOS_ZeroMemory(&m_picParams, sizeof(m_picParams));
+        m_picParams.entropy_coding_mode_flag               = 1;
+        m_picParams.deblocking_filter_control_present_flag = 1;
+
+        // Current picture in frame store 0, references in 1 and 2
+        for (uint32_t i = 0; i < m_numFrameStores; i++)
+        {
+            MOS_ZeroMemory(&m_refList[i], sizeof(m_refList[i]));
+            m_ppRefList[i] = &m_refList[i];
+        }
+        m_refList[0].sFrameNumber = 3;
+        m_refList[0].bUsedAsRef   = true;
+        m_refList[1].sFrameNumber = 1;
+        m_refList[2].sFrameNumber = 2;
+
+        // P slices listing the references in frame number order, so the
+        // lists are reordered. One slice in the middle breaks the template.
+        for (uint32_t i = 0; i < m_numSlices; i++)
+        {
+            CODEC_AVC_ENCODE_SLICE_PARAMS &slice = m_slices[i];
+            MOS_ZeroMemory(&slice, sizeof(slice));
+            slice.first_mb_in_slice                 = i * 40;
+            slice.NumMbsForSlice                    = 40;
+            slice.slice_id                          = i;
+            slice.slice_type                        = 0;
+            slice.frame_num                         = 3;
+            slice.pic_order_cnt_lsb                 = 6;
+            slice.MaxFrameNum                       = 16;
+            slice.num_ref_idx_active_override_flag  = 1;
+            slice.num_ref_idx_l0_active_minus1      = 1;
+            slice.PicOrder[0][0].Picture            = {1, PICTURE_FRAME, 0};
+            slice.PicOrder[0][1].Picture            = {2, PICTURE_FRAME, 0};
+            slice.cabac_init_idc                    = (i == 5) ? 2 : 0;
+            slice.slice_qp_delta                    = (char)i - 4;
+            slice.disable_deblocking_filter_idc     = i & 1;
+            slice.slice_alpha_c0_offset_div2        = 1;
+            slice.slice_beta_offset_div2            = -1;
+        }
+    }
+
+    void TearDown() override
+    {
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    class Bitstream
+    {
+    public:
+
+        Bitstream()
+        {
+            m_buffer.assign(1 << 16, 0xa5);
+            MOS_ZeroMemory(&m_bsBuffer, sizeof(m_bsBuffer));
+            m_bsBuffer.pBase      = m_buffer.data();
+            m_bsBuffer.pCurrent   = m_buffer.data();
+            m_bsBuffer.BufferSize = (uint32_t)m_buffer.size();
+            *m_bsBuffer.pCurrent  = 0;
+        }
+
+        bool operator==(const Bitstream &other) const
+        {
+            size_t size = m_bsBuffer.pCurrent - m_bsBuffer.pBase + 1;
+            return (size == (size_t)(other.m_bsBuffer.pCurrent - other.m_bsBuffer.pBase + 1)) &&
+                m_bsBuffer.BitOffset   == other.m_bsBuffer.BitOffset   &&
+                m_bsBuffer.BitSize     == other.m_bsBuffer.BitSize     &&
+                m_bsBuffer.SliceOffset == other.m_bsBuffer.SliceOffset &&
+                memcmp(m_bsBuffer.pBase, other.m_bsBuffer.pBase, size) == 0;
+        }
+
+        vector<uint8_t> m_buffer;
+        BSBuffer        m_bsBuffer;
+    };
+
+    // Packs the slices of a frame, with the template if given
+    void PackFrame(Bitstream &bitstream, PCODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE sliceHeaderTemplate)
+    {
+        for (uint32_t i = 0; i < m_numSlices; i++)
+        {
+            // packing updates the reference lists of the slice
+            CODEC_AVC_ENCODE_SLICE_PARAMS slice = m_slices[i];
+
+            CODECHAL_ENCODE_AVC_PACK_SLC_HEADER_PARAMS params;
+            MOS_ZeroMemory(&params, sizeof(params));
+            params.pBsBuffer            = &bitstream.m_bsBuffer;
+            params.pPicParams           = &m_picParams;
+            params.pSeqParams           = &m_seqParams;
+            params.pAvcSliceParams      = &slice;
+            params.ppRefList            = m_ppRefList;
+            params.CurrPic              = {0, PICTURE_FRAME, 0};
+            params.CurrReconPic         = {0, PICTURE_FRAME, 0};
+            params.NalUnitType          = CODECHAL_ENCODE_AVC_NAL_UT_SLICE;
+            params.wPictureCodingType   = P_TYPE;
+            params.pSliceHeaderTemplate = sliceHeaderTemplate;
+            ASSERT_EQ(MOS_STATUS_SUCCESS, m_pfnPackSliceHeader(&params)) << "slice " << i;
+        }
+    }
+
+    DriverDllLoader                             m_driverLoader;
+    Platform_t                                  m_platform          = igfx_MAX;
+    bool                                        m_driverInitialized = false;
+    PackSliceHeaderFunc                         m_pfnPackSliceHeader = nullptr;
+    CODEC_AVC_ENCODE_SEQUENCE_PARAMS            m_seqParams;
+    CODEC_AVC_ENCODE_PIC_PARAMS                 m_picParams;
+    CODEC_REF_LIST                              m_refList[m_numFrameStores];
+    PCODEC_REF_LIST                             m_ppRefList[m_numFrameStores];
+    CODEC_AVC_ENCODE_SLICE_PARAMS               m_slices[m_numSlices];
+    CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE   m_template;
+};
+
+TEST_F(MediaEncodeSliceHeaderTest, PackWithTemplate)
+{
+    if (m_pfnPackSliceHeader == nullptr)
+    {
+        return;
+    }
+
+    Bitstream expected;
+    PackFrame(expected, nullptr);
+
+    // Pass 0 of a frame invalidates the template, later passes keep it
+    MOS_ZeroMemory(&m_template, sizeof(m_template));
+    for (uint32_t pass = 0; pass < 2; pass++)
+    {
+        if (pass == 0)
+        {
+            m_template.bValid = false;
+        }
+
+        Bitstream actual;
+        PackFrame(actual, &m_template);
+        EXPECT_TRUE(expected == actual) << "pass " << pass;
+        EXPECT_TRUE(m_template.bValid) << "pass " << pass;
+    }
+}
+
+TEST_F(MediaEncodeSliceHeaderTest, InvalidateTemplatePerFrame)
+{
+    if (m_pfnPackSliceHeader == nullptr)
+    {
+        return;
+    }
+
+    MOS_ZeroMemory(&m_template, sizeof(m_template));
+    Bitstream firstFrame;
+    PackFrame(firstFrame, &m_template);
+    CODECHAL_ENCODE_AVC_SLICE_HEADER_TEMPLATE staleTemplate = m_template;
+
+    // The next frame reuses the parameter buffers with new content the
+    // template does not key on: no CABAC and references no longer reordered
+    m_picParams.entropy_coding_mode_flag = 0;
+    m_refList[1].sFrameNumber = 2;
+    m_refList[2].sFrameNumber = 1;
+
+    Bitstream expected;
+    PackFrame(expected, nullptr);
+
+    m_template.bValid = false;
+    Bitstream actual;
+    PackFrame(actual, &m_template);
+    EXPECT_TRUE(expected == actual);
+
+    // Without the invalidation the previous frame's fields would be copied
+    Bitstream stale;
+    PackFrame(stale, &staleTemplate);
+    EXPECT_FALSE(expected == stale);
+}
@@ -0,0 +1,160 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <memory>
+#include "gtest/gtest.h"
+#include "codechal_encode_jpeg.h"
+
+using namespace std;
+
+// The lookup of the JPEG header cache is header only, so it is checked on host
+// memory. The encoder converts the Huffman tables and packs the headers only
+// when the lookup misses; the test stands in for it by filling the cache.
+class MediaEncodeJpegHeaderCacheTest : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        m_cache.reset(new CodechalEncodeJpegHeaderCache());
+        MOS_ZeroMemory(&m_key, sizeof(m_key));
+        for (uint32_t i = 0; i < JPEG_MAX_NUM_QUANT_TABLE_INDEX; i++)
+        {
+            m_key.m_quantTables.m_quantTable[i].m_tableID = i;
+            for (uint32_t j = 0; j < JPEG_NUM_QUANTMATRIX; j++)
+            {
+                m_key.m_quantTables.m_quantTable[i].m_qm[j] = (uint16_t)(1 + (i * 7 + j) % 50);
+            }
+        }
+        m_key.m_numHuffBuffers     = 2;
+        m_key.m_picWidth           = 640;
+        m_key.m_picHeight          = 480;
+        m_key.m_numComponent       = 3;
+        m_key.m_componentID[0]     = 1;
+        m_key.m_componentID[1]     = 2;
+        m_key.m_componentID[2]     = 3;
+    }
+
+    // Packs the headers of a missed picture, as UpdateHeaderCache does
+    void Rebuild(uint8_t fill)
+    {
+        m_cache->m_huffTableParams[0].HuffTableID = 1;
+        m_cache->m_numSegments                    = 2;
+        m_cache->m_segments[1].m_offset           = 64;
+        m_cache->m_segments[1].m_bitSize          = 100 * 8;
+        m_cache->m_dataSize                       = 164;
+        memset(m_cache->m_data, fill, m_cache->m_dataSize);
+        m_cache->m_valid = true;
+        m_rebuilds++;
+    }
+
+    // Returns true if the picture reused the cache
+    bool EncodePicture(uint8_t fill)
+    {
+        if (m_cache->Lookup(m_key))
+        {
+            return true;
+        }
+        Rebuild(fill);
+        return false;
+    }
+
+    unique_ptr<CodechalEncodeJpegHeaderCache> m_cache;
+    CodechalEncodeJpegHeaderCacheKey          m_key;
+    uint32_t                                  m_rebuilds = 0;
+};
+
+TEST_F(MediaEncodeJpegHeaderCacheTest, HitSkipsRebuild)
+{
+    EXPECT_FALSE(EncodePicture(0x11));
+    for (uint32_t n = 0; n < 16; n++)
+    {
+        EXPECT_TRUE(EncodePicture(0x22)) << "picture " << n;
+    }
+
+    EXPECT_EQ(1u, m_rebuilds);
+    EXPECT_EQ(16u, m_cache->m_hits);
+    EXPECT_EQ(1u, m_cache->m_misses);
+
+    // The packed headers of the first picture are kept as they were
+    ASSERT_EQ(2u, m_cache->m_numSegments);
+    EXPECT_EQ(164u, m_cache->m_dataSize);
+    EXPECT_EQ(1u, m_cache->m_huffTableParams[0].HuffTableID);
+    for (uint32_t i = 0; i < m_cache->m_dataSize; i++)
+    {
+        ASSERT_EQ(0x11, m_cache->m_data[i]) << "byte " << i;
+    }
+}
+
+TEST_F(MediaEncodeJpegHeaderCacheTest, ChangedKeyRebuilds)
+{
+    EXPECT_FALSE(EncodePicture(0x11));
+
+    // Every field of the key takes part in the match
+    auto quant    = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_quantTables.m_quantTable[2].m_qm[63]++; };
+    auto huffman  = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_huffmanTables.m_huffmanData[1].m_huffVal[5]++; };
+    auto buffers  = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_numHuffBuffers++; };
+    auto width    = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_picWidth += 16; };
+    auto height   = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_picHeight += 16; };
+    auto format   = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_inputSurfaceFormat++; };
+    auto comps    = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_numComponent--; };
+    auto compID   = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_componentID[2]++; };
+    auto restart  = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_restartInterval++; };
+    auto single   = [](CodechalEncodeJpegHeaderCacheKey &key) { key.m_useSingleDefaultQuantTable ^= 1; };
+    void (*changes[])(CodechalEncodeJpegHeaderCacheKey &) = {
+        quant, huffman, buffers, width, height, format, comps, compID, restart, single };
+
+    uint32_t rebuilds = m_rebuilds;
+    uint8_t  fill     = 0x20;
+    for (auto change : changes)
+    {
+        change(m_key);
+        fill++;
+        EXPECT_FALSE(EncodePicture(fill)) << "change " << (uint32_t)(fill - 0x20);
+        EXPECT_EQ(++rebuilds, m_rebuilds);
+
+        // The new headers are reused from the next picture on
+        EXPECT_TRUE(EncodePicture(0xff));
+        EXPECT_EQ(fill, m_cache->m_data[0]);
+    }
+
+    EXPECT_EQ(sizeof(changes) / sizeof(changes[0]) + 1, m_cache->m_misses);
+    EXPECT_EQ(sizeof(changes) / sizeof(changes[0]), m_cache->m_hits);
+}
+
+TEST_F(MediaEncodeJpegHeaderCacheTest, MissEmptiesCache)
+{
+    EXPECT_FALSE(EncodePicture(0x11));
+
+    m_key.m_picWidth += 16;
+    EXPECT_FALSE(m_cache->Lookup(m_key));
+    EXPECT_FALSE(m_cache->m_valid);
+    EXPECT_EQ(0u, m_cache->m_numSegments);
+    EXPECT_EQ(0u, m_cache->m_dataSize);
+    EXPECT_EQ(0u, m_cache->m_huffTableParams[0].HuffTableID);
+
+    // Packing failed before the cache was marked valid, the next picture packs again
+    EXPECT_FALSE(EncodePicture(0x33));
+    EXPECT_TRUE(EncodePicture(0x44));
+    EXPECT_EQ(0x33, m_cache->m_data[0]);
+    EXPECT_EQ(3u, m_cache->m_misses);
+    EXPECT_EQ(1u, m_cache->m_hits);
+}
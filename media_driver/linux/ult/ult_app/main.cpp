@@ -20,15 +20,20 @@
 * OTHER DEALINGS IN THE SOFTWARE.
 */
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <stdio.h>
 #include "devconfig.h"
 #include "gtest/gtest.h"
+#include "perf_benchmark.h"
 
 using namespace std;
 
 const char*        g_dirverPath;
 vector<Platform_t> g_platform;
+static uint32_t    g_benchmarkFrames;
+static const char* g_benchmarkOut;
 
 static bool ParseCmd(int argc, char *argv[]);
 
@@ -41,37 +46,79 @@ int main(int argc, char *argv[])
         return -1;
     }
 
-    return RUN_ALL_TESTS();
+    int ret = RUN_ALL_TESTS();
+
+    PerfBenchmark::GetInstance()->Report();
+
+    return ret;
 }
 
 static bool ParsePlatform(const char *str);
 static bool ParseDriverPath(const char *str);
+static bool ParseBenchmark(const char *str);
 
 static bool ParseCmd(int argc, char *argv[])
 {
     g_dirverPath = nullptr;
     g_platform.clear();
+    g_benchmarkFrames = 0;
+    g_benchmarkOut    = nullptr;
 
     for (int i = 1; i < argc; i++)
     {
-        if (ParseDriverPath(argv[i]) == false && ParsePlatform(argv[i]) == false)
+        if (ParseDriverPath(argv[i]) == false && ParsePlatform(argv[i]) == false &&
+            ParseBenchmark(argv[i]) == false)
         {
             printf("ERROR\n    Bad command line parameter!\n\n");
-            printf("USAGE\n    devult [driver_path] [platform_name...]\n\n");
+            printf("USAGE\n    devult [driver_path] [platform_name...] [--benchmark=frames] [--benchmark_out=file]\n\n");
             printf("DESCRIPTION\n    [driver_path]     : Use default driver relative path if not specify driver_path.\n"
-                "    [platform_name...]: Select zero or more items from {SKL, BXT, BDW, CNL}.\n\n");
+                "    [platform_name...]: Select zero or more items from {SKL, BXT, BDW, CNL}.\n"
+                "    [--benchmark]     : Run each decode/encode test for the given number of frames and report\n"
+                "                        CPU time, command buffer bytes, relocations and allocations per frame.\n"
+                "    [--benchmark_out] : Write benchmark results to file, one JSON object per line.\n\n");
             printf("EXAMPLE\n    devult\n"
                 "    devult ./build/media_driver/iHD_drv_video.so\n"
                 "    devult skl\n"
                 "    devult ./build/media_driver/iHD_drv_video.so skl\n"
-                "    devult ./build/media_driver/iHD_drv_video.so skl cnl\n\n");
+                "    devult ./build/media_driver/iHD_drv_video.so skl cnl\n"
+                "    devult ./build/media_driver/iHD_drv_video.so skl --benchmark=500 --benchmark_out=perf.json\n\n");
             return false;
         }
     }
 
+    if (g_benchmarkFrames > 0)
+    {
+        PerfBenchmark::GetInstance()->Enable(g_benchmarkFrames, g_benchmarkOut);
+    }
+
     return true;
 }
 
+static bool ParseBenchmark(const char *str)
+{
+    const char benchmark[]    = "--benchmark=";
+    const char benchmarkOut[] = "--benchmark_out=";
+
+    if (strncmp(str, benchmark, sizeof(benchmark) - 1) == 0)
+    {
+        int frames = atoi(str + sizeof(benchmark) - 1);
+        if (frames <= 0)
+        {
+            return false;
+        }
+        g_benchmarkFrames = frames;
+        return true;
+    }
+
+    if (strncmp(str, benchmarkOut, sizeof(benchmarkOut) - 1) == 0 && str[sizeof(benchmarkOut) - 1] != '\0')
+    {
+        g_benchmarkOut = str + sizeof(benchmarkOut) - 1;
+        return true;
+    }
+
+    return false;
+}
+
 static bool ParsePlatform(const char *str)
 {
     string tmpStr(str);
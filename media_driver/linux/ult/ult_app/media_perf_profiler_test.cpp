@@ -0,0 +1,298 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_perf_profiler.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+
+using namespace std;
+
+typedef MOS_STATUS (*RunRingOpsFunc)(uint32_t, const char *, PPERF_PROFILER_ULT_OP, uint32_t);
+
+// Runs the ring mode of the perf profiler on a host buffer through the driver
+// test hook, nodes are completed and drained in the order of the test.
+class MediaPerfProfilerTest : public testing::Test
+{
+protected:
+
+    struct LatencyLine
+    {
+        uint32_t instance;
+        uint32_t engine;
+        uint64_t count, min, avg, p50, p90, p99, max;
+    };
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnRunRingOps = (RunRingOpsFunc)GetUltHook("MediaPerfProfiler_UltRunRingOps");
+    }
+
+    void TearDown() override
+    {
+        remove(m_outputFileName);
+        remove((string(m_outputFileName) + ".stats").c_str());
+
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    static PERF_PROFILER_ULT_OP Submit(uint32_t instanceId, uint32_t engineTag, uint64_t beginTS)
+    {
+        PERF_PROFILER_ULT_OP op = {};
+        op.type       = PERF_PROFILER_ULT_SUBMIT;
+        op.instanceId = instanceId;
+        op.engineTag  = engineTag;
+        op.timeStamp  = beginTS;
+        return op;
+    }
+
+    static PERF_PROFILER_ULT_OP Complete(uint32_t node, uint64_t endTS)
+    {
+        PERF_PROFILER_ULT_OP op = {};
+        op.type      = PERF_PROFILER_ULT_COMPLETE;
+        op.node      = node;
+        op.timeStamp = endTS;
+        return op;
+    }
+
+    static PERF_PROFILER_ULT_OP Drain()
+    {
+        PERF_PROFILER_ULT_OP op = {};
+        op.type = PERF_PROFILER_ULT_DRAIN;
+        return op;
+    }
+
+    void RunOps(uint32_t nodeNum, vector<PERF_PROFILER_ULT_OP> &ops)
+    {
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_pfnRunRingOps(nodeNum, m_outputFileName, ops.data(), (uint32_t)ops.size()));
+    }
+
+    // Statistics line of an instance on an engine in the saved statistics file
+    bool ReadLatencyLine(uint32_t instance, uint32_t engine, LatencyLine &latency, string *text = nullptr)
+    {
+        ifstream file(string(m_outputFileName) + ".stats");
+        string   line;
+        while (getline(file, line))
+        {
+            if (text != nullptr)
+            {
+                *text += line + "\n";
+            }
+
+            unsigned long long count, min, avg, p50, p90, p99, max;
+            if (sscanf(line.c_str(), "instance %u engine %u count %llu min %llu avg %llu p50 %llu p90 %llu p99 %llu max %llu",
+                    &latency.instance, &latency.engine, &count, &min, &avg, &p50, &p90, &p99, &max) == 9 &&
+                latency.instance == instance && latency.engine == engine)
+            {
+                latency.count = count;
+                latency.min   = min;
+                latency.avg   = avg;
+                latency.p50   = p50;
+                latency.p90   = p90;
+                latency.p99   = p99;
+                latency.max   = max;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    DriverDllLoader m_driverLoader;
+    Platform_t      m_platform          = igfx_MAX;
+    bool            m_driverInitialized = false;
+    RunRingOpsFunc  m_pfnRunRingOps     = nullptr;
+    const char      *m_outputFileName   = "media_perf_profiler_test.bin";
+};
+
+// Nodes complete out of order across engines, the drain waits for the oldest
+TEST_F(MediaPerfProfilerTest, DrainWaitsForOldestNode)
+{
+    if (m_pfnRunRingOps == nullptr)
+    {
+        return;
+    }
+
+    vector<PERF_PROFILER_ULT_OP> ops;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        ops.push_back(Submit(1, i & 1, 100 * i));
+    }
+    ops.push_back(Complete(1, 1000));
+    ops.push_back(Complete(2, 1000));
+    ops.push_back(Drain());
+    ops.push_back(Complete(0, 1000));
+    ops.push_back(Drain());
+    ops.push_back(Complete(3, 1000));
+    ops.push_back(Drain());
+    RunOps(16, ops);
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(i, ops[i].node);
+    }
+    EXPECT_EQ(0u, ops[6].drainedNodes);
+    EXPECT_EQ(3u, ops[8].drainedNodes);
+    EXPECT_EQ(1u, ops[10].drainedNodes);
+    EXPECT_EQ(0u, ops[10].droppedNodes);
+
+    LatencyLine latency;
+    ASSERT_TRUE(ReadLatencyLine(1, 0, latency));
+    EXPECT_EQ(2u, latency.count);
+    ASSERT_TRUE(ReadLatencyLine(1, 1, latency));
+    EXPECT_EQ(2u, latency.count);
+}
+
+// A node not completed when half the ring has been submitted after it is dropped
+TEST_F(MediaPerfProfilerTest, DropIncompleteNodeHalfRingBehind)
+{
+    if (m_pfnRunRingOps == nullptr)
+    {
+        return;
+    }
+
+    vector<PERF_PROFILER_ULT_OP> ops;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        ops.push_back(Submit(1, 0, 0));
+    }
+    for (uint32_t i = 1; i < 4; i++)
+    {
+        ops.push_back(Complete(i, 1000));
+    }
+    ops.push_back(Drain());
+    ops.push_back(Submit(1, 0, 0));
+    ops.push_back(Complete(4, 1000));
+    ops.push_back(Drain());
+    RunOps(8, ops);
+
+    EXPECT_EQ(0u, ops[7].drainedNodes);
+    EXPECT_EQ(0u, ops[7].droppedNodes);
+    EXPECT_EQ(4u, ops[10].drainedNodes);
+    EXPECT_EQ(1u, ops[10].droppedNodes);
+}
+
+// Nodes overwritten before they were drained are dropped, and their reuse
+// must not be taken as complete from the end timestamp of the previous lap
+TEST_F(MediaPerfProfilerTest, OverwrittenNodesAreDropped)
+{
+    if (m_pfnRunRingOps == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t nodeNum = 8;
+
+    vector<PERF_PROFILER_ULT_OP> ops;
+    for (uint32_t i = 0; i < nodeNum; i++)
+    {
+        ops.push_back(Submit(1, 0, 0));
+        ops.push_back(Complete(i, 1000));
+    }
+    for (uint32_t i = 0; i < nodeNum / 2; i++)
+    {
+        ops.push_back(Submit(1, 0, 0));
+    }
+    ops.push_back(Drain());
+    size_t firstDrain = ops.size() - 1;
+    for (uint32_t i = 0; i < nodeNum / 2; i++)
+    {
+        ops.push_back(Complete(i, 2000));
+    }
+    ops.push_back(Drain());
+    RunOps(nodeNum, ops);
+
+    EXPECT_EQ(nodeNum / 2, ops[firstDrain].drainedNodes);
+    EXPECT_EQ(nodeNum / 2, ops[firstDrain].droppedNodes);
+    EXPECT_EQ(nodeNum / 2, ops.back().drainedNodes);
+    EXPECT_EQ(nodeNum / 2, ops.back().droppedNodes);
+
+    LatencyLine latency;
+    ASSERT_TRUE(ReadLatencyLine(1, 0, latency));
+    EXPECT_EQ(nodeNum, latency.count);
+    EXPECT_EQ(1000u, latency.min);
+    EXPECT_EQ(2000u, latency.max);
+}
+
+// Percentiles are interpolated within the log2 bins of the histogram
+TEST_F(MediaPerfProfilerTest, LatencyPercentiles)
+{
+    if (m_pfnRunRingOps == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t nodeNum = 256;
+    const uint32_t count   = 200;
+
+    // Latencies spread evenly over [1024, 2048), and a constant latency
+    vector<PERF_PROFILER_ULT_OP> ops;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ops.push_back(Submit(2, 1, 5000));
+        ops.push_back(Complete(ops.size() / 2, 5000 + 1024 + 5 * i));
+    }
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        ops.push_back(Submit(3, 1, 5000));
+        ops.push_back(Complete(count + i, 5000 + 1500));
+    }
+    ops.push_back(Drain());
+    RunOps(nodeNum, ops);
+    EXPECT_EQ(count + 10, ops.back().drainedNodes);
+
+    string      text;
+    LatencyLine latency;
+    ASSERT_TRUE(ReadLatencyLine(2, 1, latency, &text));
+    EXPECT_NE(string::npos, text.find("interpolated")) << text;
+    EXPECT_EQ(count, latency.count);
+    EXPECT_EQ(1024u, latency.min);
+    EXPECT_EQ(1024u + 5 * (count - 1), latency.max);
+    EXPECT_EQ(1024u + 5 * (count - 1) / 2, latency.avg);
+
+    // Exact percentiles are the latencies of rank 100, 180 and 198, within a
+    // few steps of 5 ticks
+    EXPECT_NEAR(1024 + 5 * 99, (double)latency.p50, 32);
+    EXPECT_NEAR(1024 + 5 * 179, (double)latency.p90, 32);
+    EXPECT_NEAR(1024 + 5 * 197, (double)latency.p99, 32);
+    EXPECT_LE(latency.p50, latency.p90);
+    EXPECT_LE(latency.p90, latency.p99);
+    EXPECT_LE(latency.p99, latency.max);
+
+    ASSERT_TRUE(ReadLatencyLine(3, 1, latency));
+    EXPECT_EQ(1500u, latency.p50);
+    EXPECT_EQ(1500u, latency.p90);
+    EXPECT_EQ(1500u, latency.p99);
+}
@@ -0,0 +1,172 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <vector>
+#include "gtest/gtest.h"
+#include "mhw_utilities.h"
+#include "mhw_state_heap.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+
+using namespace std;
+
+typedef MOS_STATUS (*CalcPolyphaseTableFunc)(uint32_t, int32_t *, float, float, uint32_t, uint32_t, bool, uint32_t, int32_t);
+typedef MOS_STATUS (*GetPolyphaseCacheStatsFunc)(uint64_t *, uint64_t *);
+
+// Table types of Mhw_UltCalcPolyphaseTable, MHW_POLYPHASE_TABLE_TYPE
+enum
+{
+    POLYPHASE_TABLE_Y = 0,
+    POLYPHASE_TABLE_UV,
+    POLYPHASE_TABLE_UV_OFFSET
+};
+
+// Calculates polyphase tables through the process wide cache of the driver
+// and checks hits return what a fresh calculation does.
+class MhwPolyphaseCacheTest : public testing::Test
+{
+protected:
+
+    struct Table
+    {
+        uint32_t    type;
+        float       scaleFactor;
+        float       param;
+        uint32_t    plane;
+        int32_t     uvPhaseOffset;
+    };
+
+    static const uint32_t m_cacheSize = 64;     // MHW_POLYPHASE_CACHE_SIZE
+    static const uint32_t m_maxCoefs  = NUM_HW_POLYPHASE_TABLES * NUM_POLYPHASE_Y_ENTRIES;
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnCalc     = (CalcPolyphaseTableFunc)GetUltHook("Mhw_UltCalcPolyphaseTable");
+        m_pfnGetStats = (GetPolyphaseCacheStatsFunc)GetUltHook("Mhw_UltGetPolyphaseCacheStats");
+    }
+
+    void TearDown() override
+    {
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    // Entries past the table keep the fill value, so whole buffers are compared
+    vector<int32_t> Calc(const Table &table)
+    {
+        vector<int32_t> coefs(m_maxCoefs, 0x5a5a5a5a);
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_pfnCalc(table.type, coefs.data(), table.scaleFactor, table.param,
+            table.plane, Format_NV12, true, NUM_HW_POLYPHASE_TABLES, table.uvPhaseOffset));
+        return coefs;
+    }
+
+    void GetStats(uint64_t &hits, uint64_t &misses)
+    {
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_pfnGetStats(&hits, &misses));
+    }
+
+    void ExecuteHitMatchesFresh(const Table &table)
+    {
+        uint64_t hits, misses, hits2, misses2;
+
+        GetStats(hits, misses);
+        vector<int32_t> fresh = Calc(table);
+        vector<int32_t> hit   = Calc(table);
+        GetStats(hits2, misses2);
+        EXPECT_EQ(hits + 1, hits2) << "type " << table.type;
+        EXPECT_EQ(misses + 1, misses2) << "type " << table.type;
+        EXPECT_EQ(fresh, hit) << "type " << table.type;
+
+        // Replace every entry, round robin, so the table is calculated again
+        for (uint32_t i = 0; i < m_cacheSize; i++)
+        {
+            Table other = { POLYPHASE_TABLE_UV, 0.125f + i / 256.0f, 3.0f, MHW_U_PLANE, 0 };
+            Calc(other);
+        }
+
+        GetStats(hits, misses);
+        vector<int32_t> recalculated = Calc(table);
+        GetStats(hits2, misses2);
+        EXPECT_EQ(hits, hits2) << "type " << table.type;
+        EXPECT_EQ(misses + 1, misses2) << "type " << table.type;
+        EXPECT_EQ(recalculated, hit) << "type " << table.type;
+    }
+
+    DriverDllLoader             m_driverLoader;
+    Platform_t                  m_platform          = igfx_MAX;
+    bool                        m_driverInitialized = false;
+    CalcPolyphaseTableFunc      m_pfnCalc           = nullptr;
+    GetPolyphaseCacheStatsFunc  m_pfnGetStats       = nullptr;
+};
+
+TEST_F(MhwPolyphaseCacheTest, HitMatchesFreshY)
+{
+    if (m_pfnCalc == nullptr || m_pfnGetStats == nullptr)
+    {
+        return;
+    }
+
+    ExecuteHitMatchesFresh({ POLYPHASE_TABLE_Y, 0.6171875f, 0.375f, MHW_Y_PLANE, 0 });
+    ExecuteHitMatchesFresh({ POLYPHASE_TABLE_Y, 1.8671875f, 0.375f, MHW_U_PLANE, 0 });
+}
+
+TEST_F(MhwPolyphaseCacheTest, HitMatchesFreshUV)
+{
+    if (m_pfnCalc == nullptr || m_pfnGetStats == nullptr)
+    {
+        return;
+    }
+
+    ExecuteHitMatchesFresh({ POLYPHASE_TABLE_UV, 0.4296875f, 3.0f, MHW_U_PLANE, 0 });
+    ExecuteHitMatchesFresh({ POLYPHASE_TABLE_UV_OFFSET, 0.4296875f, 3.0f, MHW_U_PLANE, 8 });
+}
+
+// Tables of inputs differing in a single bit are not mixed up
+TEST_F(MhwPolyphaseCacheTest, CloseScaleFactorsMiss)
+{
+    if (m_pfnCalc == nullptr || m_pfnGetStats == nullptr)
+    {
+        return;
+    }
+
+    uint64_t hits, misses, hits2, misses2;
+    float    scaleFactor = 0.7421875f;
+    uint32_t bits;
+    memcpy(&bits, &scaleFactor, sizeof(bits));
+    bits++;
+    float    nextScaleFactor;
+    memcpy(&nextScaleFactor, &bits, sizeof(bits));
+
+    Calc({ POLYPHASE_TABLE_Y, scaleFactor, 0.375f, MHW_Y_PLANE, 0 });
+    GetStats(hits, misses);
+    Calc({ POLYPHASE_TABLE_Y, nextScaleFactor, 0.375f, MHW_Y_PLANE, 0 });
+    GetStats(hits2, misses2);
+    EXPECT_EQ(hits, hits2);
+    EXPECT_EQ(misses + 1, misses2);
+}
@@ -0,0 +1,182 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <dlfcn.h>
+#include <stdio.h>
+#include <time.h>
+#include "perf_benchmark.h"
+
+using namespace std;
+
+PerfBenchmark *PerfBenchmark::m_instance = nullptr;
+
+PerfBenchmark *PerfBenchmark::GetInstance()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new PerfBenchmark();
+    }
+
+    return m_instance;
+}
+
+void PerfBenchmark::Enable(uint32_t frameNum, const char *outPath)
+{
+    m_frameNum = frameNum;
+    m_outPath  = outPath ? outPath : "";
+
+    // libdrm_mock is preloaded, its counters are optional
+    m_pfnGetMockCounters = (MockGetCountersFunc)dlsym(RTLD_DEFAULT, "mos_bufmgr_mock_get_counters");
+}
+
+void PerfBenchmark::Begin(const string &name, Platform_t platform)
+{
+    m_current          = {};
+    m_current.name     = name;
+    m_current.platform = platform;
+
+    GetMockCounters(m_startCounters);
+    m_running     = true;
+    m_startWallNs = GetWallTimeNs();
+    m_startCpuNs  = GetCpuTimeNs();
+}
+
+void PerfBenchmark::RecordCmdBuf(const PMOS_COMMAND_BUFFER pCmdBuffer)
+{
+    if (!m_running || pCmdBuffer == nullptr)
+    {
+        return;
+    }
+
+    m_current.cmdBufBytes += (uint8_t *)pCmdBuffer->pCmdPtr - (uint8_t *)pCmdBuffer->pCmdBase;
+    m_current.cmdBufSubmits++;
+}
+
+void PerfBenchmark::End(uint64_t items)
+{
+    uint64_t cpuNs  = GetCpuTimeNs();
+    uint64_t wallNs = GetWallTimeNs();
+    MockBufMgrCounters counters;
+
+    if (!m_running)
+    {
+        return;
+    }
+    m_running = false;
+
+    GetMockCounters(counters);
+    m_current.frames     = m_frameNum;
+    m_current.cpuTimeUs  = (cpuNs - m_startCpuNs) / 1000.0;
+    m_current.wallTimeUs = (wallNs - m_startWallNs) / 1000.0;
+    m_current.relocs     = counters.relocs - m_startCounters.relocs;
+    m_current.boAllocs   = counters.boAllocs - m_startCounters.boAllocs;
+    m_current.items      = items;
+
+    m_results.push_back(m_current);
+}
+
+void PerfBenchmark::Report() const
+{
+    if (!IsEnabled() || m_results.empty())
+    {
+        return;
+    }
+
+    printf("\n%-20s %-8s %8s %14s %14s %14s %12s %12s %12s %14s\n",
+        "BENCHMARK", "PLATFORM", "FRAMES", "CPU_US/FRAME", "WALL_US/FRAME",
+        "CMDBYTES/FRAME", "SUBMIT/FRAME", "RELOC/FRAME", "ALLOC/FRAME", "ITEMS/CPU_SEC");
+    for (const auto &r : m_results)
+    {
+        double frames = r.frames ? r.frames : 1;
+        printf("%-20s %-8s %8u %14.2f %14.2f %14.1f %12.2f %12.2f %12.2f %14.0f\n",
+            r.name.c_str(), GetPlatformName(r.platform), r.frames,
+            r.cpuTimeUs / frames, r.wallTimeUs / frames, r.cmdBufBytes / frames,
+            r.cmdBufSubmits / frames, r.relocs / frames, r.boAllocs / frames,
+            GetItemsPerSec(r));
+    }
+
+    if (m_outPath.empty())
+    {
+        return;
+    }
+
+    // One JSON object per line, totals and per frame values
+    FILE *fp = fopen(m_outPath.c_str(), "w");
+    if (fp == nullptr)
+    {
+        printf("ERROR: cannot open benchmark output file %s.\n", m_outPath.c_str());
+        return;
+    }
+
+    for (const auto &r : m_results)
+    {
+        double frames = r.frames ? r.frames : 1;
+        fprintf(fp, "{\"name\":\"%s\",\"platform\":\"%s\",\"frames\":%u,"
+            "\"cpu_us\":%.3f,\"wall_us\":%.3f,\"cmdbuf_bytes\":%llu,\"cmdbuf_submits\":%llu,"
+            "\"relocs\":%llu,\"bo_allocs\":%llu,\"items\":%llu,"
+            "\"cpu_us_per_frame\":%.3f,\"cmdbuf_bytes_per_frame\":%.1f,"
+            "\"relocs_per_frame\":%.3f,\"bo_allocs_per_frame\":%.3f,"
+            "\"items_per_cpu_sec\":%.1f}\n",
+            r.name.c_str(), GetPlatformName(r.platform), r.frames,
+            r.cpuTimeUs, r.wallTimeUs,
+            (unsigned long long)r.cmdBufBytes, (unsigned long long)r.cmdBufSubmits,
+            (unsigned long long)r.relocs, (unsigned long long)r.boAllocs,
+            (unsigned long long)r.items,
+            r.cpuTimeUs / frames, r.cmdBufBytes / frames,
+            r.relocs / frames, r.boAllocs / frames,
+            GetItemsPerSec(r));
+    }
+
+    fclose(fp);
+}
+
+double PerfBenchmark::GetItemsPerSec(const PerfBenchmarkResult &result)
+{
+    return result.cpuTimeUs > 0 ? result.items * 1000000.0 / result.cpuTimeUs : 0;
+}
+
+const char *PerfBenchmark::GetPlatformName(Platform_t platform)
+{
+    return platform < igfx_MAX ? g_platformName[platform] : "HOST";
+}
+
+uint64_t PerfBenchmark::GetCpuTimeNs()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t PerfBenchmark::GetWallTimeNs()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void PerfBenchmark::GetMockCounters(MockBufMgrCounters &counters) const
+{
+    counters = {};
+    if (m_pfnGetMockCounters)
+    {
+        m_pfnGetMockCounters(&counters);
+    }
+}
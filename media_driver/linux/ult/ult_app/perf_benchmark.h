@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef __PERF_BENCHMARK_H__
+#define __PERF_BENCHMARK_H__
+
+#include <string>
+#include <vector>
+#include "driver_loader.h"
+
+// Layout must match struct mos_bufmgr_mock_counters in libdrm_mock
+struct MockBufMgrCounters
+{
+    uint64_t boAllocs;
+    uint64_t relocs;
+    uint64_t execs;
+};
+
+typedef void (*MockGetCountersFunc)(MockBufMgrCounters *counters);
+
+struct PerfBenchmarkResult
+{
+    std::string name;
+    Platform_t  platform;       // igfx_MAX for host only benchmarks
+    uint32_t    frames;
+    double      cpuTimeUs;      // Process CPU time of the frame loop
+    double      wallTimeUs;     // Wall clock time of the frame loop
+    uint64_t    cmdBufBytes;    // Bytes programmed into submitted command buffers
+    uint64_t    cmdBufSubmits;  // Number of command buffer submissions
+    uint64_t    relocs;         // Relocations emitted (libdrm_mock)
+    uint64_t    boAllocs;       // Buffer object allocations (libdrm_mock)
+    uint64_t    items;          // Work items of the loop, e.g. macroblocks, 0 if not counted
+};
+
+// Benchmark mode of the decode/encode DDI tests: runs a fixed number of frames
+// per codec and platform against libdrm_mock and reports the driver-side CPU
+// cost per frame. Host only tests (e.g. STMM history init) report per
+// iteration. Enabled from the command line (see main.cpp).
+class PerfBenchmark
+{
+public:
+
+    static PerfBenchmark *GetInstance();
+
+    void Enable(uint32_t frameNum, const char *outPath);
+
+    bool IsEnabled() const { return m_frameNum > 0; }
+
+    bool IsRunning() const { return m_running; }
+
+    uint32_t GetFrameNum() const { return m_frameNum; }
+
+    void Begin(const std::string &name, Platform_t platform);
+
+    void RecordCmdBuf(const PMOS_COMMAND_BUFFER pCmdBuffer);
+
+    // items counts the work of the whole loop, reported per CPU second
+    void End(uint64_t items = 0);
+
+    void Report() const;
+
+private:
+
+    static const char *GetPlatformName(Platform_t platform);
+
+    static double GetItemsPerSec(const PerfBenchmarkResult &result);
+
+    static uint64_t GetCpuTimeNs();
+
+    static uint64_t GetWallTimeNs();
+
+    void GetMockCounters(MockBufMgrCounters &counters) const;
+
+private:
+
+    static PerfBenchmark             *m_instance;
+
+    uint32_t                         m_frameNum           = 0;
+    std::string                      m_outPath;
+    bool                             m_running            = false;
+    MockGetCountersFunc              m_pfnGetMockCounters = nullptr;
+
+    PerfBenchmarkResult              m_current            = {};
+    uint64_t                         m_startCpuNs         = 0;
+    uint64_t                         m_startWallNs        = 0;
+    MockBufMgrCounters               m_startCounters      = {};
+    std::vector<PerfBenchmarkResult> m_results;
+};
+
+#endif // __PERF_BENCHMARK_H__
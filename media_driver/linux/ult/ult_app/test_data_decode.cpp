@@ -164,6 +164,16 @@ DecTestDataAVC::DecTestDataAVC(FeatureID testFeatureID, bool bInShortFormat)
     }
 }
 
+DecTestDataAVCMono::DecTestDataAVCMono(FeatureID testFeatureID) : DecTestDataAVCLong(testFeatureID)
+{
+    // 4:0:0, the driver fills the chroma of the NV12 render target
+    for (auto &frame : m_frameArrayLong)
+    {
+        auto *pps = (VAPictureParameterBufferH264 *)&frame.picParam[0];
+        pps->seq_fields.bits.chroma_format_idc = 0;
+    }
+}
+
 void DecTestDataHEVC::InitCompBuffers()
 {
     m_frameArrayLong.resize(DEC_FRAME_NUM);
@@ -197,6 +197,13 @@ protected:
     void InitCompBuffers();
 };
 
+class DecTestDataAVCMono : public DecTestDataAVCLong
+{
+public:
+
+    DecTestDataAVCMono(FeatureID testFeatureID);
+};
+
 class DecTestDataAVCShort : public DecTestDataAVC
 {
 public:
@@ -222,6 +229,10 @@ public:
         {
             return new DecTestDataAVCLong(TEST_Intel_Decode_AVC);
         }
+        if (description == "AVC-Mono")
+        {
+            return new DecTestDataAVCMono(TEST_Intel_Decode_AVC);
+        }
 
         return nullptr;
     }
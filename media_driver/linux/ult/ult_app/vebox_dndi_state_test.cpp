@@ -0,0 +1,192 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mhw_vebox.h"
+#include "driver_loader.h"
+#include "memory_leak_detector.h"
+
+using namespace std;
+
+typedef MOS_STATUS (*RunDndiStateOpsFunc)(uint32_t, PMHW_VEBOX_ULT_DNDI_OP, uint32_t);
+
+// Runs DNDI state updates on a host VEBOX heap through the driver test hook
+// and checks which of them built the state.
+class VeboxDndiStateTest : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        ASSERT_LT(0, m_driverLoader.GetPlatformNum());
+        m_platform = m_driverLoader.GetPlatforms()[0];
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(m_platform));
+        m_driverInitialized = true;
+
+        m_pfnRunDndiStateOps = (RunDndiStateOpsFunc)GetUltHook("MhwVebox_UltRunDndiStateOps");
+    }
+
+    void TearDown() override
+    {
+        if (m_driverInitialized)
+        {
+            EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+            MemoryLeakDetector::Detect(m_driverLoader, m_platform);
+        }
+    }
+
+    static MHW_VEBOX_DNDI_PARAMS DefaultParams()
+    {
+        MHW_VEBOX_DNDI_PARAMS params;
+        memset(&params, 0, sizeof(params));
+        params.dwDenoiseASDThreshold   = 512;
+        params.dwDenoiseHistoryDelta   = 8;
+        params.dwDenoiseMaximumHistory = 192;
+        params.dwDenoiseSTADThreshold  = 2048;
+        params.dwLTDThreshold          = 64;
+        params.dwTDThreshold           = 128;
+        params.bProgressiveDN          = true;
+        params.bChromaDNEnable         = true;
+        return params;
+    }
+
+    static MHW_VEBOX_ULT_DNDI_OP Update(const MHW_VEBOX_DNDI_PARAMS &params, uint32_t state = 0, bool updatedByGpu = false)
+    {
+        MHW_VEBOX_ULT_DNDI_OP op;
+        memset(&op, 0, sizeof(op));
+        op.DndiParams         = params;
+        op.uiState            = state;
+        op.bStateUpdatedByGpu = updatedByGpu;
+        return op;
+    }
+
+    void RunOps(uint32_t numInstances, vector<MHW_VEBOX_ULT_DNDI_OP> &ops)
+    {
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_pfnRunDndiStateOps(numInstances, ops.data(), (uint32_t)ops.size()));
+    }
+
+    DriverDllLoader     m_driverLoader;
+    Platform_t          m_platform              = igfx_MAX;
+    bool                m_driverInitialized     = false;
+    RunDndiStateOpsFunc m_pfnRunDndiStateOps    = nullptr;
+};
+
+// Identical params reuse the state, a change of any byte of the params rebuilds it
+TEST_F(VeboxDndiStateTest, ChangedParamForcesRewrite)
+{
+    if (m_pfnRunDndiStateOps == nullptr)
+    {
+        return;
+    }
+
+    MHW_VEBOX_DNDI_PARAMS          params = DefaultParams();
+    vector<MHW_VEBOX_ULT_DNDI_OP>  ops;
+    ops.push_back(Update(params));
+    ops.push_back(Update(params));
+    for (size_t i = 0; i < sizeof(params); i++)
+    {
+        MHW_VEBOX_DNDI_PARAMS changed = params;
+        ((uint8_t *)&changed)[i] ^= 1;
+        ops.push_back(Update(changed));
+        ops.push_back(Update(changed));
+        ops.push_back(Update(params));
+    }
+    RunOps(1, ops);
+
+    EXPECT_TRUE(ops[0].bWritten);
+    EXPECT_FALSE(ops[1].bWritten);
+    for (size_t i = 0; i < sizeof(params); i++)
+    {
+        EXPECT_TRUE(ops[2 + 3 * i].bWritten) << "byte " << i;
+        EXPECT_FALSE(ops[3 + 3 * i].bWritten) << "byte " << i;
+        EXPECT_TRUE(ops[4 + 3 * i].bWritten) << "byte " << i;
+    }
+}
+
+// Every heap instance holds its own state
+TEST_F(VeboxDndiStateTest, InstancesAreIndependent)
+{
+    if (m_pfnRunDndiStateOps == nullptr)
+    {
+        return;
+    }
+
+    MHW_VEBOX_DNDI_PARAMS params  = DefaultParams();
+    MHW_VEBOX_DNDI_PARAMS changed = params;
+    changed.dwTDThreshold++;
+
+    vector<MHW_VEBOX_ULT_DNDI_OP> ops;
+    ops.push_back(Update(params, 0));
+    ops.push_back(Update(params, 1));
+    ops.push_back(Update(changed, 1));
+    ops.push_back(Update(params, 0));
+    ops.push_back(Update(changed, 1));
+    RunOps(2, ops);
+
+    EXPECT_TRUE(ops[0].bWritten);
+    EXPECT_TRUE(ops[1].bWritten);
+    EXPECT_TRUE(ops[2].bWritten);
+    EXPECT_FALSE(ops[3].bWritten);
+    EXPECT_FALSE(ops[4].bWritten);
+}
+
+// A state the auto denoise kernel modifies on the GPU is never reused
+TEST_F(VeboxDndiStateTest, GpuUpdatedStateNotReused)
+{
+    if (m_pfnRunDndiStateOps == nullptr)
+    {
+        return;
+    }
+
+    MHW_VEBOX_DNDI_PARAMS         params = DefaultParams();
+    vector<MHW_VEBOX_ULT_DNDI_OP> ops;
+    ops.push_back(Update(params, 0, true));
+    ops.push_back(Update(params, 0, true));
+    ops.push_back(Update(params));
+    ops.push_back(Update(params));
+    ops.push_back(Update(params, 0, true));
+    ops.push_back(Update(params));
+    RunOps(1, ops);
+
+    EXPECT_TRUE(ops[0].bWritten);
+    EXPECT_TRUE(ops[1].bWritten);
+    EXPECT_TRUE(ops[2].bWritten);
+    EXPECT_FALSE(ops[3].bWritten);
+    EXPECT_TRUE(ops[4].bWritten);
+    EXPECT_TRUE(ops[5].bWritten);
+}
+
+// Updates of an instance outside the heap fail
+TEST_F(VeboxDndiStateTest, InvalidInstance)
+{
+    if (m_pfnRunDndiStateOps == nullptr)
+    {
+        return;
+    }
+
+    vector<MHW_VEBOX_ULT_DNDI_OP> ops;
+    ops.push_back(Update(DefaultParams(), 2));
+    EXPECT_EQ(MOS_STATUS_INVALID_PARAMETER, m_pfnRunDndiStateOps(2, ops.data(), (uint32_t)ops.size()));
+    EXPECT_EQ(MOS_STATUS_INVALID_PARAMETER, ops[0].eStatus);
+    EXPECT_FALSE(ops[0].bWritten);
+}
@@ -0,0 +1,69 @@
+/*
+* Copyright (c) 2018, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <vector>
+#include "gtest/gtest.h"
+#include "mhw_vebox.h"
+#include "perf_benchmark.h"
+
+using namespace std;
+
+// STMM history init is a pure CPU fill of the locked surface, so it is tested
+// on host memory laid out like the STMM surface of the given resolution.
+static void ExecuteSTMMHistoryTest(const char *name, uint32_t width, uint32_t height)
+{
+    const uint8_t  untouched = 0x5a;
+    uint32_t       pitch     = MOS_ALIGN_CEIL(width, 128);
+    vector<uint8_t> surface(pitch * height, untouched);
+
+    Mhw_FillSTMMHistory(surface.data(), width, height, pitch);
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t *row = surface.data() + y * pitch;
+        for (uint32_t x = 0; x < pitch; x++)
+        {
+            uint8_t expected = (x < (width & ~3) && (x & 3) < 2) ? DNDI_HISTORY_INITVALUE : untouched;
+            ASSERT_EQ(expected, row[x]) << name << ", x = " << x << ", y = " << y;
+        }
+    }
+
+    auto perfBenchmark = PerfBenchmark::GetInstance();
+    if (perfBenchmark->IsEnabled())
+    {
+        perfBenchmark->Begin(name, igfx_MAX);
+        for (uint32_t n = 0; n < perfBenchmark->GetFrameNum(); n++)
+        {
+            Mhw_FillSTMMHistory(surface.data(), width, height, pitch);
+        }
+        perfBenchmark->End();
+    }
+}
+
+TEST(MediaVeboxSTMMTest, InitSTMMHistory1080p)
+{
+    ExecuteSTMMHistoryTest("InitSTMMHistory1080p", 1920, 1080);
+}
+
+TEST(MediaVeboxSTMMTest, InitSTMMHistory4K)
+{
+    ExecuteSTMMHistoryTest("InitSTMMHistory4K", 3840, 2160);
+}
@@ -75,6 +75,11 @@ set_target_properties(${LIB_NAME_STATIC} PROPERTIES PREFIX "")
 
 MediaAddCommonTargetDefines(${LIB_NAME_OBJ})
 
+option(MEDIA_ULT_HOOKS "Export the devult test hooks from release drivers" OFF)
+if(MEDIA_ULT_HOOKS)
+    target_compile_definitions(${LIB_NAME_OBJ} PRIVATE MEDIA_ULT_HOOKS=1)
+endif()
+
 bs_ufo_link_libraries_noBsymbolic(
     ${LIB_NAME}
     "${INCLUDED_LIBS}"